@@ -0,0 +1,244 @@
+#pragma once
+
+//defines a headless benchmark harness for the CPU side of the renderers
+//runs synthetic scenes against stand-in assets, so no device is needed, and writes the results as JSON to track regressions
+
+#include <SmokRenderers/Renderers/GPUBasedMeshRenderer.hpp>
+#include <SmokRenderers/Renderers/GUIQuadRenderer.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+
+namespace Smok::Renderers::Benchmark
+{
+	//the allocations made through the global operator new || counted by the benchmark's source file
+	extern uint64 allocationCount;
+	extern uint64 allocationBytes;
+
+	//defines a synthetic scene
+	struct BenchmarkScene
+	{
+		std::string name = "";
+		uint32 objectCount = 0; //the objects added each frame
+
+		//how many different assets the objects are spread over
+		uint32 pipelineCount = 1, meshCount = 1, textureCount = 1;
+		uint32 subMeshCount = 1; //the meshes in each static mesh
+		uint32 lodCount = 1; //the LODs of each static mesh
+	};
+
+	//defines the result of a benchmark
+	struct BenchmarkResult
+	{
+		std::string name = "", scene = "";
+		uint32 itemCount = 0; //the objects, assets or quads each iteration works on
+		uint32 iterations = 0;
+
+		double nsPerIteration = 0.0, nsPerItem = 0.0; //of the fastest iteration
+		double allocationsPerIteration = 0.0, allocatedBytesPerIteration = 0.0; //averaged over the iterations
+		double allocationsPerItem = 0.0;
+	};
+
+	//defines the IDs of the stand-in assets of a scene
+	struct BenchmarkAssets
+	{
+		std::vector<std::string> shaderNames, pipelineNames, meshNames, textureNames; //made ahead of time, so registering doesn't time string building
+		std::vector<uint64> shaderIDs, pipelineIDs, meshIDs, textureIDs;
+		uint64 samplerID = 0;
+	};
+
+	//runs a benchmark || setup is called untimed before each iteration, then func is timed
+	template<typename Setup, typename Func>
+	inline BenchmarkResult Benchmark_Run(const std::string& name, const BenchmarkScene& scene, const uint32 itemCount, const uint32 iterations,
+		Setup setup, Func func)
+	{
+		BenchmarkResult result;
+		result.name = name; result.scene = scene.name;
+		result.itemCount = itemCount; result.iterations = iterations;
+
+		double fastest = 0.0;
+		uint64 allocations = 0, bytes = 0;
+		for (uint32 i = 0; i < iterations; ++i)
+		{
+			setup();
+
+			const uint64 startAllocations = allocationCount, startBytes = allocationBytes;
+			const auto start = std::chrono::steady_clock::now();
+			func();
+			const auto end = std::chrono::steady_clock::now();
+
+			allocations += allocationCount - startAllocations;
+			bytes += allocationBytes - startBytes;
+
+			const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+			if (i == 0 || ns < fastest)
+				fastest = ns;
+		}
+
+		result.nsPerIteration = fastest;
+		result.nsPerItem = (itemCount > 0 ? fastest / (double)itemCount : 0.0);
+		result.allocationsPerIteration = (iterations > 0 ? (double)allocations / (double)iterations : 0.0);
+		result.allocatedBytesPerIteration = (iterations > 0 ? (double)bytes / (double)iterations : 0.0);
+		result.allocationsPerItem = (itemCount > 0 ? result.allocationsPerIteration / (double)itemCount : 0.0);
+		return result;
+	}
+
+	//gets a fake handle, so the asset manager thinks a asset was already made and never touches the device
+	template<typename T>
+	inline T Benchmark_StandInHandle(const uint64 value) { return (T)(uintptr_t)value; }
+
+	//makes the asset names of a scene
+	inline void Benchmark_MakeAssetNames(const BenchmarkScene& scene, BenchmarkAssets* assets)
+	{
+		assets->shaderNames.clear(); assets->pipelineNames.clear(); assets->meshNames.clear(); assets->textureNames.clear();
+		for (uint32 i = 0; i < scene.pipelineCount; ++i)
+		{
+			assets->shaderNames.emplace_back("BenchmarkShader_" + std::to_string(i));
+			assets->pipelineNames.emplace_back("BenchmarkPipeline_" + std::to_string(i));
+		}
+		for (uint32 i = 0; i < scene.meshCount; ++i)
+			assets->meshNames.emplace_back("BenchmarkMesh_" + std::to_string(i));
+		for (uint32 i = 0; i < scene.textureCount; ++i)
+			assets->textureNames.emplace_back("BenchmarkTexture_" + std::to_string(i));
+	}
+
+	//registers the assets of a scene, the names must already be made
+	inline void Benchmark_RegisterAssets(AssetManager* assetManager, BenchmarkAssets* assets)
+	{
+		assets->shaderIDs.clear(); assets->pipelineIDs.clear(); assets->meshIDs.clear(); assets->textureIDs.clear();
+		for (size_t i = 0; i < assets->shaderNames.size(); ++i)
+		{
+			const uint64 shaderID = assetManager->RegisterGraphicsShader(assets->shaderNames[i].c_str(), "")->assetID;
+			assets->shaderIDs.emplace_back(shaderID);
+			assets->pipelineIDs.emplace_back(assetManager->RegisterGraphicsPipeline(assets->pipelineNames[i].c_str(), "", shaderID)->assetID);
+		}
+		for (size_t i = 0; i < assets->meshNames.size(); ++i)
+			assets->meshIDs.emplace_back(assetManager->RegisterStaticMesh(assets->meshNames[i].c_str(), "")->assetID);
+		for (size_t i = 0; i < assets->textureNames.size(); ++i)
+			assets->textureIDs.emplace_back(assetManager->RegisterTexture(assets->textureNames[i].c_str(), "")->assetID);
+		assets->samplerID = assetManager->RegisterSampler2D("BenchmarkSampler", "")->assetID;
+	}
+
+	//fills the registered assets with fake handles and mesh data, as if they were loaded and uploaded
+	inline void Benchmark_CreateStandInAssets(AssetManager* assetManager, const BenchmarkScene& scene, const BenchmarkAssets& assets)
+	{
+		uint64 handle = 1;
+		for (size_t i = 0; i < assets.shaderIDs.size(); ++i)
+		{
+			assetManager->GetGraphicsShader(assets.shaderIDs[i])->fMod = Benchmark_StandInHandle<VkShaderModule>(handle++);
+			assetManager->GetGraphicsPipeline(assets.pipelineIDs[i])->pipeline = Benchmark_StandInHandle<VkPipeline>(handle++);
+		}
+		for (size_t i = 0; i < assets.textureIDs.size(); ++i)
+		{
+			Smok::Texture::Texture* texture = assetManager->GetTexture(assets.textureIDs[i]);
+			texture->image = Benchmark_StandInHandle<VkImage>(handle++);
+			texture->view = Benchmark_StandInHandle<VkImageView>(handle++);
+		}
+		assetManager->samplerAssets[assets.samplerID].sampler = Benchmark_StandInHandle<VkSampler>(handle++);
+
+		//each static mesh gets it's own range of the mega mesh buffer, with the LODs after the full detail meshes
+		const uint32 subMeshCount = (scene.subMeshCount > 0 ? scene.subMeshCount : 1);
+		const uint32 lodCount = (scene.lodCount > 0 ? scene.lodCount : 1);
+		uint32 megaMeshBufferIndex = 0;
+		for (size_t i = 0; i < assets.meshIDs.size(); ++i)
+		{
+			StaticMesh* staticMesh = assetManager->GetStaticMesh(assets.meshIDs[i]);
+			staticMesh->isLoaded = true;
+			staticMesh->bounds.min = glm::vec3(-1.0f); staticMesh->bounds.max = glm::vec3(1.0f);
+			staticMesh->bounds.sphere = glm::vec4(0.0f, 0.0f, 0.0f, 1.7320508f);
+
+			uint32 triangleCount = 1024;
+			for (uint32 l = 0; l < lodCount; ++l)
+			{
+				StaticMesh_LOD lod;
+				lod.screenSize = (l == 0 ? 0.0f : 0.5f / (float)l);
+				for (uint32 m = 0; m < subMeshCount; ++m)
+				{
+					StaticMesh_SubMesh subMesh;
+					subMesh.megaMeshBufferIndex = megaMeshBufferIndex++;
+					subMesh.indexCount = triangleCount * 3;
+					subMesh.bounds = staticMesh->bounds;
+
+					lod.megaMeshBufferIndexes.emplace_back(subMesh.megaMeshBufferIndex);
+					lod.subMeshes.emplace_back(subMesh);
+					lod.triangleCount += triangleCount;
+
+					MegaMeshBuffer_MeshEntry entry;
+					entry.subMesh = subMesh;
+					assetManager->megaMeshBufferMeshes.emplace_back(entry);
+				}
+				staticMesh->lods.emplace_back(lod);
+				triangleCount = (triangleCount > 2 ? triangleCount / 2 : 1);
+			}
+
+			staticMesh->megaMeshBufferIndexes = staticMesh->lods[0].megaMeshBufferIndexes;
+			staticMesh->subMeshes = staticMesh->lods[0].subMeshes;
+			if (lodCount < 2)
+				staticMesh->lods.clear();
+		}
+
+		//the draws only check there are vertices, the stand-in buffer has no data behind it
+		assetManager->megaMeshBuffer.vertexCount = megaMeshBufferIndex * 1024;
+		assetManager->quantizedMegaMeshBuffer.vertexCount = megaMeshBufferIndex * 1024;
+	}
+
+	//adds every object of a scene, spreading them over the assets
+	inline void Benchmark_AddObjects(GPUBased::MeshRenderer::GPUMeshRenderer* renderer, const BenchmarkScene& scene, const BenchmarkAssets& assets,
+		std::vector<BTD::Math::Transform>& transforms, std::vector<GPUBased::MeshRenderer::ObjectBatch_Object>& objects)
+	{
+		for (uint32 i = 0; i < scene.objectCount; ++i)
+		{
+			const size_t pipeline = i % assets.pipelineIDs.size();
+			renderer->AddObject(&transforms[i], assets.meshIDs[i % assets.meshIDs.size()], assets.shaderIDs[pipeline], assets.pipelineIDs[pipeline],
+				assets.textureIDs[i % assets.textureIDs.size()], assets.samplerID, objects);
+		}
+	}
+
+	//makes a frame of GUI quads spread over the textures and layers of a scene
+	inline void Benchmark_MakeGUIQuads(const BenchmarkScene& scene, std::vector<GPUBased::GUIRenderer::GUIQuad>& quads)
+	{
+		quads.clear(); quads.reserve(scene.objectCount);
+		for (uint32 i = 0; i < scene.objectCount; ++i)
+		{
+			const glm::vec4 rect = glm::vec4((float)(i % 64) * 16.0f, (float)((i / 64) % 64) * 16.0f, 16.0f, 16.0f);
+			quads.emplace_back(GPUBased::GUIRenderer::GUIQuad_Create(rect, glm::vec4(1.0f), i % scene.textureCount, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+				SMOK_RENDERER_GUI_NO_CLIP, i % 8));
+		}
+	}
+
+	//converts the results into JSON
+	inline std::string Benchmark_ToJSON(const std::vector<BenchmarkResult>& results)
+	{
+		std::string json = "{\"results\":[\n";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const BenchmarkResult& result = results[i];
+			json += std::string(i > 0 ? ",\n" : "") + "{\"name\":\"" + Profiler_EscapeJSON(result.name) + "\",\"scene\":\"" + Profiler_EscapeJSON(result.scene) +
+				"\",\"items\":" + std::to_string(result.itemCount) + ",\"iterations\":" + std::to_string(result.iterations) +
+				",\"nsPerIteration\":" + std::to_string(result.nsPerIteration) + ",\"nsPerItem\":" + std::to_string(result.nsPerItem) +
+				",\"allocationsPerIteration\":" + std::to_string(result.allocationsPerIteration) +
+				",\"allocatedBytesPerIteration\":" + std::to_string(result.allocatedBytesPerIteration) +
+				",\"allocationsPerItem\":" + std::to_string(result.allocationsPerItem) + "}";
+		}
+
+		json += "\n]}\n";
+		return json;
+	}
+
+	//writes the results as a JSON file
+	inline bool Benchmark_WriteJSON(const std::vector<BenchmarkResult>& results, const std::string& path)
+	{
+		std::ofstream file(path);
+		if (!file.is_open())
+		{
+			BTD_LogError("Smok Renderer", "Benchmark", "Benchmark_WriteJSON", std::string("Failed to open \"" + path + "\"").c_str());
+			return false;
+		}
+
+		file << Benchmark_ToJSON(results);
+		return true;
+	}
+}
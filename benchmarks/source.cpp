@@ -0,0 +1,191 @@
+//runs the headless renderer benchmarks
+//usage: SmokRenderers-Benchmark [--max-objects N] [--iterations N] [--json path]
+
+#include "Benchmark.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace Smok::Renderers::Benchmark
+{
+	uint64 allocationCount = 0;
+	uint64 allocationBytes = 0;
+}
+
+//keeps results the benchmarks don't use from being optimized out
+static volatile uint64 benchmarkSink = 0;
+
+//counts every allocation, so the benchmarks can report them
+void* operator new(std::size_t size)
+{
+	Smok::Renderers::Benchmark::allocationCount++;
+	Smok::Renderers::Benchmark::allocationBytes += size;
+
+	void* ptr = std::malloc(size > 0 ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace Smok::Renderers;
+using namespace Smok::Renderers::Benchmark;
+using namespace Smok::Renderers::GPUBased;
+using namespace Smok::Renderers::GPUBased::GUIRenderer;
+
+//runs every benchmark of a scene
+static void RunScene(const BenchmarkScene& scene, const uint32 iterations, std::vector<BenchmarkResult>& results)
+{
+	BenchmarkAssets assets;
+	Benchmark_MakeAssetNames(scene, &assets);
+	const uint32 assetCount = scene.pipelineCount * 2 + scene.meshCount + scene.textureCount + 1;
+
+	//registering, each iteration starts from a empty asset manager
+	std::unique_ptr<AssetManager> assetManager;
+	results.emplace_back(Benchmark_Run("AssetManager Register", scene, assetCount, iterations,
+		[&]() { assetManager = std::make_unique<AssetManager>(); assetManager->IDRegistery.iDRegistery.nextID = 1; },
+		[&]() { Benchmark_RegisterAssets(assetManager.get(), &assets); }));
+
+	Benchmark_CreateStandInAssets(assetManager.get(), scene, assets);
+
+	//looking up each object's assets by name
+	results.emplace_back(Benchmark_Run("AssetManager Lookup By Name", scene, scene.objectCount, iterations,
+		[]() {},
+		[&]() {
+			uint64 found = 0;
+			for (uint32 i = 0; i < scene.objectCount; ++i)
+			{
+				found += (assetManager->GetStaticMesh(assets.meshNames[i % assets.meshNames.size()].c_str(), true) != nullptr);
+				found += (assetManager->GetGraphicsPipeline(assets.pipelineNames[i % assets.pipelineNames.size()].c_str(), true) != nullptr);
+				found += (assetManager->GetTexture(assets.textureNames[i % assets.textureNames.size()].c_str(), true) != nullptr);
+			}
+			benchmarkSink = found;
+		}));
+
+	//looking up each object's assets by the hash of their names, the same IDs "name"_asset gives
+	AssetManager hashedAssetManager;
+	hashedAssetManager.hashedAssetIDs = true;
+	BenchmarkAssets hashedAssets = assets;
+	Benchmark_RegisterAssets(&hashedAssetManager, &hashedAssets);
+	Benchmark_CreateStandInAssets(&hashedAssetManager, scene, hashedAssets);
+	std::vector<uint64> meshHashes, pipelineHashes, textureHashes;
+	for (size_t i = 0; i < hashedAssets.meshNames.size(); ++i)
+		meshHashes.emplace_back(AssetName_Hash(hashedAssets.meshNames[i].c_str()));
+	for (size_t i = 0; i < hashedAssets.pipelineNames.size(); ++i)
+		pipelineHashes.emplace_back(AssetName_Hash(hashedAssets.pipelineNames[i].c_str()));
+	for (size_t i = 0; i < hashedAssets.textureNames.size(); ++i)
+		textureHashes.emplace_back(AssetName_Hash(hashedAssets.textureNames[i].c_str()));
+	results.emplace_back(Benchmark_Run("AssetManager Lookup By Hashed ID", scene, scene.objectCount, iterations,
+		[]() {},
+		[&]() {
+			uint64 found = 0;
+			for (uint32 i = 0; i < scene.objectCount; ++i)
+			{
+				found += (hashedAssetManager.GetStaticMesh(meshHashes[i % meshHashes.size()], true) != nullptr);
+				found += (hashedAssetManager.GetGraphicsPipeline(pipelineHashes[i % pipelineHashes.size()], true) != nullptr);
+				found += (hashedAssetManager.GetTexture(textureHashes[i % textureHashes.size()], true) != nullptr);
+			}
+			benchmarkSink = found;
+		}));
+
+	//the mesh renderer without a device
+	SMWindow_Desktop_Swapchain swapchain = {};
+	swapchain.framesInFlight = 2;
+	MeshRenderer::GPUMeshRenderer renderer;
+	renderer.InitCPUOnly(&swapchain, assetManager.get());
+	renderer.RegisterView(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f),
+		glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	std::vector<BTD::Math::Transform> transforms(scene.objectCount);
+	std::vector<MeshRenderer::ObjectBatch_Object> objects;
+	results.emplace_back(Benchmark_Run("Mesh AddObject", scene, scene.objectCount, iterations,
+		[&]() { objects.clear(); assetManager->textureBuffer = Smok::Texture::TextureBuffer(); },
+		[&]() { Benchmark_AddObjects(&renderer, scene, assets, transforms, objects); }));
+
+	std::vector<MeshRenderer::RenderBatch> renderBatch;
+	std::vector<MeshRenderer::ObjectBuffer_Object> objectBufferObjects;
+	results.emplace_back(Benchmark_Run("Mesh CalculateCommandData", scene, scene.objectCount, iterations,
+		[]() {},
+		[&]() { renderer.CalculateCommandData(objects, renderBatch, objectBufferObjects); }));
+
+	//recording the draws into a trace, with nothing sent to a device
+	CommandTrace trace;
+	Dispatch dispatch;
+	dispatch.backend = DispatchBackend::Null; dispatch.trace = &trace;
+	Frame frame;
+	frame.isValid = true; frame.frameSize = { 1920, 1080 }; frame.dispatch = &dispatch;
+	VkCommandBuffer comBuffer = VK_NULL_HANDLE;
+	results.emplace_back(Benchmark_Run("Mesh Render Recording", scene, scene.objectCount, iterations,
+		[&]() { CommandTrace_Clear(&trace); },
+		[&]() { renderer.Render(comBuffer, frame, renderBatch, objectBufferObjects); }));
+
+	//replaying the recorded trace, re-recording it so the replay can be checked without a device
+	CommandTrace replayTrace;
+	Dispatch replayDispatch;
+	replayDispatch.backend = DispatchBackend::Null; replayDispatch.trace = &replayTrace;
+	results.emplace_back(Benchmark_Run("Command Trace Replay", scene, (uint32)trace.commandCount, iterations,
+		[&]() { CommandTrace_Clear(&replayTrace); },
+		[&]() { CommandTrace_Replay(trace, comBuffer, &replayDispatch, CommandTraceReplay()); }));
+	if (replayTrace.data != trace.data)
+		std::printf("%s: the replayed trace doesn't match the recorded one\n", scene.name.c_str());
+
+	//GUI quads, sorted by layer and split by texture
+	std::vector<GUIQuad> quads;
+	std::vector<GUIQuadBatch> batches;
+	results.emplace_back(Benchmark_Run("GUI Quad Batching", scene, scene.objectCount, iterations,
+		[&]() { Benchmark_MakeGUIQuads(scene, quads); },
+		[&]() { GUIQuad_CalculateBatches(quads, batches); }));
+}
+
+int main(int argc, char** argv)
+{
+	uint32 maxObjects = 1000000, iterations = 0;
+	std::string JSONPath = "";
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--max-objects" && i + 1 < argc)
+			maxObjects = (uint32)std::strtoul(argv[++i], nullptr, 10);
+		else if (arg == "--iterations" && i + 1 < argc)
+			iterations = (uint32)std::strtoul(argv[++i], nullptr, 10);
+		else if (arg == "--json" && i + 1 < argc)
+			JSONPath = argv[++i];
+	}
+
+	//low diversity batches well, high diversity is spread over many pipelines, meshes and textures
+	std::vector<BenchmarkScene> scenes;
+	for (uint32 objectCount = 1000; objectCount <= maxObjects && objectCount <= 1000000; objectCount *= 10)
+	{
+		BenchmarkScene low;
+		low.name = std::to_string(objectCount) + " objects, low diversity";
+		low.objectCount = objectCount;
+		low.pipelineCount = 2; low.meshCount = 8; low.textureCount = 4;
+		scenes.emplace_back(low);
+
+		BenchmarkScene high;
+		high.name = std::to_string(objectCount) + " objects, high diversity";
+		high.objectCount = objectCount;
+		high.pipelineCount = 32; high.meshCount = 1024; high.textureCount = 15; //the texture array holds 15
+		high.subMeshCount = 3; high.lodCount = 3;
+		scenes.emplace_back(high);
+	}
+
+	std::vector<BenchmarkResult> results;
+	for (size_t i = 0; i < scenes.size(); ++i)
+	{
+		//big scenes get fewer iterations, so the whole suite stays quick
+		const uint32 sceneIterations = (iterations > 0 ? iterations : (scenes[i].objectCount >= 100000 ? 3 : 10));
+		RunScene(scenes[i], sceneIterations, results);
+		std::printf("%s done\n", scenes[i].name.c_str());
+	}
+
+	if (JSONPath.empty())
+		std::printf("%s", Benchmark_ToJSON(results).c_str());
+	else if (!Benchmark_WriteJSON(results, JSONPath))
+		return 1;
+
+	return 0;
+}
@@ -5,15 +5,88 @@
 #include <BTDSTD/Maps/IDHash.hpp>
 
 #include <SmokMesh/Mesh.hpp>
-#include <SmokMesh/MegaMeshBuffer.hpp>
 
 #include <SmokTexture/Texture.hpp>
 #include <SmokTexture/TextureBuffer.hpp>
 
 #include <SmokGraphics/Pipeline/GraphicsPipeline.hpp>
 
+#include <SmokRenderers/Geometry/MeshBounds.hpp>
+#include <SmokRenderers/Geometry/FullMegaMeshBuffer.hpp>
+#include <SmokRenderers/Geometry/QuantizedMegaMeshBuffer.hpp>
+#include <SmokRenderers/Geometry/MeshOptimizer.hpp>
+#include <SmokRenderers/Geometry/MeshSimplifier.hpp>
+#include <SmokRenderers/Geometry/Meshlet.hpp>
+
+#include <SmokRenderers/Util/TextureAtlas.hpp>
+#include <SmokRenderers/Util/TextureStreaming.hpp>
+#include <SmokRenderers/Dispatch.hpp>
+#include <SmokRenderers/AssetName.hpp>
+
 namespace Smok::Renderers
 {
+	//defines what a static mesh keeps on the CPU once it's been pushed into the mega mesh buffer
+	enum class MeshResidencyMode
+	{
+		KeepCPUData = 0, //keeps the raw vertex/index data around
+		ReleaseCPUData, //frees the raw vertex/index data, keeping only the bounds, counts and offsets
+
+		Count
+	};
+
+	//defines the vertex format meshes are stored in, in the mega mesh buffer
+	enum class MeshVertexFormat
+	{
+		Full = 0, //full precision Smok::Mesh::Vertex
+		Quantized, //Geometry::QuantizedVertex, 16 bit positions, octahedral normals and half float UVs
+
+		Count
+	};
+
+	//defines the data kept for a single mesh in a static mesh, even after the raw data is released
+	struct StaticMesh_SubMesh
+	{
+		uint32 megaMeshBufferIndex = 0; //the index into the mega mesh buffer
+		uint32 vertexCount = 0, indexCount = 0; //the vertex and index counts
+		uint32 firstVertex = 0, firstIndex = 0; //the offsets into the mega mesh buffer's vertex and index data
+
+		Geometry::MeshBounds bounds; //the bounds in mesh space
+	};
+
+	//defines a mesh in the mega mesh buffer, indexed by it's mega mesh buffer index
+	struct MegaMeshBuffer_MeshEntry
+	{
+		StaticMesh_SubMesh subMesh; //the bounds, counts and offsets
+		std::vector<Geometry::Meshlet> meshlets; //the clusters for culling || empty if the mesh was too small to cluster
+	};
+
+	//defines the settings for building meshlets
+	struct MeshletSettings
+	{
+		bool buildMeshlets = false; //builds meshlets for large meshes when they're pushed into the mega mesh buffer
+		uint32 minTriangleCount = 4096; //meshes with fewer triangles are drawn whole
+		uint32 maxVertices = SMOK_RENDERER_MESHLET_MAX_VERTICES, maxTriangles = SMOK_RENDERER_MESHLET_MAX_TRIANGLES; //the meshlet limits
+	};
+
+	//defines a level of detail of a static mesh
+	struct StaticMesh_LOD
+	{
+		float screenSize = 0.0f; //the LOD is used once the mesh covers less then this fraction of the screen height || 0 for the full detail LOD
+		uint32 triangleCount = 0; //the triangles across all the meshes
+
+		std::vector<uint32> megaMeshBufferIndexes; //the indexs into the mega mesh buffer
+		std::vector<StaticMesh_SubMesh> subMeshes; //the bounds, counts and offsets of each mesh
+	};
+
+	//defines the settings for generating static mesh LODs
+	struct MeshLODSettings
+	{
+		uint32 lodCount = 1; //the number of LODs per static mesh including the full detail one || 1 disables LOD generation
+		float triangleRatio = 0.5f; //each LOD keeps about this ratio of the previous LOD's triangles
+		float screenSizeStart = 0.5f; //LOD 1 is used once the mesh covers less then this fraction of the screen height
+		float screenSizeFalloff = 0.5f; //each LOD after is used at this ratio of the previous LOD's screen size
+	};
+
 	//defines a mesh
 	struct StaticMesh
 	{
@@ -21,8 +94,48 @@ namespace Smok::Renderers
 
 		std::string declPath = ""; //the decl path
 
-		std::vector<Smok::Mesh::Mesh> meshes; //the raw mesh data
+		bool isLoaded = false; //has the mesh been loaded and pushed into the mega mesh buffer
+		MeshResidencyMode residencyMode = MeshResidencyMode::KeepCPUData; //what CPU data was kept after upload
+		size_t releasedCPUBytes = 0; //the bytes of raw mesh data that were freed after upload
+
+		std::vector<Smok::Mesh::Mesh> meshes; //the raw mesh data || empty once released
 		std::vector<uint32> megaMeshBufferIndexes; //the indexs into the mega mesh buffer
+		std::vector<StaticMesh_SubMesh> subMeshes; //the bounds, counts and offsets of each mesh
+		Geometry::MeshBounds bounds; //the bounds of all the meshes
+
+		std::vector<StaticMesh_LOD> lods; //the LODs, 0 is the full detail meshes above
+	};
+
+	//gets the bytes of raw CPU data held by a mesh
+	inline size_t Mesh_GetCPUByteSize(const Smok::Mesh::Mesh& mesh)
+	{
+		return mesh.vertices.capacity() * sizeof(Smok::Mesh::Vertex) + mesh.indices.capacity() * sizeof(uint32);
+	}
+
+	//defines a report of how much memory static meshes use on the CPU
+	struct MeshMemoryReport
+	{
+		uint32 staticMeshCount = 0, //the number of registered static meshes
+			loadedStaticMeshCount = 0, //the number of loaded static meshes
+			releasedStaticMeshCount = 0, //the number of loaded static meshes that released their CPU data
+			subMeshCount = 0; //the number of meshes across all loaded static meshes
+
+		size_t residentCPUBytes = 0; //the bytes of raw vertex/index data still held
+		size_t releasedCPUBytes = 0; //the bytes of raw vertex/index data freed after upload
+		size_t metadataBytes = 0; //the bytes used by the bounds, counts and offsets
+
+		//converts the report into a human readable string
+		inline std::string ToString() const
+		{
+			const size_t totalBytes = residentCPUBytes + releasedCPUBytes;
+			const double savedPercent = (totalBytes > 0 ? (double)releasedCPUBytes / (double)totalBytes * 100.0 : 0.0);
+
+			return "Static Meshes: " + std::to_string(loadedStaticMeshCount) + "/" + std::to_string(staticMeshCount) + " loaded, " +
+				std::to_string(releasedStaticMeshCount) + " released, " + std::to_string(subMeshCount) + " meshes\n" +
+				"Resident CPU mesh data: " + std::to_string(residentCPUBytes) + " bytes\n" +
+				"Released CPU mesh data: " + std::to_string(releasedCPUBytes) + " bytes (" + std::to_string(savedPercent) + "% saved)\n" +
+				"Kept metadata: " + std::to_string(metadataBytes) + " bytes";
+		}
 	};
 
 	//manages assets
@@ -33,16 +146,46 @@ namespace Smok::Renderers
 
 		//texture descriptor stuff
 		Smok::Texture::TextureBuffer textureBuffer;
-		Smok::Mesh::Util::MegaMeshBuffer megaMeshBuffer; //the buffer of vertices
+		Geometry::FullMegaMeshBuffer megaMeshBuffer; //the buffer of vertices
+		Geometry::QuantizedMegaMeshBuffer quantizedMegaMeshBuffer; //the buffer of quantized vertices
+
+		MeshVertexFormat vertexFormat = MeshVertexFormat::Full; //the vertex format meshes are stored in || set before any meshes or pipelines are made
+		MeshResidencyMode meshResidencyMode = MeshResidencyMode::KeepCPUData; //what static meshes keep on the CPU after upload
+		MeshletSettings meshletSettings; //how meshlets are built || set before any meshes are made
+		std::vector<MegaMeshBuffer_MeshEntry> megaMeshBufferMeshes; //every mesh in the mega mesh buffer, indexed by mega mesh buffer index
+
+		MeshLODSettings meshLODSettings; //how static mesh LODs are generated || set before any meshes are made
+
+		bool optimizeMeshesOnIngest = false; //runs the mesh optimizer on meshes before they're pushed into the mega mesh buffer
+		Geometry::MeshOptimizerSettings meshOptimizerSettings; //the optimizations to run on ingestion
+		Geometry::MeshOptimizerReport meshOptimizerReport; //the vertex cache stats of every mesh optimized on ingestion
+
+		uint32 megaMeshBufferVertexCount = 0, megaMeshBufferIndexCount = 0; //the vertices and indices pushed into the mega mesh buffer so far
+		uint32 megaMeshBufferRebuildCount = 0; //the times the GPU side of the mega mesh buffer was made
+		bool megaMeshBufferDirty = false; //meshes were pushed since the GPU side of the mega mesh buffer was last made
 
 		BTD::IDStringHash IDRegistery; //the ID name registery
 
+		bool hashedAssetIDs = false; //IDs are the hash of the asset's name, so "name"_asset can be used as the ID || set before any assets are registered
+		std::unordered_map<uint64, std::string> hashedAssetNames; //the name of each hashed ID, to catch collisions
+
 		std::unordered_map<uint64, Smok::Graphics::Pipeline::GraphicsShader> GShaderAssets; //the loaded shaders
 		std::unordered_map<uint64, Smok::Graphics::Pipeline::GraphicsPipeline> GPipelineAssets; //the loaded graphics pipelines
 		std::unordered_map<uint64, Smok::Texture::Texture> textureAssets; //the loaded textures
 		std::unordered_map<uint64, Smok::Graphics::Util::Image::Sampler2D> samplerAssets; //the loaded samplers
 		std::unordered_map<uint64, StaticMesh> staticMeshAssets; //the loaded meshes
 
+		Util::TextureAtlas textureAtlas; //small textures packed into shared pages, keyed by texture ID || set it's settings before packing
+
+		Util::StagingRing stagingRing; //optional, made by InitStagingRing || the mega mesh buffers, textures and texture atlas pages are uploaded through it
+
+		Dispatch* dispatch = nullptr; //where the texture and mega mesh uploads go, set with SetDispatch || null goes straight to Vulkan
+
+		uint32 decompressedTextureCount = 0; //KTX2 textures whose block format the device can't sample, so they were decoded to RGBA8
+
+		bool textureStreaming = false; //KTX2 textures only start with their coarse mips and stream in finer ones, turned on by InitTextureStreaming
+		Util::TextureStreamer textureStreamer; //owns the streamed textures' images
+
 		//inits the asset manager
 		inline void Init(VmaAllocator _allocator,
 			SMGraphics_Core_GPU* _GPU)
@@ -60,8 +203,13 @@ namespace Smok::Renderers
 			//wait for the GPU to finish
 			vkDeviceWaitIdle(GPU->device);
 
-			Mesh::Util::MegaMeshBuffer_DestroyBuffer(&megaMeshBuffer, allocator);
-			
+			Geometry::FullMegaMeshBuffer_DestroyBuffer(&megaMeshBuffer, allocator);
+			megaMeshBuffer = Geometry::FullMegaMeshBuffer();
+			Geometry::QuantizedMegaMeshBuffer_DestroyBuffer(&quantizedMegaMeshBuffer, allocator);
+			quantizedMegaMeshBuffer = Geometry::QuantizedMegaMeshBuffer();
+			megaMeshBufferVertexCount = 0; megaMeshBufferIndexCount = 0;
+			megaMeshBufferMeshes.clear();
+			megaMeshBufferDirty = false;
 
 			//destroys the assets
 			staticMeshAssets.clear();
@@ -80,17 +228,60 @@ namespace Smok::Renderers
 
 			for (auto& texture : textureAssets)
 			{
+				if (textureStreamer.textures.find(texture.first) != textureStreamer.textures.end())
+					continue;
+
 				vkDestroyImageView(GPU->device, texture.second.view, NULL);
 				vmaDestroyImage(allocator, texture.second.image, texture.second.imageMemoy);
 			}
 			textureAssets.clear();
+			Util::TextureStreaming_Destroy(&textureStreamer, GPU->device, allocator);
+
+			Util::TextureAtlas_Destroy(&textureAtlas, GPU->device, allocator);
+			Util::StagingRing_Destroy(&stagingRing);
 
 			IDRegistery.Clear();
+			hashedAssetNames.clear();
+		}
+
+		//generates the ID of a asset being registered || fails if the name's hash collides with a different name
+		inline bool GenerateAssetID(const char* name, uint64& ID, const char* funcName)
+		{
+			if (!hashedAssetIDs)
+			{
+				IDRegistery.GenerateNewID(name, ID);
+				return true;
+			}
+
+			ID = AssetName_Hash(name);
+			auto hashedName = hashedAssetNames.find(ID);
+			if (hashedName != hashedAssetNames.end() && hashedName->second != name)
+			{
+				BTD_LogError("Smok Renderer", "Asset Manager", funcName,
+					std::string("\"" + std::string(name) + "\" has the same hash as \"" + hashedName->second + "\", rename one of them!").c_str());
+				ID = 0;
+				return false;
+			}
+
+			hashedAssetNames[ID] = name;
+			return true;
 		}
 
 		//gets the asset's ID by name
 		inline uint64 GetIDByName(const char* name, bool silenceErrors = false)
 		{
+			if (hashedAssetIDs)
+			{
+				const uint64 ID = AssetName_Hash(name);
+				if (hashedAssetNames.find(ID) != hashedAssetNames.end())
+					return ID;
+
+				if (!silenceErrors)
+					BTD_LogError("Smok Renderer", "Asset Manager", "GetIDByName",
+						std::string("\"" + std::string(name) + "\" is not a valid name for a registered asset!").c_str());
+				return 0;
+			}
+
 			if (!IDRegistery.IsID(name))
 			{
 				if(!silenceErrors)
@@ -102,17 +293,21 @@ namespace Smok::Renderers
 		}
 
 		//gets the asset's name by ID
-		inline std::string GetNameByID(const uint64& ID) { return IDRegistery.GetStr(ID); }
+		inline std::string GetNameByID(const uint64& ID)
+		{
+			if (!hashedAssetIDs)
+				return IDRegistery.GetStr(ID);
+
+			auto hashedName = hashedAssetNames.find(ID);
+			return (hashedName != hashedAssetNames.end() ? hashedName->second : "");
+		}
 
 		//gets a graphics shader
 		inline Smok::Graphics::Pipeline::GraphicsShader* GetGraphicsShader(const uint64& ID, bool silenceErrors = false)
 		{
-			//checks if it matches the shaders
-			for (auto& asset : GShaderAssets)
-			{
-				if (asset.first == ID)
-					return &asset.second;
-			}
+			auto asset = GShaderAssets.find(ID);
+			if (asset != GShaderAssets.end())
+				return &asset->second;
 
 			if(!silenceErrors)
 				BTD_LogError("Smok Renderer", "Asset Manager", "GetGraphicsShader",
@@ -135,11 +330,9 @@ namespace Smok::Renderers
 		//gets a graphics pipeline
 		inline Smok::Graphics::Pipeline::GraphicsPipeline* GetGraphicsPipeline(const uint64& ID, bool silenceErrors = false)
 		{
-			for (auto& asset : GPipelineAssets)
-			{
-				if (asset.first == ID)
-					return &asset.second;
-			}
+			auto asset = GPipelineAssets.find(ID);
+			if (asset != GPipelineAssets.end())
+				return &asset->second;
 
 			if (!silenceErrors)
 				BTD_LogError("Smok Renderer", "Asset Manager", "GetGraphicsPipeline", "ID is not a valid for a Graphics Pipeline!");
@@ -155,11 +348,9 @@ namespace Smok::Renderers
 		//gets a texture 2D
 		inline Smok::Texture::Texture* GetTexture(const uint64& ID, bool silenceErrors = false)
 		{
-			for (auto& asset : textureAssets)
-			{
-				if (asset.first == ID)
-					return &asset.second;
-			}
+			auto asset = textureAssets.find(ID);
+			if (asset != textureAssets.end())
+				return &asset->second;
 
 			if (!silenceErrors)
 				BTD_LogError("Smok Renderer", "Asset Manager", "GetTexture", "ID is not a valid for a Texture!");
@@ -169,20 +360,9 @@ namespace Smok::Renderers
 		//gets a texture 2D
 		inline Smok::Texture::Texture* GetTexture(const char* name, bool silenceErrors = false)
 		{
-			if (!IDRegistery.IsID(name))
-			{
-				if (!silenceErrors)
-					BTD_LogError("Smok Renderer", "Asset Manager", "GetTexture",
-						std::string("\"" + std::string(name) + "\" is not a valid name for a Texture!").c_str());
-				return nullptr;
-			}
-			uint64 ID = IDRegistery.GetID(name);
-
-			for (auto& asset : textureAssets)
-			{
-				if (asset.first == ID)
-					return &asset.second;
-			}
+			auto asset = textureAssets.find(GetIDByName(name, true));
+			if (asset != textureAssets.end())
+				return &asset->second;
 
 			if (!silenceErrors)
 				BTD_LogError("Smok Renderer", "Asset Manager", "GetTexture",
@@ -193,20 +373,9 @@ namespace Smok::Renderers
 		//gets a sampler 2D
 		inline Smok::Graphics::Util::Image::Sampler2D* GetSampler2D(const char* name, bool silenceErrors = false)
 		{
-			if (!IDRegistery.IsID(name))
-			{
-				if (!silenceErrors)
-					BTD_LogError("Smok Renderer", "Asset Manager", "GetSampler2D",
-						std::string("\"" + std::string(name) + "\" is not a valid name for a Sampler2D!").c_str());
-				return nullptr;
-			}
-			uint64 ID = IDRegistery.GetID(name);
-
-			for (auto& asset : samplerAssets)
-			{
-				if (asset.first == ID)
-					return &asset.second;
-			}
+			auto asset = samplerAssets.find(GetIDByName(name, true));
+			if (asset != samplerAssets.end())
+				return &asset->second;
 
 			if (!silenceErrors)
 				BTD_LogError("Smok Renderer", "Asset Manager", "GetSampler2D",
@@ -217,12 +386,9 @@ namespace Smok::Renderers
 		//gets a static mesh
 		inline StaticMesh* GetStaticMesh(const uint64& ID, bool silenceErrors = false)
 		{
-			//checks if it matches the assets
-			for (auto& asset : staticMeshAssets)
-			{
-				if (asset.first == ID)
-					return &asset.second;
-			}
+			auto asset = staticMeshAssets.find(ID);
+			if (asset != staticMeshAssets.end())
+				return &asset->second;
 
 			if (!silenceErrors)
 				BTD_LogError("Smok Renderer", "Asset Manager", "GetStaticMesh",
@@ -253,7 +419,8 @@ namespace Smok::Renderers
 
 			//creates the shader
 			uint64 ID = 0;
-			IDRegistery.GenerateNewID(name, ID);
+			if (!GenerateAssetID(name, ID, "RegisterGraphicsShader"))
+				return nullptr;
 
 			GShaderAssets[ID] = Smok::Graphics::Pipeline::GraphicsShader();
 			asset = &GShaderAssets[ID];
@@ -274,7 +441,8 @@ namespace Smok::Renderers
 
 			//creates the asset
 			uint64 ID = 0;
-			IDRegistery.GenerateNewID(name, ID);
+			if (!GenerateAssetID(name, ID, "RegisterGraphicsPipeline"))
+				return nullptr;
 
 			GPipelineAssets[ID] = Smok::Graphics::Pipeline::GraphicsPipeline();
 			asset = &GPipelineAssets[ID];
@@ -298,7 +466,8 @@ namespace Smok::Renderers
 
 			//creates the asset
 			uint64 ID = 0;
-			IDRegistery.GenerateNewID(name, ID);
+			if (!GenerateAssetID(name, ID, "RegisterTexture"))
+				return nullptr;
 
 			textureAssets[ID] = Smok::Texture::Texture();
 			asset = &textureAssets[ID];
@@ -319,7 +488,8 @@ namespace Smok::Renderers
 
 			//creates the asset
 			uint64 ID = 0;
-			IDRegistery.GenerateNewID(name, ID);
+			if (!GenerateAssetID(name, ID, "RegisterSampler2D"))
+				return nullptr;
 
 			samplerAssets[ID] = Smok::Graphics::Util::Image::Sampler2D();
 			asset = &samplerAssets[ID];
@@ -340,7 +510,8 @@ namespace Smok::Renderers
 
 			//creates the asset
 			uint64 ID = 0;
-			IDRegistery.GenerateNewID(name, ID);
+			if (!GenerateAssetID(name, ID, "RegisterStaticMesh"))
+				return nullptr;
 
 			staticMeshAssets[ID] = StaticMesh();
 			asset = &staticMeshAssets[ID];
@@ -379,9 +550,14 @@ namespace Smok::Renderers
 			if (asset->pipeline != VK_NULL_HANDLE)
 				return asset;
 
-			Graphics::Pipeline::GraphicsPipeline_Create(asset, GPU->device,
-				pipelineLayout, CreateGraphicsShader(asset->graphicsShaderAssetID), renderpass,
-				Smok::Mesh::Vertex::VertexLayout().GenBindDesc(), Smok::Mesh::Vertex::VertexLayout().GenAttDesc());
+			if (vertexFormat == MeshVertexFormat::Quantized)
+				Graphics::Pipeline::GraphicsPipeline_Create(asset, GPU->device,
+					pipelineLayout, CreateGraphicsShader(asset->graphicsShaderAssetID), renderpass,
+					Geometry::QuantizedVertex::VertexLayout().GenBindDesc(), Geometry::QuantizedVertex::VertexLayout().GenAttDesc());
+			else
+				Graphics::Pipeline::GraphicsPipeline_Create(asset, GPU->device,
+					pipelineLayout, CreateGraphicsShader(asset->graphicsShaderAssetID), renderpass,
+					Smok::Mesh::Vertex::VertexLayout().GenBindDesc(), Smok::Mesh::Vertex::VertexLayout().GenAttDesc());
 
 			return asset;
 		}
@@ -393,6 +569,83 @@ namespace Smok::Renderers
 			return CreateGraphicsPipeline(GetIDByName(name), pipelineLayout, renderpass);
 		}
 
+		//creates a texture from a KTX2 file made by the texture cook step || falls back to RGBA8 if the device can't sample it's format
+		//with the staging ring made, it's uploaded once the ring is flushed
+		inline bool CreateKTX2Texture(Smok::Texture::Texture* asset, const std::string& KTX2Path, SMGraphics_Pool_CommandPool* commandPool)
+		{
+			//with streaming, only the coarse mips are loaded and the streamer owns the image
+			if (textureStreaming)
+			{
+				const Util::StreamedTexture* streamed = Util::TextureStreaming_Register(&textureStreamer, asset->assetID, KTX2Path,
+					GPU, allocator, &stagingRing, commandPool);
+				if (!streamed)
+					return false;
+
+				if (streamed->decompress)
+					decompressedTextureCount++;
+				asset->image = streamed->image.image; asset->view = streamed->image.view; asset->imageMemoy = streamed->image.allocation;
+				return true;
+			}
+
+			Util::KTX2Texture texture;
+			if (!Util::KTX2_LoadFile(&texture, KTX2Path))
+				return false;
+
+			if (Util::KTX2Texture_MakeSampleable(&texture, GPU->physicalDevice))
+				decompressedTextureCount++;
+
+			const bool staged = Util::StagingRing_IsValid(&stagingRing);
+			Util::GPUImage image;
+			if (!Util::GPUImage_Create(&image, GPU->device, allocator, texture.format, texture.width, texture.height,
+				(staged ? nullptr : texture.data.data()), texture.data.size(), texture.levelOffsets))
+				return false;
+
+			const bool uploaded = (staged ? Util::StagingRing_UploadImage(&stagingRing, &image, texture.data.data(), texture.data.size()) :
+				Util::GPUImage_UploadNow(&image, GPU, allocator, commandPool, dispatch));
+			if (!uploaded)
+			{
+				Util::GPUImage_Destroy(&image, GPU->device, allocator);
+				return false;
+			}
+
+			asset->image = image.image; asset->view = image.view; asset->imageMemoy = image.allocation;
+			return true;
+		}
+
+		//creates a texture from a image file stb_image can read, as sRGB RGBA8 without mips
+		//with the staging ring made, it's uploaded once the ring is flushed
+		inline bool CreateImageTexture(Smok::Texture::Texture* asset, const std::string& imagePath, SMGraphics_Pool_CommandPool* commandPool)
+		{
+			int32 width = 0, height = 0, channels = 0;
+			stbi_uc* pixels = stbi_load(imagePath.c_str(), &width, &height, &channels, 4);
+			if (!pixels)
+			{
+				BTD_LogError("Smok Renderer", "Asset Manager", "CreateImageTexture",
+					std::string("Failed to load a image at \"" + imagePath + "\", " + stbi_failure_reason()).c_str());
+				return false;
+			}
+
+			const size_t byteSize = (size_t)width * (size_t)height * 4;
+			const bool staged = Util::StagingRing_IsValid(&stagingRing);
+			Util::GPUImage image;
+			bool uploaded = Util::GPUImage_Create(&image, GPU->device, allocator, VK_FORMAT_R8G8B8A8_SRGB, (uint32)width, (uint32)height,
+				(staged ? nullptr : pixels), byteSize);
+			if (uploaded)
+			{
+				uploaded = (staged ? Util::StagingRing_UploadImage(&stagingRing, &image, pixels, byteSize) :
+					Util::GPUImage_UploadNow(&image, GPU, allocator, commandPool, dispatch));
+				if (!uploaded)
+					Util::GPUImage_Destroy(&image, GPU->device, allocator);
+			}
+			stbi_image_free(pixels);
+
+			if (!uploaded)
+				return false;
+
+			asset->image = image.image; asset->view = image.view; asset->imageMemoy = image.allocation;
+			return true;
+		}
+
 		//creates a texture
 		inline Smok::Texture::Texture* CreateTexture(const uint64& ID, SMGraphics_Pool_CommandPool* commandPool)
 		{
@@ -409,7 +662,9 @@ namespace Smok::Renderers
 				return asset;
 			}
 
-			if (!Smok::Texture::Texture_Create(asset, binaryPath, allocator, GPU, commandPool))
+			//cooked KTX2 textures bring their own mips and block compression
+			const bool isKTX2 = (binaryPath.size() >= 5 && binaryPath.compare(binaryPath.size() - 5, 5, ".ktx2") == 0);
+			if (isKTX2 ? !CreateKTX2Texture(asset, binaryPath, commandPool) : !CreateImageTexture(asset, binaryPath, commandPool))
 			{
 				BTD_LogError("Smok Renderer", "Asset Manager",
 					"CreateTexture2D",
@@ -445,27 +700,153 @@ namespace Smok::Renderers
 			return CreateSampler2D(GetIDByName(name));
 		}
 
+		//packs a registered texture into the texture atlas instead of giving it it's own image
+		//returns nullptr if it can't be packed, like when it's too big, then it should be made with CreateTexture
+		inline const Util::TextureAtlasEntry* PackTextureIntoAtlas(const uint64& ID)
+		{
+			if (const Util::TextureAtlasEntry* entry = Util::TextureAtlas_GetEntry(&textureAtlas, ID))
+				return entry;
+
+			Smok::Texture::Texture* asset = GetTexture(ID);
+			if (!asset)
+				return nullptr;
+
+			std::string assetName = "", binaryPath = "";
+			if (!Smok::Texture::Texture_LoadDecl(asset->declPath, assetName, binaryPath))
+			{
+				BTD_LogError("Smok Renderer", "Asset Manager",
+					"PackTextureIntoAtlas",
+					std::string("Failed to load a texture decl file at \"" + asset->declPath + "\"").c_str());
+				return nullptr;
+			}
+
+			return Util::TextureAtlas_AddImageFile(&textureAtlas, ID, binaryPath);
+		}
+
+		//packs a registered texture into the texture atlas
+		inline const Util::TextureAtlasEntry* PackTextureIntoAtlas(const char* name)
+		{
+			return PackTextureIntoAtlas(GetIDByName(name));
+		}
+
+		//gets where a texture is in the texture atlas || returns nullptr if it wasn't packed
+		inline const Util::TextureAtlasEntry* GetTextureAtlasEntry(const uint64& ID)
+		{
+			return Util::TextureAtlas_GetEntry(&textureAtlas, ID);
+		}
+
+		//uploads the texture atlas pages that changed since the last call, call after packing || with the staging ring made, they're done once it's flushed
+		inline bool CreateTextureAtlasPages(SMGraphics_Pool_CommandPool* commandPool)
+		{
+			return Util::TextureAtlas_CreatePages(&textureAtlas, GPU, allocator, commandPool, &stagingRing);
+		}
+
+		//pushes a mesh into the mega mesh buffer for the current vertex format, filling out it's bounds, counts and offsets
+		inline void PushMeshIntoMegaMeshBuffer(const Smok::Mesh::Mesh& mesh, StaticMesh_SubMesh& subMesh)
+		{
+			if (vertexFormat == MeshVertexFormat::Quantized)
+			{
+				Geometry::QuantizedMegaMeshBuffer_AddMesh(&quantizedMegaMeshBuffer, mesh, subMesh.megaMeshBufferIndex);
+
+				const Geometry::QuantizedMegaMeshBuffer_Mesh& entry = quantizedMegaMeshBuffer.meshes[subMesh.megaMeshBufferIndex];
+				subMesh.firstVertex = entry.firstVertex;
+				subMesh.firstIndex = entry.firstIndex;
+			}
+			else
+			{
+				Geometry::FullMegaMeshBuffer_AddMesh(&megaMeshBuffer, mesh, subMesh.megaMeshBufferIndex);
+
+				const Geometry::FullMegaMeshBuffer_Mesh& entry = megaMeshBuffer.meshes[subMesh.megaMeshBufferIndex];
+				subMesh.firstVertex = entry.firstVertex;
+				subMesh.firstIndex = entry.firstIndex;
+			}
+
+			subMesh.vertexCount = (uint32)mesh.vertices.size();
+			subMesh.indexCount = (uint32)mesh.indices.size();
+			subMesh.bounds = Geometry::MeshBounds_Calculate(mesh);
+
+			megaMeshBufferVertexCount += subMesh.vertexCount;
+			megaMeshBufferIndexCount += subMesh.indexCount;
+			megaMeshBufferDirty = true;
+
+			//stores the entry, so the renderers can get the offsets and meshlets from just the mega mesh buffer index
+			if (megaMeshBufferMeshes.size() <= subMesh.megaMeshBufferIndex)
+				megaMeshBufferMeshes.resize(subMesh.megaMeshBufferIndex + 1);
+			MegaMeshBuffer_MeshEntry* entry = &megaMeshBufferMeshes[subMesh.megaMeshBufferIndex];
+			entry->subMesh = subMesh;
+
+			//large meshes get split into meshlets, so they can be culled in pieces
+			if (meshletSettings.buildMeshlets && subMesh.indexCount / 3 >= meshletSettings.minTriangleCount)
+				entry->meshlets = Geometry::Meshlet_Build(mesh.vertices, mesh.indices, meshletSettings.maxVertices, meshletSettings.maxTriangles);
+		}
+
 		//creates a static mesh
 		inline StaticMesh* CreateStaticMesh(const uint64& staticMeshID)
 		{
 			StaticMesh* asset = GetStaticMesh(staticMeshID, true);
+			if (!asset)
+				return nullptr;
 
 			//if the mesh asset is already loaded
-			if (asset->meshes.size() > 0)
+			if (asset->isLoaded)
 				return asset;
 
 			//loads mesh
 			Smok::Mesh::MeshDeclData declData;
 			Smok::Mesh::Mesh_LoadMeshDataFromFile(asset->declPath, declData);
 
-			//pushes the meshes into the mega mesh buffer
 			const size_t meshCount = declData.meshCount;
+			asset->meshes = std::move(declData.meshes);
+
+			//optimizes the meshes before they're uploaded
+			if (optimizeMeshesOnIngest)
+			{
+				for (uint32 i = 0; i < meshCount; ++i)
+					meshOptimizerReport.Merge(Geometry::MeshOptimizer_OptimizeMesh(asset->meshes[i], meshOptimizerSettings));
+			}
+
+			//pushes the meshes into the mega mesh buffer
 			asset->megaMeshBufferIndexes.resize(meshCount);
-			asset->meshes = declData.meshes;
+			asset->subMeshes.resize(meshCount);
+			for (uint32 i = 0; i < meshCount; ++i)
+			{
+				PushMeshIntoMegaMeshBuffer(asset->meshes[i], asset->subMeshes[i]);
+				asset->megaMeshBufferIndexes[i] = asset->subMeshes[i].megaMeshBufferIndex;
+				asset->bounds = (i == 0 ? asset->subMeshes[i].bounds : Geometry::MeshBounds_Merge(asset->bounds, asset->subMeshes[i].bounds));
+			}
 
+			//the full detail LOD
+			asset->lods.resize(1);
+			asset->lods[0].megaMeshBufferIndexes = asset->megaMeshBufferIndexes;
+			asset->lods[0].subMeshes = asset->subMeshes;
 			for (uint32 i = 0; i < meshCount; ++i)
-				Mesh::Util::MegaMeshBuffer_AddMesh(&megaMeshBuffer, asset->meshes[i],
-					asset->megaMeshBufferIndexes[i]);
+				asset->lods[0].triangleCount += asset->subMeshes[i].indexCount / 3;
+
+			//generates the simplified LODs, each one is pushed after the last so a mesh's LODs sit together in the mega mesh buffer
+			std::vector<Smok::Mesh::Mesh> lodSources;
+			if (meshLODSettings.lodCount > 1)
+				lodSources = asset->meshes;
+			for (uint32 l = 1; l < meshLODSettings.lodCount; ++l)
+			{
+				StaticMesh_LOD* lod = &asset->lods.emplace_back(StaticMesh_LOD());
+				lod->screenSize = meshLODSettings.screenSizeStart * std::pow(meshLODSettings.screenSizeFalloff, (float)(l - 1));
+				lod->megaMeshBufferIndexes.resize(meshCount);
+				lod->subMeshes.resize(meshCount);
+
+				for (uint32 i = 0; i < meshCount; ++i)
+				{
+					lodSources[i] = Geometry::MeshSimplifier_Simplify(lodSources[i], meshLODSettings.triangleRatio);
+					PushMeshIntoMegaMeshBuffer(lodSources[i], lod->subMeshes[i]);
+					lod->megaMeshBufferIndexes[i] = lod->subMeshes[i].megaMeshBufferIndex;
+					lod->triangleCount += lod->subMeshes[i].indexCount / 3;
+				}
+			}
+
+			asset->isLoaded = true;
+
+			//the mega mesh buffer has it's own copy now, so we can drop ours
+			if (meshResidencyMode == MeshResidencyMode::ReleaseCPUData)
+				ReleaseStaticMeshCPUData(asset);
 
 			return asset;
 		}
@@ -476,6 +857,215 @@ namespace Smok::Renderers
 			return CreateStaticMesh(GetIDByName(staticMeshName));
 		}
 
+		//releases the raw CPU data of a loaded static mesh, keeping only the bounds, counts and offsets
+		inline void ReleaseStaticMeshCPUData(StaticMesh* asset)
+		{
+			if (!asset || !asset->isLoaded || asset->residencyMode == MeshResidencyMode::ReleaseCPUData)
+				return;
+
+			for (size_t i = 0; i < asset->meshes.size(); ++i)
+				asset->releasedCPUBytes += Mesh_GetCPUByteSize(asset->meshes[i]);
+
+			std::vector<Smok::Mesh::Mesh>().swap(asset->meshes);
+			asset->residencyMode = MeshResidencyMode::ReleaseCPUData;
+		}
+
+		//releases the raw CPU data of a loaded static mesh, keeping only the bounds, counts and offsets
+		inline void ReleaseStaticMeshCPUData(const uint64& staticMeshID)
+		{
+			ReleaseStaticMeshCPUData(GetStaticMesh(staticMeshID));
+		}
+
+		//generates a report of the size and precision of the quantized vertex format for all loaded meshes
+		//meshes that released their CPU data can't be measured, they're counted in the report's releasedMeshCount instead
+		inline Geometry::QuantizationReport GenerateVertexFormatReport()
+		{
+			Geometry::QuantizationReport report;
+			for (auto& asset : staticMeshAssets)
+			{
+				if (asset.second.residencyMode == MeshResidencyMode::ReleaseCPUData)
+				{
+					report.releasedMeshCount += (uint32)asset.second.megaMeshBufferIndexes.size();
+					continue;
+				}
+
+				for (size_t i = 0; i < asset.second.meshes.size(); ++i)
+					report.Merge(Geometry::QuantizedVertex_GenerateReport(asset.second.meshes[i]));
+			}
+
+			if (report.releasedMeshCount > 0)
+				BTD_LogError("Smok Renderer", "Asset Manager", "GenerateVertexFormatReport",
+					std::string("Can't report " + std::to_string(report.releasedMeshCount) +
+						" meshes, their CPU data was released! Load them with MeshResidencyMode::KeepCPUData to report them.").c_str());
+
+			return report;
+		}
+
+		//makes the staging ring uploads go through || give it to the RenderManager so it's flushed every frame
+		inline bool InitStagingRing(SMGraphics_Pool_CommandPool* commandPool, const uint32 framesInFlight,
+			const size_t size = SMOK_RENDERER_STAGING_RING_DEFAULT_SIZE)
+		{
+			stagingRing.dispatch = dispatch;
+			return Util::StagingRing_Create(&stagingRing, GPU, allocator, commandPool, framesInFlight, size);
+		}
+
+		//sends the texture and mega mesh uploads, and the staging ring's copies, through a dispatch
+		//give it the RenderManager's so a trace has the uploads the frames depend on
+		inline void SetDispatch(Dispatch* _dispatch)
+		{
+			dispatch = _dispatch;
+			stagingRing.dispatch = _dispatch;
+		}
+
+		//moves the staging ring's copies onto a dedicated transfer queue, so large uploads run alongside rendering
+		//find the family with Util::StagingRing_FindTransferQueueFamily and make the device with a queue from it || the graphics family keeps them on graphics
+		inline bool UseTransferQueue(VkQueue transferQueue, const uint32 transferQueueFamily, const uint32 graphicsQueueFamily)
+		{
+			if (!Util::StagingRing_IsValid(&stagingRing))
+			{
+				BTD_LogError("Smok Renderer", "Asset Manager", "UseTransferQueue", "Call InitStagingRing before picking it's queue!");
+				return false;
+			}
+
+			Util::StagingRing_FlushAndWait(&stagingRing);
+			return Util::StagingRing_UseTransferQueue(&stagingRing, transferQueue, transferQueueFamily, graphicsQueueFamily);
+		}
+
+		//turns on mip streaming for the KTX2 textures created after || call UpdateTextureStreaming every frame
+		inline void InitTextureStreaming(const uint32 framesInFlight, const Util::TextureStreamingSettings& settings = Util::TextureStreamingSettings())
+		{
+			textureStreaming = true;
+			textureStreamer.settings = settings;
+			textureStreamer.framesInFlight = framesInFlight;
+		}
+
+		//asks for a streamed texture to have the mips a object covering this many pixels on screen needs
+		inline void RequestTextureMips(const uint64& ID, const float screenPixels)
+		{
+			if (textureStreaming)
+				Util::TextureStreaming_Request(&textureStreamer, ID, screenPixels);
+		}
+
+		//streams the mips this frame's objects asked for in, and the ones nothing needs out, call once a frame after adding objects and before rendering
+		//swapped images take their new view in the texture array, so it's rewritten when it's next drawn
+		inline void UpdateTextureStreaming(SMGraphics_Pool_CommandPool* commandPool)
+		{
+			if (!textureStreaming)
+				return;
+
+			std::vector<Util::TextureStreaming_Swap> swaps;
+			Util::TextureStreaming_Update(&textureStreamer, GPU, allocator, &stagingRing, commandPool, swaps);
+			for (size_t i = 0; i < swaps.size(); ++i)
+			{
+				auto asset = textureAssets.find(swaps[i].ID);
+				if (asset != textureAssets.end())
+				{
+					asset->second.image = swaps[i].texture->image.image; asset->second.view = swaps[i].texture->image.view;
+					asset->second.imageMemoy = swaps[i].texture->image.allocation;
+				}
+
+				for (size_t v = 0; v < textureBuffer.textureViews.size(); ++v)
+				{
+					if (textureBuffer.textureViews[v] != swaps[i].oldView)
+						continue;
+
+					textureBuffer.textureViews[v] = swaps[i].texture->image.view;
+					textureBuffer.sizeHasChanged = true;
+				}
+			}
+		}
+
+		//creates the GPU side of the mega mesh buffer for the current vertex format
+		inline void CreateMegaMeshBuffer(SMGraphics_Pool_CommandPool* commandPool)
+		{
+			//nothing new to upload
+			if (!megaMeshBufferDirty)
+				return;
+
+			megaMeshBufferDirty = false;
+			megaMeshBufferRebuildCount++;
+			if (vertexFormat == MeshVertexFormat::Quantized)
+				Geometry::QuantizedMegaMeshBuffer_CreateBuffer(&quantizedMegaMeshBuffer, allocator, GPU, &stagingRing, dispatch);
+			else
+				Geometry::FullMegaMeshBuffer_CreateBuffer(&megaMeshBuffer, allocator, GPU, &stagingRing, dispatch);
+		}
+
+		//gets the vertex count of the mega mesh buffer for the current vertex format
+		inline uint64 GetMegaMeshBufferVertexCount()
+		{
+			return (vertexFormat == MeshVertexFormat::Quantized ? quantizedMegaMeshBuffer.vertexCount : megaMeshBuffer.vertexCount);
+		}
+
+		//draws a range of a mesh's indices in the mega mesh buffer, works for both vertex formats
+		//expects the mega mesh buffer's indices to be relative to each mesh, offset by the mesh's first vertex
+		inline void DrawMegaMeshBufferRange(VkCommandBuffer& comBuffer, const uint64& meshIndex,
+			const uint32& firstIndex, const uint32& indexCount, const uint64& objIndex, const uint32 instanceCount = 1, Dispatch* dispatch = nullptr)
+		{
+			const StaticMesh_SubMesh& subMesh = megaMeshBufferMeshes[meshIndex].subMesh;
+			Dispatch_CmdDrawIndexed(dispatch, comBuffer, indexCount, instanceCount, subMesh.firstIndex + firstIndex, (int32)subMesh.firstVertex, (uint32)objIndex);
+		}
+
+		//binds the mega mesh buffer for the current vertex format
+		inline void BindMegaMeshBuffer(VkCommandBuffer& comBuffer, Dispatch* dispatch = nullptr)
+		{
+			Dispatch_RecordBindMegaMeshBuffer(dispatch);
+			if (!Dispatch_IsExecuting(dispatch))
+				return;
+
+			if (vertexFormat == MeshVertexFormat::Quantized)
+				Geometry::QuantizedMegaMeshBuffer_Bind(&quantizedMegaMeshBuffer, comBuffer);
+			else
+				Geometry::FullMegaMeshBuffer_Bind(&megaMeshBuffer, comBuffer);
+		}
+
+		//draws a mesh in the mega mesh buffer for the current vertex format
+		inline void DrawMegaMeshBuffer(VkCommandBuffer& comBuffer, const uint64& meshIndex, const uint64& objIndex, Dispatch* dispatch = nullptr)
+		{
+			//recorded as the draw the mega mesh buffer makes, so a replay doesn't need the mega mesh buffer
+			const StaticMesh_SubMesh& subMesh = megaMeshBufferMeshes[meshIndex].subMesh;
+			Dispatch_RecordDrawIndexed(dispatch, subMesh.indexCount, 1, subMesh.firstIndex, (int32)subMesh.firstVertex, (uint32)objIndex);
+			if (!Dispatch_IsExecuting(dispatch))
+				return;
+
+			if (vertexFormat == MeshVertexFormat::Quantized)
+				Geometry::QuantizedMegaMeshBuffer_Draw(&quantizedMegaMeshBuffer, comBuffer, meshIndex, objIndex);
+			else
+				Geometry::FullMegaMeshBuffer_Draw(&megaMeshBuffer, comBuffer, meshIndex, objIndex);
+		}
+
+		//generates a report of how much CPU memory the static meshes are using
+		inline MeshMemoryReport GenerateMeshMemoryReport()
+		{
+			MeshMemoryReport report;
+			report.staticMeshCount = (uint32)staticMeshAssets.size();
+
+			for (auto& asset : staticMeshAssets)
+			{
+				if (!asset.second.isLoaded)
+					continue;
+
+				report.loadedStaticMeshCount++;
+				report.subMeshCount += (uint32)asset.second.subMeshes.size();
+				report.metadataBytes += asset.second.subMeshes.capacity() * sizeof(StaticMesh_SubMesh) +
+					asset.second.megaMeshBufferIndexes.capacity() * sizeof(uint32);
+				for (size_t l = 0; l < asset.second.lods.size(); ++l)
+					report.metadataBytes += sizeof(StaticMesh_LOD) + asset.second.lods[l].subMeshes.capacity() * sizeof(StaticMesh_SubMesh) +
+					asset.second.lods[l].megaMeshBufferIndexes.capacity() * sizeof(uint32);
+
+				if (asset.second.residencyMode == MeshResidencyMode::ReleaseCPUData)
+					report.releasedStaticMeshCount++;
+				report.releasedCPUBytes += asset.second.releasedCPUBytes;
+
+				for (size_t i = 0; i < asset.second.meshes.size(); ++i)
+					report.residentCPUBytes += Mesh_GetCPUByteSize(asset.second.meshes[i]);
+			}
+
+			for (size_t i = 0; i < megaMeshBufferMeshes.size(); ++i)
+				report.metadataBytes += sizeof(MegaMeshBuffer_MeshEntry) + megaMeshBufferMeshes[i].meshlets.capacity() * sizeof(Geometry::Meshlet);
+
+			return report;
+		}
+
 		//destroy a graphics shader
 		  
 		//destroy a graphics pipeline
@@ -0,0 +1,43 @@
+#pragma once
+
+//defines compile time hashed asset names
+//with AssetManager::hashedAssetIDs on, a asset's ID is the hash of it's name, so "player_mesh"_asset is the ID and lookups never touch strings
+
+#include <BTDSTD/Maps/IDHash.hpp>
+
+#include <cstddef>
+
+#define SMOK_RENDERER_ASSET_NAME_HASH_OFFSET 0xcbf29ce484222325ull //the FNV-1a 64 bit offset basis
+#define SMOK_RENDERER_ASSET_NAME_HASH_PRIME 0x100000001b3ull //the FNV-1a 64 bit prime
+
+namespace Smok::Renderers
+{
+	//hashes a asset name with FNV-1a 64 bit || never returns 0, since 0 is the error ID
+	constexpr uint64 AssetName_Hash(const char* name, const size_t length)
+	{
+		uint64 hash = SMOK_RENDERER_ASSET_NAME_HASH_OFFSET;
+		for (size_t i = 0; i < length; ++i)
+		{
+			hash ^= (uint64)(uint8)name[i];
+			hash *= SMOK_RENDERER_ASSET_NAME_HASH_PRIME;
+		}
+
+		return (hash != 0 ? hash : 1);
+	}
+
+	//hashes a null terminated asset name
+	constexpr uint64 AssetName_Hash(const char* name)
+	{
+		size_t length = 0;
+		while (name[length] != '\0')
+			length++;
+
+		return AssetName_Hash(name, length);
+	}
+
+	namespace Literals
+	{
+		//hashes a asset name at compile time || only matches registered IDs when the asset manager uses hashed IDs
+		constexpr uint64 operator""_asset(const char* name, const size_t length) { return AssetName_Hash(name, length); }
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+//culls meshlets on the CPU against the frustum and their backface cones, emitting only the visible index ranges
+
+#include <SmokRenderers/Culling/Frustum.hpp>
+#include <SmokRenderers/Geometry/Meshlet.hpp>
+
+namespace Smok::Renderers::Culling
+{
+	//defines a range of indices to draw
+	struct IndexRange
+	{
+		uint32 firstIndex = 0, indexCount = 0; //relative to the start of the mesh
+	};
+
+	//defines the stats of culling clusters
+	struct ClusterCullStats
+	{
+		uint32 clustersTested = 0; //the meshlets tested
+		uint32 clustersVisible = 0; //the meshlets that passed
+		uint32 frustumCulled = 0; //the meshlets outside the frustum
+		uint32 backfaceCulled = 0; //the meshlets facing away from the camera
+		uint64 trianglesTested = 0, trianglesVisible = 0; //the triangles in the tested and visible meshlets
+		uint32 rangesEmitted = 0; //the draws emitted after merging neighbouring visible meshlets
+
+		//resets the stats
+		inline void Reset() { *this = ClusterCullStats(); }
+	};
+
+	//tests if a meshlet is facing away from the camera || the camera position must be in the same space as the meshlet
+	inline bool ClusterCuller_IsBackfacing(const Geometry::Meshlet& meshlet, const glm::vec3& cameraPosition)
+	{
+		const glm::vec3 center = glm::vec3(meshlet.sphere.x, meshlet.sphere.y, meshlet.sphere.z);
+		const glm::vec3 toCenter = center - cameraPosition;
+
+		//every triangle faces away if the view direction is inside the cone grown by the sphere
+		return glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.sphere.w;
+	}
+
+	//culls the meshlets of a mesh, emitting the visible ones as index ranges, merging ones next to each other into one range
+	//the frustum and camera position are in the mesh's space, see Frustum_Extract
+	inline void ClusterCuller_CullMeshlets(const std::vector<Geometry::Meshlet>& meshlets,
+		const Frustum& frustum, const glm::vec3& cameraPosition, const bool coneCulling,
+		std::vector<IndexRange>& visibleRanges, ClusterCullStats& stats)
+	{
+		IndexRange* lastRange = nullptr;
+		uint32 lastEnd = ~0u;
+
+		for (size_t m = 0; m < meshlets.size(); ++m)
+		{
+			const Geometry::Meshlet& meshlet = meshlets[m];
+			stats.clustersTested++;
+			stats.trianglesTested += meshlet.triangleCount;
+
+			if (!Frustum_TestSphere(frustum, meshlet.sphere))
+			{
+				stats.frustumCulled++;
+				continue;
+			}
+
+			if (coneCulling && ClusterCuller_IsBackfacing(meshlet, cameraPosition))
+			{
+				stats.backfaceCulled++;
+				continue;
+			}
+
+			stats.clustersVisible++;
+			stats.trianglesVisible += meshlet.triangleCount;
+
+			//extends the last range if it ends where this meshlet starts
+			const uint32 firstIndex = meshlet.firstTriangle * 3;
+			if (lastRange && lastEnd == firstIndex)
+				lastRange->indexCount += meshlet.triangleCount * 3;
+			else
+			{
+				lastRange = &visibleRanges.emplace_back(IndexRange());
+				lastRange->firstIndex = firstIndex;
+				lastRange->indexCount = meshlet.triangleCount * 3;
+				stats.rangesEmitted++;
+			}
+			lastEnd = firstIndex + meshlet.triangleCount * 3;
+		}
+	}
+
+	//checks if a model matrix scales all axes the same, the backface cones are only valid under uniform scale
+	inline bool ClusterCuller_IsUniformScale(const glm::mat4& model)
+	{
+		const float x = glm::dot(glm::vec3(model[0].x, model[0].y, model[0].z), glm::vec3(model[0].x, model[0].y, model[0].z));
+		const float y = glm::dot(glm::vec3(model[1].x, model[1].y, model[1].z), glm::vec3(model[1].x, model[1].y, model[1].z));
+		const float z = glm::dot(glm::vec3(model[2].x, model[2].y, model[2].z), glm::vec3(model[2].x, model[2].y, model[2].z));
+
+		const float epsilon = 1e-3f * glm::max(x, glm::max(y, z));
+		return std::fabs(x - y) <= epsilon && std::fabs(x - z) <= epsilon;
+	}
+}
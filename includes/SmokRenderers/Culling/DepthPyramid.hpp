@@ -0,0 +1,523 @@
+#pragma once
+
+//defines a hierarchical depth pyramid, each level keeps the farthest depth of the 2x2 texels under it
+//GPUDepthPyramid builds it from the depth attachment with shaders/DepthPyramid.comp, the GPU culler samples it's levels and it's read back for the CPU,
+//DepthPyramid_BuildFromDepth is the CPU reference it's verified against
+
+#include <SmokRenderers/Culling/SoftwareRasterizer.hpp>
+#include <SmokRenderers/Util/GPUBuffer.hpp>
+#include <SmokRenderers/Util/ShaderModule.hpp>
+#include <SmokRenderers/Dispatch.hpp>
+
+namespace Smok::Renderers::Culling
+{
+	//defines a level of the depth pyramid
+	struct DepthPyramid_Level
+	{
+		uint32 width = 0, height = 0;
+		std::vector<float> depth; //row major, width * height
+	};
+
+	//defines a depth pyramid || level 0 is the full depth buffer
+	struct DepthPyramid
+	{
+		std::vector<DepthPyramid_Level> levels;
+	};
+
+	//checks if a pyramid has been built
+	inline bool DepthPyramid_IsBuilt(const DepthPyramid& pyramid) { return !pyramid.levels.empty(); }
+
+	//builds the levels below level 0 || odd sizes round up, so every texel is covered
+	inline void DepthPyramid_BuildLevels(DepthPyramid* pyramid)
+	{
+		pyramid->levels.resize(1);
+		while (pyramid->levels.back().width > 1 || pyramid->levels.back().height > 1)
+		{
+			const uint32 parentIndex = (uint32)pyramid->levels.size() - 1;
+			DepthPyramid_Level next;
+			next.width = (pyramid->levels[parentIndex].width + 1) / 2;
+			next.height = (pyramid->levels[parentIndex].height + 1) / 2;
+			next.depth.resize((size_t)next.width * (size_t)next.height);
+
+			const DepthPyramid_Level& parent = pyramid->levels[parentIndex];
+			for (uint32 y = 0; y < next.height; ++y)
+			{
+				const uint32 y0 = y * 2, y1 = std::min(y * 2 + 1, parent.height - 1);
+				for (uint32 x = 0; x < next.width; ++x)
+				{
+					const uint32 x0 = x * 2, x1 = std::min(x * 2 + 1, parent.width - 1);
+					next.depth[(size_t)y * next.width + x] = std::max(
+						std::max(parent.depth[(size_t)y0 * parent.width + x0], parent.depth[(size_t)y0 * parent.width + x1]),
+						std::max(parent.depth[(size_t)y1 * parent.width + x0], parent.depth[(size_t)y1 * parent.width + x1]));
+				}
+			}
+
+			pyramid->levels.emplace_back(std::move(next));
+		}
+	}
+
+	//builds a depth pyramid from a depth buffer, which is level 0
+	inline void DepthPyramid_Build(DepthPyramid* pyramid, const float* depth, const uint32 width, const uint32 height)
+	{
+		pyramid->levels.clear();
+		if (!width || !height)
+			return;
+
+		DepthPyramid_Level* level = &pyramid->levels.emplace_back(DepthPyramid_Level());
+		level->width = width; level->height = height;
+		level->depth.assign(depth, depth + (size_t)width * (size_t)height);
+		DepthPyramid_BuildLevels(pyramid);
+	}
+
+	//builds a depth pyramid the way the GPU does from a depth attachment of any size, the CPU reference of shaders/DepthPyramid.comp
+	//level 0 is width x height, each texel keeping the farthest depth of every source texel it's footprint touches
+	inline void DepthPyramid_BuildFromDepth(DepthPyramid* pyramid, const float* depth, const uint32 depthWidth, const uint32 depthHeight,
+		const uint32 width, const uint32 height)
+	{
+		pyramid->levels.clear();
+		if (!depthWidth || !depthHeight || !width || !height)
+			return;
+
+		DepthPyramid_Level* level = &pyramid->levels.emplace_back(DepthPyramid_Level());
+		level->width = width; level->height = height;
+		level->depth.resize((size_t)width * (size_t)height);
+		for (uint32 y = 0; y < height; ++y)
+		{
+			const uint32 beginY = (y * depthHeight) / height;
+			const uint32 endY = std::max(std::min(((y + 1) * depthHeight + height - 1) / height, depthHeight), beginY + 1);
+			for (uint32 x = 0; x < width; ++x)
+			{
+				const uint32 beginX = (x * depthWidth) / width;
+				const uint32 endX = std::max(std::min(((x + 1) * depthWidth + width - 1) / width, depthWidth), beginX + 1);
+
+				float farthest = 0.0f;
+				for (uint32 sy = beginY; sy < endY; ++sy)
+					for (uint32 sx = beginX; sx < endX; ++sx)
+						farthest = std::max(farthest, depth[(size_t)sy * depthWidth + sx]);
+				level->depth[(size_t)y * width + x] = farthest;
+			}
+		}
+
+		DepthPyramid_BuildLevels(pyramid);
+	}
+
+	//builds a depth pyramid from a CPU depth buffer
+	inline void DepthPyramid_Build(DepthPyramid* pyramid, const DepthBuffer& buffer)
+	{
+		DepthPyramid_Build(pyramid, buffer.depth.data(), buffer.width, buffer.height);
+	}
+
+	//gets the farthest depth in a pixel rect of level 0, using the level where the rect covers at most 2x2 texels
+	//the rect is inclusive and must be inside the pyramid
+	inline float DepthPyramid_SampleMax(const DepthPyramid& pyramid, uint32 minX, uint32 minY, uint32 maxX, uint32 maxY)
+	{
+		uint32 levelIndex = 0;
+		while (levelIndex + 1 < pyramid.levels.size() && ((maxX >> levelIndex) - (minX >> levelIndex) > 1 ||
+			(maxY >> levelIndex) - (minY >> levelIndex) > 1))
+			levelIndex++;
+
+		const DepthPyramid_Level& level = pyramid.levels[levelIndex];
+		minX >>= levelIndex; maxX = std::min(maxX >> levelIndex, level.width - 1);
+		minY >>= levelIndex; maxY = std::min(maxY >> levelIndex, level.height - 1);
+
+		float farthest = 0.0f;
+		for (uint32 y = minY; y <= maxY; ++y)
+			for (uint32 x = minX; x <= maxX; ++x)
+				farthest = std::max(farthest, level.depth[(size_t)y * level.width + x]);
+
+		return farthest;
+	}
+
+	//the workgroup size of the depth pyramid shader, in both dimensions
+#define SMOK_RENDERER_DEPTH_PYRAMID_WORKGROUP_SIZE 8
+
+	//defines the push constants of the depth pyramid shader
+	struct GPUDepthPyramid_PushConstants
+	{
+		uint32 sourceWidth = 0, sourceHeight = 0;
+		uint32 destinationWidth = 0, destinationHeight = 0;
+		uint32 fromDepth = 0; //1 reduces the footprint of the depth attachment, 0 reduces 2x2
+	};
+
+	//defines a level of the GPU depth pyramid || each is it's own image, since odd sizes round up and a mip chain rounds down
+	struct GPUDepthPyramid_Level
+	{
+		VkImage image = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+
+		uint32 width = 0, height = 0;
+		VkDeviceSize readBackOffset = 0; //where the level starts in the read back buffers
+	};
+
+	//defines a depth pyramid built on the GPU from the depth attachment, sampled by the GPU culler and read back for the CPU to cull against
+	struct GPUDepthPyramid
+	{
+		VkDevice device = VK_NULL_HANDLE;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+
+		VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+		std::vector<VkDescriptorSet> descriptorSets; //per frame in flight and level, frame * level count + level
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkSampler sampler = VK_NULL_HANDLE;
+
+		std::vector<GPUDepthPyramid_Level> levels; //left in VK_IMAGE_LAYOUT_GENERAL after a build, for compute shaders to sample
+		bool recorded = false; //if a build has been recorded, so later work in the queue can sample the levels
+
+		//per frame in flight || every level packed, so a frame's pyramid can be read once it's fence is done
+		std::vector<Util::GPUBuffer> readBackBuffers;
+		std::vector<uint8> built; //if the frame's read back buffer has a pyramid in it
+		uint32 oldestFrameIndex = 0; //the frame in flight built longest ago, done once NextFrame has waited on it's fence
+	};
+
+	//destroys a GPU depth pyramid
+	inline void GPUDepthPyramid_Destroy(GPUDepthPyramid* pyramid)
+	{
+		if (pyramid->device == VK_NULL_HANDLE)
+			return;
+
+		for (size_t i = 0; i < pyramid->readBackBuffers.size(); ++i)
+			Util::GPUBuffer_Destroy(&pyramid->readBackBuffers[i], pyramid->allocator);
+		for (size_t l = 0; l < pyramid->levels.size(); ++l)
+		{
+			if (pyramid->levels[l].view != VK_NULL_HANDLE)
+				vkDestroyImageView(pyramid->device, pyramid->levels[l].view, nullptr);
+			if (pyramid->levels[l].image != VK_NULL_HANDLE)
+				vmaDestroyImage(pyramid->allocator, pyramid->levels[l].image, pyramid->levels[l].allocation);
+		}
+
+		if (pyramid->sampler != VK_NULL_HANDLE)
+			vkDestroySampler(pyramid->device, pyramid->sampler, nullptr);
+		if (pyramid->pipeline != VK_NULL_HANDLE)
+			vkDestroyPipeline(pyramid->device, pyramid->pipeline, nullptr);
+		if (pyramid->pipelineLayout != VK_NULL_HANDLE)
+			vkDestroyPipelineLayout(pyramid->device, pyramid->pipelineLayout, nullptr);
+		if (pyramid->descriptorPool != VK_NULL_HANDLE)
+			vkDestroyDescriptorPool(pyramid->device, pyramid->descriptorPool, nullptr);
+		if (pyramid->descriptorSetLayout != VK_NULL_HANDLE)
+			vkDestroyDescriptorSetLayout(pyramid->device, pyramid->descriptorSetLayout, nullptr);
+
+		*pyramid = GPUDepthPyramid();
+	}
+
+	//inits a GPU depth pyramid with a level 0 of width x height || the shader is shaders/DepthPyramid.comp compiled to SPIR-V
+	inline bool GPUDepthPyramid_Init(GPUDepthPyramid* pyramid, SMGraphics_Core_GPU* GPU, VmaAllocator allocator,
+		const std::string& SPIRVPath, const uint32 framesInFlight, const uint32 width, const uint32 height)
+	{
+		pyramid->device = GPU->device; pyramid->allocator = allocator;
+		if (!width || !height)
+		{
+			BTD_LogError("Smok Renderer", "Depth Pyramid", "GPUDepthPyramid_Init", "The pyramid can't be 0 texels in size!");
+			return false;
+		}
+
+		//the level sizes, the same as DepthPyramid_BuildLevels
+		pyramid->levels.emplace_back(GPUDepthPyramid_Level());
+		pyramid->levels[0].width = width; pyramid->levels[0].height = height;
+		while (pyramid->levels.back().width > 1 || pyramid->levels.back().height > 1)
+		{
+			GPUDepthPyramid_Level next;
+			next.width = (pyramid->levels.back().width + 1) / 2;
+			next.height = (pyramid->levels.back().height + 1) / 2;
+			pyramid->levels.emplace_back(next);
+		}
+
+		VkDeviceSize readBackSize = 0;
+		for (size_t l = 0; l < pyramid->levels.size(); ++l)
+		{
+			GPUDepthPyramid_Level* level = &pyramid->levels[l];
+			level->readBackOffset = readBackSize;
+			readBackSize += sizeof(float) * (VkDeviceSize)level->width * level->height;
+
+			VkImageCreateInfo imageInfo = {};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.format = VK_FORMAT_R32_SFLOAT;
+			imageInfo.extent = { level->width, level->height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			VmaAllocationCreateInfo allocInfo = {};
+			allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+			if (vmaCreateImage(allocator, &imageInfo, &allocInfo, &level->image, &level->allocation, nullptr) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "Depth Pyramid", "GPUDepthPyramid_Init", "Failed to create a level's image!");
+				level->image = VK_NULL_HANDLE;
+				return false;
+			}
+
+			VkImageViewCreateInfo viewInfo = {};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = level->image;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = VK_FORMAT_R32_SFLOAT;
+			viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			if (vkCreateImageView(pyramid->device, &viewInfo, nullptr, &level->view) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "Depth Pyramid", "GPUDepthPyramid_Init", "Failed to create a level's image view!");
+				level->view = VK_NULL_HANDLE;
+				return false;
+			}
+		}
+
+		pyramid->readBackBuffers.resize(framesInFlight);
+		pyramid->built.resize(framesInFlight, 0);
+		for (uint32 f = 0; f < framesInFlight; ++f)
+		{
+			if (!Util::GPUBuffer_Create(&pyramid->readBackBuffers[f], allocator, (size_t)readBackSize,
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU))
+				return false;
+		}
+
+		//texel fetches ignore filtering, but a sampled image still needs a sampler
+		VkSamplerCreateInfo samplerInfo = {};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST; samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		if (vkCreateSampler(pyramid->device, &samplerInfo, nullptr, &pyramid->sampler) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Depth Pyramid", "GPUDepthPyramid_Init", "Failed to create the sampler!");
+			pyramid->sampler = VK_NULL_HANDLE;
+			return false;
+		}
+
+		//descriptor set layout || the source depth and the level written
+		VkDescriptorSetLayoutBinding bindings[2] = {};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 2;
+		layoutInfo.pBindings = bindings;
+		if (vkCreateDescriptorSetLayout(pyramid->device, &layoutInfo, nullptr, &pyramid->descriptorSetLayout) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Depth Pyramid", "GPUDepthPyramid_Init", "Failed to create the descriptor set layout!");
+			return false;
+		}
+
+		//descriptor pool and sets
+		const uint32 setCount = framesInFlight * (uint32)pyramid->levels.size();
+		VkDescriptorPoolSize poolSizes[2] = {};
+		poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		poolSizes[0].descriptorCount = setCount;
+		poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		poolSizes[1].descriptorCount = setCount;
+
+		VkDescriptorPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.maxSets = setCount;
+		poolInfo.poolSizeCount = 2;
+		poolInfo.pPoolSizes = poolSizes;
+		if (vkCreateDescriptorPool(pyramid->device, &poolInfo, nullptr, &pyramid->descriptorPool) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Depth Pyramid", "GPUDepthPyramid_Init", "Failed to create the descriptor pool!");
+			return false;
+		}
+
+		std::vector<VkDescriptorSetLayout> layouts(setCount, pyramid->descriptorSetLayout);
+		pyramid->descriptorSets.resize(setCount);
+
+		VkDescriptorSetAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = pyramid->descriptorPool;
+		allocInfo.descriptorSetCount = setCount;
+		allocInfo.pSetLayouts = layouts.data();
+		if (vkAllocateDescriptorSets(pyramid->device, &allocInfo, pyramid->descriptorSets.data()) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Depth Pyramid", "GPUDepthPyramid_Init", "Failed to allocate the descriptor sets!");
+			return false;
+		}
+
+		//every level but 0 reads the level above, which never changes || level 0's depth is bound when recording
+		for (uint32 f = 0; f < framesInFlight; ++f)
+		{
+			for (uint32 l = 0; l < pyramid->levels.size(); ++l)
+			{
+				const VkDescriptorSet set = pyramid->descriptorSets[f * pyramid->levels.size() + l];
+				VkDescriptorImageInfo imageInfos[2] = {};
+				imageInfos[0] = { pyramid->sampler, (l > 0 ? pyramid->levels[l - 1].view : VK_NULL_HANDLE), VK_IMAGE_LAYOUT_GENERAL };
+				imageInfos[1] = { VK_NULL_HANDLE, pyramid->levels[l].view, VK_IMAGE_LAYOUT_GENERAL };
+
+				VkWriteDescriptorSet writes[2] = {};
+				for (uint32 w = 0; w < 2; ++w)
+				{
+					writes[w].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					writes[w].dstSet = set;
+					writes[w].dstBinding = w;
+					writes[w].descriptorCount = 1;
+					writes[w].descriptorType = bindings[w].descriptorType;
+					writes[w].pImageInfo = &imageInfos[w];
+				}
+				vkUpdateDescriptorSets(pyramid->device, (l > 0 ? 2 : 1), (l > 0 ? writes : writes + 1), 0, nullptr);
+			}
+		}
+
+		//pipeline
+		VkPushConstantRange pushConstantRange = {};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.size = sizeof(GPUDepthPyramid_PushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &pyramid->descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		if (vkCreatePipelineLayout(pyramid->device, &pipelineLayoutInfo, nullptr, &pyramid->pipelineLayout) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Depth Pyramid", "GPUDepthPyramid_Init", "Failed to create the pipeline layout!");
+			return false;
+		}
+
+		pyramid->pipeline = Util::ComputePipeline_CreateFromFile(pyramid->device, SPIRVPath, pyramid->pipelineLayout);
+		return pyramid->pipeline != VK_NULL_HANDLE;
+	}
+
+	//records building the pyramid from a depth attachment and copying it into the frame's read back buffer
+	//must be recorded outside of a render pass, after the depth is written || the depth view needs the depth aspect, it's image
+	//VK_IMAGE_USAGE_SAMPLED_BIT, and it has to be in depthLayout
+	//the levels end up readable by compute shaders, the GPU culler tests against them later in the frame and in the next one
+	inline void GPUDepthPyramid_RecordBuild(GPUDepthPyramid* pyramid, VkCommandBuffer comBuffer, const uint32 frameIndex,
+		VkImageView depthView, const uint32 depthWidth, const uint32 depthHeight,
+		const VkImageLayout depthLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, Dispatch* dispatch = nullptr)
+	{
+		if (pyramid->pipeline == VK_NULL_HANDLE || depthView == VK_NULL_HANDLE || !depthWidth || !depthHeight)
+			return;
+
+		const uint32 levelCount = (uint32)pyramid->levels.size();
+		const VkDescriptorSet* sets = &pyramid->descriptorSets[frameIndex * levelCount];
+
+		//binds this frame's depth || the depth can be remade when the swapchain is, so this is done every frame
+		VkDescriptorImageInfo depthInfo = { pyramid->sampler, depthView, depthLayout };
+		VkWriteDescriptorSet write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = sets[0];
+		write.dstBinding = 0;
+		write.descriptorCount = 1;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.pImageInfo = &depthInfo;
+		Dispatch_UpdateDescriptorSets(dispatch, pyramid->device, 1, &write);
+
+		//every level is rewritten, so the last frame's contents are dropped || waits on the last copy and cull reading them
+		std::vector<VkImageMemoryBarrier> imageBarriers(levelCount);
+		for (uint32 l = 0; l < levelCount; ++l)
+		{
+			imageBarriers[l] = {};
+			imageBarriers[l].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageBarriers[l].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; imageBarriers[l].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarriers[l].image = pyramid->levels[l].image;
+			imageBarriers[l].subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			imageBarriers[l].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; imageBarriers[l].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			imageBarriers[l].srcAccessMask = 0; imageBarriers[l].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		}
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, levelCount, imageBarriers.data());
+
+		//reduces each level from the one above
+		Dispatch_CmdBindPipeline(dispatch, comBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid->pipeline);
+		for (uint32 l = 0; l < levelCount; ++l)
+		{
+			GPUDepthPyramid_PushConstants pc;
+			pc.sourceWidth = (l > 0 ? pyramid->levels[l - 1].width : depthWidth);
+			pc.sourceHeight = (l > 0 ? pyramid->levels[l - 1].height : depthHeight);
+			pc.destinationWidth = pyramid->levels[l].width; pc.destinationHeight = pyramid->levels[l].height;
+			pc.fromDepth = (l > 0 ? 0 : 1);
+
+			Dispatch_CmdBindDescriptorSets(dispatch, comBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid->pipelineLayout, 0, 1, &sets[l]);
+			Dispatch_CmdPushConstants(dispatch, comBuffer, pyramid->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+				sizeof(GPUDepthPyramid_PushConstants), &pc);
+			Dispatch_CmdDispatch(dispatch, comBuffer,
+				(pc.destinationWidth + SMOK_RENDERER_DEPTH_PYRAMID_WORKGROUP_SIZE - 1) / SMOK_RENDERER_DEPTH_PYRAMID_WORKGROUP_SIZE,
+				(pc.destinationHeight + SMOK_RENDERER_DEPTH_PYRAMID_WORKGROUP_SIZE - 1) / SMOK_RENDERER_DEPTH_PYRAMID_WORKGROUP_SIZE, 1);
+
+			//the next level reads this one
+			VkImageMemoryBarrier levelBarrier = imageBarriers[l];
+			levelBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL; levelBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT; levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			if (l + 1 < levelCount)
+				Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+					0, 0, nullptr, 0, nullptr, 1, &levelBarrier);
+		}
+
+		//copies every level into the frame's read back buffer
+		std::vector<VkBufferImageCopy> copies(levelCount);
+		for (uint32 l = 0; l < levelCount; ++l)
+		{
+			imageBarriers[l].oldLayout = VK_IMAGE_LAYOUT_GENERAL; imageBarriers[l].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			imageBarriers[l].srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT; imageBarriers[l].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+			copies[l] = {};
+			copies[l].bufferOffset = pyramid->levels[l].readBackOffset;
+			copies[l].imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+			copies[l].imageExtent = { pyramid->levels[l].width, pyramid->levels[l].height, 1 };
+		}
+
+		VkBufferMemoryBarrier readBackBarrier = {};
+		readBackBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		readBackBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; readBackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		readBackBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; readBackBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		readBackBarrier.buffer = pyramid->readBackBuffers[frameIndex].buffer;
+		readBackBarrier.size = VK_WHOLE_SIZE;
+
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, levelCount, imageBarriers.data());
+		for (uint32 l = 0; l < levelCount; ++l)
+			Dispatch_CmdCopyImageToBuffer(dispatch, comBuffer, pyramid->levels[l].image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				pyramid->readBackBuffers[frameIndex].buffer, 1, &copies[l]);
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+			0, 0, nullptr, 1, &readBackBarrier, 0, nullptr);
+
+		//hands the levels to the culls that sample them
+		for (uint32 l = 0; l < levelCount; ++l)
+		{
+			imageBarriers[l].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL; imageBarriers[l].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			imageBarriers[l].srcAccessMask = 0; imageBarriers[l].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		}
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, levelCount, imageBarriers.data());
+		pyramid->recorded = true;
+
+		//without a device nothing was written to read back
+		pyramid->built[frameIndex] = (Dispatch_IsExecuting(dispatch) ? 1 : 0);
+		pyramid->oldestFrameIndex = (frameIndex + 1) % (uint32)pyramid->readBackBuffers.size();
+	}
+
+	//reads back the pyramid a frame built || the frame's fence must have been waited on, returns false if it hasn't built one
+	inline bool GPUDepthPyramid_ReadBack(GPUDepthPyramid* pyramid, const uint32 frameIndex, DepthPyramid* out)
+	{
+		if (frameIndex >= pyramid->built.size() || !pyramid->built[frameIndex])
+			return false;
+
+		const Util::GPUBuffer& buffer = pyramid->readBackBuffers[frameIndex];
+		vmaInvalidateAllocation(pyramid->allocator, buffer.allocation, 0, VK_WHOLE_SIZE);
+
+		out->levels.resize(pyramid->levels.size());
+		for (size_t l = 0; l < pyramid->levels.size(); ++l)
+		{
+			const GPUDepthPyramid_Level& level = pyramid->levels[l];
+			out->levels[l].width = level.width; out->levels[l].height = level.height;
+			out->levels[l].depth.resize((size_t)level.width * level.height);
+			memcpy(out->levels[l].depth.data(), (const uint8*)buffer.allocationInfo.pMappedData + level.readBackOffset,
+				sizeof(float) * out->levels[l].depth.size());
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+//defines a view frustum for culling bounds on the CPU
+
+#include <glm/glm.hpp>
+
+namespace Smok::Renderers::Culling
+{
+	//defines the planes of a frustum || xyz = normal pointing in, w = distance
+	struct Frustum
+	{
+		glm::vec4 planes[6]; //left, right, bottom, top, near, far
+	};
+
+	//extracts a frustum from a projection * view matrix || pass P * V * model to get the frustum in the model's space
+	//expects a zero to one depth range, which the renderers use
+	inline Frustum Frustum_Extract(const glm::mat4& m)
+	{
+		Frustum frustum;
+
+		//the rows of the matrix
+		const glm::vec4 row0 = glm::vec4(m[0][0], m[1][0], m[2][0], m[3][0]);
+		const glm::vec4 row1 = glm::vec4(m[0][1], m[1][1], m[2][1], m[3][1]);
+		const glm::vec4 row2 = glm::vec4(m[0][2], m[1][2], m[2][2], m[3][2]);
+		const glm::vec4 row3 = glm::vec4(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+		frustum.planes[0] = row3 + row0; //left
+		frustum.planes[1] = row3 - row0; //right
+		frustum.planes[2] = row3 + row1; //bottom
+		frustum.planes[3] = row3 - row1; //top
+		frustum.planes[4] = row2; //near
+		frustum.planes[5] = row3 - row2; //far
+
+		//normalizes, so sphere tests get real distances
+		for (uint32 i = 0; i < 6; ++i)
+		{
+			const float length = glm::length(glm::vec3(frustum.planes[i].x, frustum.planes[i].y, frustum.planes[i].z));
+			if (length > 0.0f)
+				frustum.planes[i] /= length;
+		}
+
+		return frustum;
+	}
+
+	//tests if a sphere is at least partly inside the frustum || xyz = center, w = radius
+	inline bool Frustum_TestSphere(const Frustum& frustum, const glm::vec4& sphere)
+	{
+		for (uint32 i = 0; i < 6; ++i)
+		{
+			const glm::vec4& p = frustum.planes[i];
+			if (p.x * sphere.x + p.y * sphere.y + p.z * sphere.z + p.w < -sphere.w)
+				return false;
+		}
+
+		return true;
+	}
+
+	//tests if a AABB is at least partly inside the frustum
+	inline bool Frustum_TestAABB(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max)
+	{
+		for (uint32 i = 0; i < 6; ++i)
+		{
+			//the corner furthest along the plane normal
+			const glm::vec4& p = frustum.planes[i];
+			const glm::vec3 positive = glm::vec3(p.x >= 0.0f ? max.x : min.x, p.y >= 0.0f ? max.y : min.y, p.z >= 0.0f ? max.z : min.z);
+			if (p.x * positive.x + p.y * positive.y + p.z * positive.z + p.w < 0.0f)
+				return false;
+		}
+
+		return true;
+	}
+}
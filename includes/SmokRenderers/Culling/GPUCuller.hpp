@@ -0,0 +1,748 @@
+#pragma once
+
+//defines a GPU driven culler, a compute pass that frustum culls draws, picks their LOD and writes compacted indirect draw commands
+//the shader is shaders/GPUCull.comp, GPUCuller_CullCPU is the CPU reference it's verified against
+//with GPUCuller_InitOcclusion it also occlusion culls in two phases against a GPUDepthPyramid, see GPUCuller_RecordOcclusionCull
+
+#include <SmokRenderers/Geometry/MeshBounds.hpp>
+#include <SmokRenderers/Culling/Frustum.hpp>
+#include <SmokRenderers/Culling/OcclusionCuller.hpp>
+#include <SmokRenderers/Util/GPUBuffer.hpp>
+#include <SmokRenderers/Util/ShaderModule.hpp>
+#include <SmokRenderers/Dispatch.hpp>
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+#include <algorithm>
+
+namespace Smok::Renderers::Culling
+{
+	//the most LODs a candidate can pick from, matches the shader
+#define SMOK_RENDERER_GPU_CULL_MAX_LODS 5
+
+	//the workgroup size of the cull shader
+#define SMOK_RENDERER_GPU_CULL_WORKGROUP_SIZE 64
+
+	//the most levels a depth pyramid the cull tests against can have, matches the shader || a level 0 up to 32768 texels wide
+#define SMOK_RENDERER_GPU_CULL_MAX_PYRAMID_LEVELS 16
+
+	//defines which pass of the two phase occlusion cull is run
+	enum class GPUCull_OcclusionPhase
+	{
+		None = 0, //no occlusion culling
+		PhaseOne, //tests against last frame's pyramid, flagging the candidates it rejects
+		PhaseTwo //tests the rejected candidates against the pyramid of what phase one drew, writing after phase one's commands and counts
+	};
+
+	//defines a draw the GPU decides to draw or not || matches GPUCull_Candidate in the shader
+	struct GPUCull_Candidate
+	{
+		glm::vec4 cullSphere = glm::vec4(0.0f); //mesh space sphere of the mesh, for frustum culling
+		glm::vec4 lodSphere = glm::vec4(0.0f); //mesh space sphere of the whole static mesh, for picking the LOD
+		glm::vec4 lodScreenSizes = glm::vec4(0.0f); //the screen size LOD 1, 2, 3 and 4 start at
+
+		uint32 objectIndex = 0; //the index into the object buffer, written as the first instance
+		uint32 firstLODMeshDraw = 0; //the mesh draw of LOD 0, the others follow it
+		uint32 lodCount = 1; //the number of LODs
+		uint32 batchIndex = 0; //the batch the draw is counted in
+
+		uint32 commandBase = 0; //the first command slot of the batch
+		uint32 candidateIndex = 0; //the index of this candidate in the batch, used when not compacting
+		uint32 pad0 = 0, pad1 = 0;
+	};
+
+	//defines where a mesh lives in the mega mesh buffer || matches GPUCull_MeshDraw in the shader
+	struct GPUCull_MeshDraw
+	{
+		uint32 indexCount = 0;
+		uint32 firstIndex = 0;
+		int32 vertexOffset = 0;
+		uint32 pad = 0;
+	};
+
+	//defines the push constants of the cull shader
+	struct GPUCull_PushConstants
+	{
+		glm::vec4 frustumPlanes[6]; //world space, normalized, pointing in
+		glm::vec4 cameraPosition = glm::vec4(0.0f); //xyz = world position, w = P[1][1]
+		uint32 candidateCount = 0;
+		uint32 compact = 1; //1 writes visible draws packed, 0 writes every slot with culled ones having 0 instances
+		uint32 isOrthographic = 0;
+		float lodBias = 1.0f; //multiplies the screen size before picking LODs
+	};
+
+	//defines what the occlusion cull tests against || matches OcclusionBuffer in the shader
+	struct GPUCull_OcclusionData
+	{
+		glm::mat4 PV = glm::mat4(1.0f); //the camera the pyramid is tested with
+		uint32 pyramidWidth = 0, pyramidHeight = 0, pyramidLevelCount = 0;
+		uint32 phaseTwoCommandOffset = 0; //where phase two's commands start, after every phase one command
+		uint32 phaseTwoCountOffset = 0; //where phase two's counts start, after every phase one count
+		uint32 pad0 = 0, pad1 = 0, pad2 = 0;
+	};
+
+	//fills the push constants from a camera
+	inline GPUCull_PushConstants GPUCuller_CalculatePushConstants(const glm::mat4& V, const glm::mat4& P,
+		const uint32 candidateCount, const bool compact, const float lodBias = 1.0f)
+	{
+		GPUCull_PushConstants pc;
+
+		const Frustum frustum = Frustum_Extract(P * V);
+		for (uint32 i = 0; i < 6; ++i)
+			pc.frustumPlanes[i] = frustum.planes[i];
+
+		const glm::mat4 invView = glm::inverse(V);
+		pc.cameraPosition = glm::vec4(invView[3].x, invView[3].y, invView[3].z, P[1][1]);
+		pc.candidateCount = candidateCount;
+		pc.compact = (compact ? 1 : 0);
+		pc.isOrthographic = (P[3][3] == 1.0f ? 1 : 0);
+		pc.lodBias = lodBias;
+
+		return pc;
+	}
+
+	//picks the LOD of a candidate the same way the shader does
+	inline uint32 GPUCuller_PickLOD(const GPUCull_PushConstants& pc, const GPUCull_Candidate& candidate, const glm::mat4& model)
+	{
+		const glm::vec4 lodSphere = Geometry::BoundingSphere_Transform(candidate.lodSphere, model);
+		float screenSize = 1.0f;
+		if (pc.isOrthographic)
+			screenSize = lodSphere.w * fabsf(pc.cameraPosition.w);
+		else
+		{
+			const float distance = glm::length(glm::vec3(lodSphere.x - pc.cameraPosition.x, lodSphere.y - pc.cameraPosition.y, lodSphere.z - pc.cameraPosition.z));
+			if (distance > lodSphere.w)
+				screenSize = lodSphere.w * fabsf(pc.cameraPosition.w) / distance;
+		}
+		screenSize *= pc.lodBias;
+
+		uint32 lod = 0;
+		for (uint32 l = 1; l < std::min(candidate.lodCount, (uint32)SMOK_RENDERER_GPU_CULL_MAX_LODS); ++l)
+		{
+			if (screenSize < candidate.lodScreenSizes[l - 1])
+				lod = l;
+		}
+
+		return lod;
+	}
+
+	//runs the cull on the CPU, writing the same commands and counts the shader does
+	//compacted commands are written in candidate order, the GPU writes them in any order
+	//an occlusion phase tests against pyramid with PV and reads or writes one rejected flag per candidate,
+	//phase two's commands and counts are written where commands and counts point, so pass the phase two regions for it
+	inline void GPUCuller_CullCPU(const GPUCull_PushConstants& pc,
+		const GPUCull_Candidate* candidates, const GPUCull_MeshDraw* meshDraws,
+		const glm::mat4* models, const size_t modelStride,
+		VkDrawIndexedIndirectCommand* commands, uint32* counts,
+		const GPUCull_OcclusionPhase phase = GPUCull_OcclusionPhase::None, const DepthPyramid* pyramid = nullptr,
+		const glm::mat4& PV = glm::mat4(1.0f), uint32* rejected = nullptr)
+	{
+		for (uint32 id = 0; id < pc.candidateCount; ++id)
+		{
+			//phase two only looks at what phase one rejected, the rest are already drawn || without compacting every slot is still written
+			if (phase == GPUCull_OcclusionPhase::PhaseTwo && !rejected[id] && pc.compact)
+				continue;
+
+			const GPUCull_Candidate& candidate = candidates[id];
+			const glm::mat4& model = *(const glm::mat4*)((const uint8*)models + modelStride * candidate.objectIndex);
+
+			//frustum
+			const glm::vec4 sphere = Geometry::BoundingSphere_Transform(candidate.cullSphere, model);
+			bool visible = true;
+			for (uint32 i = 0; i < 6; ++i)
+			{
+				const glm::vec4& p = pc.frustumPlanes[i];
+				visible = visible && (p.x * sphere.x + p.y * sphere.y + p.z * sphere.z + p.w >= -sphere.w);
+			}
+
+			//occlusion
+			if (phase == GPUCull_OcclusionPhase::PhaseOne)
+			{
+				const bool occluded = visible && OcclusionCuller_IsOccluded(*pyramid, sphere, PV);
+				rejected[id] = (occluded ? 1 : 0);
+				visible = visible && !occluded;
+			}
+			else if (phase == GPUCull_OcclusionPhase::PhaseTwo)
+				visible = visible && rejected[id] && !OcclusionCuller_IsOccluded(*pyramid, sphere, PV);
+
+			//LOD
+			const uint32 lod = GPUCuller_PickLOD(pc, candidate, model);
+
+			const GPUCull_MeshDraw& meshDraw = meshDraws[candidate.firstLODMeshDraw + lod];
+
+			//writes the draw
+			uint32 slot = 0;
+			if (pc.compact)
+			{
+				if (!visible)
+					continue;
+				slot = counts[candidate.batchIndex]++;
+			}
+			else
+				slot = candidate.candidateIndex;
+
+			VkDrawIndexedIndirectCommand& command = commands[candidate.commandBase + slot];
+			command.indexCount = meshDraw.indexCount;
+			command.instanceCount = (visible ? 1 : 0);
+			command.firstIndex = meshDraw.firstIndex;
+			command.vertexOffset = meshDraw.vertexOffset;
+			command.firstInstance = candidate.objectIndex;
+		}
+	}
+
+	//compares the commands of one batch from the GPU against the CPU reference || order doesn't matter
+	inline bool GPUCuller_CompareBatch(const VkDrawIndexedIndirectCommand* GPUCommands, const VkDrawIndexedIndirectCommand* CPUCommands,
+		const uint32 commandCount)
+	{
+		auto less = [](const VkDrawIndexedIndirectCommand& a, const VkDrawIndexedIndirectCommand& b) {
+			if (a.firstInstance != b.firstInstance) return a.firstInstance < b.firstInstance;
+			if (a.firstIndex != b.firstIndex) return a.firstIndex < b.firstIndex;
+			if (a.vertexOffset != b.vertexOffset) return a.vertexOffset < b.vertexOffset;
+			if (a.indexCount != b.indexCount) return a.indexCount < b.indexCount;
+			return a.instanceCount < b.instanceCount;
+		};
+
+		std::vector<VkDrawIndexedIndirectCommand> a(GPUCommands, GPUCommands + commandCount), b(CPUCommands, CPUCommands + commandCount);
+		std::sort(a.begin(), a.end(), less); std::sort(b.begin(), b.end(), less);
+
+		for (uint32 i = 0; i < commandCount; ++i)
+		{
+			if (a[i].indexCount != b[i].indexCount || a[i].instanceCount != b[i].instanceCount || a[i].firstIndex != b[i].firstIndex ||
+				a[i].vertexOffset != b[i].vertexOffset || a[i].firstInstance != b[i].firstInstance)
+				return false;
+		}
+
+		return true;
+	}
+
+	//defines a GPU culler
+	struct GPUCuller
+	{
+		VkDevice device = VK_NULL_HANDLE;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+
+		VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+		std::vector<VkDescriptorSet> descriptorSets; //per frame in flight
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+		VkPipeline pipeline = VK_NULL_HANDLE;
+
+		bool useDrawIndirectCount = true; //compacts the draws and draws them with vkCmdDrawIndexedIndirectCount
+		bool readBack = false; //keeps the commands and counts host readable, so they can be checked against the CPU
+
+		//per frame in flight || the mesh draw table is too, so growing it never has to wait on a frame that's still reading it
+		std::vector<Util::GPUBuffer> meshDrawBuffers, candidateBuffers, commandBuffers, countBuffers;
+		std::vector<uint32> meshDrawCounts, candidateCounts, commandCounts, batchCounts;
+
+		//made by GPUCuller_InitOcclusion || the command and count buffers hold phase one's then phase two's
+		bool occlusion = false;
+		VkDescriptorSetLayout occlusionDescriptorSetLayout = VK_NULL_HANDLE;
+		VkDescriptorPool occlusionDescriptorPool = VK_NULL_HANDLE;
+		std::vector<VkDescriptorSet> occlusionDescriptorSets; //per frame in flight
+		VkPipelineLayout occlusionPipelineLayout = VK_NULL_HANDLE;
+		VkPipeline occlusionPipelines[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE }; //phase one and two
+		std::vector<Util::GPUBuffer> occlusionDataBuffers, rejectedBuffers; //per frame in flight
+	};
+
+	//inits the GPU culler || useDrawIndirectCount needs Vulkan 1.2 or VK_KHR_draw_indirect_count, all paths need drawIndirectFirstInstance
+	inline bool GPUCuller_Init(GPUCuller* culler, SMGraphics_Core_GPU* GPU, VmaAllocator allocator,
+		const std::string& SPIRVPath, const uint32 framesInFlight, const bool useDrawIndirectCount, const bool readBack = false)
+	{
+		culler->device = GPU->device; culler->allocator = allocator;
+		culler->useDrawIndirectCount = useDrawIndirectCount; culler->readBack = readBack;
+
+		//descriptor set layout || object buffer, candidates, mesh draws, commands, counts
+		VkDescriptorSetLayoutBinding bindings[5] = {};
+		for (uint32 i = 0; i < 5; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 5;
+		layoutInfo.pBindings = bindings;
+		if (vkCreateDescriptorSetLayout(culler->device, &layoutInfo, nullptr, &culler->descriptorSetLayout) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_Init", "Failed to create the descriptor set layout!");
+			return false;
+		}
+
+		//descriptor pool and sets
+		VkDescriptorPoolSize poolSize = {};
+		poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSize.descriptorCount = 5 * framesInFlight;
+
+		VkDescriptorPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.maxSets = framesInFlight;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+		if (vkCreateDescriptorPool(culler->device, &poolInfo, nullptr, &culler->descriptorPool) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_Init", "Failed to create the descriptor pool!");
+			return false;
+		}
+
+		std::vector<VkDescriptorSetLayout> layouts(framesInFlight, culler->descriptorSetLayout);
+		culler->descriptorSets.resize(framesInFlight);
+
+		VkDescriptorSetAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = culler->descriptorPool;
+		allocInfo.descriptorSetCount = framesInFlight;
+		allocInfo.pSetLayouts = layouts.data();
+		if (vkAllocateDescriptorSets(culler->device, &allocInfo, culler->descriptorSets.data()) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_Init", "Failed to allocate the descriptor sets!");
+			return false;
+		}
+
+		//pipeline
+		VkPushConstantRange pushConstantRange = {};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.size = sizeof(GPUCull_PushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &culler->descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		if (vkCreatePipelineLayout(culler->device, &pipelineLayoutInfo, nullptr, &culler->pipelineLayout) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_Init", "Failed to create the pipeline layout!");
+			return false;
+		}
+
+		culler->pipeline = Util::ComputePipeline_CreateFromFile(culler->device, SPIRVPath, culler->pipelineLayout);
+		if (culler->pipeline == VK_NULL_HANDLE)
+			return false;
+
+		culler->meshDrawBuffers.resize(framesInFlight); culler->meshDrawCounts.resize(framesInFlight, 0);
+		culler->candidateBuffers.resize(framesInFlight); culler->commandBuffers.resize(framesInFlight); culler->countBuffers.resize(framesInFlight);
+		culler->candidateCounts.resize(framesInFlight, 0); culler->commandCounts.resize(framesInFlight, 0); culler->batchCounts.resize(framesInFlight, 0);
+
+		return true;
+	}
+
+	//destroys the occlusion culling of a GPU culler, leaving it frustum culling
+	inline void GPUCuller_DestroyOcclusion(GPUCuller* culler)
+	{
+		if (culler->device == VK_NULL_HANDLE)
+			return;
+
+		for (size_t i = 0; i < culler->occlusionDataBuffers.size(); ++i)
+		{
+			Util::GPUBuffer_Destroy(&culler->occlusionDataBuffers[i], culler->allocator);
+			Util::GPUBuffer_Destroy(&culler->rejectedBuffers[i], culler->allocator);
+		}
+
+		for (uint32 p = 0; p < 2; ++p)
+		{
+			if (culler->occlusionPipelines[p] != VK_NULL_HANDLE)
+				vkDestroyPipeline(culler->device, culler->occlusionPipelines[p], nullptr);
+			culler->occlusionPipelines[p] = VK_NULL_HANDLE;
+		}
+		if (culler->occlusionPipelineLayout != VK_NULL_HANDLE)
+			vkDestroyPipelineLayout(culler->device, culler->occlusionPipelineLayout, nullptr);
+		if (culler->occlusionDescriptorPool != VK_NULL_HANDLE)
+			vkDestroyDescriptorPool(culler->device, culler->occlusionDescriptorPool, nullptr);
+		if (culler->occlusionDescriptorSetLayout != VK_NULL_HANDLE)
+			vkDestroyDescriptorSetLayout(culler->device, culler->occlusionDescriptorSetLayout, nullptr);
+
+		culler->occlusion = false;
+		culler->occlusionDescriptorSetLayout = VK_NULL_HANDLE; culler->occlusionDescriptorPool = VK_NULL_HANDLE;
+		culler->occlusionDescriptorSets.clear(); culler->occlusionPipelineLayout = VK_NULL_HANDLE;
+		culler->occlusionDataBuffers.clear(); culler->rejectedBuffers.clear();
+	}
+
+	//destroys the GPU culler
+	inline void GPUCuller_Destroy(GPUCuller* culler)
+	{
+		if (culler->device == VK_NULL_HANDLE)
+			return;
+
+		GPUCuller_DestroyOcclusion(culler);
+
+		for (size_t i = 0; i < culler->candidateBuffers.size(); ++i)
+		{
+			Util::GPUBuffer_Destroy(&culler->meshDrawBuffers[i], culler->allocator);
+			Util::GPUBuffer_Destroy(&culler->candidateBuffers[i], culler->allocator);
+			Util::GPUBuffer_Destroy(&culler->commandBuffers[i], culler->allocator);
+			Util::GPUBuffer_Destroy(&culler->countBuffers[i], culler->allocator);
+		}
+
+		if (culler->pipeline != VK_NULL_HANDLE)
+			vkDestroyPipeline(culler->device, culler->pipeline, nullptr);
+		if (culler->pipelineLayout != VK_NULL_HANDLE)
+			vkDestroyPipelineLayout(culler->device, culler->pipelineLayout, nullptr);
+		if (culler->descriptorPool != VK_NULL_HANDLE)
+			vkDestroyDescriptorPool(culler->device, culler->descriptorPool, nullptr);
+		if (culler->descriptorSetLayout != VK_NULL_HANDLE)
+			vkDestroyDescriptorSetLayout(culler->device, culler->descriptorSetLayout, nullptr);
+
+		*culler = GPUCuller();
+	}
+
+	//adds two phase occlusion culling to a GPU culler || the shader is shaders/GPUCull.comp compiled with OCCLUSION_CULLING,
+	//each phase is a pipeline of it with OCCLUSION_PHASE specialized
+	inline bool GPUCuller_InitOcclusion(GPUCuller* culler, const std::string& SPIRVPath)
+	{
+		const uint32 framesInFlight = (uint32)culler->descriptorSets.size();
+
+		//descriptor set layout || the frustum cull's buffers, then the occlusion data, the pyramid levels and the rejected flags
+		VkDescriptorSetLayoutBinding bindings[8] = {};
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		bindings[6].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[6].descriptorCount = SMOK_RENDERER_GPU_CULL_MAX_PYRAMID_LEVELS;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 8;
+		layoutInfo.pBindings = bindings;
+		if (vkCreateDescriptorSetLayout(culler->device, &layoutInfo, nullptr, &culler->occlusionDescriptorSetLayout) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_InitOcclusion", "Failed to create the descriptor set layout!");
+			return false;
+		}
+
+		//descriptor pool and sets
+		VkDescriptorPoolSize poolSizes[2] = {};
+		poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSizes[0].descriptorCount = 7 * framesInFlight;
+		poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		poolSizes[1].descriptorCount = SMOK_RENDERER_GPU_CULL_MAX_PYRAMID_LEVELS * framesInFlight;
+
+		VkDescriptorPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.maxSets = framesInFlight;
+		poolInfo.poolSizeCount = 2;
+		poolInfo.pPoolSizes = poolSizes;
+		if (vkCreateDescriptorPool(culler->device, &poolInfo, nullptr, &culler->occlusionDescriptorPool) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_InitOcclusion", "Failed to create the descriptor pool!");
+			return false;
+		}
+
+		std::vector<VkDescriptorSetLayout> layouts(framesInFlight, culler->occlusionDescriptorSetLayout);
+		culler->occlusionDescriptorSets.resize(framesInFlight);
+
+		VkDescriptorSetAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = culler->occlusionDescriptorPool;
+		allocInfo.descriptorSetCount = framesInFlight;
+		allocInfo.pSetLayouts = layouts.data();
+		if (vkAllocateDescriptorSets(culler->device, &allocInfo, culler->occlusionDescriptorSets.data()) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_InitOcclusion", "Failed to allocate the descriptor sets!");
+			return false;
+		}
+
+		//pipelines, the same push constants as the frustum cull
+		VkPushConstantRange pushConstantRange = {};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.size = sizeof(GPUCull_PushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &culler->occlusionDescriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		if (vkCreatePipelineLayout(culler->device, &pipelineLayoutInfo, nullptr, &culler->occlusionPipelineLayout) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_InitOcclusion", "Failed to create the pipeline layout!");
+			return false;
+		}
+
+		for (uint32 p = 0; p < 2; ++p)
+		{
+			const uint32 phase = p + 1;
+			VkSpecializationMapEntry entry = { 0, 0, sizeof(uint32) };
+			VkSpecializationInfo specialization = {};
+			specialization.mapEntryCount = 1;
+			specialization.pMapEntries = &entry;
+			specialization.dataSize = sizeof(uint32);
+			specialization.pData = &phase;
+
+			culler->occlusionPipelines[p] = Util::ComputePipeline_CreateFromFile(culler->device, SPIRVPath, culler->occlusionPipelineLayout,
+				&specialization);
+			if (culler->occlusionPipelines[p] == VK_NULL_HANDLE)
+				return false;
+		}
+
+		//the occlusion data is rewritten every frame, the rejected flags are sized with the candidates
+		culler->occlusionDataBuffers.resize(framesInFlight); culler->rejectedBuffers.resize(framesInFlight);
+		for (uint32 f = 0; f < framesInFlight; ++f)
+		{
+			if (!Util::GPUBuffer_Create(&culler->occlusionDataBuffers[f], culler->allocator, sizeof(GPUCull_OcclusionData),
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU))
+				return false;
+		}
+
+		//the command and count buffers grow to hold both phases the next time the candidates are uploaded
+		culler->occlusion = true;
+		return true;
+	}
+
+	//uploads the mesh draw table of a frame || only the draws added since the frame's last upload are written, since mesh draws are only ever appended
+	//the frame's slot was last read by the frame the fence before recording waited on, so growing it needs no device wait
+	inline bool GPUCuller_UploadMeshDraws(GPUCuller* culler, const uint32 frameIndex, const std::vector<GPUCull_MeshDraw>& meshDraws)
+	{
+		if (meshDraws.size() == culler->meshDrawCounts[frameIndex] || meshDraws.empty())
+			return true;
+
+		Util::GPUBuffer* meshDrawBuffer = &culler->meshDrawBuffers[frameIndex];
+		const VkBuffer oldBuffer = meshDrawBuffer->buffer;
+		if (!Util::GPUBuffer_EnsureSize(meshDrawBuffer, culler->allocator, sizeof(GPUCull_MeshDraw) * meshDraws.size(),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU))
+			return false;
+
+		//the already uploaded draws never change, so only the new ones are written, unless the buffer was remade
+		const size_t firstNew = (oldBuffer == meshDrawBuffer->buffer ? culler->meshDrawCounts[frameIndex] : 0);
+		Util::GPUBuffer_Write(meshDrawBuffer, culler->allocator, meshDraws.data() + firstNew,
+			sizeof(GPUCull_MeshDraw) * (meshDraws.size() - firstNew), sizeof(GPUCull_MeshDraw) * firstNew);
+
+		culler->meshDrawCounts[frameIndex] = (uint32)meshDraws.size();
+		return true;
+	}
+
+	//uploads the candidates of a frame and sizes the command and count buffers
+	inline bool GPUCuller_UploadCandidates(GPUCuller* culler, const uint32 frameIndex,
+		const std::vector<GPUCull_Candidate>& candidates, const uint32 commandCount, const uint32 batchCount)
+	{
+		culler->candidateCounts[frameIndex] = (uint32)candidates.size();
+		culler->commandCounts[frameIndex] = commandCount;
+		culler->batchCounts[frameIndex] = batchCount;
+		if (candidates.empty())
+			return true;
+
+		const VmaMemoryUsage outputMemory = (culler->readBack ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY);
+
+		//occlusion culling writes phase two's commands and counts after phase one's
+		const size_t phaseCount = (culler->occlusion ? 2 : 1);
+		if (!Util::GPUBuffer_EnsureSize(&culler->candidateBuffers[frameIndex], culler->allocator, sizeof(GPUCull_Candidate) * candidates.size(),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU) ||
+			!Util::GPUBuffer_EnsureSize(&culler->commandBuffers[frameIndex], culler->allocator,
+				sizeof(VkDrawIndexedIndirectCommand) * commandCount * phaseCount,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, outputMemory) ||
+			!Util::GPUBuffer_EnsureSize(&culler->countBuffers[frameIndex], culler->allocator, sizeof(uint32) * batchCount * phaseCount,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, outputMemory) ||
+			(culler->occlusion && !Util::GPUBuffer_EnsureSize(&culler->rejectedBuffers[frameIndex], culler->allocator, sizeof(uint32) * candidates.size(),
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY)))
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_UploadCandidates", "Failed to size the cull buffers!");
+			return false;
+		}
+
+		Util::GPUBuffer_Write(&culler->candidateBuffers[frameIndex], culler->allocator, candidates.data(), sizeof(GPUCull_Candidate) * candidates.size());
+		return true;
+	}
+
+	//records the cull dispatch || must be recorded outside of a render pass, before the draws that use it
+	inline void GPUCuller_RecordCull(GPUCuller* culler, VkCommandBuffer comBuffer, const uint32 frameIndex,
+		VkBuffer objectBuffer, const VkDeviceSize objectBufferSize, GPUCull_PushConstants pc, Dispatch* dispatch = nullptr)
+	{
+		const uint32 candidateCount = culler->candidateCounts[frameIndex];
+		if (!candidateCount || culler->meshDrawBuffers[frameIndex].buffer == VK_NULL_HANDLE)
+			return;
+
+		//without a count buffer every slot is written, so culled draws need to be there with 0 instances
+		pc.candidateCount = candidateCount;
+		pc.compact = (culler->useDrawIndirectCount ? 1 : 0);
+
+		//binds the buffers of this frame || the object buffer can be remade when it grows, so this is done every frame
+		VkDescriptorBufferInfo bufferInfos[5] = {};
+		bufferInfos[0] = { objectBuffer, 0, objectBufferSize };
+		bufferInfos[1] = { culler->candidateBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+		bufferInfos[2] = { culler->meshDrawBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+		bufferInfos[3] = { culler->commandBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+		bufferInfos[4] = { culler->countBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+
+		VkWriteDescriptorSet writes[5] = {};
+		for (uint32 i = 0; i < 5; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = culler->descriptorSets[frameIndex];
+			writes[i].dstBinding = i;
+			writes[i].descriptorCount = 1;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
+		Dispatch_UpdateDescriptorSets(dispatch, culler->device, 5, writes);
+
+		//clears the counts
+		Dispatch_CmdFillBuffer(dispatch, comBuffer, culler->countBuffers[frameIndex].buffer, 0, sizeof(uint32) * culler->batchCounts[frameIndex], 0);
+
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		//culls
+		Dispatch_CmdBindPipeline(dispatch, comBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->pipeline);
+		Dispatch_CmdBindDescriptorSets(dispatch, comBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->pipelineLayout, 0, 1,
+			&culler->descriptorSets[frameIndex]);
+		Dispatch_CmdPushConstants(dispatch, comBuffer, culler->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUCull_PushConstants), &pc);
+		Dispatch_CmdDispatch(dispatch, comBuffer, (candidateCount + SMOK_RENDERER_GPU_CULL_WORKGROUP_SIZE - 1) / SMOK_RENDERER_GPU_CULL_WORKGROUP_SIZE, 1, 1);
+
+		//makes the commands visible to the indirect draws, and to the host if reading back
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | (culler->readBack ? VK_ACCESS_HOST_READ_BIT : 0);
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | (culler->readBack ? VK_PIPELINE_STAGE_HOST_BIT : 0),
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	//records a phase of the occlusion cull, needs GPUCuller_InitOcclusion || must be recorded outside of a render pass
+	//phase one tests against the pyramid's last build and is drawn by GPUCuller_DrawBatch, then once that depth has been built into the pyramid
+	//phase two re-tests what phase one rejected and is drawn by GPUCuller_DrawBatch with GPUCull_OcclusionPhase::PhaseTwo
+	//the pyramid must have been recorded before phase one, use GPUCuller_RecordCull until it has
+	inline void GPUCuller_RecordOcclusionCull(GPUCuller* culler, VkCommandBuffer comBuffer, const uint32 frameIndex,
+		VkBuffer objectBuffer, const VkDeviceSize objectBufferSize, GPUCull_PushConstants pc, const GPUCull_OcclusionPhase phase,
+		const glm::mat4& PV, const GPUDepthPyramid* pyramid, Dispatch* dispatch = nullptr)
+	{
+		const uint32 candidateCount = culler->candidateCounts[frameIndex];
+		if (!culler->occlusion || phase == GPUCull_OcclusionPhase::None || !candidateCount ||
+			culler->meshDrawBuffers[frameIndex].buffer == VK_NULL_HANDLE)
+			return;
+
+		pc.candidateCount = candidateCount;
+		pc.compact = (culler->useDrawIndirectCount ? 1 : 0);
+
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		if (phase == GPUCull_OcclusionPhase::PhaseOne)
+		{
+			GPUCull_OcclusionData occlusionData;
+			occlusionData.PV = PV;
+			occlusionData.pyramidWidth = pyramid->levels[0].width; occlusionData.pyramidHeight = pyramid->levels[0].height;
+			occlusionData.pyramidLevelCount = (uint32)std::min(pyramid->levels.size(), (size_t)SMOK_RENDERER_GPU_CULL_MAX_PYRAMID_LEVELS);
+			occlusionData.phaseTwoCommandOffset = culler->commandCounts[frameIndex];
+			occlusionData.phaseTwoCountOffset = culler->batchCounts[frameIndex];
+			Util::GPUBuffer_Write(&culler->occlusionDataBuffers[frameIndex], culler->allocator, &occlusionData, sizeof(GPUCull_OcclusionData));
+
+			//binds the buffers and pyramid of this frame, both phases use them || unused level slots repeat the last level
+			VkDescriptorBufferInfo bufferInfos[7] = {};
+			bufferInfos[0] = { objectBuffer, 0, objectBufferSize };
+			bufferInfos[1] = { culler->candidateBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+			bufferInfos[2] = { culler->meshDrawBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+			bufferInfos[3] = { culler->commandBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+			bufferInfos[4] = { culler->countBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+			bufferInfos[5] = { culler->occlusionDataBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+			bufferInfos[6] = { culler->rejectedBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+
+			VkDescriptorImageInfo levelInfos[SMOK_RENDERER_GPU_CULL_MAX_PYRAMID_LEVELS] = {};
+			for (uint32 l = 0; l < SMOK_RENDERER_GPU_CULL_MAX_PYRAMID_LEVELS; ++l)
+				levelInfos[l] = { pyramid->sampler, pyramid->levels[std::min(l, occlusionData.pyramidLevelCount - 1)].view, VK_IMAGE_LAYOUT_GENERAL };
+
+			VkWriteDescriptorSet writes[8] = {};
+			for (uint32 i = 0; i < 8; ++i)
+			{
+				writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[i].dstSet = culler->occlusionDescriptorSets[frameIndex];
+				writes[i].dstBinding = i;
+				writes[i].descriptorCount = 1;
+				writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				writes[i].pBufferInfo = &bufferInfos[i < 6 ? i : i - 1];
+			}
+			writes[6].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			writes[6].descriptorCount = SMOK_RENDERER_GPU_CULL_MAX_PYRAMID_LEVELS;
+			writes[6].pBufferInfo = nullptr;
+			writes[6].pImageInfo = levelInfos;
+			Dispatch_UpdateDescriptorSets(dispatch, culler->device, 8, writes);
+
+			//clears the counts of both phases
+			Dispatch_CmdFillBuffer(dispatch, comBuffer, culler->countBuffers[frameIndex].buffer, 0,
+				sizeof(uint32) * culler->batchCounts[frameIndex] * 2, 0);
+
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+		}
+		else
+		{
+			//phase two reads the flags phase one wrote
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				0, 1, &barrier, 0, nullptr, 0, nullptr);
+		}
+
+		//culls
+		Dispatch_CmdBindPipeline(dispatch, comBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+			culler->occlusionPipelines[phase == GPUCull_OcclusionPhase::PhaseOne ? 0 : 1]);
+		Dispatch_CmdBindDescriptorSets(dispatch, comBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->occlusionPipelineLayout, 0, 1,
+			&culler->occlusionDescriptorSets[frameIndex]);
+		Dispatch_CmdPushConstants(dispatch, comBuffer, culler->occlusionPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+			sizeof(GPUCull_PushConstants), &pc);
+		Dispatch_CmdDispatch(dispatch, comBuffer, (candidateCount + SMOK_RENDERER_GPU_CULL_WORKGROUP_SIZE - 1) / SMOK_RENDERER_GPU_CULL_WORKGROUP_SIZE, 1, 1);
+
+		//makes the commands visible to the indirect draws, and to the host if reading back
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | (culler->readBack ? VK_ACCESS_HOST_READ_BIT : 0);
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | (culler->readBack ? VK_PIPELINE_STAGE_HOST_BIT : 0),
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	//draws the commands of a batch || the pipeline, descriptor sets and mega mesh buffer must already be bound
+	//GPUCull_OcclusionPhase::PhaseTwo draws what the second occlusion phase recovered, the others draw what the cull or phase one kept
+	inline void GPUCuller_DrawBatch(GPUCuller* culler, VkCommandBuffer comBuffer, const uint32 frameIndex,
+		const uint32 batchIndex, const uint32 commandBase, const uint32 maxDrawCount,
+		const GPUCull_OcclusionPhase phase = GPUCull_OcclusionPhase::None, Dispatch* dispatch = nullptr)
+	{
+		if (!maxDrawCount || !culler->candidateCounts[frameIndex])
+			return;
+
+		//phase two's commands and counts are after phase one's
+		const bool phaseTwo = (phase == GPUCull_OcclusionPhase::PhaseTwo);
+		const uint32 commandOffset = (phaseTwo ? culler->commandCounts[frameIndex] : 0);
+		const uint32 countOffset = (phaseTwo ? culler->batchCounts[frameIndex] : 0);
+
+		const VkDeviceSize offset = sizeof(VkDrawIndexedIndirectCommand) * (commandOffset + commandBase);
+		if (culler->useDrawIndirectCount)
+			Dispatch_CmdDrawIndexedIndirectCount(dispatch, comBuffer, culler->commandBuffers[frameIndex].buffer, offset,
+				culler->countBuffers[frameIndex].buffer, sizeof(uint32) * (countOffset + batchIndex),
+				maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+		else
+			Dispatch_CmdDrawIndexedIndirect(dispatch, comBuffer, culler->commandBuffers[frameIndex].buffer, offset,
+				maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+	}
+
+	//reads back the commands and counts of a frame, phase one's when occlusion culling || needs readBack, and the frame's fence to have been waited on
+	inline bool GPUCuller_ReadBack(GPUCuller* culler, const uint32 frameIndex,
+		std::vector<VkDrawIndexedIndirectCommand>& commands, std::vector<uint32>& counts)
+	{
+		if (!culler->readBack)
+		{
+			BTD_LogError("Smok Renderer", "GPU Culler", "GPUCuller_ReadBack", "The culler was not made with read back on!");
+			return false;
+		}
+
+		commands.resize(culler->commandCounts[frameIndex]);
+		counts.resize(culler->batchCounts[frameIndex]);
+		if (commands.empty())
+			return true;
+
+		vmaInvalidateAllocation(culler->allocator, culler->commandBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+		vmaInvalidateAllocation(culler->allocator, culler->countBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+		memcpy(commands.data(), culler->commandBuffers[frameIndex].allocationInfo.pMappedData, sizeof(VkDrawIndexedIndirectCommand) * commands.size());
+		memcpy(counts.data(), culler->countBuffers[frameIndex].allocationInfo.pMappedData, sizeof(uint32) * counts.size());
+
+		return true;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+//defines occlusion culling of bounding spheres against a depth pyramid
+//the pyramid is built on the GPU from the depth attachment (GPUDepthPyramid) and tested against by the GPU culler,
+//or for headless testing from occluders drawn by the CPU software rasterizer, which is the reference the GPU path is compared against
+//both are two phase: objects are tested against last frame's pyramid, the visible ones are drawn and make a new pyramid,
+//then the rejected ones are tested again against the new pyramid so nothing that became visible is lost
+
+#include <SmokRenderers/Culling/DepthPyramid.hpp>
+
+#include <string>
+
+namespace Smok::Renderers::Culling
+{
+	//defines the settings for occlusion culling
+	struct OcclusionSettings
+	{
+		uint32 depthWidth = 256, depthHeight = 128; //the size of level 0 of the pyramid, the GPU path reduces the depth attachment down to it
+		uint32 maxOccluderTriangleCount = 16384; //meshes with more triangles then this are not drawn as occluders by the software rasterizer
+	};
+
+	//defines the occlusion culling stats of a frame
+	struct OcclusionCullStats
+	{
+		uint32 testedObjectCount = 0; //the objects tested
+		uint32 phaseOneOccludedCount = 0; //the objects rejected against last frame's pyramid
+		uint32 phaseTwoRecoveredCount = 0; //the rejected objects that were visible against the new pyramid
+		uint32 occludedObjectCount = 0; //the objects not drawn
+		uint32 occluderCount = 0; //the objects drawn into the depth buffer, only by the software rasterizer
+		uint64 occluderTriangleCount = 0; //the triangles drawn into the depth buffer, only by the software rasterizer
+		bool GPUPyramid = false; //if the GPU culler tested the objects, it's phase counts stay on the GPU
+
+		//resets the stats
+		inline void Reset() { *this = OcclusionCullStats(); }
+
+		//converts the stats into a human readable string
+		inline std::string ToString() const
+		{
+			if (GPUPyramid)
+				return "Occlusion (GPU pyramid): " + std::to_string(testedObjectCount) + " objects tested in two phases by the GPU culler";
+
+			return "Occlusion: " + std::to_string(occludedObjectCount) + "/" + std::to_string(testedObjectCount) + " objects occluded, " +
+				std::to_string(phaseOneOccludedCount) + " rejected in phase one, " + std::to_string(phaseTwoRecoveredCount) + " recovered in phase two\n" +
+				"Occluders: " + std::to_string(occluderCount) + " objects, " + std::to_string(occluderTriangleCount) + " triangles";
+		}
+	};
+
+	//projects a world space sphere to a pixel rect and it's nearest depth || returns false if it can't be tested, like when it crosses the near plane
+	inline bool OcclusionCuller_ProjectSphere(const glm::vec4& worldSphere, const glm::mat4& PV,
+		const uint32 width, const uint32 height,
+		uint32& minX, uint32& minY, uint32& maxX, uint32& maxY, float& nearestDepth)
+	{
+		//projects the corners of the box around the sphere, which is conservative
+		float ndcMinX = 1.0f, ndcMinY = 1.0f, ndcMaxX = -1.0f, ndcMaxY = -1.0f;
+		nearestDepth = 1.0f;
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			const glm::vec4 corner = glm::vec4(worldSphere.x + ((i & 1) ? worldSphere.w : -worldSphere.w),
+				worldSphere.y + ((i & 2) ? worldSphere.w : -worldSphere.w),
+				worldSphere.z + ((i & 4) ? worldSphere.w : -worldSphere.w), 1.0f);
+			const glm::vec4 clip = PV * corner;
+			if (clip.w <= 0.0f || clip.z < 0.0f)
+				return false;
+
+			const float invW = 1.0f / clip.w;
+			ndcMinX = std::min(ndcMinX, clip.x * invW); ndcMaxX = std::max(ndcMaxX, clip.x * invW);
+			ndcMinY = std::min(ndcMinY, clip.y * invW); ndcMaxY = std::max(ndcMaxY, clip.y * invW);
+			nearestDepth = std::min(nearestDepth, clip.z * invW);
+		}
+
+		//off screen is for the frustum cull to decide
+		if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f)
+			return false;
+
+		auto toPixel = [](const float ndc, const uint32 size) {
+			return (uint32)std::min(std::max((ndc * 0.5f + 0.5f) * (float)size, 0.0f), (float)(size - 1));
+		};
+		minX = toPixel(ndcMinX, width); maxX = toPixel(ndcMaxX, width);
+		minY = toPixel(ndcMinY, height); maxY = toPixel(ndcMaxY, height);
+
+		return true;
+	}
+
+	//checks if a world space sphere is fully hidden by the depth in a pyramid
+	inline bool OcclusionCuller_IsOccluded(const DepthPyramid& pyramid, const glm::vec4& worldSphere, const glm::mat4& PV)
+	{
+		if (!DepthPyramid_IsBuilt(pyramid))
+			return false;
+
+		uint32 minX = 0, minY = 0, maxX = 0, maxY = 0; float nearestDepth = 1.0f;
+		if (!OcclusionCuller_ProjectSphere(worldSphere, PV, pyramid.levels[0].width, pyramid.levels[0].height,
+			minX, minY, maxX, maxY, nearestDepth))
+			return false;
+
+		return nearestDepth > DepthPyramid_SampleMax(pyramid, minX, minY, maxX, maxY);
+	}
+}
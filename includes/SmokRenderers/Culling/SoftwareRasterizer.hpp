@@ -0,0 +1,142 @@
+#pragma once
+
+//defines a small CPU depth only rasterizer, used to draw occluders for occlusion culling without the GPU
+
+#include <SmokMesh/Mesh.hpp>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <algorithm>
+
+namespace Smok::Renderers::Culling
+{
+	//defines a CPU depth buffer || zero to one depth, 1 is the far plane
+	struct DepthBuffer
+	{
+		uint32 width = 0, height = 0;
+		std::vector<float> depth; //row major, width * height
+	};
+
+	//resizes and clears a depth buffer to the far plane
+	inline void DepthBuffer_Clear(DepthBuffer* buffer, const uint32 width, const uint32 height)
+	{
+		buffer->width = width; buffer->height = height;
+		buffer->depth.assign((size_t)width * (size_t)height, 1.0f);
+	}
+
+	//rasterizes a triangle already clipped to the near plane, in pixel space with xy in pixels and z as depth
+	inline void SoftwareRasterizer_DrawScreenTriangle(DepthBuffer* buffer, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+	{
+		const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		if (area == 0.0f)
+			return;
+
+		//both windings are drawn, occluders don't need backfaces culled
+		const float sign = (area < 0.0f ? -1.0f : 1.0f);
+		const float invArea = 1.0f / (area * sign);
+
+		const int32 minX = std::max((int32)std::floor(std::min(a.x, std::min(b.x, c.x))), 0);
+		const int32 maxX = std::min((int32)std::ceil(std::max(a.x, std::max(b.x, c.x))), (int32)buffer->width - 1);
+		const int32 minY = std::max((int32)std::floor(std::min(a.y, std::min(b.y, c.y))), 0);
+		const int32 maxY = std::min((int32)std::ceil(std::max(a.y, std::max(b.y, c.y))), (int32)buffer->height - 1);
+
+		for (int32 y = minY; y <= maxY; ++y)
+		{
+			const float py = (float)y + 0.5f;
+			for (int32 x = minX; x <= maxX; ++x)
+			{
+				const float px = (float)x + 0.5f;
+
+				//barycentrics from the edge functions || each is evaluated on it's own, since a edge shared by two triangles
+				//then gives exactly negated values in each and every pixel on it is drawn by one of them, without cracks
+				const float e0 = ((b.x - px) * (c.y - py) - (b.y - py) * (c.x - px)) * sign;
+				const float e1 = ((c.x - px) * (a.y - py) - (c.y - py) * (a.x - px)) * sign;
+				const float e2 = ((a.x - px) * (b.y - py) - (a.y - py) * (b.x - px)) * sign;
+				if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f)
+					continue;
+
+				const float w0 = e0 * invArea, w1 = e1 * invArea, w2 = e2 * invArea;
+
+				//depth is linear in screen space after the perspective divide
+				const float z = w0 * a.z + w1 * b.z + w2 * c.z;
+				float& dst = buffer->depth[(size_t)y * buffer->width + x];
+				if (z < dst)
+					dst = z;
+			}
+		}
+	}
+
+	//rasterizes a clip space triangle, clipping it against the near plane
+	inline void SoftwareRasterizer_DrawTriangle(DepthBuffer* buffer, const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+	{
+		//clips against z >= 0, a triangle can become a quad
+		glm::vec4 in[3] = { a, b, c };
+		glm::vec4 out[4];
+		uint32 outCount = 0;
+		for (uint32 i = 0; i < 3; ++i)
+		{
+			const glm::vec4& p = in[i];
+			const glm::vec4& q = in[(i + 1) % 3];
+			const bool pInside = p.z >= 0.0f, qInside = q.z >= 0.0f;
+
+			if (pInside)
+				out[outCount++] = p;
+			if (pInside != qInside)
+			{
+				const float t = p.z / (p.z - q.z);
+				out[outCount++] = p + (q - p) * t;
+			}
+		}
+
+		if (outCount < 3)
+			return;
+
+		//to pixel space
+		glm::vec3 screen[4];
+		for (uint32 i = 0; i < outCount; ++i)
+		{
+			const float invW = 1.0f / out[i].w;
+			screen[i] = glm::vec3((out[i].x * invW * 0.5f + 0.5f) * (float)buffer->width,
+				(out[i].y * invW * 0.5f + 0.5f) * (float)buffer->height,
+				out[i].z * invW);
+		}
+
+		SoftwareRasterizer_DrawScreenTriangle(buffer, screen[0], screen[1], screen[2]);
+		if (outCount == 4)
+			SoftwareRasterizer_DrawScreenTriangle(buffer, screen[0], screen[2], screen[3]);
+	}
+
+	//rasterizes a indexed mesh || PVM is projection * view * model, returns the triangles drawn
+	inline uint32 SoftwareRasterizer_DrawMesh(DepthBuffer* buffer, const glm::mat4& PVM,
+		const glm::vec3* positions, const size_t positionCount, const size_t stride,
+		const uint32* indices, const size_t indexCount)
+	{
+		uint32 triangleCount = 0;
+		for (size_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			if (indices[i] >= positionCount || indices[i + 1] >= positionCount || indices[i + 2] >= positionCount)
+				continue;
+
+			const glm::vec3& p0 = *(const glm::vec3*)((const uint8*)positions + stride * indices[i]);
+			const glm::vec3& p1 = *(const glm::vec3*)((const uint8*)positions + stride * indices[i + 1]);
+			const glm::vec3& p2 = *(const glm::vec3*)((const uint8*)positions + stride * indices[i + 2]);
+
+			SoftwareRasterizer_DrawTriangle(buffer, PVM * glm::vec4(p0.x, p0.y, p0.z, 1.0f),
+				PVM * glm::vec4(p1.x, p1.y, p1.z, 1.0f), PVM * glm::vec4(p2.x, p2.y, p2.z, 1.0f));
+			triangleCount++;
+		}
+
+		return triangleCount;
+	}
+
+	//rasterizes a mesh || PVM is projection * view * model, returns the triangles drawn
+	inline uint32 SoftwareRasterizer_DrawMesh(DepthBuffer* buffer, const glm::mat4& PVM, const Smok::Mesh::Mesh& mesh)
+	{
+		if (mesh.vertices.empty())
+			return 0;
+
+		return SoftwareRasterizer_DrawMesh(buffer, PVM, &mesh.vertices[0].position, mesh.vertices.size(), sizeof(Smok::Mesh::Vertex),
+			mesh.indices.data(), mesh.indices.size());
+	}
+}
@@ -0,0 +1,1164 @@
+#pragma once
+
+//defines a thin layer between the renderers and Vulkan, so their commands can go to the device, go nowhere, or be recorded
+//a recording is a compact binary trace of the binds, draws, barriers, copies, render passes, descriptor writes and uploads, that can be saved and replayed later
+//against a real or software device, to measure submission cost on it's own or to check what a frame did without a device
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Smok::Renderers
+{
+#define SMOK_RENDERER_COMMAND_TRACE_MAGIC 0x52544D53 //"SMTR"
+#define SMOK_RENDERER_COMMAND_TRACE_VERSION 2
+
+	//defines where commands go
+	enum class DispatchBackend
+	{
+		Vulkan = 0, //calls Vulkan
+		Null, //calls nothing, for running the renderers without a device || pair it with a trace to record what they did
+
+		Count
+	};
+
+	//defines the commands in a trace
+	enum class CommandTrace_Op : uint8
+	{
+		Frame = 0, //the start of a frame
+		BindPipeline,
+		BindDescriptorSets,
+		SetViewport,
+		SetScissor,
+		PushConstants,
+		BindMegaMeshBuffer, //the mega mesh buffer's vertex and index buffers, the replay binds it's own
+		Draw,
+		DrawIndexed,
+		DrawIndexedIndirect,
+		DrawIndexedIndirectCount,
+		Dispatch,
+		DescriptorWrite,
+		Upload,
+		PipelineBarrier,
+		FillBuffer,
+		CopyBuffer,
+		CopyBufferToImage,
+		CopyImageToBuffer,
+		BeginRenderPass,
+		EndRenderPass,
+		CopyImage,
+
+		Count
+	};
+
+	//gets the name of a trace command
+	inline const char* CommandTrace_OpToString(const CommandTrace_Op op)
+	{
+		static const char* names[(size_t)CommandTrace_Op::Count] = { "Frame", "BindPipeline", "BindDescriptorSets", "SetViewport", "SetScissor",
+			"PushConstants", "BindMegaMeshBuffer", "Draw", "DrawIndexed", "DrawIndexedIndirect", "DrawIndexedIndirectCount", "Dispatch",
+			"DescriptorWrite", "Upload", "PipelineBarrier", "FillBuffer", "CopyBuffer", "CopyBufferToImage", "CopyImageToBuffer",
+			"BeginRenderPass", "EndRenderPass", "CopyImage" };
+		return (op < CommandTrace_Op::Count ? names[(size_t)op] : "Unknown");
+	}
+
+	//defines a trace of commands
+	//each command is a op byte followed by it's arguments, integers and handles are LEB128 varints, so most commands are a few bytes
+	struct CommandTrace
+	{
+		std::vector<uint8> data; //the encoded commands
+		uint64 commandCounts[(size_t)CommandTrace_Op::Count] = {}; //the commands of each op
+		uint64 commandCount = 0;
+		uint64 uploadBytes = 0; //the bytes uploaded, kept or not
+
+		bool recordUploadData = false; //keeps the uploaded bytes so a replay can copy them || makes the trace a lot bigger
+
+		//converts the trace's counts into a human readable string
+		inline std::string ToString() const
+		{
+			std::string str = "Command Trace: " + std::to_string(commandCount) + " commands in " + std::to_string(data.size()) + " bytes, " +
+				std::to_string(uploadBytes) + " bytes uploaded";
+			for (size_t i = 0; i < (size_t)CommandTrace_Op::Count; ++i)
+			{
+				if (commandCounts[i] > 0)
+					str += "\n" + std::string(CommandTrace_OpToString((CommandTrace_Op)i)) + ": " + std::to_string(commandCounts[i]);
+			}
+			return str;
+		}
+	};
+
+	//defines where the renderers send their commands || a null dispatch pointer goes straight to Vulkan
+	struct Dispatch
+	{
+		DispatchBackend backend = DispatchBackend::Vulkan;
+		CommandTrace* trace = nullptr; //records every command when set, with either backend
+	};
+
+	//------------------------------------ENCODING-----------------------------------//
+
+	//clears a trace
+	inline void CommandTrace_Clear(CommandTrace* trace)
+	{
+		trace->data.clear();
+		for (size_t i = 0; i < (size_t)CommandTrace_Op::Count; ++i)
+			trace->commandCounts[i] = 0;
+		trace->commandCount = 0; trace->uploadBytes = 0;
+	}
+
+	//writes a unsigned varint
+	inline void CommandTrace_WriteUInt(CommandTrace* trace, uint64 value)
+	{
+		while (value >= 0x80)
+		{
+			trace->data.emplace_back((uint8)(value | 0x80));
+			value >>= 7;
+		}
+		trace->data.emplace_back((uint8)value);
+	}
+
+	//writes a signed varint, zigzagged so small negatives stay small
+	inline void CommandTrace_WriteInt(CommandTrace* trace, const int64 value)
+	{
+		CommandTrace_WriteUInt(trace, ((uint64)value << 1) ^ (uint64)(value >> 63));
+	}
+
+	//writes raw bytes
+	inline void CommandTrace_WriteBytes(CommandTrace* trace, const void* bytes, const size_t size)
+	{
+		if (!size)
+			return;
+
+		const size_t offset = trace->data.size();
+		trace->data.resize(offset + size);
+		memcpy(trace->data.data() + offset, bytes, size);
+	}
+
+	//writes a float
+	inline void CommandTrace_WriteFloat(CommandTrace* trace, const float value) { CommandTrace_WriteBytes(trace, &value, sizeof(float)); }
+
+	//writes a Vulkan handle
+	template<typename T>
+	inline void CommandTrace_WriteHandle(CommandTrace* trace, const T handle) { CommandTrace_WriteUInt(trace, (uint64)handle); }
+
+	//starts a command
+	inline void CommandTrace_BeginCommand(CommandTrace* trace, const CommandTrace_Op op)
+	{
+		trace->data.emplace_back((uint8)op);
+		trace->commandCounts[(size_t)op]++;
+		trace->commandCount++;
+	}
+
+	//defines a reader over a trace's data
+	struct CommandTrace_Reader
+	{
+		const uint8* data = nullptr;
+		size_t size = 0, offset = 0;
+		bool failed = false; //set when a read goes past the end
+	};
+
+	//reads a unsigned varint
+	inline uint64 CommandTrace_ReadUInt(CommandTrace_Reader* reader)
+	{
+		uint64 value = 0;
+		for (uint32 shift = 0; shift < 64; shift += 7)
+		{
+			if (reader->offset >= reader->size)
+			{
+				reader->failed = true;
+				return 0;
+			}
+
+			const uint8 byte = reader->data[reader->offset++];
+			value |= (uint64)(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+
+		reader->failed = true;
+		return value;
+	}
+
+	//reads a signed varint
+	inline int64 CommandTrace_ReadInt(CommandTrace_Reader* reader)
+	{
+		const uint64 value = CommandTrace_ReadUInt(reader);
+		return (int64)(value >> 1) ^ -(int64)(value & 1);
+	}
+
+	//reads raw bytes, returning where they are in the trace || nullptr if they go past the end
+	inline const uint8* CommandTrace_ReadBytes(CommandTrace_Reader* reader, const size_t size)
+	{
+		if (reader->offset + size > reader->size)
+		{
+			reader->failed = true;
+			return nullptr;
+		}
+
+		const uint8* bytes = reader->data + reader->offset;
+		reader->offset += size;
+		return bytes;
+	}
+
+	//reads a float
+	inline float CommandTrace_ReadFloat(CommandTrace_Reader* reader)
+	{
+		float value = 0.0f;
+		if (const uint8* bytes = CommandTrace_ReadBytes(reader, sizeof(float)))
+			memcpy(&value, bytes, sizeof(float));
+		return value;
+	}
+
+	//------------------------------------RECORDING-----------------------------------//
+
+	//is the dispatch calling Vulkan
+	inline bool Dispatch_IsExecuting(const Dispatch* dispatch) { return (!dispatch || dispatch->backend == DispatchBackend::Vulkan); }
+
+	//gets the trace of a dispatch, if it's recording
+	inline CommandTrace* Dispatch_GetTrace(const Dispatch* dispatch) { return (dispatch ? dispatch->trace : nullptr); }
+
+	//marks the start of a frame
+	inline void Dispatch_BeginFrame(Dispatch* dispatch, const uint64 frameNumber)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::Frame);
+			CommandTrace_WriteUInt(trace, frameNumber);
+		}
+	}
+
+	//records a pipeline bind || for binds made by other libraries, Dispatch_CmdBindPipeline makes it's own
+	inline void Dispatch_RecordBindPipeline(Dispatch* dispatch, const VkPipelineBindPoint bindPoint, VkPipeline pipeline)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::BindPipeline);
+			CommandTrace_WriteUInt(trace, (uint64)bindPoint);
+			CommandTrace_WriteHandle(trace, pipeline);
+		}
+	}
+
+	//records a viewport || for ones set by other libraries
+	inline void Dispatch_RecordSetViewport(Dispatch* dispatch, const VkViewport& viewport)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::SetViewport);
+			CommandTrace_WriteFloat(trace, viewport.x); CommandTrace_WriteFloat(trace, viewport.y);
+			CommandTrace_WriteFloat(trace, viewport.width); CommandTrace_WriteFloat(trace, viewport.height);
+			CommandTrace_WriteFloat(trace, viewport.minDepth); CommandTrace_WriteFloat(trace, viewport.maxDepth);
+		}
+	}
+
+	//records a scissor || for ones set by other libraries
+	inline void Dispatch_RecordSetScissor(Dispatch* dispatch, const VkRect2D& scissor)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::SetScissor);
+			CommandTrace_WriteInt(trace, scissor.offset.x); CommandTrace_WriteInt(trace, scissor.offset.y);
+			CommandTrace_WriteUInt(trace, scissor.extent.width); CommandTrace_WriteUInt(trace, scissor.extent.height);
+		}
+	}
+
+	//records the mega mesh buffer being bound
+	inline void Dispatch_RecordBindMegaMeshBuffer(Dispatch* dispatch)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::BindMegaMeshBuffer);
+	}
+
+	//records a indexed draw || for draws made by other libraries
+	inline void Dispatch_RecordDrawIndexed(Dispatch* dispatch, const uint32 indexCount, const uint32 instanceCount,
+		const uint32 firstIndex, const int32 vertexOffset, const uint32 firstInstance)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::DrawIndexed);
+			CommandTrace_WriteUInt(trace, indexCount); CommandTrace_WriteUInt(trace, instanceCount);
+			CommandTrace_WriteUInt(trace, firstIndex); CommandTrace_WriteInt(trace, vertexOffset);
+			CommandTrace_WriteUInt(trace, firstInstance);
+		}
+	}
+
+	//is a descriptor type written with buffer infos
+	inline bool Dispatch_IsBufferDescriptor(const VkDescriptorType type)
+	{
+		return (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+			type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC);
+	}
+
+	//is a descriptor type written with image infos
+	inline bool Dispatch_IsImageDescriptor(const VkDescriptorType type)
+	{
+		return (type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+			type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE || type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT);
+	}
+
+	//records descriptor writes || for writes made by other libraries, texel buffer writes only keep their counts
+	inline void Dispatch_RecordDescriptorWrites(Dispatch* dispatch, const uint32 writeCount, const VkWriteDescriptorSet* writes)
+	{
+		CommandTrace* trace = Dispatch_GetTrace(dispatch);
+		if (!trace)
+			return;
+
+		for (uint32 w = 0; w < writeCount; ++w)
+		{
+			const VkWriteDescriptorSet& write = writes[w];
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::DescriptorWrite);
+			CommandTrace_WriteHandle(trace, write.dstSet);
+			CommandTrace_WriteUInt(trace, write.dstBinding); CommandTrace_WriteUInt(trace, write.dstArrayElement);
+			CommandTrace_WriteUInt(trace, (uint64)write.descriptorType); CommandTrace_WriteUInt(trace, write.descriptorCount);
+
+			for (uint32 d = 0; d < write.descriptorCount; ++d)
+			{
+				if (Dispatch_IsBufferDescriptor(write.descriptorType) && write.pBufferInfo)
+				{
+					CommandTrace_WriteHandle(trace, write.pBufferInfo[d].buffer);
+					CommandTrace_WriteUInt(trace, write.pBufferInfo[d].offset); CommandTrace_WriteUInt(trace, write.pBufferInfo[d].range);
+				}
+				else if (Dispatch_IsImageDescriptor(write.descriptorType) && write.pImageInfo)
+				{
+					CommandTrace_WriteHandle(trace, write.pImageInfo[d].sampler); CommandTrace_WriteHandle(trace, write.pImageInfo[d].imageView);
+					CommandTrace_WriteUInt(trace, (uint64)write.pImageInfo[d].imageLayout);
+				}
+			}
+		}
+	}
+
+	//records a upload || target is the buffer or image the bytes end up in, so a replay can find where to copy them
+	inline void Dispatch_RecordUpload(Dispatch* dispatch, const uint64 target, const uint64 offset, const void* data, const size_t size)
+	{
+		CommandTrace* trace = Dispatch_GetTrace(dispatch);
+		if (!trace)
+			return;
+
+		CommandTrace_BeginCommand(trace, CommandTrace_Op::Upload);
+		CommandTrace_WriteUInt(trace, target); CommandTrace_WriteUInt(trace, offset); CommandTrace_WriteUInt(trace, size);
+
+		const bool hasData = (trace->recordUploadData && data);
+		CommandTrace_WriteUInt(trace, (hasData ? 1 : 0));
+		if (hasData)
+			CommandTrace_WriteBytes(trace, data, size);
+		trace->uploadBytes += size;
+	}
+
+	//writes a buffer image copy region
+	inline void CommandTrace_WriteBufferImageCopy(CommandTrace* trace, const VkBufferImageCopy& region)
+	{
+		CommandTrace_WriteUInt(trace, region.bufferOffset);
+		CommandTrace_WriteUInt(trace, region.bufferRowLength); CommandTrace_WriteUInt(trace, region.bufferImageHeight);
+		CommandTrace_WriteUInt(trace, region.imageSubresource.aspectMask); CommandTrace_WriteUInt(trace, region.imageSubresource.mipLevel);
+		CommandTrace_WriteUInt(trace, region.imageSubresource.baseArrayLayer); CommandTrace_WriteUInt(trace, region.imageSubresource.layerCount);
+		CommandTrace_WriteInt(trace, region.imageOffset.x); CommandTrace_WriteInt(trace, region.imageOffset.y); CommandTrace_WriteInt(trace, region.imageOffset.z);
+		CommandTrace_WriteUInt(trace, region.imageExtent.width); CommandTrace_WriteUInt(trace, region.imageExtent.height);
+		CommandTrace_WriteUInt(trace, region.imageExtent.depth);
+	}
+
+	//writes a image copy region
+	inline void CommandTrace_WriteImageCopy(CommandTrace* trace, const VkImageCopy& region)
+	{
+		const VkImageSubresourceLayers* subresources[2] = { &region.srcSubresource, &region.dstSubresource };
+		const VkOffset3D* offsets[2] = { &region.srcOffset, &region.dstOffset };
+		for (uint32 i = 0; i < 2; ++i)
+		{
+			CommandTrace_WriteUInt(trace, subresources[i]->aspectMask); CommandTrace_WriteUInt(trace, subresources[i]->mipLevel);
+			CommandTrace_WriteUInt(trace, subresources[i]->baseArrayLayer); CommandTrace_WriteUInt(trace, subresources[i]->layerCount);
+			CommandTrace_WriteInt(trace, offsets[i]->x); CommandTrace_WriteInt(trace, offsets[i]->y); CommandTrace_WriteInt(trace, offsets[i]->z);
+		}
+		CommandTrace_WriteUInt(trace, region.extent.width); CommandTrace_WriteUInt(trace, region.extent.height);
+		CommandTrace_WriteUInt(trace, region.extent.depth);
+	}
+
+	//------------------------------------DISPATCH-----------------------------------//
+
+	//binds a pipeline
+	inline void Dispatch_CmdBindPipeline(Dispatch* dispatch, VkCommandBuffer comBuffer, const VkPipelineBindPoint bindPoint, VkPipeline pipeline)
+	{
+		Dispatch_RecordBindPipeline(dispatch, bindPoint, pipeline);
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdBindPipeline(comBuffer, bindPoint, pipeline);
+	}
+
+	//binds descriptor sets
+	inline void Dispatch_CmdBindDescriptorSets(Dispatch* dispatch, VkCommandBuffer comBuffer, const VkPipelineBindPoint bindPoint,
+		VkPipelineLayout layout, const uint32 firstSet, const uint32 setCount, const VkDescriptorSet* sets)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::BindDescriptorSets);
+			CommandTrace_WriteUInt(trace, (uint64)bindPoint); CommandTrace_WriteHandle(trace, layout);
+			CommandTrace_WriteUInt(trace, firstSet); CommandTrace_WriteUInt(trace, setCount);
+			for (uint32 i = 0; i < setCount; ++i)
+				CommandTrace_WriteHandle(trace, sets[i]);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdBindDescriptorSets(comBuffer, bindPoint, layout, firstSet, setCount, sets, 0, nullptr);
+	}
+
+	//sets the viewport
+	inline void Dispatch_CmdSetViewport(Dispatch* dispatch, VkCommandBuffer comBuffer, const VkViewport& viewport)
+	{
+		Dispatch_RecordSetViewport(dispatch, viewport);
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdSetViewport(comBuffer, 0, 1, &viewport);
+	}
+
+	//sets the scissor
+	inline void Dispatch_CmdSetScissor(Dispatch* dispatch, VkCommandBuffer comBuffer, const VkRect2D& scissor)
+	{
+		Dispatch_RecordSetScissor(dispatch, scissor);
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdSetScissor(comBuffer, 0, 1, &scissor);
+	}
+
+	//pushes constants
+	inline void Dispatch_CmdPushConstants(Dispatch* dispatch, VkCommandBuffer comBuffer, VkPipelineLayout layout,
+		const VkShaderStageFlags stages, const uint32 offset, const uint32 size, const void* data)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::PushConstants);
+			CommandTrace_WriteHandle(trace, layout); CommandTrace_WriteUInt(trace, stages);
+			CommandTrace_WriteUInt(trace, offset); CommandTrace_WriteUInt(trace, size);
+			CommandTrace_WriteBytes(trace, data, size);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdPushConstants(comBuffer, layout, stages, offset, size, data);
+	}
+
+	//draws
+	inline void Dispatch_CmdDraw(Dispatch* dispatch, VkCommandBuffer comBuffer, const uint32 vertexCount, const uint32 instanceCount,
+		const uint32 firstVertex, const uint32 firstInstance)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::Draw);
+			CommandTrace_WriteUInt(trace, vertexCount); CommandTrace_WriteUInt(trace, instanceCount);
+			CommandTrace_WriteUInt(trace, firstVertex); CommandTrace_WriteUInt(trace, firstInstance);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdDraw(comBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+	}
+
+	//draws indexed
+	inline void Dispatch_CmdDrawIndexed(Dispatch* dispatch, VkCommandBuffer comBuffer, const uint32 indexCount, const uint32 instanceCount,
+		const uint32 firstIndex, const int32 vertexOffset, const uint32 firstInstance)
+	{
+		Dispatch_RecordDrawIndexed(dispatch, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdDrawIndexed(comBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+	}
+
+	//draws indexed from a buffer of commands
+	inline void Dispatch_CmdDrawIndexedIndirect(Dispatch* dispatch, VkCommandBuffer comBuffer, VkBuffer buffer, const VkDeviceSize offset,
+		const uint32 drawCount, const uint32 stride)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::DrawIndexedIndirect);
+			CommandTrace_WriteHandle(trace, buffer); CommandTrace_WriteUInt(trace, offset);
+			CommandTrace_WriteUInt(trace, drawCount); CommandTrace_WriteUInt(trace, stride);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdDrawIndexedIndirect(comBuffer, buffer, offset, drawCount, stride);
+	}
+
+	//draws indexed from a buffer of commands, with the count from another buffer
+	inline void Dispatch_CmdDrawIndexedIndirectCount(Dispatch* dispatch, VkCommandBuffer comBuffer, VkBuffer buffer, const VkDeviceSize offset,
+		VkBuffer countBuffer, const VkDeviceSize countOffset, const uint32 maxDrawCount, const uint32 stride)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::DrawIndexedIndirectCount);
+			CommandTrace_WriteHandle(trace, buffer); CommandTrace_WriteUInt(trace, offset);
+			CommandTrace_WriteHandle(trace, countBuffer); CommandTrace_WriteUInt(trace, countOffset);
+			CommandTrace_WriteUInt(trace, maxDrawCount); CommandTrace_WriteUInt(trace, stride);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdDrawIndexedIndirectCount(comBuffer, buffer, offset, countBuffer, countOffset, maxDrawCount, stride);
+	}
+
+	//dispatches compute work
+	inline void Dispatch_CmdDispatch(Dispatch* dispatch, VkCommandBuffer comBuffer, const uint32 x, const uint32 y, const uint32 z)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::Dispatch);
+			CommandTrace_WriteUInt(trace, x); CommandTrace_WriteUInt(trace, y); CommandTrace_WriteUInt(trace, z);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdDispatch(comBuffer, x, y, z);
+	}
+
+	//records a pipeline barrier
+	inline void Dispatch_CmdPipelineBarrier(Dispatch* dispatch, VkCommandBuffer comBuffer, const VkPipelineStageFlags srcStages,
+		const VkPipelineStageFlags dstStages, const VkDependencyFlags dependencyFlags,
+		const uint32 memoryBarrierCount, const VkMemoryBarrier* memoryBarriers,
+		const uint32 bufferBarrierCount, const VkBufferMemoryBarrier* bufferBarriers,
+		const uint32 imageBarrierCount, const VkImageMemoryBarrier* imageBarriers)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::PipelineBarrier);
+			CommandTrace_WriteUInt(trace, srcStages); CommandTrace_WriteUInt(trace, dstStages); CommandTrace_WriteUInt(trace, dependencyFlags);
+
+			CommandTrace_WriteUInt(trace, memoryBarrierCount);
+			for (uint32 i = 0; i < memoryBarrierCount; ++i)
+			{
+				CommandTrace_WriteUInt(trace, memoryBarriers[i].srcAccessMask); CommandTrace_WriteUInt(trace, memoryBarriers[i].dstAccessMask);
+			}
+
+			CommandTrace_WriteUInt(trace, bufferBarrierCount);
+			for (uint32 i = 0; i < bufferBarrierCount; ++i)
+			{
+				const VkBufferMemoryBarrier& barrier = bufferBarriers[i];
+				CommandTrace_WriteUInt(trace, barrier.srcAccessMask); CommandTrace_WriteUInt(trace, barrier.dstAccessMask);
+				CommandTrace_WriteUInt(trace, barrier.srcQueueFamilyIndex); CommandTrace_WriteUInt(trace, barrier.dstQueueFamilyIndex);
+				CommandTrace_WriteHandle(trace, barrier.buffer);
+				CommandTrace_WriteUInt(trace, barrier.offset); CommandTrace_WriteUInt(trace, barrier.size);
+			}
+
+			CommandTrace_WriteUInt(trace, imageBarrierCount);
+			for (uint32 i = 0; i < imageBarrierCount; ++i)
+			{
+				const VkImageMemoryBarrier& barrier = imageBarriers[i];
+				CommandTrace_WriteUInt(trace, barrier.srcAccessMask); CommandTrace_WriteUInt(trace, barrier.dstAccessMask);
+				CommandTrace_WriteUInt(trace, (uint64)barrier.oldLayout); CommandTrace_WriteUInt(trace, (uint64)barrier.newLayout);
+				CommandTrace_WriteUInt(trace, barrier.srcQueueFamilyIndex); CommandTrace_WriteUInt(trace, barrier.dstQueueFamilyIndex);
+				CommandTrace_WriteHandle(trace, barrier.image);
+				CommandTrace_WriteUInt(trace, barrier.subresourceRange.aspectMask);
+				CommandTrace_WriteUInt(trace, barrier.subresourceRange.baseMipLevel); CommandTrace_WriteUInt(trace, barrier.subresourceRange.levelCount);
+				CommandTrace_WriteUInt(trace, barrier.subresourceRange.baseArrayLayer); CommandTrace_WriteUInt(trace, barrier.subresourceRange.layerCount);
+			}
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdPipelineBarrier(comBuffer, srcStages, dstStages, dependencyFlags, memoryBarrierCount, memoryBarriers,
+				bufferBarrierCount, bufferBarriers, imageBarrierCount, imageBarriers);
+	}
+
+	//fills a buffer range with a value
+	inline void Dispatch_CmdFillBuffer(Dispatch* dispatch, VkCommandBuffer comBuffer, VkBuffer buffer, const VkDeviceSize offset,
+		const VkDeviceSize size, const uint32 data)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::FillBuffer);
+			CommandTrace_WriteHandle(trace, buffer); CommandTrace_WriteUInt(trace, offset);
+			CommandTrace_WriteUInt(trace, size); CommandTrace_WriteUInt(trace, data);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdFillBuffer(comBuffer, buffer, offset, size, data);
+	}
+
+	//copies between buffers
+	inline void Dispatch_CmdCopyBuffer(Dispatch* dispatch, VkCommandBuffer comBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer,
+		const uint32 regionCount, const VkBufferCopy* regions)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::CopyBuffer);
+			CommandTrace_WriteHandle(trace, srcBuffer); CommandTrace_WriteHandle(trace, dstBuffer);
+			CommandTrace_WriteUInt(trace, regionCount);
+			for (uint32 i = 0; i < regionCount; ++i)
+			{
+				CommandTrace_WriteUInt(trace, regions[i].srcOffset); CommandTrace_WriteUInt(trace, regions[i].dstOffset);
+				CommandTrace_WriteUInt(trace, regions[i].size);
+			}
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdCopyBuffer(comBuffer, srcBuffer, dstBuffer, regionCount, regions);
+	}
+
+	//copies a buffer into a image
+	inline void Dispatch_CmdCopyBufferToImage(Dispatch* dispatch, VkCommandBuffer comBuffer, VkBuffer buffer, VkImage image,
+		const VkImageLayout layout, const uint32 regionCount, const VkBufferImageCopy* regions)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::CopyBufferToImage);
+			CommandTrace_WriteHandle(trace, buffer); CommandTrace_WriteHandle(trace, image);
+			CommandTrace_WriteUInt(trace, (uint64)layout); CommandTrace_WriteUInt(trace, regionCount);
+			for (uint32 i = 0; i < regionCount; ++i)
+				CommandTrace_WriteBufferImageCopy(trace, regions[i]);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdCopyBufferToImage(comBuffer, buffer, image, layout, regionCount, regions);
+	}
+
+	//copies a image into a buffer
+	inline void Dispatch_CmdCopyImageToBuffer(Dispatch* dispatch, VkCommandBuffer comBuffer, VkImage image, const VkImageLayout layout,
+		VkBuffer buffer, const uint32 regionCount, const VkBufferImageCopy* regions)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::CopyImageToBuffer);
+			CommandTrace_WriteHandle(trace, image); CommandTrace_WriteUInt(trace, (uint64)layout);
+			CommandTrace_WriteHandle(trace, buffer); CommandTrace_WriteUInt(trace, regionCount);
+			for (uint32 i = 0; i < regionCount; ++i)
+				CommandTrace_WriteBufferImageCopy(trace, regions[i]);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdCopyImageToBuffer(comBuffer, image, layout, buffer, regionCount, regions);
+	}
+
+	//copies between images
+	inline void Dispatch_CmdCopyImage(Dispatch* dispatch, VkCommandBuffer comBuffer, VkImage srcImage, const VkImageLayout srcLayout,
+		VkImage dstImage, const VkImageLayout dstLayout, const uint32 regionCount, const VkImageCopy* regions)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::CopyImage);
+			CommandTrace_WriteHandle(trace, srcImage); CommandTrace_WriteUInt(trace, (uint64)srcLayout);
+			CommandTrace_WriteHandle(trace, dstImage); CommandTrace_WriteUInt(trace, (uint64)dstLayout);
+			CommandTrace_WriteUInt(trace, regionCount);
+			for (uint32 i = 0; i < regionCount; ++i)
+				CommandTrace_WriteImageCopy(trace, regions[i]);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdCopyImage(comBuffer, srcImage, srcLayout, dstImage, dstLayout, regionCount, regions);
+	}
+
+	//begins a render pass
+	inline void Dispatch_CmdBeginRenderPass(Dispatch* dispatch, VkCommandBuffer comBuffer, const VkRenderPassBeginInfo& beginInfo,
+		const VkSubpassContents contents)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+		{
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::BeginRenderPass);
+			CommandTrace_WriteHandle(trace, beginInfo.renderPass); CommandTrace_WriteHandle(trace, beginInfo.framebuffer);
+			CommandTrace_WriteInt(trace, beginInfo.renderArea.offset.x); CommandTrace_WriteInt(trace, beginInfo.renderArea.offset.y);
+			CommandTrace_WriteUInt(trace, beginInfo.renderArea.extent.width); CommandTrace_WriteUInt(trace, beginInfo.renderArea.extent.height);
+			CommandTrace_WriteUInt(trace, beginInfo.clearValueCount);
+			CommandTrace_WriteBytes(trace, beginInfo.pClearValues, sizeof(VkClearValue) * beginInfo.clearValueCount);
+			CommandTrace_WriteUInt(trace, (uint64)contents);
+		}
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdBeginRenderPass(comBuffer, &beginInfo, contents);
+	}
+
+	//ends a render pass
+	inline void Dispatch_CmdEndRenderPass(Dispatch* dispatch, VkCommandBuffer comBuffer)
+	{
+		if (CommandTrace* trace = Dispatch_GetTrace(dispatch))
+			CommandTrace_BeginCommand(trace, CommandTrace_Op::EndRenderPass);
+
+		if (Dispatch_IsExecuting(dispatch))
+			vkCmdEndRenderPass(comBuffer);
+	}
+
+	//writes descriptors
+	inline void Dispatch_UpdateDescriptorSets(Dispatch* dispatch, VkDevice device, const uint32 writeCount, const VkWriteDescriptorSet* writes)
+	{
+		Dispatch_RecordDescriptorWrites(dispatch, writeCount, writes);
+		if (Dispatch_IsExecuting(dispatch))
+			vkUpdateDescriptorSets(device, writeCount, writes, 0, nullptr);
+	}
+
+	//copies data into mapped memory || target is the buffer or image the memory belongs to
+	inline void Dispatch_Upload(Dispatch* dispatch, void* mappedMemory, const uint64 target, const uint64 offset, const void* data, const size_t size)
+	{
+		Dispatch_RecordUpload(dispatch, target, offset, data, size);
+		if (Dispatch_IsExecuting(dispatch) && mappedMemory)
+			memcpy((uint8*)mappedMemory + offset, data, size);
+	}
+
+	//------------------------------------REPLAY-----------------------------------//
+
+	//defines how a trace is replayed
+	struct CommandTraceReplay
+	{
+		VkDevice device = VK_NULL_HANDLE; //the device descriptor writes are made on
+		std::unordered_map<uint64, uint64> handles; //the recorded handles to the replay's handles || unmapped handles are used as is
+		std::unordered_map<uint64, void*> mappedMemory; //where uploads to a recorded target are copied || unmapped uploads are skipped
+		std::function<void(VkCommandBuffer)> bindMegaMeshBuffer; //binds the replay's vertex and index buffers
+	};
+
+	//defines the stats of a replay
+	struct CommandTraceReplayStats
+	{
+		uint64 commandCount = 0, frameCount = 0, drawCount = 0;
+		uint64 uploadBytes = 0; //the bytes copied
+		double milliseconds = 0.0; //the CPU time recording took
+		bool succeeded = true; //false if the trace was cut off or had a unknown command
+		std::vector<size_t> frameOffsets; //where each frame command started in the trace
+	};
+
+	//gets a replayed handle
+	template<typename T>
+	inline T CommandTrace_ReadHandle(CommandTrace_Reader* reader, const CommandTraceReplay& replay)
+	{
+		const uint64 handle = CommandTrace_ReadUInt(reader);
+		auto it = replay.handles.find(handle);
+		return (T)(it != replay.handles.end() ? it->second : handle);
+	}
+
+	//reads a buffer image copy region
+	inline VkBufferImageCopy CommandTrace_ReadBufferImageCopy(CommandTrace_Reader* reader)
+	{
+		VkBufferImageCopy region = {};
+		region.bufferOffset = CommandTrace_ReadUInt(reader);
+		region.bufferRowLength = (uint32)CommandTrace_ReadUInt(reader); region.bufferImageHeight = (uint32)CommandTrace_ReadUInt(reader);
+		region.imageSubresource.aspectMask = (VkImageAspectFlags)CommandTrace_ReadUInt(reader);
+		region.imageSubresource.mipLevel = (uint32)CommandTrace_ReadUInt(reader);
+		region.imageSubresource.baseArrayLayer = (uint32)CommandTrace_ReadUInt(reader);
+		region.imageSubresource.layerCount = (uint32)CommandTrace_ReadUInt(reader);
+		region.imageOffset.x = (int32)CommandTrace_ReadInt(reader); region.imageOffset.y = (int32)CommandTrace_ReadInt(reader);
+		region.imageOffset.z = (int32)CommandTrace_ReadInt(reader);
+		region.imageExtent.width = (uint32)CommandTrace_ReadUInt(reader); region.imageExtent.height = (uint32)CommandTrace_ReadUInt(reader);
+		region.imageExtent.depth = (uint32)CommandTrace_ReadUInt(reader);
+		return region;
+	}
+
+	//reads a image copy region
+	inline VkImageCopy CommandTrace_ReadImageCopy(CommandTrace_Reader* reader)
+	{
+		VkImageCopy region = {};
+		VkImageSubresourceLayers* subresources[2] = { &region.srcSubresource, &region.dstSubresource };
+		VkOffset3D* offsets[2] = { &region.srcOffset, &region.dstOffset };
+		for (uint32 i = 0; i < 2; ++i)
+		{
+			subresources[i]->aspectMask = (VkImageAspectFlags)CommandTrace_ReadUInt(reader);
+			subresources[i]->mipLevel = (uint32)CommandTrace_ReadUInt(reader);
+			subresources[i]->baseArrayLayer = (uint32)CommandTrace_ReadUInt(reader);
+			subresources[i]->layerCount = (uint32)CommandTrace_ReadUInt(reader);
+			offsets[i]->x = (int32)CommandTrace_ReadInt(reader); offsets[i]->y = (int32)CommandTrace_ReadInt(reader);
+			offsets[i]->z = (int32)CommandTrace_ReadInt(reader);
+		}
+		region.extent.width = (uint32)CommandTrace_ReadUInt(reader); region.extent.height = (uint32)CommandTrace_ReadUInt(reader);
+		region.extent.depth = (uint32)CommandTrace_ReadUInt(reader);
+		return region;
+	}
+
+	//replays the commands of a trace between two offsets into a command buffer, through a dispatch
+	//a null backend dispatch with a trace re-records it, which is how traces are checked without a device
+	inline CommandTraceReplayStats CommandTrace_Replay(const CommandTrace& trace, VkCommandBuffer comBuffer, Dispatch* dispatch,
+		const CommandTraceReplay& replay, const size_t start = 0, const size_t end = SIZE_MAX)
+	{
+		CommandTraceReplayStats stats;
+		CommandTrace_Reader reader;
+		reader.data = trace.data.data(); reader.size = std::min(end, trace.data.size()); reader.offset = start;
+
+		std::vector<VkDescriptorSet> sets;
+		std::vector<VkDescriptorBufferInfo> bufferInfos; std::vector<VkDescriptorImageInfo> imageInfos;
+		std::vector<VkMemoryBarrier> memoryBarriers; std::vector<VkBufferMemoryBarrier> bufferBarriers; std::vector<VkImageMemoryBarrier> imageBarriers;
+		std::vector<VkBufferCopy> bufferCopies; std::vector<VkBufferImageCopy> imageCopies; std::vector<VkImageCopy> imageToImageCopies;
+		std::vector<VkClearValue> clearValues;
+
+		const auto startTime = std::chrono::steady_clock::now();
+		while (reader.offset < reader.size && !reader.failed)
+		{
+			const size_t commandOffset = reader.offset;
+			const CommandTrace_Op op = (CommandTrace_Op)reader.data[reader.offset++];
+			stats.commandCount++;
+
+			switch (op)
+			{
+			case CommandTrace_Op::Frame:
+				Dispatch_BeginFrame(dispatch, CommandTrace_ReadUInt(&reader));
+				stats.frameOffsets.emplace_back(commandOffset);
+				stats.frameCount++;
+				break;
+
+			case CommandTrace_Op::BindPipeline:
+			{
+				const VkPipelineBindPoint bindPoint = (VkPipelineBindPoint)CommandTrace_ReadUInt(&reader);
+				Dispatch_CmdBindPipeline(dispatch, comBuffer, bindPoint, CommandTrace_ReadHandle<VkPipeline>(&reader, replay));
+				break;
+			}
+
+			case CommandTrace_Op::BindDescriptorSets:
+			{
+				const VkPipelineBindPoint bindPoint = (VkPipelineBindPoint)CommandTrace_ReadUInt(&reader);
+				VkPipelineLayout layout = CommandTrace_ReadHandle<VkPipelineLayout>(&reader, replay);
+				const uint32 firstSet = (uint32)CommandTrace_ReadUInt(&reader);
+				sets.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				for (size_t i = 0; i < sets.size(); ++i)
+					sets[i] = CommandTrace_ReadHandle<VkDescriptorSet>(&reader, replay);
+				Dispatch_CmdBindDescriptorSets(dispatch, comBuffer, bindPoint, layout, firstSet, (uint32)sets.size(), sets.data());
+				break;
+			}
+
+			case CommandTrace_Op::SetViewport:
+			{
+				VkViewport viewport;
+				viewport.x = CommandTrace_ReadFloat(&reader); viewport.y = CommandTrace_ReadFloat(&reader);
+				viewport.width = CommandTrace_ReadFloat(&reader); viewport.height = CommandTrace_ReadFloat(&reader);
+				viewport.minDepth = CommandTrace_ReadFloat(&reader); viewport.maxDepth = CommandTrace_ReadFloat(&reader);
+				Dispatch_CmdSetViewport(dispatch, comBuffer, viewport);
+				break;
+			}
+
+			case CommandTrace_Op::SetScissor:
+			{
+				VkRect2D scissor;
+				scissor.offset.x = (int32)CommandTrace_ReadInt(&reader); scissor.offset.y = (int32)CommandTrace_ReadInt(&reader);
+				scissor.extent.width = (uint32)CommandTrace_ReadUInt(&reader); scissor.extent.height = (uint32)CommandTrace_ReadUInt(&reader);
+				Dispatch_CmdSetScissor(dispatch, comBuffer, scissor);
+				break;
+			}
+
+			case CommandTrace_Op::PushConstants:
+			{
+				VkPipelineLayout layout = CommandTrace_ReadHandle<VkPipelineLayout>(&reader, replay);
+				const VkShaderStageFlags stages = (VkShaderStageFlags)CommandTrace_ReadUInt(&reader);
+				const uint32 offset = (uint32)CommandTrace_ReadUInt(&reader), size = (uint32)CommandTrace_ReadUInt(&reader);
+				const uint8* bytes = CommandTrace_ReadBytes(&reader, size);
+				if (bytes)
+					Dispatch_CmdPushConstants(dispatch, comBuffer, layout, stages, offset, size, bytes);
+				break;
+			}
+
+			case CommandTrace_Op::BindMegaMeshBuffer:
+				Dispatch_RecordBindMegaMeshBuffer(dispatch);
+				if (Dispatch_IsExecuting(dispatch) && replay.bindMegaMeshBuffer)
+					replay.bindMegaMeshBuffer(comBuffer);
+				break;
+
+			case CommandTrace_Op::Draw:
+			{
+				const uint32 vertexCount = (uint32)CommandTrace_ReadUInt(&reader), instanceCount = (uint32)CommandTrace_ReadUInt(&reader);
+				const uint32 firstVertex = (uint32)CommandTrace_ReadUInt(&reader), firstInstance = (uint32)CommandTrace_ReadUInt(&reader);
+				Dispatch_CmdDraw(dispatch, comBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+				stats.drawCount++;
+				break;
+			}
+
+			case CommandTrace_Op::DrawIndexed:
+			{
+				const uint32 indexCount = (uint32)CommandTrace_ReadUInt(&reader), instanceCount = (uint32)CommandTrace_ReadUInt(&reader);
+				const uint32 firstIndex = (uint32)CommandTrace_ReadUInt(&reader);
+				const int32 vertexOffset = (int32)CommandTrace_ReadInt(&reader);
+				const uint32 firstInstance = (uint32)CommandTrace_ReadUInt(&reader);
+				Dispatch_CmdDrawIndexed(dispatch, comBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+				stats.drawCount++;
+				break;
+			}
+
+			case CommandTrace_Op::DrawIndexedIndirect:
+			{
+				VkBuffer buffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+				const VkDeviceSize offset = CommandTrace_ReadUInt(&reader);
+				const uint32 drawCount = (uint32)CommandTrace_ReadUInt(&reader), stride = (uint32)CommandTrace_ReadUInt(&reader);
+				Dispatch_CmdDrawIndexedIndirect(dispatch, comBuffer, buffer, offset, drawCount, stride);
+				stats.drawCount++;
+				break;
+			}
+
+			case CommandTrace_Op::DrawIndexedIndirectCount:
+			{
+				VkBuffer buffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+				const VkDeviceSize offset = CommandTrace_ReadUInt(&reader);
+				VkBuffer countBuffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+				const VkDeviceSize countOffset = CommandTrace_ReadUInt(&reader);
+				const uint32 maxDrawCount = (uint32)CommandTrace_ReadUInt(&reader), stride = (uint32)CommandTrace_ReadUInt(&reader);
+				Dispatch_CmdDrawIndexedIndirectCount(dispatch, comBuffer, buffer, offset, countBuffer, countOffset, maxDrawCount, stride);
+				stats.drawCount++;
+				break;
+			}
+
+			case CommandTrace_Op::Dispatch:
+			{
+				const uint32 x = (uint32)CommandTrace_ReadUInt(&reader), y = (uint32)CommandTrace_ReadUInt(&reader), z = (uint32)CommandTrace_ReadUInt(&reader);
+				Dispatch_CmdDispatch(dispatch, comBuffer, x, y, z);
+				break;
+			}
+
+			case CommandTrace_Op::DescriptorWrite:
+			{
+				VkWriteDescriptorSet write = {};
+				write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				write.dstSet = CommandTrace_ReadHandle<VkDescriptorSet>(&reader, replay);
+				write.dstBinding = (uint32)CommandTrace_ReadUInt(&reader); write.dstArrayElement = (uint32)CommandTrace_ReadUInt(&reader);
+				write.descriptorType = (VkDescriptorType)CommandTrace_ReadUInt(&reader);
+				write.descriptorCount = (uint32)CommandTrace_ReadUInt(&reader) & 0xFFFF;
+
+				bufferInfos.clear(); imageInfos.clear();
+				for (uint32 d = 0; d < write.descriptorCount && !reader.failed; ++d)
+				{
+					if (Dispatch_IsBufferDescriptor(write.descriptorType))
+					{
+						VkDescriptorBufferInfo& info = bufferInfos.emplace_back();
+						info.buffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+						info.offset = CommandTrace_ReadUInt(&reader); info.range = CommandTrace_ReadUInt(&reader);
+					}
+					else if (Dispatch_IsImageDescriptor(write.descriptorType))
+					{
+						VkDescriptorImageInfo& info = imageInfos.emplace_back();
+						info.sampler = CommandTrace_ReadHandle<VkSampler>(&reader, replay);
+						info.imageView = CommandTrace_ReadHandle<VkImageView>(&reader, replay);
+						info.imageLayout = (VkImageLayout)CommandTrace_ReadUInt(&reader);
+					}
+				}
+
+				//texel buffer writes only kept their counts, so they can't be replayed
+				if (!bufferInfos.empty())
+					write.pBufferInfo = bufferInfos.data();
+				else if (!imageInfos.empty())
+					write.pImageInfo = imageInfos.data();
+				else
+					break;
+				Dispatch_UpdateDescriptorSets(dispatch, replay.device, 1, &write);
+				break;
+			}
+
+			case CommandTrace_Op::Upload:
+			{
+				const uint64 target = CommandTrace_ReadUInt(&reader), offset = CommandTrace_ReadUInt(&reader);
+				const size_t size = (size_t)CommandTrace_ReadUInt(&reader);
+				const bool hasData = (CommandTrace_ReadUInt(&reader) != 0);
+				const uint8* bytes = (hasData ? CommandTrace_ReadBytes(&reader, size) : nullptr);
+
+				auto it = replay.mappedMemory.find(target);
+				void* mappedMemory = (it != replay.mappedMemory.end() ? it->second : nullptr);
+				if (bytes && mappedMemory)
+				{
+					Dispatch_Upload(dispatch, mappedMemory, target, offset, bytes, size);
+					stats.uploadBytes += size;
+				}
+				else
+					Dispatch_RecordUpload(dispatch, target, offset, bytes, size);
+				break;
+			}
+
+			case CommandTrace_Op::PipelineBarrier:
+			{
+				const VkPipelineStageFlags srcStages = (VkPipelineStageFlags)CommandTrace_ReadUInt(&reader);
+				const VkPipelineStageFlags dstStages = (VkPipelineStageFlags)CommandTrace_ReadUInt(&reader);
+				const VkDependencyFlags dependencyFlags = (VkDependencyFlags)CommandTrace_ReadUInt(&reader);
+
+				memoryBarriers.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				for (size_t i = 0; i < memoryBarriers.size() && !reader.failed; ++i)
+				{
+					VkMemoryBarrier& barrier = memoryBarriers[i];
+					barrier = {};
+					barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+					barrier.srcAccessMask = (VkAccessFlags)CommandTrace_ReadUInt(&reader); barrier.dstAccessMask = (VkAccessFlags)CommandTrace_ReadUInt(&reader);
+				}
+
+				bufferBarriers.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				for (size_t i = 0; i < bufferBarriers.size() && !reader.failed; ++i)
+				{
+					VkBufferMemoryBarrier& barrier = bufferBarriers[i];
+					barrier = {};
+					barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+					barrier.srcAccessMask = (VkAccessFlags)CommandTrace_ReadUInt(&reader); barrier.dstAccessMask = (VkAccessFlags)CommandTrace_ReadUInt(&reader);
+					barrier.srcQueueFamilyIndex = (uint32)CommandTrace_ReadUInt(&reader); barrier.dstQueueFamilyIndex = (uint32)CommandTrace_ReadUInt(&reader);
+					barrier.buffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+					barrier.offset = CommandTrace_ReadUInt(&reader); barrier.size = CommandTrace_ReadUInt(&reader);
+				}
+
+				imageBarriers.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				for (size_t i = 0; i < imageBarriers.size() && !reader.failed; ++i)
+				{
+					VkImageMemoryBarrier& barrier = imageBarriers[i];
+					barrier = {};
+					barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+					barrier.srcAccessMask = (VkAccessFlags)CommandTrace_ReadUInt(&reader); barrier.dstAccessMask = (VkAccessFlags)CommandTrace_ReadUInt(&reader);
+					barrier.oldLayout = (VkImageLayout)CommandTrace_ReadUInt(&reader); barrier.newLayout = (VkImageLayout)CommandTrace_ReadUInt(&reader);
+					barrier.srcQueueFamilyIndex = (uint32)CommandTrace_ReadUInt(&reader); barrier.dstQueueFamilyIndex = (uint32)CommandTrace_ReadUInt(&reader);
+					barrier.image = CommandTrace_ReadHandle<VkImage>(&reader, replay);
+					barrier.subresourceRange.aspectMask = (VkImageAspectFlags)CommandTrace_ReadUInt(&reader);
+					barrier.subresourceRange.baseMipLevel = (uint32)CommandTrace_ReadUInt(&reader); barrier.subresourceRange.levelCount = (uint32)CommandTrace_ReadUInt(&reader);
+					barrier.subresourceRange.baseArrayLayer = (uint32)CommandTrace_ReadUInt(&reader); barrier.subresourceRange.layerCount = (uint32)CommandTrace_ReadUInt(&reader);
+				}
+
+				if (!reader.failed)
+					Dispatch_CmdPipelineBarrier(dispatch, comBuffer, srcStages, dstStages, dependencyFlags,
+						(uint32)memoryBarriers.size(), memoryBarriers.data(), (uint32)bufferBarriers.size(), bufferBarriers.data(),
+						(uint32)imageBarriers.size(), imageBarriers.data());
+				break;
+			}
+
+			case CommandTrace_Op::FillBuffer:
+			{
+				VkBuffer buffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+				const VkDeviceSize offset = CommandTrace_ReadUInt(&reader), size = CommandTrace_ReadUInt(&reader);
+				const uint32 data = (uint32)CommandTrace_ReadUInt(&reader);
+				Dispatch_CmdFillBuffer(dispatch, comBuffer, buffer, offset, size, data);
+				break;
+			}
+
+			case CommandTrace_Op::CopyBuffer:
+			{
+				VkBuffer srcBuffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+				VkBuffer dstBuffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+				bufferCopies.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				for (size_t i = 0; i < bufferCopies.size() && !reader.failed; ++i)
+				{
+					bufferCopies[i].srcOffset = CommandTrace_ReadUInt(&reader); bufferCopies[i].dstOffset = CommandTrace_ReadUInt(&reader);
+					bufferCopies[i].size = CommandTrace_ReadUInt(&reader);
+				}
+				if (!reader.failed)
+					Dispatch_CmdCopyBuffer(dispatch, comBuffer, srcBuffer, dstBuffer, (uint32)bufferCopies.size(), bufferCopies.data());
+				break;
+			}
+
+			case CommandTrace_Op::CopyBufferToImage:
+			{
+				VkBuffer buffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+				VkImage image = CommandTrace_ReadHandle<VkImage>(&reader, replay);
+				const VkImageLayout layout = (VkImageLayout)CommandTrace_ReadUInt(&reader);
+				imageCopies.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				for (size_t i = 0; i < imageCopies.size() && !reader.failed; ++i)
+					imageCopies[i] = CommandTrace_ReadBufferImageCopy(&reader);
+				if (!reader.failed)
+					Dispatch_CmdCopyBufferToImage(dispatch, comBuffer, buffer, image, layout, (uint32)imageCopies.size(), imageCopies.data());
+				break;
+			}
+
+			case CommandTrace_Op::CopyImageToBuffer:
+			{
+				VkImage image = CommandTrace_ReadHandle<VkImage>(&reader, replay);
+				const VkImageLayout layout = (VkImageLayout)CommandTrace_ReadUInt(&reader);
+				VkBuffer buffer = CommandTrace_ReadHandle<VkBuffer>(&reader, replay);
+				imageCopies.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				for (size_t i = 0; i < imageCopies.size() && !reader.failed; ++i)
+					imageCopies[i] = CommandTrace_ReadBufferImageCopy(&reader);
+				if (!reader.failed)
+					Dispatch_CmdCopyImageToBuffer(dispatch, comBuffer, image, layout, buffer, (uint32)imageCopies.size(), imageCopies.data());
+				break;
+			}
+
+			case CommandTrace_Op::BeginRenderPass:
+			{
+				VkRenderPassBeginInfo beginInfo = {};
+				beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+				beginInfo.renderPass = CommandTrace_ReadHandle<VkRenderPass>(&reader, replay);
+				beginInfo.framebuffer = CommandTrace_ReadHandle<VkFramebuffer>(&reader, replay);
+				beginInfo.renderArea.offset.x = (int32)CommandTrace_ReadInt(&reader); beginInfo.renderArea.offset.y = (int32)CommandTrace_ReadInt(&reader);
+				beginInfo.renderArea.extent.width = (uint32)CommandTrace_ReadUInt(&reader); beginInfo.renderArea.extent.height = (uint32)CommandTrace_ReadUInt(&reader);
+				clearValues.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				if (const uint8* bytes = CommandTrace_ReadBytes(&reader, sizeof(VkClearValue) * clearValues.size()))
+					memcpy(clearValues.data(), bytes, sizeof(VkClearValue) * clearValues.size());
+				const VkSubpassContents contents = (VkSubpassContents)CommandTrace_ReadUInt(&reader);
+
+				beginInfo.clearValueCount = (uint32)clearValues.size();
+				beginInfo.pClearValues = (clearValues.empty() ? nullptr : clearValues.data());
+				if (!reader.failed)
+					Dispatch_CmdBeginRenderPass(dispatch, comBuffer, beginInfo, contents);
+				break;
+			}
+
+			case CommandTrace_Op::EndRenderPass:
+				Dispatch_CmdEndRenderPass(dispatch, comBuffer);
+				break;
+
+			case CommandTrace_Op::CopyImage:
+			{
+				VkImage srcImage = CommandTrace_ReadHandle<VkImage>(&reader, replay);
+				const VkImageLayout srcLayout = (VkImageLayout)CommandTrace_ReadUInt(&reader);
+				VkImage dstImage = CommandTrace_ReadHandle<VkImage>(&reader, replay);
+				const VkImageLayout dstLayout = (VkImageLayout)CommandTrace_ReadUInt(&reader);
+				imageToImageCopies.resize((size_t)CommandTrace_ReadUInt(&reader) & 0xFFFF);
+				for (size_t i = 0; i < imageToImageCopies.size() && !reader.failed; ++i)
+					imageToImageCopies[i] = CommandTrace_ReadImageCopy(&reader);
+				if (!reader.failed)
+					Dispatch_CmdCopyImage(dispatch, comBuffer, srcImage, srcLayout, dstImage, dstLayout,
+						(uint32)imageToImageCopies.size(), imageToImageCopies.data());
+				break;
+			}
+
+			default:
+				reader.failed = true;
+				break;
+			}
+		}
+
+		stats.succeeded = !reader.failed;
+		stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+		return stats;
+	}
+
+	//finds where each frame starts in a trace, so frames can be replayed one at a time
+	inline std::vector<size_t> CommandTrace_FindFrames(const CommandTrace& trace)
+	{
+		Dispatch nullDispatch;
+		nullDispatch.backend = DispatchBackend::Null;
+		return CommandTrace_Replay(trace, VK_NULL_HANDLE, &nullDispatch, CommandTraceReplay()).frameOffsets;
+	}
+
+	//writes a trace to a file
+	inline bool CommandTrace_WriteFile(const CommandTrace& trace, const std::string& path)
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			BTD_LogError("Smok Renderer", "Command Trace", "CommandTrace_WriteFile", std::string("Failed to open \"" + path + "\"").c_str());
+			return false;
+		}
+
+		const uint32 header[2] = { SMOK_RENDERER_COMMAND_TRACE_MAGIC, SMOK_RENDERER_COMMAND_TRACE_VERSION };
+		const uint64 counts[3] = { trace.commandCount, trace.uploadBytes, (uint64)trace.data.size() };
+		file.write((const char*)header, sizeof(header));
+		file.write((const char*)counts, sizeof(counts));
+		file.write((const char*)trace.commandCounts, sizeof(trace.commandCounts));
+		file.write((const char*)trace.data.data(), (std::streamsize)trace.data.size());
+		return file.good();
+	}
+
+	//loads a trace from a file
+	inline bool CommandTrace_LoadFile(CommandTrace* trace, const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			BTD_LogError("Smok Renderer", "Command Trace", "CommandTrace_LoadFile", std::string("Failed to open \"" + path + "\"").c_str());
+			return false;
+		}
+
+		uint32 header[2] = { 0, 0 };
+		uint64 counts[3] = { 0, 0, 0 };
+		file.read((char*)header, sizeof(header));
+		if (!file.good() || header[0] != SMOK_RENDERER_COMMAND_TRACE_MAGIC || header[1] != SMOK_RENDERER_COMMAND_TRACE_VERSION)
+		{
+			BTD_LogError("Smok Renderer", "Command Trace", "CommandTrace_LoadFile", std::string("\"" + path + "\" is not a command trace this version can read").c_str());
+			return false;
+		}
+
+		CommandTrace_Clear(trace);
+		file.read((char*)counts, sizeof(counts));
+		file.read((char*)trace->commandCounts, sizeof(trace->commandCounts));
+
+		//the data size comes from the file, so it's checked against what's left before anything is allocated
+		const std::streamoff dataStart = file.tellg();
+		file.seekg(0, std::ios::end);
+		const std::streamoff fileEnd = file.tellg();
+		file.seekg(dataStart);
+		if (!file.good() || dataStart < 0 || fileEnd < dataStart || counts[2] != (uint64)(fileEnd - dataStart))
+		{
+			BTD_LogError("Smok Renderer", "Command Trace", "CommandTrace_LoadFile",
+				std::string("\"" + path + "\" says it has " + std::to_string(counts[2]) + " bytes of commands, but the file doesn't match").c_str());
+			CommandTrace_Clear(trace);
+			return false;
+		}
+
+		trace->commandCount = counts[0]; trace->uploadBytes = counts[1];
+		trace->data.resize((size_t)counts[2]);
+		file.read((char*)trace->data.data(), (std::streamsize)trace->data.size());
+		if (!file.good())
+		{
+			BTD_LogError("Smok Renderer", "Command Trace", "CommandTrace_LoadFile", std::string("\"" + path + "\" was cut off").c_str());
+			CommandTrace_Clear(trace);
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+//defines the per frame stats RenderManager and the renderers fill in, so a frame's cost can be read without a GPU debugger
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+#include <string>
+
+namespace Smok::Renderers
+{
+	//defines the stats of a frame
+	struct FrameStats
+	{
+		uint64 frameNumber = 0;
+
+		//recording
+		uint32 drawCallCount = 0; //direct draws
+		uint32 indirectDrawCount = 0; //indirect draws, their instances and triangles are decided on the GPU so aren't counted
+		uint32 dispatchCount = 0; //compute dispatches
+		uint64 instanceCount = 0; //of the direct draws
+		uint64 triangleCount = 0; //of the direct draws
+		uint32 batchCount = 0;
+		uint32 pipelineBindCount = 0;
+		uint32 descriptorBindCount = 0; //vkCmdBindDescriptorSets calls
+		uint32 descriptorUpdateCount = 0; //descriptor sets rewritten
+
+		//uploads
+		uint64 objectBufferBytes = 0; //memcpy'd into the mesh object buffers
+		uint64 GUIQuadBytes = 0; //memcpy'd into the GUI quad buffers
+		uint32 megaMeshBufferRebuildCount = 0; //the mega mesh buffer being remade since the last frame
+		uint32 textureArrayUploadCount = 0; //the texture array descriptor being rewritten
+		uint64 stagedBytes = 0; //copied into the staging ring
+		uint32 stagingSubmitCount = 0; //transfer submissions of the staging ring
+
+		//waiting, in milliseconds
+		double nextFrameFenceWait = 0.0; //NextFrame waiting on the frame in flight's fence
+		double submitFrameWait = 0.0; //SubmitFrame waiting on the fence of the frame last drawn into the image
+
+		//counts a direct draw
+		inline void AddDraw(const uint32 indexCount, const uint32 instances)
+		{
+			drawCallCount++;
+			instanceCount += instances;
+			triangleCount += (uint64)(indexCount / 3) * (uint64)instances;
+		}
+
+		//converts the stats into a human readable string
+		inline std::string ToString() const
+		{
+			return "Frame " + std::to_string(frameNumber) + "\n" +
+				"Draws: " + std::to_string(drawCallCount) + " direct, " + std::to_string(indirectDrawCount) + " indirect, " +
+				std::to_string(dispatchCount) + " dispatches\n" +
+				"Instances: " + std::to_string(instanceCount) + ", Triangles: " + std::to_string(triangleCount) + ", Batches: " + std::to_string(batchCount) + "\n" +
+				"Binds: " + std::to_string(pipelineBindCount) + " pipelines, " + std::to_string(descriptorBindCount) + " descriptor sets, " +
+				std::to_string(descriptorUpdateCount) + " descriptor updates\n" +
+				"Uploads: " + std::to_string(objectBufferBytes) + " object buffer bytes, " + std::to_string(GUIQuadBytes) + " GUI quad bytes, " +
+				std::to_string(megaMeshBufferRebuildCount) + " mega mesh buffer rebuilds, " + std::to_string(textureArrayUploadCount) + " texture array uploads\n" +
+				"Staging: " + std::to_string(stagedBytes) + " bytes staged, " + std::to_string(stagingSubmitCount) + " submits\n" +
+				"Waits: " + std::to_string(nextFrameFenceWait) + " ms in NextFrame, " + std::to_string(submitFrameWait) + " ms in SubmitFrame";
+		}
+	};
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+//defines a mega mesh buffer that stores meshes in the mesh library's full precision vertex format
+//it takes the place of the mesh library's mega mesh buffer so it's uploads can go through the staging ring, like the quantized one
+
+#include <SmokMesh/Mesh.hpp>
+
+#include <SmokRenderers/Geometry/MegaMeshBufferUpload.hpp>
+
+namespace Smok::Renderers::Geometry
+{
+	//defines a mesh stored in the full precision mega mesh buffer
+	struct FullMegaMeshBuffer_Mesh
+	{
+		uint32 firstVertex = 0, vertexCount = 0; //the range of vertices
+		uint32 firstIndex = 0, indexCount = 0; //the range of indices
+	};
+
+	//defines a mega mesh buffer of full precision vertices
+	struct FullMegaMeshBuffer
+	{
+		std::vector<Smok::Mesh::Vertex> vertices; //the CPU side vertices
+		std::vector<uint32> indices; //the CPU side indices
+		std::vector<FullMegaMeshBuffer_Mesh> meshes; //the meshes in the buffer
+
+		bool isDirty = false; //have meshes been added since the GPU buffers were made
+
+		VkBuffer vertexBuffer = VK_NULL_HANDLE, indexBuffer = VK_NULL_HANDLE;
+		VmaAllocation vertexAllocation = VK_NULL_HANDLE, indexAllocation = VK_NULL_HANDLE;
+		uint32 vertexCount = 0, indexCount = 0; //the counts in the GPU buffers
+	};
+
+	//adds a mesh to the buffer
+	inline void FullMegaMeshBuffer_AddMesh(FullMegaMeshBuffer* buffer, const Smok::Mesh::Mesh& mesh, uint32& meshIndex)
+	{
+		meshIndex = (uint32)buffer->meshes.size();
+		FullMegaMeshBuffer_Mesh* entry = &buffer->meshes.emplace_back(FullMegaMeshBuffer_Mesh());
+
+		entry->firstVertex = (uint32)buffer->vertices.size(); entry->vertexCount = (uint32)mesh.vertices.size();
+		entry->firstIndex = (uint32)buffer->indices.size(); entry->indexCount = (uint32)mesh.indices.size();
+
+		buffer->vertices.insert(buffer->vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+		buffer->indices.insert(buffer->indices.end(), mesh.indices.begin(), mesh.indices.end());
+
+		buffer->isDirty = true;
+	}
+
+	//destroys the GPU buffers
+	inline void FullMegaMeshBuffer_DestroyBuffer(FullMegaMeshBuffer* buffer, VmaAllocator allocator)
+	{
+		MegaMeshBuffer_DestroyGPUBuffers(allocator, buffer->vertexBuffer, buffer->vertexAllocation, buffer->indexBuffer, buffer->indexAllocation);
+		buffer->vertexCount = 0; buffer->indexCount = 0;
+		buffer->isDirty = !buffer->meshes.empty();
+	}
+
+	//creates the GPU buffers, only remaking them if meshes were added since the last time
+	//with a staging ring that can hold them, the buffers are device local and are filled once the ring is flushed, otherwise they're host visible
+	inline bool FullMegaMeshBuffer_CreateBuffer(FullMegaMeshBuffer* buffer, VmaAllocator allocator, SMGraphics_Core_GPU* GPU,
+		Util::StagingRing* stagingRing = nullptr, Dispatch* dispatch = nullptr)
+	{
+		if (!buffer->isDirty || buffer->vertices.empty() || buffer->indices.empty())
+			return true;
+
+		if (!MegaMeshBuffer_CreateGPUBuffers(allocator, GPU, stagingRing, dispatch,
+			buffer->vertices.data(), buffer->vertices.size() * sizeof(Smok::Mesh::Vertex), buffer->indices.data(), buffer->indices.size() * sizeof(uint32),
+			buffer->vertexBuffer, buffer->vertexAllocation, buffer->indexBuffer, buffer->indexAllocation))
+		{
+			FullMegaMeshBuffer_DestroyBuffer(buffer, allocator);
+			return false;
+		}
+
+		buffer->vertexCount = (uint32)buffer->vertices.size();
+		buffer->indexCount = (uint32)buffer->indices.size();
+		buffer->isDirty = false;
+		return true;
+	}
+
+	//binds the buffer
+	inline void FullMegaMeshBuffer_Bind(FullMegaMeshBuffer* buffer, VkCommandBuffer& comBuffer)
+	{
+		const VkDeviceSize offset = 0;
+		vkCmdBindVertexBuffers(comBuffer, 0, 1, &buffer->vertexBuffer, &offset);
+		vkCmdBindIndexBuffer(comBuffer, buffer->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+	}
+
+	//draws a mesh in the buffer, the object index is passed as the first instance
+	inline void FullMegaMeshBuffer_Draw(FullMegaMeshBuffer* buffer, VkCommandBuffer& comBuffer,
+		const uint64& meshIndex, const uint64& objIndex)
+	{
+		const FullMegaMeshBuffer_Mesh& mesh = buffer->meshes[meshIndex];
+		vkCmdDrawIndexed(comBuffer, mesh.indexCount, 1, mesh.firstIndex, (int32)mesh.firstVertex, (uint32)objIndex);
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+//uploads the vertex and index buffers of the mega mesh buffers, whatever their vertex format
+//with a staging ring that can hold them, the buffers are device local and are filled once the ring is flushed, otherwise they're host visible
+
+#include <SmokRenderers/Util/StagingRing.hpp>
+
+namespace Smok::Renderers::Geometry
+{
+	//creates a host visible buffer and copies data into it
+	inline bool MegaMeshBuffer_CreateHostBuffer(VmaAllocator allocator, const void* data, const size_t size,
+		VkBufferUsageFlags usage, VkBuffer& buffer, VmaAllocation& allocation, Dispatch* dispatch = nullptr)
+	{
+		VkBufferCreateInfo bufferInfo = {};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = usage;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+		allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		VmaAllocationInfo allocationInfo = {};
+		if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &buffer, &allocation, &allocationInfo) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Mega Mesh Buffer Upload", "MegaMeshBuffer_CreateHostBuffer",
+				"Failed to create a GPU buffer!");
+			buffer = VK_NULL_HANDLE; allocation = VK_NULL_HANDLE;
+			return false;
+		}
+
+		Dispatch_Upload(dispatch, allocationInfo.pMappedData, (uint64)buffer, 0, data, size);
+		vmaFlushAllocation(allocator, allocation, 0, VK_WHOLE_SIZE);
+		return true;
+	}
+
+	//creates a device local buffer that's filled through a staging ring
+	inline bool MegaMeshBuffer_CreateStagedBuffer(VmaAllocator allocator, Util::StagingRing* stagingRing, const void* data, const size_t size,
+		VkBufferUsageFlags usage, const VkPipelineStageFlags dstStages, const VkAccessFlags dstAccess, VkBuffer& buffer, VmaAllocation& allocation)
+	{
+		VkBufferCreateInfo bufferInfo = {};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+		if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &buffer, &allocation, nullptr) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Mega Mesh Buffer Upload", "MegaMeshBuffer_CreateStagedBuffer",
+				"Failed to create a GPU buffer!");
+			buffer = VK_NULL_HANDLE; allocation = VK_NULL_HANDLE;
+			return false;
+		}
+
+		return Util::StagingRing_UploadBuffer(stagingRing, buffer, 0, data, size, dstStages, dstAccess);
+	}
+
+	//destroys a vertex and index buffer pair
+	inline void MegaMeshBuffer_DestroyGPUBuffers(VmaAllocator allocator, VkBuffer& vertexBuffer, VmaAllocation& vertexAllocation,
+		VkBuffer& indexBuffer, VmaAllocation& indexAllocation)
+	{
+		if (vertexBuffer != VK_NULL_HANDLE)
+			vmaDestroyBuffer(allocator, vertexBuffer, vertexAllocation);
+		if (indexBuffer != VK_NULL_HANDLE)
+			vmaDestroyBuffer(allocator, indexBuffer, indexAllocation);
+
+		vertexBuffer = VK_NULL_HANDLE; indexBuffer = VK_NULL_HANDLE;
+		vertexAllocation = VK_NULL_HANDLE; indexAllocation = VK_NULL_HANDLE;
+	}
+
+	//remakes a vertex and index buffer pair from the CPU side data, destroying the old pair once the GPU is done with it
+	//the host visible writes are recorded to the dispatch, the staged ones to the ring's
+	inline bool MegaMeshBuffer_CreateGPUBuffers(VmaAllocator allocator, SMGraphics_Core_GPU* GPU, Util::StagingRing* stagingRing, Dispatch* dispatch,
+		const void* vertices, const size_t vertexBytes, const void* indices, const size_t indexBytes,
+		VkBuffer& vertexBuffer, VmaAllocation& vertexAllocation, VkBuffer& indexBuffer, VmaAllocation& indexAllocation)
+	{
+		const bool staged = (Util::StagingRing_IsValid(stagingRing) && vertexBytes + indexBytes + SMOK_RENDERER_STAGING_RING_ALIGNMENT <= stagingRing->buffer.size);
+
+		//the old buffers may still be in flight, or have copies queued into them
+		if (vertexBuffer != VK_NULL_HANDLE || indexBuffer != VK_NULL_HANDLE)
+		{
+			if (Util::StagingRing_IsValid(stagingRing))
+				Util::StagingRing_FlushAndWait(stagingRing);
+			vkDeviceWaitIdle(GPU->device);
+			MegaMeshBuffer_DestroyGPUBuffers(allocator, vertexBuffer, vertexAllocation, indexBuffer, indexAllocation);
+		}
+
+		if (staged)
+		{
+			if (!MegaMeshBuffer_CreateStagedBuffer(allocator, stagingRing, vertices, vertexBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, vertexBuffer, vertexAllocation) ||
+				!MegaMeshBuffer_CreateStagedBuffer(allocator, stagingRing, indices, indexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+					VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT, indexBuffer, indexAllocation))
+			{
+				//a copy may already be queued into the vertex buffer
+				Util::StagingRing_FlushAndWait(stagingRing);
+				MegaMeshBuffer_DestroyGPUBuffers(allocator, vertexBuffer, vertexAllocation, indexBuffer, indexAllocation);
+				return false;
+			}
+		}
+
+		else if (!MegaMeshBuffer_CreateHostBuffer(allocator, vertices, vertexBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexAllocation, dispatch) ||
+			!MegaMeshBuffer_CreateHostBuffer(allocator, indices, indexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexAllocation, dispatch))
+		{
+			MegaMeshBuffer_DestroyGPUBuffers(allocator, vertexBuffer, vertexAllocation, indexBuffer, indexAllocation);
+			return false;
+		}
+
+		return true;
+	}
+}
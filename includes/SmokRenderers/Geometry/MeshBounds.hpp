@@ -0,0 +1,99 @@
+#pragma once
+
+//calculates the bounds of meshes, so they can be culled and LODed without the raw vertex data
+
+#include <SmokMesh/Mesh.hpp>
+
+#include <glm/glm.hpp>
+
+namespace Smok::Renderers::Geometry
+{
+	//defines the bounds of a mesh in mesh space
+	struct MeshBounds
+	{
+		glm::vec3 min = glm::vec3(0.0f), max = glm::vec3(0.0f); //the AABB
+		glm::vec4 sphere = glm::vec4(0.0f); //the bounding sphere || xyz = center, w = radius
+	};
+
+	//calculates the bounds of a set of positions
+	inline MeshBounds MeshBounds_Calculate(const glm::vec3* positions, const size_t positionCount, const size_t stride = sizeof(glm::vec3))
+	{
+		MeshBounds bounds;
+		if (!positionCount)
+			return bounds;
+
+		const uint8* data = (const uint8*)positions;
+
+		//AABB
+		bounds.min = *(const glm::vec3*)data; bounds.max = bounds.min;
+		for (size_t i = 1; i < positionCount; ++i)
+		{
+			const glm::vec3& p = *(const glm::vec3*)(data + i * stride);
+			bounds.min = glm::min(bounds.min, p);
+			bounds.max = glm::max(bounds.max, p);
+		}
+
+		//sphere around the AABB center, with the radius fitted to the actual points so it stays tight
+		const glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+		float radiusSq = 0.0f;
+		for (size_t i = 0; i < positionCount; ++i)
+		{
+			const glm::vec3 d = *(const glm::vec3*)(data + i * stride) - center;
+			radiusSq = glm::max(radiusSq, glm::dot(d, d));
+		}
+		bounds.sphere = glm::vec4(center, std::sqrt(radiusSq));
+
+		return bounds;
+	}
+
+	//calculates the bounds of a mesh
+	inline MeshBounds MeshBounds_Calculate(const Smok::Mesh::Mesh& mesh)
+	{
+		if (mesh.vertices.empty())
+			return MeshBounds();
+
+		return MeshBounds_Calculate(&mesh.vertices[0].position, mesh.vertices.size(), sizeof(Smok::Mesh::Vertex));
+	}
+
+	//merges two bounds
+	inline MeshBounds MeshBounds_Merge(const MeshBounds& a, const MeshBounds& b)
+	{
+		MeshBounds bounds;
+		bounds.min = glm::min(a.min, b.min);
+		bounds.max = glm::max(a.max, b.max);
+
+		const glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+		const float radius = glm::max(glm::length(glm::vec3(a.sphere.x, a.sphere.y, a.sphere.z) - center) + a.sphere.w,
+			glm::length(glm::vec3(b.sphere.x, b.sphere.y, b.sphere.z) - center) + b.sphere.w);
+		bounds.sphere = glm::vec4(center, radius);
+
+		return bounds;
+	}
+
+	//transforms a bounding sphere into world space || the radius is scaled by the largest axis scale
+	inline glm::vec4 BoundingSphere_Transform(const glm::vec4& sphere, const glm::mat4& model)
+	{
+		const glm::vec4 center = model * glm::vec4(sphere.x, sphere.y, sphere.z, 1.0f);
+		const float scaleSq = glm::max(glm::dot(glm::vec3(model[0].x, model[0].y, model[0].z), glm::vec3(model[0].x, model[0].y, model[0].z)),
+			glm::max(glm::dot(glm::vec3(model[1].x, model[1].y, model[1].z), glm::vec3(model[1].x, model[1].y, model[1].z)),
+				glm::dot(glm::vec3(model[2].x, model[2].y, model[2].z), glm::vec3(model[2].x, model[2].y, model[2].z))));
+
+		return glm::vec4(center.x, center.y, center.z, sphere.w * std::sqrt(scaleSq));
+	}
+
+	//calculates the fraction of the screen height a world space bounding sphere covers || 1 or more when the camera is inside it
+	inline float BoundingSphere_CalculateScreenSize(const glm::vec4& worldSphere, const glm::mat4& V, const glm::mat4& P)
+	{
+		//orthographic projections don't shrink with distance
+		if (P[3][3] == 1.0f)
+			return worldSphere.w * std::fabs(P[1][1]);
+
+		const glm::vec4 viewCenter = V * glm::vec4(worldSphere.x, worldSphere.y, worldSphere.z, 1.0f);
+		const float distance = glm::length(glm::vec3(viewCenter.x, viewCenter.y, viewCenter.z));
+		if (distance <= worldSphere.w)
+			return 1.0f;
+
+		//P[1][1] is 1 / tan(fovY / 2), so this is the projected diameter over the screen height of 2
+		return worldSphere.w * std::fabs(P[1][1]) / distance;
+	}
+}
@@ -0,0 +1,443 @@
+#pragma once
+
+//optimizes meshes on ingestion, before they're pushed into the mega mesh buffer
+//reorders indices for the post transform vertex cache, reorders vertices for fetch locality and removes duplicate vertices
+
+#include <SmokMesh/Mesh.hpp>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+
+namespace Smok::Renderers::Geometry
+{
+	//defines the vertex cache stats of a index buffer, measured by simulating a FIFO cache on the CPU
+	struct VertexCacheStats
+	{
+		uint32 triangleCount = 0; //the number of triangles
+		uint32 uniqueVertexCount = 0; //the number of vertices referenced by the indices
+		uint32 transformedVertexCount = 0; //the number of vertices that missed the cache and had to be transformed
+
+		float ACMR = 0.0f; //average cache miss ratio, transformed vertices per triangle || 0.5 is ideal, 3.0 is worst
+		float ATVR = 0.0f; //average transformed vertex ratio, transformed vertices per unique vertex || 1.0 is ideal
+	};
+
+	//defines what optimizations are ran on a mesh
+	struct MeshOptimizerSettings
+	{
+		bool removeDuplicateVertices = true; //merges bitwise identical vertices
+		bool optimizeVertexCache = true; //reorders triangles for the post transform vertex cache
+		bool optimizeOverdraw = true; //reorders clusters of triangles so outward facing ones are drawn first
+		bool optimizeVertexFetch = true; //reorders vertices in the order they're first used
+
+		uint32 analyzeCacheSize = 16; //the FIFO cache size used when measuring the stats
+	};
+
+	//defines the report of optimizing meshes
+	struct MeshOptimizerReport
+	{
+		uint32 meshCount = 0; //the number of meshes optimized
+		uint32 vertexCountBefore = 0, vertexCountAfter = 0; //the vertex counts before and after removing duplicates
+
+		VertexCacheStats before, after; //the vertex cache stats before and after
+
+		//merges another report into this one
+		inline void Merge(const MeshOptimizerReport& other)
+		{
+			meshCount += other.meshCount;
+			vertexCountBefore += other.vertexCountBefore; vertexCountAfter += other.vertexCountAfter;
+
+			auto merge = [](VertexCacheStats& a, const VertexCacheStats& b) {
+				a.triangleCount += b.triangleCount; a.uniqueVertexCount += b.uniqueVertexCount;
+				a.transformedVertexCount += b.transformedVertexCount;
+				a.ACMR = (a.triangleCount > 0 ? (float)a.transformedVertexCount / (float)a.triangleCount : 0.0f);
+				a.ATVR = (a.uniqueVertexCount > 0 ? (float)a.transformedVertexCount / (float)a.uniqueVertexCount : 0.0f);
+			};
+			merge(before, other.before); merge(after, other.after);
+		}
+
+		//converts the report into a human readable string
+		inline std::string ToString() const
+		{
+			return "Meshes: " + std::to_string(meshCount) + "\n" +
+				"Vertices: " + std::to_string(vertexCountBefore) + " -> " + std::to_string(vertexCountAfter) + "\n" +
+				"ACMR: " + std::to_string(before.ACMR) + " -> " + std::to_string(after.ACMR) + "\n" +
+				"ATVR: " + std::to_string(before.ATVR) + " -> " + std::to_string(after.ATVR);
+		}
+	};
+
+	//measures the vertex cache efficiency of a index buffer by simulating a FIFO cache
+	inline VertexCacheStats MeshOptimizer_AnalyzeVertexCache(const uint32* indices, const size_t indexCount, const uint32 vertexCount,
+		const uint32 cacheSize = 16)
+	{
+		VertexCacheStats stats;
+		stats.triangleCount = (uint32)(indexCount / 3);
+
+		//a vertex is in the cache if it was pushed less then cacheSize misses ago
+		std::vector<uint32> cacheTimestamps(vertexCount, 0);
+		uint32 timestamp = cacheSize + 1;
+
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			const uint32 v = indices[i];
+			if (cacheTimestamps[v] == 0)
+				stats.uniqueVertexCount++;
+
+			if (timestamp - cacheTimestamps[v] > cacheSize)
+			{
+				cacheTimestamps[v] = timestamp++;
+				stats.transformedVertexCount++;
+			}
+		}
+
+		stats.ACMR = (stats.triangleCount > 0 ? (float)stats.transformedVertexCount / (float)stats.triangleCount : 0.0f);
+		stats.ATVR = (stats.uniqueVertexCount > 0 ? (float)stats.transformedVertexCount / (float)stats.uniqueVertexCount : 0.0f);
+		return stats;
+	}
+
+	//hashes the bytes of a vertex
+	inline uint64 MeshOptimizer_HashBytes(const void* data, const size_t size)
+	{
+		const uint8* bytes = (const uint8*)data;
+		uint64 hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	//removes bitwise identical vertices and remaps the indices || returns the new vertex count
+	template<typename VertexT>
+	inline uint32 MeshOptimizer_RemoveDuplicateVertices(std::vector<VertexT>& vertices, std::vector<uint32>& indices)
+	{
+		const size_t vertexCount = vertices.size();
+		if (!vertexCount)
+			return 0;
+
+		//open addressed table of vertex index + 1, sized to a power of two at least twice the vertex count
+		size_t tableSize = 1;
+		while (tableSize < vertexCount * 2)
+			tableSize <<= 1;
+		std::vector<uint32> table(tableSize, 0);
+
+		std::vector<uint32> remap(vertexCount);
+		std::vector<VertexT> uniqueVertices; uniqueVertices.reserve(vertexCount);
+
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			size_t slot = (size_t)MeshOptimizer_HashBytes(&vertices[v], sizeof(VertexT)) & (tableSize - 1);
+			while (true)
+			{
+				//new unique vertex
+				if (table[slot] == 0)
+				{
+					remap[v] = (uint32)uniqueVertices.size();
+					uniqueVertices.emplace_back(vertices[v]);
+					table[slot] = remap[v] + 1;
+					break;
+				}
+
+				//duplicate
+				if (memcmp(&uniqueVertices[table[slot] - 1], &vertices[v], sizeof(VertexT)) == 0)
+				{
+					remap[v] = table[slot] - 1;
+					break;
+				}
+
+				slot = (slot + 1) & (tableSize - 1);
+			}
+		}
+
+		for (size_t i = 0; i < indices.size(); ++i)
+			indices[i] = remap[indices[i]];
+
+		vertices.swap(uniqueVertices);
+		return (uint32)vertices.size();
+	}
+
+	//scores a vertex for the vertex cache optimizer, based on Tom Forsyth's linear speed vertex cache optimization
+	inline float MeshOptimizer_VertexScore(const int32 cachePosition, const uint32 liveTriangleCount, const uint32 cacheSize)
+	{
+		//no triangles left using it
+		if (liveTriangleCount == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			//the last triangle's vertices get a fixed score, so we don't just keep re-using them
+			if (cachePosition < 3)
+				score = 0.75f;
+			else
+				score = std::pow(1.0f - (float)(cachePosition - 3) / (float)(cacheSize - 3), 1.5f);
+		}
+
+		//boosts vertices with few triangles left, so lone triangles get cleaned up instead of left for later
+		score += 2.0f * std::pow((float)liveTriangleCount, -0.5f);
+		return score;
+	}
+
+	//reorders triangles to improve post transform vertex cache efficiency
+	inline void MeshOptimizer_OptimizeVertexCache(std::vector<uint32>& indices, const uint32 vertexCount)
+	{
+		const uint32 cacheSize = 32;
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount < 2)
+			return;
+
+		//builds the vertex -> triangle adjacency
+		std::vector<uint32> liveTriangles(vertexCount, 0), adjacencyOffsets(vertexCount + 1, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+			liveTriangles[indices[i]]++;
+		for (uint32 v = 0; v < vertexCount; ++v)
+			adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+
+		std::vector<uint32> adjacency(triangleCount * 3), fillCounts(vertexCount, 0);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			for (uint32 k = 0; k < 3; ++k)
+			{
+				const uint32 v = indices[t * 3 + k];
+				adjacency[adjacencyOffsets[v] + fillCounts[v]++] = (uint32)t;
+			}
+		}
+
+		//scores
+		std::vector<int32> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount, 0.0f), triangleScores(triangleCount, 0.0f);
+		for (uint32 v = 0; v < vertexCount; ++v)
+			vertexScores[v] = MeshOptimizer_VertexScore(-1, liveTriangles[v], cacheSize);
+
+		int64 bestTriangle = -1; float bestScore = -1.0f;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+			if (triangleScores[t] > bestScore)
+			{
+				bestScore = triangleScores[t];
+				bestTriangle = (int64)t;
+			}
+		}
+
+		std::vector<uint8> emitted(triangleCount, 0);
+		std::vector<uint32> cache, newCache; cache.reserve(cacheSize + 3); newCache.reserve(cacheSize + 3);
+		std::vector<uint32> output; output.reserve(triangleCount * 3);
+		size_t fallbackCursor = 0;
+
+		while (bestTriangle >= 0)
+		{
+			const size_t t = (size_t)bestTriangle;
+			const uint32 tri[3] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+
+			//emits the triangle
+			output.emplace_back(tri[0]); output.emplace_back(tri[1]); output.emplace_back(tri[2]);
+			emitted[t] = 1;
+
+			//removes it from it's vertices adjacency
+			for (uint32 k = 0; k < 3; ++k)
+			{
+				const uint32 v = tri[k];
+				uint32* begin = &adjacency[adjacencyOffsets[v]];
+				for (uint32 a = 0; a < liveTriangles[v]; ++a)
+				{
+					if (begin[a] == t)
+					{
+						begin[a] = begin[liveTriangles[v] - 1];
+						break;
+					}
+				}
+				liveTriangles[v]--;
+			}
+
+			//the triangle's vertices move to the front of the cache
+			newCache.clear();
+			newCache.emplace_back(tri[0]); newCache.emplace_back(tri[1]); newCache.emplace_back(tri[2]);
+			for (size_t c = 0; c < cache.size(); ++c)
+			{
+				if (cache[c] != tri[0] && cache[c] != tri[1] && cache[c] != tri[2])
+					newCache.emplace_back(cache[c]);
+			}
+
+			//updates the scores of everything in the cache, and anything that just fell out of it
+			for (size_t c = 0; c < newCache.size(); ++c)
+			{
+				const uint32 v = newCache[c];
+				cachePositions[v] = (c < cacheSize ? (int32)c : -1);
+				vertexScores[v] = MeshOptimizer_VertexScore(cachePositions[v], liveTriangles[v], cacheSize);
+			}
+			if (newCache.size() > cacheSize)
+				newCache.resize(cacheSize);
+			cache.swap(newCache);
+
+			//finds the best triangle touching the cache
+			bestTriangle = -1; bestScore = -1.0f;
+			for (size_t c = 0; c < cache.size(); ++c)
+			{
+				const uint32 v = cache[c];
+				for (uint32 a = 0; a < liveTriangles[v]; ++a)
+				{
+					const uint32 adjTri = adjacency[adjacencyOffsets[v] + a];
+					const float score = vertexScores[indices[adjTri * 3]] + vertexScores[indices[adjTri * 3 + 1]] +
+						vertexScores[indices[adjTri * 3 + 2]];
+					triangleScores[adjTri] = score;
+					if (score > bestScore)
+					{
+						bestScore = score;
+						bestTriangle = adjTri;
+					}
+				}
+			}
+
+			//nothing touches the cache, so we start again from the next triangle we haven't emitted
+			if (bestTriangle < 0)
+			{
+				while (fallbackCursor < triangleCount && emitted[fallbackCursor])
+					fallbackCursor++;
+				if (fallbackCursor < triangleCount)
+					bestTriangle = (int64)fallbackCursor;
+			}
+		}
+
+		output.insert(output.end(), indices.begin() + triangleCount * 3, indices.end()); //keeps any stray indices
+		indices.swap(output);
+	}
+
+	//reorders clusters of triangles so the ones facing out from the mesh center are drawn first, reducing overdraw
+	//clusters are split where the vertex cache would be cold anyway, so the cache efficiency is kept
+	template<typename VertexT>
+	inline void MeshOptimizer_OptimizeOverdraw(std::vector<uint32>& indices, const std::vector<VertexT>& vertices, const uint32 cacheSize = 16)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount < 2 || vertices.empty())
+			return;
+
+		//splits into clusters where a triangle misses the cache on all 3 vertices
+		std::vector<uint32> clusterStarts;
+		std::vector<uint32> cacheTimestamps(vertices.size(), 0);
+		uint32 timestamp = cacheSize + 1;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			uint32 misses = 0;
+			for (uint32 k = 0; k < 3; ++k)
+			{
+				const uint32 v = indices[t * 3 + k];
+				if (timestamp - cacheTimestamps[v] > cacheSize)
+				{
+					cacheTimestamps[v] = timestamp++;
+					misses++;
+				}
+			}
+
+			if (t == 0 || misses == 3)
+				clusterStarts.emplace_back((uint32)t);
+		}
+		clusterStarts.emplace_back((uint32)triangleCount);
+
+		const size_t clusterCount = clusterStarts.size() - 1;
+		if (clusterCount < 2)
+			return;
+
+		//the mesh center
+		glm::vec3 meshCenter = glm::vec3(0.0f);
+		for (size_t i = 0; i < vertices.size(); ++i)
+			meshCenter += vertices[i].position;
+		meshCenter /= (float)vertices.size();
+
+		//scores each cluster by how much it faces away from the center
+		std::vector<float> clusterScores(clusterCount, 0.0f);
+		for (size_t c = 0; c < clusterCount; ++c)
+		{
+			glm::vec3 centroid = glm::vec3(0.0f), normal = glm::vec3(0.0f);
+			float totalArea = 0.0f;
+			for (uint32 t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+			{
+				const glm::vec3& a = vertices[indices[t * 3]].position;
+				const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+				const glm::vec3& p = vertices[indices[t * 3 + 2]].position;
+
+				//the cross product's length is twice the area, so bigger triangles count more
+				const glm::vec3 areaNormal = glm::cross(b - a, p - a);
+				const float area = glm::length(areaNormal);
+
+				centroid += (a + b + p) * (area / 3.0f);
+				normal += areaNormal;
+				totalArea += area;
+			}
+
+			const float normalLength = glm::length(normal);
+			if (normalLength <= 0.0f || totalArea <= 0.0f)
+				continue;
+
+			centroid /= totalArea;
+			clusterScores[c] = glm::dot(centroid - meshCenter, normal / normalLength);
+		}
+
+		//sorts the clusters, most outward facing first
+		std::vector<uint32> clusterOrder(clusterCount);
+		for (uint32 c = 0; c < clusterCount; ++c)
+			clusterOrder[c] = c;
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+			[&clusterScores](const uint32 a, const uint32 b) { return clusterScores[a] > clusterScores[b]; });
+
+		std::vector<uint32> output; output.reserve(indices.size());
+		for (size_t o = 0; o < clusterCount; ++o)
+		{
+			const uint32 c = clusterOrder[o];
+			output.insert(output.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+		}
+		output.insert(output.end(), indices.begin() + triangleCount * 3, indices.end());
+		indices.swap(output);
+	}
+
+	//reorders vertices in the order the indices first use them, dropping unused vertices || returns the new vertex count
+	template<typename VertexT>
+	inline uint32 MeshOptimizer_OptimizeVertexFetch(std::vector<VertexT>& vertices, std::vector<uint32>& indices)
+	{
+		const uint32 unused = ~0u;
+		std::vector<uint32> remap(vertices.size(), unused);
+		std::vector<VertexT> ordered; ordered.reserve(vertices.size());
+
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			uint32& newIndex = remap[indices[i]];
+			if (newIndex == unused)
+			{
+				newIndex = (uint32)ordered.size();
+				ordered.emplace_back(vertices[indices[i]]);
+			}
+			indices[i] = newIndex;
+		}
+
+		vertices.swap(ordered);
+		return (uint32)vertices.size();
+	}
+
+	//runs the enabled optimizations on a mesh
+	inline MeshOptimizerReport MeshOptimizer_OptimizeMesh(Smok::Mesh::Mesh& mesh, const MeshOptimizerSettings& settings)
+	{
+		MeshOptimizerReport report;
+		report.meshCount = 1;
+		report.vertexCountBefore = (uint32)mesh.vertices.size();
+		report.before = MeshOptimizer_AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), (uint32)mesh.vertices.size(),
+			settings.analyzeCacheSize);
+
+		if (settings.removeDuplicateVertices)
+			MeshOptimizer_RemoveDuplicateVertices(mesh.vertices, mesh.indices);
+
+		if (settings.optimizeVertexCache)
+			MeshOptimizer_OptimizeVertexCache(mesh.indices, (uint32)mesh.vertices.size());
+
+		if (settings.optimizeOverdraw)
+			MeshOptimizer_OptimizeOverdraw(mesh.indices, mesh.vertices, settings.analyzeCacheSize);
+
+		if (settings.optimizeVertexFetch)
+			MeshOptimizer_OptimizeVertexFetch(mesh.vertices, mesh.indices);
+
+		report.vertexCountAfter = (uint32)mesh.vertices.size();
+		report.after = MeshOptimizer_AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), (uint32)mesh.vertices.size(),
+			settings.analyzeCacheSize);
+		return report;
+	}
+}
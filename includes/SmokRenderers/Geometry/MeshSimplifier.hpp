@@ -0,0 +1,149 @@
+#pragma once
+
+//simplifies meshes for generating LODs
+//uses vertex clustering, snapping vertices to a grid and merging everything in a cell, which is fast and never fails on messy meshes
+
+#include <SmokRenderers/Geometry/MeshBounds.hpp>
+#include <SmokRenderers/Geometry/MeshOptimizer.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Smok::Renderers::Geometry
+{
+	//defines a triangle's indices, rotated so the smallest is first, as a key for finding duplicates
+	struct MeshSimplifier_Triangle
+	{
+		uint32 indices[3] = { 0, 0, 0 };
+
+		inline bool operator==(const MeshSimplifier_Triangle& other) const
+		{
+			return indices[0] == other.indices[0] && indices[1] == other.indices[1] && indices[2] == other.indices[2];
+		}
+	};
+
+	//hashes a triangle key || the map compares the indices themselves, so a collision can't drop a triangle
+	struct MeshSimplifier_TriangleHash
+	{
+		inline size_t operator()(const MeshSimplifier_Triangle& triangle) const
+		{
+			return (size_t)MeshOptimizer_HashBytes(triangle.indices, sizeof(triangle.indices));
+		}
+	};
+
+	//simplifies a mesh by clustering it's vertices into a grid of the given resolution along the longest axis
+	inline void MeshSimplifier_ClusterVertices(const Smok::Mesh::Mesh& source, const MeshBounds& bounds, const uint32 gridResolution,
+		Smok::Mesh::Mesh& result)
+	{
+		result.vertices.clear(); result.indices.clear();
+
+		const glm::vec3 extent = bounds.max - bounds.min;
+		const float longestAxis = glm::max(extent.x, glm::max(extent.y, extent.z));
+		if (longestAxis <= 0.0f || gridResolution == 0)
+			return;
+
+		const float cellSize = longestAxis / (float)gridResolution;
+		const uint32 cellsX = (uint32)(extent.x / cellSize) + 1, cellsY = (uint32)(extent.y / cellSize) + 1;
+
+		//maps each vertex to a cell, and each used cell to a new vertex
+		std::unordered_map<uint64, uint32> cellToVertex; cellToVertex.reserve(source.vertices.size());
+		std::vector<uint32> remap(source.vertices.size());
+		std::vector<uint32> cellVertexCounts;
+
+		for (size_t v = 0; v < source.vertices.size(); ++v)
+		{
+			const glm::vec3 local = (source.vertices[v].position - bounds.min) / cellSize;
+			const uint64 cell = (uint64)local.x + (uint64)cellsX * ((uint64)local.y + (uint64)cellsY * (uint64)local.z);
+
+			auto found = cellToVertex.find(cell);
+			if (found == cellToVertex.end())
+			{
+				found = cellToVertex.emplace(cell, (uint32)result.vertices.size()).first;
+				Smok::Mesh::Vertex* vertex = &result.vertices.emplace_back(source.vertices[v]);
+				vertex->position = glm::vec3(0.0f); vertex->normal = glm::vec3(0.0f); vertex->uv = glm::vec2(0.0f);
+				cellVertexCounts.emplace_back(0);
+			}
+
+			//accumulates the cell average
+			const uint32 newIndex = found->second;
+			Smok::Mesh::Vertex* vertex = &result.vertices[newIndex];
+			vertex->position += source.vertices[v].position;
+			vertex->normal += source.vertices[v].normal;
+			vertex->uv += source.vertices[v].uv;
+			cellVertexCounts[newIndex]++;
+
+			remap[v] = newIndex;
+		}
+
+		for (size_t v = 0; v < result.vertices.size(); ++v)
+		{
+			const float inv = 1.0f / (float)cellVertexCounts[v];
+			result.vertices[v].position *= inv;
+			result.vertices[v].uv *= inv;
+
+			const float normalLength = glm::length(result.vertices[v].normal);
+			if (normalLength > 0.0f)
+				result.vertices[v].normal /= normalLength;
+		}
+
+		//keeps only triangles that still span 3 cells, skipping ones that collapsed into a duplicate
+		std::unordered_set<MeshSimplifier_Triangle, MeshSimplifier_TriangleHash> emittedTriangles; emittedTriangles.reserve(source.indices.size() / 3);
+		result.indices.reserve(source.indices.size());
+		for (size_t t = 0; t + 2 < source.indices.size(); t += 3)
+		{
+			const uint32 a = remap[source.indices[t]], b = remap[source.indices[t + 1]], c = remap[source.indices[t + 2]];
+			if (a == b || b == c || a == c)
+				continue;
+
+			//rotates so the smallest index is first, keeping the winding, so duplicates have the same key
+			//the winding is kept so two sided geometry, a triangle and it's flipped twin, isn't merged
+			MeshSimplifier_Triangle tri = { { a, b, c } };
+			if (b < a && b < c) tri = { { b, c, a } };
+			else if (c < a && c < b) tri = { { c, a, b } };
+
+			if (!emittedTriangles.emplace(tri).second)
+				continue;
+
+			result.indices.emplace_back(tri.indices[0]); result.indices.emplace_back(tri.indices[1]); result.indices.emplace_back(tri.indices[2]);
+		}
+
+		//drops vertices that no triangle uses anymore
+		MeshOptimizer_OptimizeVertexFetch(result.vertices, result.indices);
+	}
+
+	//simplifies a mesh down to about the target ratio of it's triangles
+	inline Smok::Mesh::Mesh MeshSimplifier_Simplify(const Smok::Mesh::Mesh& source, const float targetTriangleRatio)
+	{
+		const size_t sourceTriangleCount = source.indices.size() / 3;
+		const size_t targetTriangleCount = (size_t)((float)sourceTriangleCount * glm::clamp(targetTriangleRatio, 0.0f, 1.0f));
+		if (targetTriangleCount >= sourceTriangleCount || source.vertices.empty())
+			return source;
+
+		const MeshBounds bounds = MeshBounds_Calculate(source);
+
+		//binary searches the grid resolution that gets closest to the target without going over
+		Smok::Mesh::Mesh best, attempt;
+		uint32 low = 1, high = 1024;
+		for (uint32 pass = 0; pass < 10 && low <= high; ++pass)
+		{
+			const uint32 resolution = (low + high) / 2;
+			MeshSimplifier_ClusterVertices(source, bounds, resolution, attempt);
+
+			const size_t triangleCount = attempt.indices.size() / 3;
+			if (triangleCount <= targetTriangleCount)
+			{
+				if (triangleCount > 0 && triangleCount >= best.indices.size() / 3)
+					best = attempt;
+				low = resolution + 1;
+			}
+			else
+				high = resolution - 1;
+		}
+
+		//the mesh is too small to reduce, so we keep it as is
+		if (best.indices.empty())
+			return source;
+
+		return best;
+	}
+}
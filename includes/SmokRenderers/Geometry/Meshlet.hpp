@@ -0,0 +1,126 @@
+#pragma once
+
+//defines meshlets, fixed size clusters of triangles in a mesh that can be culled on their own
+
+#include <SmokRenderers/Geometry/MeshBounds.hpp>
+
+namespace Smok::Renderers::Geometry
+{
+	//the default meshlet limits, which match what mesh shading hardware prefers
+#define SMOK_RENDERER_MESHLET_MAX_VERTICES 64
+#define SMOK_RENDERER_MESHLET_MAX_TRIANGLES 124
+
+	//defines a meshlet || the triangles are a contiguous range of the mesh's indices
+	struct Meshlet
+	{
+		uint32 firstTriangle = 0, triangleCount = 0; //the range of triangles in the mesh
+		uint32 vertexCount = 0; //the unique vertices the triangles use
+
+		glm::vec4 sphere = glm::vec4(0.0f); //the bounding sphere in mesh space || xyz = center, w = radius
+		glm::vec3 coneAxis = glm::vec3(0.0f); //the average facing of the triangles
+		float coneCutoff = 1.0f; //the sine of the cone's spread || 1 when the triangles face too many ways for the cone to cull
+	};
+
+	//calculates the bounding sphere and normal cone of a meshlet
+	inline void Meshlet_CalculateBounds(Meshlet& meshlet, const std::vector<Smok::Mesh::Vertex>& vertices, const std::vector<uint32>& indices)
+	{
+		const uint32 firstIndex = meshlet.firstTriangle * 3, indexCount = meshlet.triangleCount * 3;
+
+		//sphere
+		std::vector<glm::vec3> positions(indexCount);
+		for (uint32 i = 0; i < indexCount; ++i)
+			positions[i] = vertices[indices[firstIndex + i]].position;
+		meshlet.sphere = MeshBounds_Calculate(positions.data(), positions.size()).sphere;
+
+		//cone axis, the average triangle normal
+		std::vector<glm::vec3> normals; normals.reserve(meshlet.triangleCount);
+		glm::vec3 axis = glm::vec3(0.0f);
+		for (uint32 t = 0; t < meshlet.triangleCount; ++t)
+		{
+			const glm::vec3& a = positions[t * 3];
+			const glm::vec3 n = glm::cross(positions[t * 3 + 1] - a, positions[t * 3 + 2] - a);
+			const float length = glm::length(n);
+			if (length <= 0.0f)
+				continue;
+
+			normals.emplace_back(n / length);
+			axis += normals.back();
+		}
+
+		const float axisLength = glm::length(axis);
+		if (normals.empty() || axisLength <= 0.0f)
+		{
+			meshlet.coneAxis = glm::vec3(0.0f); meshlet.coneCutoff = 1.0f;
+			return;
+		}
+		axis /= axisLength;
+
+		//the widest triangle decides the spread
+		float minDot = 1.0f;
+		for (size_t i = 0; i < normals.size(); ++i)
+			minDot = glm::min(minDot, glm::dot(axis, normals[i]));
+
+		//a cone wider then about 85 degrees can't reject anything useful
+		if (minDot <= 0.1f)
+		{
+			meshlet.coneAxis = glm::vec3(0.0f); meshlet.coneCutoff = 1.0f;
+			return;
+		}
+
+		meshlet.coneAxis = axis;
+		meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+
+	//builds meshlets from a mesh, walking the triangles in order so each meshlet is a contiguous range of the indices
+	//run the vertex cache optimizer first, so neighbouring triangles share vertices and the meshlets stay tight
+	inline std::vector<Meshlet> Meshlet_Build(const std::vector<Smok::Mesh::Vertex>& vertices, const std::vector<uint32>& indices,
+		const uint32 maxVertices = SMOK_RENDERER_MESHLET_MAX_VERTICES, const uint32 maxTriangles = SMOK_RENDERER_MESHLET_MAX_TRIANGLES)
+	{
+		std::vector<Meshlet> meshlets;
+		const uint32 triangleCount = (uint32)(indices.size() / 3);
+		if (!triangleCount)
+			return meshlets;
+
+		//stamps which meshlet last used a vertex, so we can count unique vertices without clearing a set
+		std::vector<uint32> vertexStamps(vertices.size(), ~0u);
+
+		Meshlet current;
+		uint32 stamp = 0;
+		for (uint32 t = 0; t < triangleCount; ++t)
+		{
+			uint32 newVertices = 0;
+			for (uint32 k = 0; k < 3; ++k)
+			{
+				if (vertexStamps[indices[t * 3 + k]] != stamp)
+					newVertices++;
+			}
+
+			//starts a new meshlet if this triangle doesn't fit
+			if (current.triangleCount > 0 &&
+				(current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles))
+			{
+				meshlets.emplace_back(current);
+				current = Meshlet();
+				current.firstTriangle = t;
+				stamp++;
+			}
+
+			for (uint32 k = 0; k < 3; ++k)
+			{
+				uint32& vertexStamp = vertexStamps[indices[t * 3 + k]];
+				if (vertexStamp != stamp)
+				{
+					vertexStamp = stamp;
+					current.vertexCount++;
+				}
+			}
+			current.triangleCount++;
+		}
+		meshlets.emplace_back(current);
+
+		for (size_t m = 0; m < meshlets.size(); ++m)
+			Meshlet_CalculateBounds(meshlets[m], vertices, indices);
+
+		return meshlets;
+	}
+}
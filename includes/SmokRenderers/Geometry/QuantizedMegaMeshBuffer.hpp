@@ -0,0 +1,101 @@
+#pragma once
+
+//defines a mega mesh buffer that stores meshes in the quantized vertex format
+
+#include <SmokRenderers/Geometry/QuantizedVertex.hpp>
+
+#include <SmokRenderers/Geometry/MegaMeshBufferUpload.hpp>
+
+namespace Smok::Renderers::Geometry
+{
+	//defines a mesh stored in the quantized mega mesh buffer
+	struct QuantizedMegaMeshBuffer_Mesh
+	{
+		uint32 firstVertex = 0, vertexCount = 0; //the range of vertices
+		uint32 firstIndex = 0, indexCount = 0; //the range of indices
+
+		MeshBounds bounds; //the bounds the positions are quantized against
+		glm::vec4 dequantizeScale = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), dequantizeOffset = glm::vec4(0.0f); //turns the unorm positions back into mesh space
+	};
+
+	//defines a mega mesh buffer of quantized vertices
+	struct QuantizedMegaMeshBuffer
+	{
+		std::vector<QuantizedVertex> vertices; //the CPU side vertices
+		std::vector<uint32> indices; //the CPU side indices
+		std::vector<QuantizedMegaMeshBuffer_Mesh> meshes; //the meshes in the buffer
+
+		bool isDirty = false; //have meshes been added since the GPU buffers were made
+
+		VkBuffer vertexBuffer = VK_NULL_HANDLE, indexBuffer = VK_NULL_HANDLE;
+		VmaAllocation vertexAllocation = VK_NULL_HANDLE, indexAllocation = VK_NULL_HANDLE;
+		uint32 vertexCount = 0, indexCount = 0; //the counts in the GPU buffers
+	};
+
+	//adds a mesh to the buffer, quantizing it against it's bounds
+	inline void QuantizedMegaMeshBuffer_AddMesh(QuantizedMegaMeshBuffer* buffer, const Smok::Mesh::Mesh& mesh, uint32& meshIndex)
+	{
+		meshIndex = (uint32)buffer->meshes.size();
+		QuantizedMegaMeshBuffer_Mesh* entry = &buffer->meshes.emplace_back(QuantizedMegaMeshBuffer_Mesh());
+
+		entry->firstVertex = (uint32)buffer->vertices.size(); entry->vertexCount = (uint32)mesh.vertices.size();
+		entry->firstIndex = (uint32)buffer->indices.size(); entry->indexCount = (uint32)mesh.indices.size();
+		entry->bounds = MeshBounds_Calculate(mesh);
+		QuantizedVertex_CalculateDequantize(entry->bounds, entry->dequantizeScale, entry->dequantizeOffset);
+
+		buffer->vertices.reserve(buffer->vertices.size() + mesh.vertices.size());
+		for (size_t i = 0; i < mesh.vertices.size(); ++i)
+			buffer->vertices.emplace_back(QuantizedVertex_Quantize(mesh.vertices[i], entry->bounds));
+
+		buffer->indices.insert(buffer->indices.end(), mesh.indices.begin(), mesh.indices.end());
+
+		buffer->isDirty = true;
+	}
+
+	//destroys the GPU buffers
+	inline void QuantizedMegaMeshBuffer_DestroyBuffer(QuantizedMegaMeshBuffer* buffer, VmaAllocator allocator)
+	{
+		MegaMeshBuffer_DestroyGPUBuffers(allocator, buffer->vertexBuffer, buffer->vertexAllocation, buffer->indexBuffer, buffer->indexAllocation);
+		buffer->vertexCount = 0; buffer->indexCount = 0;
+		buffer->isDirty = !buffer->meshes.empty();
+	}
+
+	//creates the GPU buffers, only remaking them if meshes were added since the last time
+	//with a staging ring that can hold them, the buffers are device local and are filled once the ring is flushed, otherwise they're host visible
+	//the host visible writes are recorded to the dispatch, the staged ones to the ring's
+	inline bool QuantizedMegaMeshBuffer_CreateBuffer(QuantizedMegaMeshBuffer* buffer, VmaAllocator allocator, SMGraphics_Core_GPU* GPU,
+		Util::StagingRing* stagingRing = nullptr, Dispatch* dispatch = nullptr)
+	{
+		if (!buffer->isDirty || buffer->vertices.empty() || buffer->indices.empty())
+			return true;
+
+		if (!MegaMeshBuffer_CreateGPUBuffers(allocator, GPU, stagingRing, dispatch,
+			buffer->vertices.data(), buffer->vertices.size() * sizeof(QuantizedVertex), buffer->indices.data(), buffer->indices.size() * sizeof(uint32),
+			buffer->vertexBuffer, buffer->vertexAllocation, buffer->indexBuffer, buffer->indexAllocation))
+		{
+			QuantizedMegaMeshBuffer_DestroyBuffer(buffer, allocator);
+			return false;
+		}
+
+		buffer->vertexCount = (uint32)buffer->vertices.size();
+		buffer->indexCount = (uint32)buffer->indices.size();
+		buffer->isDirty = false;
+		return true;
+	}
+
+	//binds the buffer
+	inline void QuantizedMegaMeshBuffer_Bind(QuantizedMegaMeshBuffer* buffer, VkCommandBuffer& comBuffer)
+	{
+		const VkDeviceSize offset = 0;
+		vkCmdBindVertexBuffers(comBuffer, 0, 1, &buffer->vertexBuffer, &offset);
+		vkCmdBindIndexBuffer(comBuffer, buffer->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+	}
+
+	//draws a mesh in the buffer, the object index is passed as the first instance
+	inline void QuantizedMegaMeshBuffer_Draw(QuantizedMegaMeshBuffer* buffer, VkCommandBuffer& comBuffer,
+		const uint64& meshIndex, const uint64& objIndex)
+	{
+		const QuantizedMegaMeshBuffer_Mesh& mesh = buffer->meshes[meshIndex];
+		vkCmdDrawIndexed(comBuffer, mesh.indexCount, 1, mesh.firstIndex, (int32)mesh.firstVertex, (uint32)objIndex);
+	}
+}
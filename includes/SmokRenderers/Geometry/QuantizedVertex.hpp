@@ -0,0 +1,276 @@
+#pragma once
+
+//defines a compressed vertex format for the mega mesh buffer
+//positions are 16 bit relative to the mesh bounds, normals are octahedral encoded and UVs are half floats
+
+#include <SmokMesh/Mesh.hpp>
+
+#include <SmokRenderers/Geometry/MeshBounds.hpp>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Smok::Renderers::Geometry
+{
+	//converts a float into a half float
+	inline uint16 Half_FromFloat(const float value)
+	{
+		uint32 bits = 0; memcpy(&bits, &value, sizeof(float));
+
+		const uint32 sign = (bits >> 16) & 0x8000;
+		const int32 exponent = (int32)((bits >> 23) & 0xff) - 127 + 15;
+		uint32 mantissa = bits & 0x007fffff;
+
+		//NaN and Inf
+		if (((bits >> 23) & 0xff) == 0xff)
+			return (uint16)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+
+		//too large, clamp to Inf
+		if (exponent >= 31)
+			return (uint16)(sign | 0x7c00);
+
+		//too small for a normal half, make a denormal or zero
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+				return (uint16)sign;
+
+			mantissa |= 0x00800000;
+			const uint32 shift = (uint32)(14 - exponent);
+			uint32 halfMantissa = mantissa >> shift;
+			if ((mantissa >> (shift - 1)) & 1) //round to nearest
+				halfMantissa++;
+			return (uint16)(sign | halfMantissa);
+		}
+
+		uint32 half = sign | ((uint32)exponent << 10) | (mantissa >> 13);
+		if (mantissa & 0x00001000) //round to nearest, carrying into the exponent is correct
+			half++;
+		return (uint16)half;
+	}
+
+	//converts a half float into a float
+	inline float Half_ToFloat(const uint16 half)
+	{
+		const uint32 sign = (uint32)(half & 0x8000) << 16;
+		uint32 exponent = (half >> 10) & 0x1f;
+		uint32 mantissa = half & 0x3ff;
+
+		uint32 bits = 0;
+		if (exponent == 0)
+		{
+			if (mantissa == 0)
+				bits = sign;
+			else
+			{
+				//normalizes the denormal
+				exponent = 127 - 15 + 1;
+				while (!(mantissa & 0x400))
+				{
+					mantissa <<= 1;
+					exponent--;
+				}
+				mantissa &= 0x3ff;
+				bits = sign | (exponent << 23) | (mantissa << 13);
+			}
+		}
+		else if (exponent == 31)
+			bits = sign | 0x7f800000 | (mantissa << 13);
+		else
+			bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+		float value = 0.0f; memcpy(&value, &bits, sizeof(float));
+		return value;
+	}
+
+	//encodes a unit normal into octahedral coordinates in the range [-1, 1]
+	inline glm::vec2 Octahedral_Encode(const glm::vec3& normal)
+	{
+		const float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+		if (l1 <= 0.0f)
+			return glm::vec2(0.0f, 0.0f);
+
+		glm::vec2 p = glm::vec2(normal.x, normal.y) / l1;
+		if (normal.z < 0.0f)
+		{
+			p = glm::vec2((1.0f - std::fabs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+				(1.0f - std::fabs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+		}
+
+		return p;
+	}
+
+	//decodes octahedral coordinates back into a unit normal
+	inline glm::vec3 Octahedral_Decode(const glm::vec2& p)
+	{
+		glm::vec3 n = glm::vec3(p.x, p.y, 1.0f - std::fabs(p.x) - std::fabs(p.y));
+		const float t = glm::max(-n.z, 0.0f);
+		n.x += (n.x >= 0.0f ? -t : t);
+		n.y += (n.y >= 0.0f ? -t : t);
+		return glm::normalize(n);
+	}
+
+	//packs a float in the range [0, 1] into a unorm 16
+	inline uint16 UNorm16_FromFloat(const float value) { return (uint16)std::lround(glm::clamp(value, 0.0f, 1.0f) * 65535.0f); }
+
+	//packs a float in the range [-1, 1] into a snorm 16
+	inline int16 SNorm16_FromFloat(const float value) { return (int16)std::lround(glm::clamp(value, -1.0f, 1.0f) * 32767.0f); }
+
+	//defines a quantized vertex || 16 bytes
+	struct QuantizedVertex
+	{
+		uint16 position[4] = { 0, 0, 0, 65535 }; //unorm 16 relative to the mesh bounds || w is always 1 so the shader can use it as a vec4 directly
+		int16 normal[2] = { 0, 0 }; //snorm 16 octahedral encoded normal
+		uint16 uv[2] = { 0, 0 }; //half float UVs
+
+		//defines the layout
+		struct VertexLayout
+		{
+			//generates the binding description
+			inline VkVertexInputBindingDescription GenBindDesc()
+			{
+				VkVertexInputBindingDescription bindingDescription = {};
+				bindingDescription.binding = 0;
+				bindingDescription.stride = sizeof(QuantizedVertex);
+				bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+				return bindingDescription;
+			}
+
+			//generates the attribute descriptions || these use the same locations as the full precision layout
+			inline std::vector<VkVertexInputAttributeDescription> GenAttDesc()
+			{
+				std::vector<VkVertexInputAttributeDescription> attributeDescriptions(3);
+
+				//position
+				attributeDescriptions[0].binding = 0;
+				attributeDescriptions[0].location = 0;
+				attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+				attributeDescriptions[0].offset = offsetof(QuantizedVertex, position);
+
+				//normal || the shader has to octahedral decode it
+				attributeDescriptions[1].binding = 0;
+				attributeDescriptions[1].location = 1;
+				attributeDescriptions[1].format = VK_FORMAT_R16G16_SNORM;
+				attributeDescriptions[1].offset = offsetof(QuantizedVertex, normal);
+
+				//UV
+				attributeDescriptions[2].binding = 0;
+				attributeDescriptions[2].location = 2;
+				attributeDescriptions[2].format = VK_FORMAT_R16G16_SFLOAT;
+				attributeDescriptions[2].offset = offsetof(QuantizedVertex, uv);
+
+				return attributeDescriptions;
+			}
+		};
+	};
+
+	//quantizes a vertex against the bounds of it's mesh
+	inline QuantizedVertex QuantizedVertex_Quantize(const Smok::Mesh::Vertex& vertex, const MeshBounds& bounds)
+	{
+		QuantizedVertex q;
+
+		const glm::vec3 extent = bounds.max - bounds.min;
+		for (uint32 i = 0; i < 3; ++i)
+			q.position[i] = UNorm16_FromFloat(extent[i] > 0.0f ? (vertex.position[i] - bounds.min[i]) / extent[i] : 0.0f);
+
+		const glm::vec2 oct = Octahedral_Encode(vertex.normal);
+		q.normal[0] = SNorm16_FromFloat(oct.x); q.normal[1] = SNorm16_FromFloat(oct.y);
+
+		q.uv[0] = Half_FromFloat(vertex.uv.x); q.uv[1] = Half_FromFloat(vertex.uv.y);
+
+		return q;
+	}
+
+	//dequantizes a vertex, matches what the vertex shader gets from the mesh's entry in the mesh dequantize buffer
+	inline void QuantizedVertex_Dequantize(const QuantizedVertex& q, const MeshBounds& bounds,
+		glm::vec3& position, glm::vec3& normal, glm::vec2& uv)
+	{
+		const glm::vec3 extent = bounds.max - bounds.min;
+		for (uint32 i = 0; i < 3; ++i)
+			position[i] = bounds.min[i] + ((float)q.position[i] / 65535.0f) * extent[i];
+
+		normal = Octahedral_Decode(glm::vec2(glm::max((float)q.normal[0] / 32767.0f, -1.0f),
+			glm::max((float)q.normal[1] / 32767.0f, -1.0f)));
+
+		uv = glm::vec2(Half_ToFloat(q.uv[0]), Half_ToFloat(q.uv[1]));
+	}
+
+	//calculates the scale and offset that turn unorm positions back into mesh space || position = offset + unorm * scale
+	//these go to the vertex shader beside the model matrix, folding them into it would skew the normals of meshes that aren't cubes
+	inline void QuantizedVertex_CalculateDequantize(const MeshBounds& bounds, glm::vec4& scale, glm::vec4& offset)
+	{
+		scale = glm::vec4(bounds.max - bounds.min, 0.0f);
+		offset = glm::vec4(bounds.min, 0.0f);
+	}
+
+	//defines a report of the size and precision lost by quantizing meshes
+	struct QuantizationReport
+	{
+		uint64 vertexCount = 0; //the number of vertices tested
+
+		size_t fullBytes = 0, quantizedBytes = 0; //the vertex memory in each format
+
+		float maxPositionError = 0.0f; //the largest position error in mesh space units
+		float maxNormalErrorDegrees = 0.0f; //the largest angle between the source and decoded normal
+		float maxUVError = 0.0f; //the largest UV error
+
+		uint32 releasedMeshCount = 0; //the meshes that couldn't be reported, their CPU data was released after upload
+
+		//merges another report into this one
+		inline void Merge(const QuantizationReport& other)
+		{
+			vertexCount += other.vertexCount;
+			fullBytes += other.fullBytes; quantizedBytes += other.quantizedBytes;
+			maxPositionError = glm::max(maxPositionError, other.maxPositionError);
+			maxNormalErrorDegrees = glm::max(maxNormalErrorDegrees, other.maxNormalErrorDegrees);
+			maxUVError = glm::max(maxUVError, other.maxUVError);
+			releasedMeshCount += other.releasedMeshCount;
+		}
+
+		//converts the report into a human readable string
+		inline std::string ToString() const
+		{
+			const double ratio = (fullBytes > 0 ? (double)quantizedBytes / (double)fullBytes * 100.0 : 0.0);
+
+			return "Vertices: " + std::to_string(vertexCount) + "\n" +
+				"Full precision: " + std::to_string(fullBytes) + " bytes (" + std::to_string(sizeof(Smok::Mesh::Vertex)) + " per vertex)\n" +
+				"Quantized: " + std::to_string(quantizedBytes) + " bytes (" + std::to_string(sizeof(QuantizedVertex)) + " per vertex, " +
+				std::to_string(ratio) + "% of full)\n" +
+				"Max position error: " + std::to_string(maxPositionError) + "\n" +
+				"Max normal error: " + std::to_string(maxNormalErrorDegrees) + " degrees\n" +
+				"Max UV error: " + std::to_string(maxUVError) +
+				(releasedMeshCount > 0 ? "\nNot reported: " + std::to_string(releasedMeshCount) + " meshes had their CPU data released" : "");
+		}
+	};
+
+	//quantizes a mesh and measures the size saved and the precision lost
+	inline QuantizationReport QuantizedVertex_GenerateReport(const Smok::Mesh::Mesh& mesh)
+	{
+		QuantizationReport report;
+		report.vertexCount = mesh.vertices.size();
+		report.fullBytes = mesh.vertices.size() * sizeof(Smok::Mesh::Vertex);
+		report.quantizedBytes = mesh.vertices.size() * sizeof(QuantizedVertex);
+
+		const MeshBounds bounds = MeshBounds_Calculate(mesh);
+		for (size_t i = 0; i < mesh.vertices.size(); ++i)
+		{
+			const Smok::Mesh::Vertex& v = mesh.vertices[i];
+
+			glm::vec3 position, normal; glm::vec2 uv;
+			QuantizedVertex_Dequantize(QuantizedVertex_Quantize(v, bounds), bounds, position, normal, uv);
+
+			report.maxPositionError = glm::max(report.maxPositionError, glm::length(position - v.position));
+			report.maxUVError = glm::max(report.maxUVError, glm::max(std::fabs(uv.x - v.uv.x), std::fabs(uv.y - v.uv.y)));
+
+			const float sourceLength = glm::length(v.normal);
+			if (sourceLength > 0.0f)
+			{
+				const float cosAngle = glm::clamp(glm::dot(v.normal / sourceLength, normal), -1.0f, 1.0f);
+				report.maxNormalErrorDegrees = glm::max(report.maxNormalErrorDegrees, std::acos(cosAngle) * 57.2957795f);
+			}
+		}
+
+		return report;
+	}
+}
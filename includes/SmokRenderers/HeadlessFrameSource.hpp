@@ -0,0 +1,329 @@
+#pragma once
+
+//defines a headless frame source, a ring of offscreen images the renderers draw into without a surface or present
+//used for render farms, thumbnails and CI, it works on software Vulkan devices
+
+#include <SmokRenderers/RenderManager.hpp>
+#include <SmokRenderers/Util/GPUBuffer.hpp>
+#include <SmokRenderers/Util/RenderPass.hpp>
+
+#include <chrono>
+
+namespace Smok::Renderers
+{
+	//defines the settings for making a headless frame source
+	struct HeadlessFrameSourceCreateInfo
+	{
+		uint32 width = 1280, height = 720; //the size of the images
+		VkFormat colorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+		VkFormat depthFormat = VK_FORMAT_D32_SFLOAT; //VK_FORMAT_UNDEFINED for no depth
+		uint32 imageCount = 2; //the size of the ring, also the frames in flight
+		bool readBack = false; //keeps a host visible copy of each frame || needs a 4 byte color format
+	};
+
+	//defines a image in the ring
+	struct HeadlessFrameSource_Image
+	{
+		VkImage colorImage = VK_NULL_HANDLE; VmaAllocation colorAllocation = VK_NULL_HANDLE; VkImageView colorView = VK_NULL_HANDLE;
+		VkImage depthImage = VK_NULL_HANDLE; VmaAllocation depthAllocation = VK_NULL_HANDLE; VkImageView depthView = VK_NULL_HANDLE;
+		VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+		VkFence fence = VK_NULL_HANDLE; //signaled once the frame drawing into it is done
+		Util::GPUBuffer readBackBuffer; //the pixels of the last frame, if reading back
+		bool hasReadBack = false; //was a read back recorded for the frame in flight
+	};
+
+	//defines the throughput of a headless frame source
+	struct HeadlessFrameStats
+	{
+		uint64 frameCount = 0; //the frames submitted
+		double elapsedSeconds = 0.0; //the time from the first frame's NextFrame to the last finished one
+
+		//gets the frames per second
+		inline double FPS() const { return (elapsedSeconds > 0.0 ? (double)frameCount / elapsedSeconds : 0.0); }
+
+		//gets the average frame time
+		inline double AverageFrameMilliseconds() const { return (frameCount > 0 ? elapsedSeconds * 1000.0 / (double)frameCount : 0.0); }
+
+		//converts the stats into a human readable string
+		inline std::string ToString() const
+		{
+			return "Headless: " + std::to_string(frameCount) + " frames in " + std::to_string(elapsedSeconds) + " seconds, " +
+				std::to_string(FPS()) + " FPS (" + std::to_string(AverageFrameMilliseconds()) + " ms)";
+		}
+	};
+
+	//defines a headless frame source
+	struct HeadlessFrameSource
+	{
+		VkDevice device = VK_NULL_HANDLE;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+
+		VkRenderPass renderpass = VK_NULL_HANDLE;
+		VkExtent2D extents = { 0, 0 };
+		VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+		bool readBack = false;
+
+		std::vector<HeadlessFrameSource_Image> images;
+		uint32 nextImage = 0; //the image the next frame draws into
+
+		uint64 frameCount = 0;
+		std::chrono::steady_clock::time_point firstFrameTime, lastFrameTime;
+
+		Util::StagingRing* stagingRing = nullptr; //optional, NextFrame begins it's frames and SubmitFrame flushes it before the frame is submitted
+	};
+
+	//creates a image and it's view for the headless frame source
+	inline bool HeadlessFrameSource_CreateImage(HeadlessFrameSource* source, const VkFormat format, const VkImageUsageFlags usage,
+		const VkImageAspectFlags aspect, VkImage& image, VmaAllocation& allocation, VkImageView& view)
+	{
+		VkImageCreateInfo imageInfo = {};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.format = format;
+		imageInfo.extent = { source->extents.width, source->extents.height, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = usage;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+		if (vmaCreateImage(source->allocator, &imageInfo, &allocInfo, &image, &allocation, nullptr) != VK_SUCCESS)
+			return false;
+
+		VkImageViewCreateInfo viewInfo = {};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = format;
+		viewInfo.subresourceRange = { aspect, 0, 1, 0, 1 };
+
+		return vkCreateImageView(source->device, &viewInfo, nullptr, &view) == VK_SUCCESS;
+	}
+
+	//destroys a headless frame source
+	inline void HeadlessFrameSource_Destroy(HeadlessFrameSource* source)
+	{
+		if (source->device == VK_NULL_HANDLE)
+			return;
+
+		vkDeviceWaitIdle(source->device);
+
+		for (size_t i = 0; i < source->images.size(); ++i)
+		{
+			HeadlessFrameSource_Image& image = source->images[i];
+			if (image.framebuffer != VK_NULL_HANDLE) vkDestroyFramebuffer(source->device, image.framebuffer, nullptr);
+			if (image.colorView != VK_NULL_HANDLE) vkDestroyImageView(source->device, image.colorView, nullptr);
+			if (image.depthView != VK_NULL_HANDLE) vkDestroyImageView(source->device, image.depthView, nullptr);
+			if (image.colorImage != VK_NULL_HANDLE) vmaDestroyImage(source->allocator, image.colorImage, image.colorAllocation);
+			if (image.depthImage != VK_NULL_HANDLE) vmaDestroyImage(source->allocator, image.depthImage, image.depthAllocation);
+			if (image.fence != VK_NULL_HANDLE) vkDestroyFence(source->device, image.fence, nullptr);
+			Util::GPUBuffer_Destroy(&image.readBackBuffer, source->allocator);
+		}
+
+		if (source->renderpass != VK_NULL_HANDLE)
+			vkDestroyRenderPass(source->device, source->renderpass, nullptr);
+
+		*source = HeadlessFrameSource();
+	}
+
+	//creates a headless frame source
+	inline bool HeadlessFrameSource_Create(HeadlessFrameSource* source, SMGraphics_Core_GPU* GPU, VmaAllocator allocator,
+		const HeadlessFrameSourceCreateInfo& info)
+	{
+		source->device = GPU->device; source->allocator = allocator;
+		source->extents = { info.width, info.height };
+		source->colorFormat = info.colorFormat;
+		source->readBack = info.readBack;
+
+		//read back copies straight out of the render pass, otherwise the image is left for sampling
+		source->renderpass = Util::RenderPass_Create(source->device, info.colorFormat, info.depthFormat,
+			(info.readBack ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+		if (source->renderpass == VK_NULL_HANDLE)
+		{
+			HeadlessFrameSource_Destroy(source);
+			return false;
+		}
+
+		VkFenceCreateInfo fenceInfo = {};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+		source->images.resize(info.imageCount);
+		for (uint32 i = 0; i < info.imageCount; ++i)
+		{
+			HeadlessFrameSource_Image& image = source->images[i];
+
+			bool succeeded = HeadlessFrameSource_CreateImage(source, info.colorFormat,
+				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+				VK_IMAGE_ASPECT_COLOR_BIT, image.colorImage, image.colorAllocation, image.colorView);
+			if (succeeded && info.depthFormat != VK_FORMAT_UNDEFINED)
+				succeeded = HeadlessFrameSource_CreateImage(source, info.depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+					VK_IMAGE_ASPECT_DEPTH_BIT, image.depthImage, image.depthAllocation, image.depthView);
+
+			VkImageView attachments[2] = { image.colorView, image.depthView };
+			VkFramebufferCreateInfo framebufferInfo = {};
+			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			framebufferInfo.renderPass = source->renderpass;
+			framebufferInfo.attachmentCount = (info.depthFormat != VK_FORMAT_UNDEFINED ? 2 : 1);
+			framebufferInfo.pAttachments = attachments;
+			framebufferInfo.width = info.width; framebufferInfo.height = info.height;
+			framebufferInfo.layers = 1;
+
+			succeeded = succeeded && vkCreateFramebuffer(source->device, &framebufferInfo, nullptr, &image.framebuffer) == VK_SUCCESS &&
+				vkCreateFence(source->device, &fenceInfo, nullptr, &image.fence) == VK_SUCCESS;
+
+			//tightly packed 4 byte pixels
+			if (succeeded && info.readBack)
+				succeeded = Util::GPUBuffer_Create(&image.readBackBuffer, allocator, (size_t)info.width * info.height * 4,
+					VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+
+			if (!succeeded)
+			{
+				BTD_LogError("Smok Renderer", "Headless Frame Source", "HeadlessFrameSource_Create", "Failed to create the offscreen images!");
+				HeadlessFrameSource_Destroy(source);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//fills a swapchain with the headless frame source, so the renderers can be made against it unchanged
+	inline void HeadlessFrameSource_FillSwapchain(HeadlessFrameSource* source, SMWindow_Desktop_Swapchain* swapchain)
+	{
+		swapchain->swapchain = VK_NULL_HANDLE;
+		swapchain->renderpass = source->renderpass;
+		swapchain->extents.width = source->extents.width; swapchain->extents.height = source->extents.height;
+		swapchain->framesInFlight = (uint32)source->images.size();
+
+		swapchain->framebuffers.resize(source->images.size());
+		for (size_t i = 0; i < source->images.size(); ++i)
+			swapchain->framebuffers[i] = source->images[i].framebuffer;
+	}
+
+	//gets the next frame of a headless frame source, waiting for the image to be free
+	inline bool NextFrame(HeadlessFrameSource* source, Frame& frame)
+	{
+		const uint32 index = source->nextImage;
+		HeadlessFrameSource_Image& image = source->images[index];
+		vkWaitForFences(source->device, 1, &image.fence, VK_TRUE, UINT64_MAX);
+
+		//frees the ring space this image's uploads held
+		if (Util::StagingRing_IsValid(source->stagingRing))
+			Util::StagingRing_BeginFrame(source->stagingRing, index);
+
+		//the image's last read back is overwritten by this frame, so it only has one again if this frame records it
+		image.hasReadBack = false;
+
+		//the clock starts with the first frame's recording, so every measured frame is inside the elapsed time
+		if (source->frameCount == 0)
+			source->firstFrameTime = std::chrono::steady_clock::now();
+
+		frame.isValid = true;
+		frame.imageIndex = index;
+		frame.frameIndex = index;
+		frame.currentFrame = index;
+		frame.frameSize = { source->extents.width, source->extents.height };
+		frame.framebuffer = image.framebuffer;
+
+		return true;
+	}
+
+	//records copying the frame's color into it's read back buffer || record after the render pass ends
+	inline void HeadlessFrameSource_RecordReadBack(HeadlessFrameSource* source, VkCommandBuffer comBuffer, const Frame& frame)
+	{
+		if (!source->readBack)
+			return;
+
+		HeadlessFrameSource_Image& image = source->images[frame.imageIndex];
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageExtent = { source->extents.width, source->extents.height, 1 };
+		vkCmdCopyImageToBuffer(comBuffer, image.colorImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.readBackBuffer.buffer, 1, &region);
+
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		vkCmdPipelineBarrier(comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		image.hasReadBack = true;
+	}
+
+	//submits a frame of a headless frame source || no semaphores or present, the image's fence marks it done
+	inline bool SubmitFrame(HeadlessFrameSource* source, SMGraphics_Core_GPU* GPU, Frame& frame,
+		VkCommandBuffer* comBuffers, const uint8 comBufferCount = 1)
+	{
+		if (frame.framebuffer == VK_NULL_HANDLE)
+			return false;
+
+		HeadlessFrameSource_Image& image = source->images[frame.imageIndex];
+
+		//every upload of the frame goes in one transfer submission, ahead of the frame on the same queue
+		if (Util::StagingRing_IsValid(source->stagingRing))
+			Util::StagingRing_Flush(source->stagingRing);
+
+		VkSubmitInfo submitInfo = {};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = comBufferCount;
+		submitInfo.pCommandBuffers = comBuffers;
+
+		vkResetFences(source->device, 1, &image.fence);
+		if (vkQueueSubmit(GPU->graphicsQueue, 1, &submitInfo, image.fence) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Headless Frame Source", "SubmitFrame", "Failed to submit draw command buffer!");
+			return false;
+		}
+
+		source->frameCount++;
+
+		source->nextImage = (source->nextImage + 1) % (uint32)source->images.size();
+		return true;
+	}
+
+	//waits for a frame and copies out it's pixels, tightly packed rows of 4 byte pixels
+	inline bool HeadlessFrameSource_ReadPixels(HeadlessFrameSource* source, const uint32 imageIndex, std::vector<uint8>& pixels)
+	{
+		HeadlessFrameSource_Image& image = source->images[imageIndex];
+		if (!source->readBack || !image.hasReadBack)
+		{
+			BTD_LogError("Smok Renderer", "Headless Frame Source", "HeadlessFrameSource_ReadPixels", "No read back was recorded for the image!");
+			return false;
+		}
+
+		vkWaitForFences(source->device, 1, &image.fence, VK_TRUE, UINT64_MAX);
+		vmaInvalidateAllocation(source->allocator, image.readBackBuffer.allocation, 0, VK_WHOLE_SIZE);
+
+		pixels.resize(image.readBackBuffer.size);
+		memcpy(pixels.data(), image.readBackBuffer.allocationInfo.pMappedData, pixels.size());
+		return true;
+	}
+
+	//waits for every frame in flight and gets the throughput so far
+	inline HeadlessFrameStats HeadlessFrameSource_Finish(HeadlessFrameSource* source)
+	{
+		for (size_t i = 0; i < source->images.size(); ++i)
+			vkWaitForFences(source->device, 1, &source->images[i].fence, VK_TRUE, UINT64_MAX);
+		source->lastFrameTime = std::chrono::steady_clock::now();
+
+		HeadlessFrameStats stats;
+		stats.frameCount = source->frameCount;
+		if (source->frameCount > 0)
+			stats.elapsedSeconds = std::chrono::duration<double>(source->lastFrameTime - source->firstFrameTime).count();
+		return stats;
+	}
+
+	//resets the throughput counters, so warm up frames aren't measured
+	inline void HeadlessFrameSource_ResetStats(HeadlessFrameSource* source)
+	{
+		HeadlessFrameSource_Finish(source);
+		source->frameCount = 0;
+	}
+}
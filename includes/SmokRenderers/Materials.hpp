@@ -49,7 +49,7 @@ namespace Smok::Renderers::Material
 
 	//defines a phong based lit mesh material
 
-	//defines a 2D text material
+	//defines a 2D text material || text is drawn by the GUI quad renderer with GUIText.frag, see Text/SDFFont.hpp
 
 	//defines a Wind Waker Cell Shaded lit mesh material
 }
\ No newline at end of file
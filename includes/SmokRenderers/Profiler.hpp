@@ -0,0 +1,447 @@
+#pragma once
+
+//defines a frame profiler, with named CPU scopes and GPU timestamp scopes
+//GPU results are read back when a frame slot comes around again, after it's fence was waited on, so reading them never stalls
+//resolved frames are kept in a history and can be exported as Chrome trace JSON (chrome://tracing or ui.perfetto.dev)
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+#include <chrono>
+#include <fstream>
+#include <deque>
+
+namespace Smok::Renderers
+{
+	//the default GPU scopes a frame can have
+#define SMOK_RENDERER_PROFILER_DEFAULT_MAX_GPU_SCOPES 64
+
+	//defines a timed scope || times are in microseconds from the start of the frame
+	struct ProfilerScope
+	{
+		std::string name = "";
+		uint32 depth = 0; //how many scopes it's inside of
+		double start = 0.0, duration = 0.0;
+	};
+
+	//defines a profiled frame
+	struct ProfilerFrame
+	{
+		uint64 frameNumber = 0;
+		double startTime = 0.0; //in microseconds from when the profiler was made
+		double CPUDuration = 0.0; //from BeginFrame to EndFrame
+		double GPUDuration = 0.0; //from the first GPU timestamp to the last, 0 if there were none
+
+		std::vector<ProfilerScope> CPUScopes;
+		std::vector<ProfilerScope> GPUScopes; //relative to the frame's first GPU timestamp
+	};
+
+	//defines a GPU scope waiting for it's timestamps
+	struct Profiler_PendingGPUScope
+	{
+		std::string name = "";
+		uint32 depth = 0;
+		uint32 startQuery = 0, endQuery = 0;
+	};
+
+	//defines the GPU queries of a frame in flight
+	struct Profiler_FrameSlot
+	{
+		VkQueryPool queryPool = VK_NULL_HANDLE;
+		uint32 queryCount = 0; //the queries written this frame
+		bool wasReset = false; //the pool was reset in this frame's command buffer
+
+		std::vector<Profiler_PendingGPUScope> GPUScopes;
+		std::vector<uint32> openScopes; //the scopes begun but not ended
+		ProfilerFrame frame; //the CPU results, waiting for the GPU ones
+		bool isPending = false;
+	};
+
+	//defines a profiler
+	struct Profiler
+	{
+		bool isEnabled = true;
+		VkDevice device = VK_NULL_HANDLE;
+
+		//GPU
+		bool supportsGPUTimestamps = false;
+		double timestampPeriod = 1.0; //nanoseconds per tick
+		uint32 maxGPUScopes = SMOK_RENDERER_PROFILER_DEFAULT_MAX_GPU_SCOPES;
+		std::vector<Profiler_FrameSlot> slots; //per frame in flight
+		uint32 currentSlot = 0;
+
+		//CPU
+		std::chrono::steady_clock::time_point epoch; //when the profiler was made
+		std::chrono::steady_clock::time_point frameStart;
+		std::vector<uint32> openCPUScopes; //into the current frame's CPU scopes
+		bool inFrame = false;
+		uint64 frameNumber = 0;
+
+		//resolved frames, oldest first
+		std::deque<ProfilerFrame> history;
+		uint32 historyLength = 240;
+	};
+
+	//gets the microseconds between two times
+	inline double Profiler_Microseconds(const std::chrono::steady_clock::time_point& from, const std::chrono::steady_clock::time_point& to)
+	{
+		return std::chrono::duration<double, std::micro>(to - from).count();
+	}
+
+	//inits a profiler || without timestamp support on the graphics queue only CPU scopes are recorded
+	inline bool Profiler_Init(Profiler* profiler, SMGraphics_Core_GPU* GPU, const uint32 framesInFlight,
+		const uint32 maxGPUScopes = SMOK_RENDERER_PROFILER_DEFAULT_MAX_GPU_SCOPES)
+	{
+		profiler->device = GPU->device;
+		profiler->maxGPUScopes = maxGPUScopes;
+		profiler->epoch = std::chrono::steady_clock::now();
+
+		VkPhysicalDeviceProperties properties = {};
+		vkGetPhysicalDeviceProperties(GPU->physicalDevice, &properties);
+		profiler->supportsGPUTimestamps = (properties.limits.timestampComputeAndGraphics == VK_TRUE);
+		profiler->timestampPeriod = (double)properties.limits.timestampPeriod;
+
+		profiler->slots.resize(framesInFlight);
+		if (!profiler->supportsGPUTimestamps)
+			return true;
+
+		VkQueryPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		poolInfo.queryCount = maxGPUScopes * 2;
+		for (size_t i = 0; i < profiler->slots.size(); ++i)
+		{
+			if (vkCreateQueryPool(profiler->device, &poolInfo, nullptr, &profiler->slots[i].queryPool) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "Profiler", "Profiler_Init", "Failed to create a timestamp query pool!");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//shutsdown a profiler
+	inline void Profiler_Shutdown(Profiler* profiler)
+	{
+		for (size_t i = 0; i < profiler->slots.size(); ++i)
+		{
+			if (profiler->slots[i].queryPool != VK_NULL_HANDLE)
+				vkDestroyQueryPool(profiler->device, profiler->slots[i].queryPool, nullptr);
+		}
+
+		*profiler = Profiler();
+	}
+
+	//adds a resolved frame to the history
+	inline void Profiler_PushHistory(Profiler* profiler, ProfilerFrame& frame)
+	{
+		profiler->history.emplace_back(std::move(frame));
+		while (profiler->history.size() > profiler->historyLength)
+			profiler->history.pop_front();
+	}
+
+	//reads back a slot's GPU scopes and moves it's frame into the history || the slot's fence must have been waited on
+	inline void Profiler_ResolveSlot(Profiler* profiler, Profiler_FrameSlot& slot)
+	{
+		if (!slot.isPending)
+			return;
+
+		slot.isPending = false;
+		if (slot.queryCount > 0)
+		{
+			std::vector<uint64> timestamps(slot.queryCount);
+			const VkResult result = vkGetQueryPoolResults(profiler->device, slot.queryPool, 0, slot.queryCount,
+				sizeof(uint64) * timestamps.size(), timestamps.data(), sizeof(uint64), VK_QUERY_RESULT_64_BIT);
+
+			//not ready shouldn't happen after the fence, the GPU scopes are dropped rather then waited on
+			if (result == VK_SUCCESS)
+			{
+				uint64 first = UINT64_MAX, last = 0;
+				for (size_t i = 0; i < slot.GPUScopes.size(); ++i)
+				{
+					first = std::min(first, timestamps[slot.GPUScopes[i].startQuery]);
+					last = std::max(last, timestamps[slot.GPUScopes[i].endQuery]);
+				}
+
+				const double toMicroseconds = profiler->timestampPeriod / 1000.0;
+				for (size_t i = 0; i < slot.GPUScopes.size(); ++i)
+				{
+					const Profiler_PendingGPUScope& pending = slot.GPUScopes[i];
+					ProfilerScope& scope = slot.frame.GPUScopes.emplace_back();
+					scope.name = pending.name; scope.depth = pending.depth;
+					scope.start = (double)(timestamps[pending.startQuery] - first) * toMicroseconds;
+					scope.duration = (double)(timestamps[pending.endQuery] - timestamps[pending.startQuery]) * toMicroseconds;
+				}
+				if (!slot.GPUScopes.empty())
+					slot.frame.GPUDuration = (double)(last - first) * toMicroseconds;
+			}
+		}
+
+		Profiler_PushHistory(profiler, slot.frame);
+		slot.frame = ProfilerFrame();
+	}
+
+	//starts a frame, resolving the results last recorded in this frame slot || call after the slot's fence was waited on
+	//start can be earlier then now, so time spent waiting for the fence counts as part of the frame
+	inline void Profiler_BeginFrame(Profiler* profiler, const uint32 frameSlot,
+		const std::chrono::steady_clock::time_point& start = std::chrono::steady_clock::now())
+	{
+		if (!profiler->isEnabled || profiler->slots.empty())
+			return;
+
+		//a frame that was begun but never ended is dropped
+		if (profiler->inFrame)
+			profiler->slots[profiler->currentSlot].frame = ProfilerFrame();
+
+		profiler->currentSlot = frameSlot % (uint32)profiler->slots.size();
+		Profiler_FrameSlot& slot = profiler->slots[profiler->currentSlot];
+		Profiler_ResolveSlot(profiler, slot);
+
+		slot.queryCount = 0; slot.wasReset = false;
+		slot.GPUScopes.clear(); slot.openScopes.clear();
+
+		profiler->frameStart = start;
+		profiler->openCPUScopes.clear();
+		profiler->inFrame = true;
+
+		slot.frame.frameNumber = profiler->frameNumber++;
+		slot.frame.startTime = Profiler_Microseconds(profiler->epoch, profiler->frameStart);
+	}
+
+	//resets the frame's queries, call at the start of the frame's command buffer outside of a render pass
+	inline void Profiler_RecordFrameStart(Profiler* profiler, VkCommandBuffer comBuffer)
+	{
+		if (!profiler->isEnabled || !profiler->inFrame || !profiler->supportsGPUTimestamps)
+			return;
+
+		Profiler_FrameSlot& slot = profiler->slots[profiler->currentSlot];
+		vkCmdResetQueryPool(comBuffer, slot.queryPool, 0, profiler->maxGPUScopes * 2);
+		slot.wasReset = true;
+	}
+
+	//ends a frame, it's results are resolved when it's slot comes around again
+	inline void Profiler_EndFrame(Profiler* profiler)
+	{
+		if (!profiler->inFrame)
+			return;
+
+		Profiler_FrameSlot& slot = profiler->slots[profiler->currentSlot];
+		const auto now = std::chrono::steady_clock::now();
+
+		//closes anything left open
+		while (!profiler->openCPUScopes.empty())
+		{
+			ProfilerScope& scope = slot.frame.CPUScopes[profiler->openCPUScopes.back()];
+			scope.duration = Profiler_Microseconds(profiler->frameStart, now) - scope.start;
+			profiler->openCPUScopes.pop_back();
+		}
+		if (!slot.openScopes.empty())
+		{
+			BTD_LogError("Smok Renderer", "Profiler", "Profiler_EndFrame", "A GPU scope was never ended, the frame's GPU scopes are dropped!");
+			slot.GPUScopes.clear(); slot.queryCount = 0;
+		}
+
+		slot.frame.CPUDuration = Profiler_Microseconds(profiler->frameStart, now);
+		slot.isPending = true;
+		profiler->inFrame = false;
+	}
+
+	//starts a CPU scope
+	inline void Profiler_BeginCPUScope(Profiler* profiler, const char* name)
+	{
+		if (!profiler->isEnabled || !profiler->inFrame)
+			return;
+
+		ProfilerFrame& frame = profiler->slots[profiler->currentSlot].frame;
+		ProfilerScope& scope = frame.CPUScopes.emplace_back();
+		scope.name = name; scope.depth = (uint32)profiler->openCPUScopes.size();
+		scope.start = Profiler_Microseconds(profiler->frameStart, std::chrono::steady_clock::now());
+		profiler->openCPUScopes.emplace_back((uint32)frame.CPUScopes.size() - 1);
+	}
+
+	//ends the last CPU scope
+	inline void Profiler_EndCPUScope(Profiler* profiler)
+	{
+		if (!profiler->isEnabled || !profiler->inFrame || profiler->openCPUScopes.empty())
+			return;
+
+		ProfilerScope& scope = profiler->slots[profiler->currentSlot].frame.CPUScopes[profiler->openCPUScopes.back()];
+		scope.duration = Profiler_Microseconds(profiler->frameStart, std::chrono::steady_clock::now()) - scope.start;
+		profiler->openCPUScopes.pop_back();
+	}
+
+	//adds a CPU scope that was timed outside the profiler, like one that happened before the frame could begin
+	inline void Profiler_AddCPUScope(Profiler* profiler, const char* name,
+		const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end)
+	{
+		if (!profiler->isEnabled || !profiler->inFrame)
+			return;
+
+		ProfilerScope& scope = profiler->slots[profiler->currentSlot].frame.CPUScopes.emplace_back();
+		scope.name = name; scope.depth = (uint32)profiler->openCPUScopes.size();
+		scope.start = Profiler_Microseconds(profiler->frameStart, start);
+		scope.duration = Profiler_Microseconds(start, end);
+	}
+
+	//starts a GPU scope, writing a timestamp once the GPU reaches it
+	inline void Profiler_BeginGPUScope(Profiler* profiler, VkCommandBuffer comBuffer, const char* name)
+	{
+		if (!profiler->isEnabled || !profiler->inFrame || !profiler->supportsGPUTimestamps)
+			return;
+
+		Profiler_FrameSlot& slot = profiler->slots[profiler->currentSlot];
+		if (!slot.wasReset || slot.queryCount + 2 > profiler->maxGPUScopes * 2)
+		{
+			slot.openScopes.emplace_back(UINT32_MAX); //matched by the end, but not recorded
+			return;
+		}
+
+		Profiler_PendingGPUScope& scope = slot.GPUScopes.emplace_back();
+		scope.name = name; scope.depth = (uint32)slot.openScopes.size();
+		scope.startQuery = slot.queryCount++;
+		scope.endQuery = slot.queryCount++;
+		vkCmdWriteTimestamp(comBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.queryPool, scope.startQuery);
+		slot.openScopes.emplace_back((uint32)slot.GPUScopes.size() - 1);
+	}
+
+	//ends the last GPU scope, writing a timestamp once the GPU has finished everything before it
+	inline void Profiler_EndGPUScope(Profiler* profiler, VkCommandBuffer comBuffer)
+	{
+		if (!profiler->isEnabled || !profiler->inFrame || !profiler->supportsGPUTimestamps)
+			return;
+
+		Profiler_FrameSlot& slot = profiler->slots[profiler->currentSlot];
+		if (slot.openScopes.empty())
+			return;
+
+		const uint32 scope = slot.openScopes.back();
+		slot.openScopes.pop_back();
+		if (scope != UINT32_MAX)
+			vkCmdWriteTimestamp(comBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.queryPool, slot.GPUScopes[scope].endQuery);
+	}
+
+	//gets the newest resolved frame || returns nullptr if none are resolved yet
+	inline const ProfilerFrame* Profiler_GetLatestFrame(const Profiler* profiler)
+	{
+		return (profiler->history.empty() ? nullptr : &profiler->history.back());
+	}
+
+	//converts a frame into a human readable string
+	inline std::string Profiler_FrameToString(const ProfilerFrame& frame)
+	{
+		std::string str = "Frame " + std::to_string(frame.frameNumber) + ": CPU " + std::to_string(frame.CPUDuration / 1000.0) +
+			" ms, GPU " + std::to_string(frame.GPUDuration / 1000.0) + " ms\n";
+		for (size_t i = 0; i < frame.CPUScopes.size(); ++i)
+			str += "CPU " + std::string(frame.CPUScopes[i].depth * 2, ' ') + frame.CPUScopes[i].name + ": " +
+			std::to_string(frame.CPUScopes[i].duration / 1000.0) + " ms\n";
+		for (size_t i = 0; i < frame.GPUScopes.size(); ++i)
+			str += "GPU " + std::string(frame.GPUScopes[i].depth * 2, ' ') + frame.GPUScopes[i].name + ": " +
+			std::to_string(frame.GPUScopes[i].duration / 1000.0) + " ms\n";
+
+		return str;
+	}
+
+	//escapes a string for JSON
+	inline std::string Profiler_EscapeJSON(const std::string& str)
+	{
+		std::string escaped;
+		escaped.reserve(str.size());
+		for (size_t i = 0; i < str.size(); ++i)
+		{
+			if (str[i] == '"' || str[i] == '\\')
+				escaped += '\\';
+			if ((uint8)str[i] >= 0x20)
+				escaped += str[i];
+		}
+
+		return escaped;
+	}
+
+	//converts the history into Chrome trace JSON || CPU scopes are process 0, GPU scopes process 1, with a thread per depth
+	//the GPU clock isn't calibrated against the CPU's, so each frame's GPU scopes are drawn from the start of it's CPU frame
+	inline std::string Profiler_ToChromeTrace(const Profiler* profiler)
+	{
+		std::string json = "{\"traceEvents\":[\n";
+		bool first = true;
+		auto addEvent = [&](const std::string& name, const uint32 pid, const uint32 tid, const double start, const double duration) {
+			json += std::string(first ? "" : ",\n") + "{\"name\":\"" + Profiler_EscapeJSON(name) + "\",\"ph\":\"X\",\"pid\":" + std::to_string(pid) +
+				",\"tid\":" + std::to_string(tid) + ",\"ts\":" + std::to_string(start) + ",\"dur\":" + std::to_string(duration) + "}";
+			first = false;
+		};
+
+		for (const ProfilerFrame& frame : profiler->history)
+		{
+			addEvent("Frame " + std::to_string(frame.frameNumber), 0, 0, frame.startTime, frame.CPUDuration);
+			for (size_t i = 0; i < frame.CPUScopes.size(); ++i)
+				addEvent(frame.CPUScopes[i].name, 0, frame.CPUScopes[i].depth + 1, frame.startTime + frame.CPUScopes[i].start, frame.CPUScopes[i].duration);
+			for (size_t i = 0; i < frame.GPUScopes.size(); ++i)
+				addEvent(frame.GPUScopes[i].name, 1, frame.GPUScopes[i].depth, frame.startTime + frame.GPUScopes[i].start, frame.GPUScopes[i].duration);
+		}
+
+		json += "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"process 0\":\"CPU\",\"process 1\":\"GPU\"}}\n";
+		return json;
+	}
+
+	//writes the history as a Chrome trace JSON file
+	inline bool Profiler_ExportChromeTrace(const Profiler* profiler, const std::string& path)
+	{
+		std::ofstream file(path);
+		if (!file.is_open())
+		{
+			BTD_LogError("Smok Renderer", "Profiler", "Profiler_ExportChromeTrace", std::string("Failed to open \"" + path + "\"").c_str());
+			return false;
+		}
+
+		file << Profiler_ToChromeTrace(profiler);
+		return true;
+	}
+
+	//times a CPU scope until it goes out of scope || a null profiler does nothing
+	class ProfilerCPUScope
+	{
+		Profiler* profiler = nullptr;
+
+	public:
+
+		inline ProfilerCPUScope(Profiler* _profiler, const char* name)
+			: profiler(_profiler)
+		{
+			if (profiler)
+				Profiler_BeginCPUScope(profiler, name);
+		}
+
+		inline ~ProfilerCPUScope()
+		{
+			if (profiler)
+				Profiler_EndCPUScope(profiler);
+		}
+
+		ProfilerCPUScope(const ProfilerCPUScope&) = delete;
+		ProfilerCPUScope& operator=(const ProfilerCPUScope&) = delete;
+	};
+
+	//times a GPU scope until it goes out of scope || a null profiler does nothing
+	class ProfilerGPUScope
+	{
+		Profiler* profiler = nullptr;
+		VkCommandBuffer comBuffer = VK_NULL_HANDLE;
+
+	public:
+
+		inline ProfilerGPUScope(Profiler* _profiler, VkCommandBuffer _comBuffer, const char* name)
+			: profiler(_profiler), comBuffer(_comBuffer)
+		{
+			if (profiler)
+				Profiler_BeginGPUScope(profiler, comBuffer, name);
+		}
+
+		inline ~ProfilerGPUScope()
+		{
+			if (profiler)
+				Profiler_EndGPUScope(profiler, comBuffer);
+		}
+
+		ProfilerGPUScope(const ProfilerGPUScope&) = delete;
+		ProfilerGPUScope& operator=(const ProfilerGPUScope&) = delete;
+	};
+}
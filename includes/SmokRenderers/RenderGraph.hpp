@@ -0,0 +1,1149 @@
+#pragma once
+
+//defines a render graph, passes declare the images and buffers they read and write instead of recording in whatever order the app picks
+//compiling orders the passes, culls the ones nothing uses, works out the barriers between them,
+//and lets transient resources that are never alive at the same time share memory
+//compiling touches no GPU objects, so a graph can be built and checked without a device
+
+#include <SmokRenderers/Dispatch.hpp>
+
+#include <functional>
+#include <string>
+#include <algorithm>
+
+namespace Smok::Renderers
+{
+	//the handle of a resource that doesn't exist
+#define SMOK_RENDER_GRAPH_NO_RESOURCE UINT32_MAX
+
+	//defines how a pass uses a resource
+	enum class RenderGraph_Access
+	{
+		ColorAttachment = 0, //written as a color attachment
+		DepthAttachment, //depth tested and written
+		DepthRead, //depth tested but not written
+		FragmentRead, //sampled or read in a fragment shader
+		VertexRead, //read in a vertex shader
+		ComputeRead, //read in a compute shader
+		ComputeWrite, //written in a compute shader
+		VertexBuffer, //read as a vertex buffer
+		IndexBuffer, //read as a index buffer
+		IndirectBuffer, //read as indirect draw or dispatch arguments
+		TransferRead, //the source of a copy
+		TransferWrite, //the destination of a copy or clear
+		HostRead, //read by the CPU once the frame is done
+		Present, //handed to the presentation engine
+		SelfSynchronized //the pass does it's own barriers for it, only used to order and cull passes
+	};
+
+	//defines the pipeline sync of a access
+	struct RenderGraph_AccessInfo
+	{
+		VkPipelineStageFlags stage = 0;
+		VkAccessFlags access = 0;
+		VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; //only used for images
+		bool isWrite = false;
+	};
+
+	//gets the pipeline sync of a access
+	inline RenderGraph_AccessInfo RenderGraph_GetAccessInfo(const RenderGraph_Access access)
+	{
+		RenderGraph_AccessInfo info;
+		switch (access)
+		{
+		case RenderGraph_Access::ColorAttachment:
+			info = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true };
+			break;
+		case RenderGraph_Access::DepthAttachment:
+			info = { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true };
+			break;
+		case RenderGraph_Access::DepthRead:
+			info = { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, false };
+			break;
+		case RenderGraph_Access::FragmentRead:
+			info = { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+			break;
+		case RenderGraph_Access::VertexRead:
+			info = { VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+			break;
+		case RenderGraph_Access::ComputeRead:
+			info = { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+			break;
+		case RenderGraph_Access::ComputeWrite:
+			info = { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, true };
+			break;
+		case RenderGraph_Access::VertexBuffer:
+			info = { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false };
+			break;
+		case RenderGraph_Access::IndexBuffer:
+			info = { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false };
+			break;
+		case RenderGraph_Access::IndirectBuffer:
+			info = { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false };
+			break;
+		case RenderGraph_Access::TransferRead:
+			info = { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, false };
+			break;
+		case RenderGraph_Access::TransferWrite:
+			info = { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true };
+			break;
+		case RenderGraph_Access::HostRead:
+			info = { VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, false };
+			break;
+		case RenderGraph_Access::Present:
+			info = { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, false };
+			break;
+		case RenderGraph_Access::SelfSynchronized:
+			break;
+		}
+
+		return info;
+	}
+
+	//converts a access into a string
+	inline const char* RenderGraph_AccessToString(const RenderGraph_Access access)
+	{
+		switch (access)
+		{
+		case RenderGraph_Access::ColorAttachment: return "ColorAttachment";
+		case RenderGraph_Access::DepthAttachment: return "DepthAttachment";
+		case RenderGraph_Access::DepthRead: return "DepthRead";
+		case RenderGraph_Access::FragmentRead: return "FragmentRead";
+		case RenderGraph_Access::VertexRead: return "VertexRead";
+		case RenderGraph_Access::ComputeRead: return "ComputeRead";
+		case RenderGraph_Access::ComputeWrite: return "ComputeWrite";
+		case RenderGraph_Access::VertexBuffer: return "VertexBuffer";
+		case RenderGraph_Access::IndexBuffer: return "IndexBuffer";
+		case RenderGraph_Access::IndirectBuffer: return "IndirectBuffer";
+		case RenderGraph_Access::TransferRead: return "TransferRead";
+		case RenderGraph_Access::TransferWrite: return "TransferWrite";
+		case RenderGraph_Access::HostRead: return "HostRead";
+		case RenderGraph_Access::Present: return "Present";
+		case RenderGraph_Access::SelfSynchronized: return "SelfSynchronized";
+		}
+
+		return "Unknown";
+	}
+
+	//converts a image layout into a string, for the graph dump
+	inline std::string RenderGraph_LayoutToString(const VkImageLayout layout)
+	{
+		switch (layout)
+		{
+		case VK_IMAGE_LAYOUT_UNDEFINED: return "Undefined";
+		case VK_IMAGE_LAYOUT_GENERAL: return "General";
+		case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL: return "ColorAttachment";
+		case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL: return "DepthStencilAttachment";
+		case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL: return "DepthStencilReadOnly";
+		case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL: return "ShaderReadOnly";
+		case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL: return "TransferSrc";
+		case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL: return "TransferDst";
+		case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR: return "PresentSrc";
+		default: return std::to_string((int32)layout);
+		}
+	}
+
+	//checks if a format is a depth format
+	inline bool RenderGraph_IsDepthFormat(const VkFormat format)
+	{
+		return (format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_D32_SFLOAT ||
+			format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT);
+	}
+
+	//gets the bytes per pixel of a format || only used to estimate memory when compiling, allocating uses the real requirements
+	inline uint32 RenderGraph_GetFormatSize(const VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_R8_UNORM: return 1;
+		case VK_FORMAT_R8G8_UNORM: case VK_FORMAT_D16_UNORM: return 2;
+		case VK_FORMAT_R16G16B16A16_UNORM: case VK_FORMAT_R16G16B16A16_SFLOAT: case VK_FORMAT_R32G32_SFLOAT:
+		case VK_FORMAT_R32G32_UINT: case VK_FORMAT_D32_SFLOAT_S8_UINT: return 8;
+		case VK_FORMAT_R32G32B32_SFLOAT: return 12;
+		case VK_FORMAT_R32G32B32A32_SFLOAT: case VK_FORMAT_R32G32B32A32_UINT: return 16;
+		default: return 4;
+		}
+	}
+
+	//defines the type of a resource
+	enum class RenderGraph_ResourceType
+	{
+		Image = 0,
+		Buffer
+	};
+
+	//defines the size and format of a image
+	struct RenderGraph_ImageDesc
+	{
+		VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+		uint32 width = 0, height = 0;
+		uint32 layers = 1;
+	};
+
+	//defines a resource of the graph
+	struct RenderGraph_Resource
+	{
+		std::string name;
+		RenderGraph_ResourceType type = RenderGraph_ResourceType::Image;
+		bool imported = false; //owned outside the graph, like the swapchain image || never aliased or culled
+
+		RenderGraph_ImageDesc imageDesc;
+		VkDeviceSize bufferSize = 0;
+
+		//the handles, set when importing or allocating
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView imageView = VK_NULL_HANDLE;
+		VkBuffer buffer = VK_NULL_HANDLE;
+
+		//imported images start in initialLayout and are moved to finalLayout after the last pass || undefined leaves it as the last pass did
+		VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED, finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		//filled in by compiling
+		VkImageUsageFlags imageUsage = 0;
+		VkBufferUsageFlags bufferUsage = 0;
+		int32 firstPass = -1, lastPass = -1; //the first and last uses, as indexes into the compiled order
+		int32 aliasSlot = -1; //the memory slot it shares, -1 if it's imported or unused
+	};
+
+	//defines a use of a resource by a pass
+	struct RenderGraph_Use
+	{
+		uint32 resource = SMOK_RENDER_GRAPH_NO_RESOURCE;
+		RenderGraph_Access access = RenderGraph_Access::FragmentRead;
+		bool isWrite = false;
+		bool discard = false; //the write covers the whole resource, so the last contents aren't needed
+	};
+
+	//defines a pass of the graph
+	struct RenderGraph_Pass
+	{
+		std::string name;
+		std::vector<RenderGraph_Use> uses;
+		bool hasSideEffects = false; //never culled, like a read back
+		std::function<void(VkCommandBuffer comBuffer)> execute;
+
+		//if set the graph begins this render pass around execute, it's attachments' initial layouts have to be undefined or the graph's
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		VkFramebuffer framebuffer = VK_NULL_HANDLE;
+		VkExtent2D renderArea = { 0, 0 };
+		std::vector<VkClearValue> clearValues;
+		std::vector<std::pair<uint32, VkImageLayout>> attachmentFinalLayouts; //the layouts the render pass leaves it's attachments in
+
+		bool culled = false; //filled in by compiling
+	};
+
+	//defines a barrier the graph records
+	struct RenderGraph_Barrier
+	{
+		uint32 resource = SMOK_RENDER_GRAPH_NO_RESOURCE;
+		VkPipelineStageFlags srcStage = 0, dstStage = 0;
+		VkAccessFlags srcAccess = 0, dstAccess = 0;
+		VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED, newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	};
+
+	//defines a pass in the compiled order
+	struct RenderGraph_CompiledPass
+	{
+		uint32 pass = 0;
+		std::vector<RenderGraph_Barrier> barriers; //recorded before the pass in one vkCmdPipelineBarrier
+	};
+
+	//defines a block of memory transient resources share
+	struct RenderGraph_AliasSlot
+	{
+		RenderGraph_ResourceType type = RenderGraph_ResourceType::Image;
+		VkDeviceSize size = 0; //estimated when compiling, the real size once allocated
+		std::vector<uint32> resources; //in the order they use it
+		std::vector<VmaAllocation> allocations; //one shared allocation, or one per resource if their memory types don't match
+	};
+
+	//defines a render graph
+	struct RenderGraph
+	{
+		std::vector<RenderGraph_Resource> resources;
+		std::vector<RenderGraph_Pass> passes;
+
+		//filled in by compiling
+		bool compiled = false;
+		std::vector<RenderGraph_CompiledPass> order;
+		std::vector<RenderGraph_Barrier> finalBarriers; //moves imported images to their final layout after the last pass
+		std::vector<RenderGraph_AliasSlot> aliasSlots;
+		uint32 barrierCount = 0;
+		VkDeviceSize transientBytes = 0, aliasedBytes = 0; //the transient memory without and with aliasing
+
+		//set once the transient resources are allocated
+		VkDevice device = VK_NULL_HANDLE;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+	};
+
+	//adds a resource
+	inline uint32 RenderGraph_AddResource(RenderGraph* graph, const RenderGraph_Resource& resource)
+	{
+		graph->compiled = false;
+		graph->resources.emplace_back(resource);
+		return (uint32)graph->resources.size() - 1;
+	}
+
+	//creates a transient image, owned and allocated by the graph
+	inline uint32 RenderGraph_CreateImage(RenderGraph* graph, const std::string& name, const RenderGraph_ImageDesc& desc)
+	{
+		RenderGraph_Resource resource;
+		resource.name = name; resource.type = RenderGraph_ResourceType::Image;
+		resource.imageDesc = desc;
+		return RenderGraph_AddResource(graph, resource);
+	}
+
+	//creates a transient buffer, owned and allocated by the graph
+	inline uint32 RenderGraph_CreateBuffer(RenderGraph* graph, const std::string& name, const VkDeviceSize size)
+	{
+		RenderGraph_Resource resource;
+		resource.name = name; resource.type = RenderGraph_ResourceType::Buffer;
+		resource.bufferSize = size;
+		return RenderGraph_AddResource(graph, resource);
+	}
+
+	//imports a image the graph doesn't own, like the swapchain image
+	inline uint32 RenderGraph_ImportImage(RenderGraph* graph, const std::string& name, const RenderGraph_ImageDesc& desc,
+		VkImage image, VkImageView imageView,
+		const VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED, const VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED)
+	{
+		RenderGraph_Resource resource;
+		resource.name = name; resource.type = RenderGraph_ResourceType::Image; resource.imported = true;
+		resource.imageDesc = desc;
+		resource.image = image; resource.imageView = imageView;
+		resource.initialLayout = initialLayout; resource.finalLayout = finalLayout;
+		return RenderGraph_AddResource(graph, resource);
+	}
+
+	//imports a buffer the graph doesn't own
+	inline uint32 RenderGraph_ImportBuffer(RenderGraph* graph, const std::string& name, VkBuffer buffer, const VkDeviceSize size)
+	{
+		RenderGraph_Resource resource;
+		resource.name = name; resource.type = RenderGraph_ResourceType::Buffer; resource.imported = true;
+		resource.buffer = buffer; resource.bufferSize = size;
+		return RenderGraph_AddResource(graph, resource);
+	}
+
+	//swaps the handles of a imported image, so a compiled graph can be reused with the next swapchain image
+	inline void RenderGraph_SetImportedImage(RenderGraph* graph, const uint32 resource, VkImage image, VkImageView imageView)
+	{
+		graph->resources[resource].image = image; graph->resources[resource].imageView = imageView;
+	}
+
+	//swaps the handle of a imported buffer
+	inline void RenderGraph_SetImportedBuffer(RenderGraph* graph, const uint32 resource, VkBuffer buffer, const VkDeviceSize size)
+	{
+		graph->resources[resource].buffer = buffer; graph->resources[resource].bufferSize = size;
+	}
+
+	//finds a resource by name
+	inline uint32 RenderGraph_FindResource(const RenderGraph& graph, const std::string& name)
+	{
+		for (size_t i = 0; i < graph.resources.size(); ++i)
+		{
+			if (graph.resources[i].name == name)
+				return (uint32)i;
+		}
+
+		return SMOK_RENDER_GRAPH_NO_RESOURCE;
+	}
+
+	//adds a pass || passes are kept in the order they're added unless their dependencies allow better
+	inline uint32 RenderGraph_AddPass(RenderGraph* graph, const std::string& name, const std::function<void(VkCommandBuffer comBuffer)>& execute)
+	{
+		graph->compiled = false;
+		RenderGraph_Pass& pass = graph->passes.emplace_back(RenderGraph_Pass());
+		pass.name = name; pass.execute = execute;
+		return (uint32)graph->passes.size() - 1;
+	}
+
+	//declares a pass reads a resource
+	inline bool RenderGraph_Read(RenderGraph* graph, const uint32 pass, const uint32 resource, const RenderGraph_Access access)
+	{
+		if (resource >= graph->resources.size())
+		{
+			BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Read", std::string("Pass \"" + graph->passes[pass].name + "\" reads a resource that doesn't exist!").c_str());
+			return false;
+		}
+		if (RenderGraph_GetAccessInfo(access).isWrite)
+		{
+			BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Read", std::string("Pass \"" + graph->passes[pass].name + "\" reads \"" +
+				graph->resources[resource].name + "\" with a write access, " + RenderGraph_AccessToString(access) + "!").c_str());
+			return false;
+		}
+
+		graph->compiled = false;
+		graph->passes[pass].uses.emplace_back(RenderGraph_Use{ resource, access, false, false });
+		return true;
+	}
+
+	//declares a pass writes a resource || discard says the whole resource is overwritten, so the passes that wrote it before aren't needed by this one
+	inline bool RenderGraph_Write(RenderGraph* graph, const uint32 pass, const uint32 resource, const RenderGraph_Access access, const bool discard = false)
+	{
+		if (resource >= graph->resources.size())
+		{
+			BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Write", std::string("Pass \"" + graph->passes[pass].name + "\" writes a resource that doesn't exist!").c_str());
+			return false;
+		}
+		if (!RenderGraph_GetAccessInfo(access).isWrite && access != RenderGraph_Access::SelfSynchronized)
+		{
+			BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Write", std::string("Pass \"" + graph->passes[pass].name + "\" writes \"" +
+				graph->resources[resource].name + "\" with a read access, " + RenderGraph_AccessToString(access) + "!").c_str());
+			return false;
+		}
+
+		graph->compiled = false;
+		graph->passes[pass].uses.emplace_back(RenderGraph_Use{ resource, access, true, discard });
+		return true;
+	}
+
+	//marks a pass as never culled
+	inline void RenderGraph_SetSideEffects(RenderGraph* graph, const uint32 pass) { graph->compiled = false; graph->passes[pass].hasSideEffects = true; }
+
+	//makes the graph begin a render pass around a pass's execute
+	inline void RenderGraph_SetRenderPass(RenderGraph* graph, const uint32 pass, VkRenderPass renderPass, VkFramebuffer framebuffer,
+		const VkExtent2D renderArea, const std::vector<VkClearValue>& clearValues)
+	{
+		RenderGraph_Pass& p = graph->passes[pass];
+		p.renderPass = renderPass; p.framebuffer = framebuffer; p.renderArea = renderArea; p.clearValues = clearValues;
+	}
+
+	//swaps the framebuffer of a pass, for passes drawing into the swapchain
+	inline void RenderGraph_SetFramebuffer(RenderGraph* graph, const uint32 pass, VkFramebuffer framebuffer, const VkExtent2D renderArea)
+	{
+		graph->passes[pass].framebuffer = framebuffer; graph->passes[pass].renderArea = renderArea;
+	}
+
+	//tells the graph the layout a pass's render pass leaves a attachment in, when the render pass transitions it itself
+	inline void RenderGraph_SetAttachmentFinalLayout(RenderGraph* graph, const uint32 pass, const uint32 resource, const VkImageLayout layout)
+	{
+		graph->compiled = false;
+		graph->passes[pass].attachmentFinalLayouts.emplace_back(std::pair<uint32, VkImageLayout>(resource, layout));
+	}
+
+	//gets the usage flags a access needs
+	inline void RenderGraph_AddUsage(RenderGraph_Resource* resource, const RenderGraph_Access access)
+	{
+		if (resource->type == RenderGraph_ResourceType::Image)
+		{
+			switch (access)
+			{
+			case RenderGraph_Access::ColorAttachment: resource->imageUsage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; break;
+			case RenderGraph_Access::DepthAttachment: case RenderGraph_Access::DepthRead: resource->imageUsage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT; break;
+			case RenderGraph_Access::FragmentRead: case RenderGraph_Access::VertexRead: case RenderGraph_Access::ComputeRead: resource->imageUsage |= VK_IMAGE_USAGE_SAMPLED_BIT; break;
+			case RenderGraph_Access::ComputeWrite: resource->imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT; break;
+			case RenderGraph_Access::TransferRead: resource->imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT; break;
+			case RenderGraph_Access::TransferWrite: resource->imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT; break;
+			default: break;
+			}
+		}
+		else
+		{
+			switch (access)
+			{
+			case RenderGraph_Access::FragmentRead: case RenderGraph_Access::VertexRead:
+			case RenderGraph_Access::ComputeRead: case RenderGraph_Access::ComputeWrite: resource->bufferUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; break;
+			case RenderGraph_Access::VertexBuffer: resource->bufferUsage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT; break;
+			case RenderGraph_Access::IndexBuffer: resource->bufferUsage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT; break;
+			case RenderGraph_Access::IndirectBuffer: resource->bufferUsage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT; break;
+			case RenderGraph_Access::TransferRead: resource->bufferUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT; break;
+			case RenderGraph_Access::TransferWrite: resource->bufferUsage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT; break;
+			default: break;
+			}
+		}
+	}
+
+	//gets the estimated memory of a transient resource
+	inline VkDeviceSize RenderGraph_GetEstimatedSize(const RenderGraph_Resource& resource)
+	{
+		if (resource.type == RenderGraph_ResourceType::Buffer)
+			return resource.bufferSize;
+
+		return (VkDeviceSize)resource.imageDesc.width * resource.imageDesc.height * std::max(resource.imageDesc.layers, 1u) *
+			RenderGraph_GetFormatSize(resource.imageDesc.format);
+	}
+
+	//compiles the graph || culls, orders, places barriers and aliases memory, without touching the GPU
+	inline bool RenderGraph_Compile(RenderGraph* graph)
+	{
+		graph->compiled = false;
+		graph->order.clear(); graph->finalBarriers.clear(); graph->aliasSlots.clear();
+		graph->barrierCount = 0; graph->transientBytes = 0; graph->aliasedBytes = 0;
+
+		const size_t passCount = graph->passes.size();
+		const size_t resourceCount = graph->resources.size();
+		for (size_t r = 0; r < resourceCount; ++r)
+		{
+			RenderGraph_Resource& resource = graph->resources[r];
+			resource.imageUsage = 0; resource.bufferUsage = 0;
+			resource.firstPass = -1; resource.lastPass = -1; resource.aliasSlot = -1;
+		}
+
+		//works out the dependencies, walking each resource's uses in the order the passes were added
+		//dependencies order the passes, producers are the dependencies whose output is actually used, which is what keeps a pass alive
+		std::vector<std::vector<uint32>> dependencies(passCount), producers(passCount);
+		auto addEdge = [](std::vector<uint32>& edges, const uint32 pass) {
+			if (std::find(edges.begin(), edges.end(), pass) == edges.end())
+				edges.emplace_back(pass);
+		};
+
+		for (uint32 r = 0; r < resourceCount; ++r)
+		{
+			int32 lastWriter = -1;
+			std::vector<uint32> readersSinceWrite;
+			for (uint32 p = 0; p < passCount; ++p)
+			{
+				bool reads = false, writes = false, discards = true;
+				for (size_t u = 0; u < graph->passes[p].uses.size(); ++u)
+				{
+					const RenderGraph_Use& use = graph->passes[p].uses[u];
+					if (use.resource != r)
+						continue;
+
+					if (use.isWrite) { writes = true; discards = discards && use.discard; }
+					else reads = true;
+				}
+				if (!reads && !writes)
+					continue;
+
+				if (reads)
+				{
+					if (lastWriter != -1)
+					{
+						addEdge(dependencies[p], (uint32)lastWriter);
+						addEdge(producers[p], (uint32)lastWriter);
+					}
+					else if (!graph->resources[r].imported)
+					{
+						BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Compile", std::string("Pass \"" + graph->passes[p].name +
+							"\" reads \"" + graph->resources[r].name + "\" before any pass writes it!").c_str());
+						return false;
+					}
+				}
+
+				if (writes)
+				{
+					//keeps the last contents unless this pass overwrites all of it
+					if (lastWriter != -1)
+					{
+						addEdge(dependencies[p], (uint32)lastWriter);
+						if (reads || !discards)
+							addEdge(producers[p], (uint32)lastWriter);
+					}
+
+					//write after read
+					for (size_t i = 0; i < readersSinceWrite.size(); ++i)
+					{
+						if (readersSinceWrite[i] != p)
+							addEdge(dependencies[p], readersSinceWrite[i]);
+					}
+
+					lastWriter = (int32)p;
+					readersSinceWrite.clear();
+				}
+				else
+					readersSinceWrite.emplace_back(p);
+			}
+		}
+
+		//culls || passes with side effects or that write a imported resource are kept, and so is everything they need
+		std::vector<bool> isAlive(passCount, false);
+		std::vector<uint32> stack;
+		for (uint32 p = 0; p < passCount; ++p)
+		{
+			bool root = graph->passes[p].hasSideEffects;
+			for (size_t u = 0; u < graph->passes[p].uses.size() && !root; ++u)
+				root = (graph->passes[p].uses[u].isWrite && graph->resources[graph->passes[p].uses[u].resource].imported);
+
+			if (root)
+			{
+				isAlive[p] = true;
+				stack.emplace_back(p);
+			}
+		}
+		while (!stack.empty())
+		{
+			const uint32 p = stack.back(); stack.pop_back();
+			for (size_t i = 0; i < producers[p].size(); ++i)
+			{
+				if (!isAlive[producers[p][i]])
+				{
+					isAlive[producers[p][i]] = true;
+					stack.emplace_back(producers[p][i]);
+				}
+			}
+		}
+		for (uint32 p = 0; p < passCount; ++p)
+			graph->passes[p].culled = !isAlive[p];
+
+		//orders the live passes || of the passes that are ready, the first one that doesn't need the pass just placed goes next,
+		//so dependent passes are spread out and the GPU can overlap them
+		std::vector<uint32> waitingOn(passCount, 0);
+		std::vector<std::vector<uint32>> dependents(passCount);
+		for (uint32 p = 0; p < passCount; ++p)
+		{
+			if (!isAlive[p])
+				continue;
+
+			for (size_t i = 0; i < dependencies[p].size(); ++i)
+			{
+				if (!isAlive[dependencies[p][i]])
+					continue;
+
+				waitingOn[p]++;
+				dependents[dependencies[p][i]].emplace_back(p);
+			}
+		}
+
+		std::vector<uint32> ready;
+		for (uint32 p = 0; p < passCount; ++p)
+		{
+			if (isAlive[p] && !waitingOn[p])
+				ready.emplace_back(p);
+		}
+
+		int32 lastPlaced = -1;
+		while (!ready.empty())
+		{
+			size_t pick = 0;
+			for (size_t i = 0; i < ready.size(); ++i)
+			{
+				const bool needsLast = (lastPlaced != -1 &&
+					std::find(dependencies[ready[i]].begin(), dependencies[ready[i]].end(), (uint32)lastPlaced) != dependencies[ready[i]].end());
+				const bool pickNeedsLast = (lastPlaced != -1 &&
+					std::find(dependencies[ready[pick]].begin(), dependencies[ready[pick]].end(), (uint32)lastPlaced) != dependencies[ready[pick]].end());
+
+				if ((pickNeedsLast && !needsLast) || (pickNeedsLast == needsLast && ready[i] < ready[pick]))
+					pick = i;
+			}
+
+			const uint32 p = ready[pick];
+			ready.erase(ready.begin() + pick);
+			graph->order.emplace_back(RenderGraph_CompiledPass());
+			graph->order.back().pass = p;
+			lastPlaced = (int32)p;
+
+			for (size_t i = 0; i < dependents[p].size(); ++i)
+			{
+				if (!--waitingOn[dependents[p][i]])
+					ready.emplace_back(dependents[p][i]);
+			}
+		}
+
+		//lifetimes and usage
+		for (uint32 o = 0; o < graph->order.size(); ++o)
+		{
+			const RenderGraph_Pass& pass = graph->passes[graph->order[o].pass];
+			for (size_t u = 0; u < pass.uses.size(); ++u)
+			{
+				RenderGraph_Resource& resource = graph->resources[pass.uses[u].resource];
+				if (resource.firstPass == -1)
+					resource.firstPass = (int32)o;
+				resource.lastPass = (int32)o;
+				RenderGraph_AddUsage(&resource, pass.uses[u].access);
+			}
+		}
+
+		//aliases the transient resources, biggest first, into the first slot that's free for their whole lifetime
+		std::vector<uint32> transients;
+		for (uint32 r = 0; r < resourceCount; ++r)
+		{
+			if (!graph->resources[r].imported && graph->resources[r].firstPass != -1)
+			{
+				transients.emplace_back(r);
+				graph->transientBytes += RenderGraph_GetEstimatedSize(graph->resources[r]);
+			}
+		}
+		std::stable_sort(transients.begin(), transients.end(), [graph](const uint32 a, const uint32 b) {
+			return RenderGraph_GetEstimatedSize(graph->resources[a]) > RenderGraph_GetEstimatedSize(graph->resources[b]);
+		});
+
+		for (size_t t = 0; t < transients.size(); ++t)
+		{
+			RenderGraph_Resource& resource = graph->resources[transients[t]];
+			int32 slotIndex = -1;
+			for (size_t s = 0; s < graph->aliasSlots.size() && slotIndex == -1; ++s)
+			{
+				if (graph->aliasSlots[s].type != resource.type)
+					continue;
+
+				bool overlaps = false;
+				for (size_t i = 0; i < graph->aliasSlots[s].resources.size() && !overlaps; ++i)
+				{
+					const RenderGraph_Resource& other = graph->resources[graph->aliasSlots[s].resources[i]];
+					overlaps = (resource.firstPass <= other.lastPass && other.firstPass <= resource.lastPass);
+				}
+				if (!overlaps)
+					slotIndex = (int32)s;
+			}
+
+			if (slotIndex == -1)
+			{
+				slotIndex = (int32)graph->aliasSlots.size();
+				graph->aliasSlots.emplace_back(RenderGraph_AliasSlot());
+				graph->aliasSlots.back().type = resource.type;
+			}
+
+			RenderGraph_AliasSlot& slot = graph->aliasSlots[slotIndex];
+			slot.resources.emplace_back(transients[t]);
+			slot.size = std::max(slot.size, RenderGraph_GetEstimatedSize(resource));
+			resource.aliasSlot = slotIndex;
+		}
+		for (size_t s = 0; s < graph->aliasSlots.size(); ++s)
+		{
+			std::sort(graph->aliasSlots[s].resources.begin(), graph->aliasSlots[s].resources.end(), [graph](const uint32 a, const uint32 b) {
+				return graph->resources[a].firstPass < graph->resources[b].firstPass;
+			});
+			graph->aliasedBytes += graph->aliasSlots[s].size;
+		}
+
+		//barriers || tracks the last write and the reads since, so only hazards and layout changes get one
+		struct ResourceState
+		{
+			VkPipelineStageFlags writeStage = 0, readStages = 0, visibleStages = 0;
+			VkAccessFlags writeAccess = 0, visibleAccess = 0;
+			VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			bool touched = false;
+		};
+		std::vector<ResourceState> states(resourceCount);
+		for (uint32 r = 0; r < resourceCount; ++r)
+			states[r].layout = graph->resources[r].initialLayout;
+
+		//the stages and writes the last user of each alias slot left behind
+		std::vector<VkPipelineStageFlags> slotStages(graph->aliasSlots.size(), 0);
+		std::vector<VkAccessFlags> slotWrites(graph->aliasSlots.size(), 0);
+
+		for (uint32 o = 0; o < graph->order.size(); ++o)
+		{
+			RenderGraph_CompiledPass& compiledPass = graph->order[o];
+			const RenderGraph_Pass& pass = graph->passes[compiledPass.pass];
+
+			//merges the uses of each resource in the pass
+			std::vector<uint32> passResources;
+			for (size_t u = 0; u < pass.uses.size(); ++u)
+			{
+				if (pass.uses[u].access != RenderGraph_Access::SelfSynchronized &&
+					std::find(passResources.begin(), passResources.end(), pass.uses[u].resource) == passResources.end())
+					passResources.emplace_back(pass.uses[u].resource);
+			}
+
+			for (size_t i = 0; i < passResources.size(); ++i)
+			{
+				const uint32 r = passResources[i];
+				const RenderGraph_Resource& resource = graph->resources[r];
+				const bool isImage = (resource.type == RenderGraph_ResourceType::Image);
+
+				RenderGraph_AccessInfo info; info.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+				for (size_t u = 0; u < pass.uses.size(); ++u)
+				{
+					if (pass.uses[u].resource != r || pass.uses[u].access == RenderGraph_Access::SelfSynchronized)
+						continue;
+
+					const RenderGraph_AccessInfo useInfo = RenderGraph_GetAccessInfo(pass.uses[u].access);
+					info.stage |= useInfo.stage; info.access |= useInfo.access; info.isWrite = info.isWrite || useInfo.isWrite;
+					if (info.layout == VK_IMAGE_LAYOUT_UNDEFINED)
+						info.layout = useInfo.layout;
+					else if (info.layout != useInfo.layout)
+						info.layout = VK_IMAGE_LAYOUT_GENERAL;
+				}
+
+				ResourceState& state = states[r];
+				RenderGraph_Barrier barrier;
+				barrier.resource = r;
+				barrier.dstStage = info.stage; barrier.dstAccess = info.access;
+				barrier.oldLayout = state.layout; barrier.newLayout = (isImage ? info.layout : VK_IMAGE_LAYOUT_UNDEFINED);
+				bool needsBarrier = false;
+
+				if (!state.touched)
+				{
+					//a transient resource's first use waits for the last user of it's memory, and drops the old contents
+					if (!resource.imported)
+					{
+						barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+						barrier.srcStage = slotStages[resource.aliasSlot]; barrier.srcAccess = slotWrites[resource.aliasSlot];
+						needsBarrier = (isImage || barrier.srcStage != 0);
+					}
+
+					//a imported resource was synced by the submit, it only needs moving into the right layout
+					else if (isImage && state.layout != info.layout)
+					{
+						barrier.srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+						needsBarrier = true;
+					}
+				}
+				else if (isImage && state.layout != info.layout)
+				{
+					barrier.srcStage = state.writeStage | state.readStages; barrier.srcAccess = state.writeAccess;
+					needsBarrier = true;
+				}
+				else if (info.isWrite)
+				{
+					//write after write, or write after read which only needs the reads to finish
+					barrier.srcStage = state.writeStage | state.readStages; barrier.srcAccess = state.writeAccess;
+					needsBarrier = (barrier.srcStage != 0);
+				}
+				else if (state.writeStage != 0)
+				{
+					//read after write, unless a earlier barrier already made the write visible to this stage
+					needsBarrier = ((state.visibleStages & info.stage) != info.stage || (state.visibleAccess & info.access) != info.access);
+					barrier.srcStage = state.writeStage; barrier.srcAccess = state.writeAccess;
+				}
+
+				if (needsBarrier)
+				{
+					if (!barrier.srcStage)
+						barrier.srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+					if (!isImage)
+						barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+					compiledPass.barriers.emplace_back(barrier);
+					graph->barrierCount++;
+				}
+
+				//updates the state
+				if (info.isWrite)
+				{
+					state.writeStage = info.stage; state.writeAccess = info.access;
+					state.readStages = 0; state.visibleStages = 0; state.visibleAccess = 0;
+				}
+				else
+				{
+					state.readStages |= info.stage;
+					if (needsBarrier)
+					{
+						state.visibleStages |= info.stage; state.visibleAccess |= info.access;
+					}
+				}
+				if (isImage)
+					state.layout = info.layout;
+				state.touched = true;
+
+				if (resource.aliasSlot != -1)
+				{
+					slotStages[resource.aliasSlot] = state.writeStage | state.readStages;
+					slotWrites[resource.aliasSlot] = state.writeAccess;
+				}
+			}
+
+			//the render pass moved it's attachments itself
+			for (size_t i = 0; i < pass.attachmentFinalLayouts.size(); ++i)
+				states[pass.attachmentFinalLayouts[i].first].layout = pass.attachmentFinalLayouts[i].second;
+		}
+
+		//moves imported images into their final layouts
+		for (uint32 r = 0; r < resourceCount; ++r)
+		{
+			const RenderGraph_Resource& resource = graph->resources[r];
+			if (!resource.imported || resource.type != RenderGraph_ResourceType::Image || resource.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED ||
+				states[r].layout == resource.finalLayout)
+				continue;
+
+			RenderGraph_Barrier barrier;
+			barrier.resource = r;
+			barrier.srcStage = (states[r].writeStage | states[r].readStages ? states[r].writeStage | states[r].readStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+			barrier.srcAccess = states[r].writeAccess;
+			barrier.dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			barrier.oldLayout = states[r].layout; barrier.newLayout = resource.finalLayout;
+			graph->finalBarriers.emplace_back(barrier);
+			graph->barrierCount++;
+		}
+
+		graph->compiled = true;
+		return true;
+	}
+
+	//frees the transient resources
+	inline void RenderGraph_FreeResources(RenderGraph* graph)
+	{
+		for (size_t r = 0; r < graph->resources.size(); ++r)
+		{
+			RenderGraph_Resource& resource = graph->resources[r];
+			if (resource.imported)
+				continue;
+
+			if (resource.imageView != VK_NULL_HANDLE)
+				vkDestroyImageView(graph->device, resource.imageView, nullptr);
+			if (resource.image != VK_NULL_HANDLE)
+				vkDestroyImage(graph->device, resource.image, nullptr);
+			if (resource.buffer != VK_NULL_HANDLE)
+				vkDestroyBuffer(graph->device, resource.buffer, nullptr);
+			resource.image = VK_NULL_HANDLE; resource.imageView = VK_NULL_HANDLE; resource.buffer = VK_NULL_HANDLE;
+		}
+
+		for (size_t s = 0; s < graph->aliasSlots.size(); ++s)
+		{
+			for (size_t i = 0; i < graph->aliasSlots[s].allocations.size(); ++i)
+				vmaFreeMemory(graph->allocator, graph->aliasSlots[s].allocations[i]);
+			graph->aliasSlots[s].allocations.clear();
+		}
+	}
+
+	//allocates the transient resources of a compiled graph, the resources sharing a slot are bound to the same memory
+	inline bool RenderGraph_Allocate(RenderGraph* graph, VkDevice device, VmaAllocator allocator)
+	{
+		if (!graph->compiled)
+		{
+			BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Allocate", "The graph has to be compiled before it's allocated!");
+			return false;
+		}
+
+		RenderGraph_FreeResources(graph);
+		graph->device = device; graph->allocator = allocator;
+		graph->aliasedBytes = 0;
+
+		for (size_t s = 0; s < graph->aliasSlots.size(); ++s)
+		{
+			RenderGraph_AliasSlot& slot = graph->aliasSlots[s];
+
+			//makes the resources, and the memory that fits all of them
+			std::vector<VkMemoryRequirements> requirements(slot.resources.size());
+			VkMemoryRequirements shared = { 0, 1, UINT32_MAX };
+			for (size_t i = 0; i < slot.resources.size(); ++i)
+			{
+				RenderGraph_Resource& resource = graph->resources[slot.resources[i]];
+				if (resource.type == RenderGraph_ResourceType::Image)
+				{
+					VkImageCreateInfo imageInfo = {};
+					imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+					imageInfo.imageType = VK_IMAGE_TYPE_2D;
+					imageInfo.format = resource.imageDesc.format;
+					imageInfo.extent = { resource.imageDesc.width, resource.imageDesc.height, 1 };
+					imageInfo.mipLevels = 1;
+					imageInfo.arrayLayers = std::max(resource.imageDesc.layers, 1u);
+					imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+					imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+					imageInfo.usage = resource.imageUsage;
+					imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+					imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+					if (vkCreateImage(device, &imageInfo, nullptr, &resource.image) != VK_SUCCESS)
+					{
+						BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Allocate", std::string("Failed to make image \"" + resource.name + "\"!").c_str());
+						return false;
+					}
+					vkGetImageMemoryRequirements(device, resource.image, &requirements[i]);
+				}
+				else
+				{
+					VkBufferCreateInfo bufferInfo = {};
+					bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+					bufferInfo.size = resource.bufferSize;
+					bufferInfo.usage = resource.bufferUsage;
+					bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+					if (vkCreateBuffer(device, &bufferInfo, nullptr, &resource.buffer) != VK_SUCCESS)
+					{
+						BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Allocate", std::string("Failed to make buffer \"" + resource.name + "\"!").c_str());
+						return false;
+					}
+					vkGetBufferMemoryRequirements(device, resource.buffer, &requirements[i]);
+				}
+
+				shared.size = std::max(shared.size, requirements[i].size);
+				shared.alignment = std::max(shared.alignment, requirements[i].alignment);
+				shared.memoryTypeBits &= requirements[i].memoryTypeBits;
+			}
+
+			//if no memory type fits all of them, they each get their own
+			VmaAllocationCreateInfo allocInfo = {};
+			allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+			const bool canAlias = (shared.memoryTypeBits != 0);
+			slot.allocations.resize(canAlias ? 1 : slot.resources.size(), VK_NULL_HANDLE);
+			slot.size = 0;
+			for (size_t a = 0; a < slot.allocations.size(); ++a)
+			{
+				if (vmaAllocateMemory(allocator, (canAlias ? &shared : &requirements[a]), &allocInfo, &slot.allocations[a], nullptr) != VK_SUCCESS)
+				{
+					BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Allocate", "Failed to allocate transient memory!");
+					return false;
+				}
+				slot.size += (canAlias ? shared.size : requirements[a].size);
+			}
+			graph->aliasedBytes += slot.size;
+
+			//binds and makes the views
+			for (size_t i = 0; i < slot.resources.size(); ++i)
+			{
+				RenderGraph_Resource& resource = graph->resources[slot.resources[i]];
+				VmaAllocation allocation = slot.allocations[canAlias ? 0 : i];
+				if (resource.type == RenderGraph_ResourceType::Buffer)
+				{
+					vmaBindBufferMemory(allocator, allocation, resource.buffer);
+					continue;
+				}
+
+				vmaBindImageMemory(allocator, allocation, resource.image);
+
+				const bool isDepth = RenderGraph_IsDepthFormat(resource.imageDesc.format);
+				VkImageViewCreateInfo viewInfo = {};
+				viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+				viewInfo.image = resource.image;
+				viewInfo.viewType = (resource.imageDesc.layers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D);
+				viewInfo.format = resource.imageDesc.format;
+				viewInfo.subresourceRange = { (VkImageAspectFlags)(isDepth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT),
+					0, 1, 0, std::max(resource.imageDesc.layers, 1u) };
+				if (vkCreateImageView(device, &viewInfo, nullptr, &resource.imageView) != VK_SUCCESS)
+				{
+					BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Allocate", std::string("Failed to make image view \"" + resource.name + "\"!").c_str());
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	//frees the transient resources and clears the graph
+	inline void RenderGraph_Destroy(RenderGraph* graph)
+	{
+		RenderGraph_FreeResources(graph);
+		*graph = RenderGraph();
+	}
+
+	//records a group of barriers
+	inline void RenderGraph_RecordBarriers(const RenderGraph* graph, VkCommandBuffer comBuffer, const std::vector<RenderGraph_Barrier>& barriers,
+		Dispatch* dispatch = nullptr)
+	{
+		if (barriers.empty())
+			return;
+
+		VkPipelineStageFlags srcStages = 0, dstStages = 0;
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+		std::vector<VkBufferMemoryBarrier> bufferBarriers;
+		for (size_t i = 0; i < barriers.size(); ++i)
+		{
+			const RenderGraph_Barrier& barrier = barriers[i];
+			const RenderGraph_Resource& resource = graph->resources[barrier.resource];
+			srcStages |= barrier.srcStage; dstStages |= barrier.dstStage;
+
+			if (resource.type == RenderGraph_ResourceType::Image)
+			{
+				VkImageMemoryBarrier imageBarrier = {};
+				imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				imageBarrier.srcAccessMask = barrier.srcAccess; imageBarrier.dstAccessMask = barrier.dstAccess;
+				imageBarrier.oldLayout = barrier.oldLayout; imageBarrier.newLayout = barrier.newLayout;
+				imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageBarrier.image = resource.image;
+
+				VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+				if (RenderGraph_IsDepthFormat(resource.imageDesc.format))
+					aspect = (resource.imageDesc.format == VK_FORMAT_D24_UNORM_S8_UINT || resource.imageDesc.format == VK_FORMAT_D32_SFLOAT_S8_UINT ?
+						VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT);
+				imageBarrier.subresourceRange = { aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+				imageBarriers.emplace_back(imageBarrier);
+			}
+			else
+			{
+				VkBufferMemoryBarrier bufferBarrier = {};
+				bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+				bufferBarrier.srcAccessMask = barrier.srcAccess; bufferBarrier.dstAccessMask = barrier.dstAccess;
+				bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				bufferBarrier.buffer = resource.buffer;
+				bufferBarrier.offset = 0; bufferBarrier.size = VK_WHOLE_SIZE;
+				bufferBarriers.emplace_back(bufferBarrier);
+			}
+		}
+
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, srcStages, dstStages, 0, 0, nullptr,
+			(uint32)bufferBarriers.size(), bufferBarriers.data(), (uint32)imageBarriers.size(), imageBarriers.data());
+	}
+
+	//records the compiled graph || the barriers and render passes go through the dispatch, the passes use their own
+	inline bool RenderGraph_Execute(RenderGraph* graph, VkCommandBuffer comBuffer, Dispatch* dispatch = nullptr)
+	{
+		if (!graph->compiled)
+		{
+			BTD_LogError("Smok Renderer", "Render Graph", "RenderGraph_Execute", "The graph has to be compiled before it's executed!");
+			return false;
+		}
+
+		for (size_t o = 0; o < graph->order.size(); ++o)
+		{
+			RenderGraph_Pass& pass = graph->passes[graph->order[o].pass];
+			RenderGraph_RecordBarriers(graph, comBuffer, graph->order[o].barriers, dispatch);
+
+			if (pass.renderPass != VK_NULL_HANDLE)
+			{
+				VkRenderPassBeginInfo beginInfo = {};
+				beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+				beginInfo.renderPass = pass.renderPass;
+				beginInfo.framebuffer = pass.framebuffer;
+				beginInfo.renderArea.offset = { 0, 0 };
+				beginInfo.renderArea.extent = pass.renderArea;
+				beginInfo.clearValueCount = (uint32)pass.clearValues.size();
+				beginInfo.pClearValues = pass.clearValues.data();
+				Dispatch_CmdBeginRenderPass(dispatch, comBuffer, beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+			}
+
+			if (pass.execute)
+				pass.execute(comBuffer);
+
+			if (pass.renderPass != VK_NULL_HANDLE)
+				Dispatch_CmdEndRenderPass(dispatch, comBuffer);
+		}
+
+		RenderGraph_RecordBarriers(graph, comBuffer, graph->finalBarriers, dispatch);
+		return true;
+	}
+
+	//converts a barrier into a string
+	inline std::string RenderGraph_BarrierToString(const RenderGraph& graph, const RenderGraph_Barrier& barrier)
+	{
+		std::string str = "barrier \"" + graph.resources[barrier.resource].name + "\"";
+		if (graph.resources[barrier.resource].type == RenderGraph_ResourceType::Image)
+			str += " " + RenderGraph_LayoutToString(barrier.oldLayout) + " -> " + RenderGraph_LayoutToString(barrier.newLayout);
+		return str + " (stages " + std::to_string(barrier.srcStage) + " -> " + std::to_string(barrier.dstStage) +
+			", access " + std::to_string(barrier.srcAccess) + " -> " + std::to_string(barrier.dstAccess) + ")";
+	}
+
+	//dumps the compiled graph into a human readable string
+	inline std::string RenderGraph_ToString(const RenderGraph& graph)
+	{
+		if (!graph.compiled)
+			return "Render Graph: not compiled";
+
+		std::string str = "Render Graph: " + std::to_string(graph.order.size()) + "/" + std::to_string(graph.passes.size()) + " passes, " +
+			std::to_string(graph.barrierCount) + " barriers\n";
+
+		for (size_t o = 0; o < graph.order.size(); ++o)
+		{
+			const RenderGraph_Pass& pass = graph.passes[graph.order[o].pass];
+			str += std::to_string(o) + ": \"" + pass.name + "\"" + (pass.renderPass != VK_NULL_HANDLE ? " (render pass)" : "") + "\n";
+			for (size_t b = 0; b < graph.order[o].barriers.size(); ++b)
+				str += "\t" + RenderGraph_BarrierToString(graph, graph.order[o].barriers[b]) + "\n";
+			for (size_t u = 0; u < pass.uses.size(); ++u)
+				str += std::string("\t") + (pass.uses[u].isWrite ? "writes" : "reads") + " \"" + graph.resources[pass.uses[u].resource].name + "\" as " +
+				RenderGraph_AccessToString(pass.uses[u].access) + (pass.uses[u].discard ? ", discarding it" : "") + "\n";
+		}
+		for (size_t b = 0; b < graph.finalBarriers.size(); ++b)
+			str += "end: " + RenderGraph_BarrierToString(graph, graph.finalBarriers[b]) + "\n";
+
+		for (size_t p = 0; p < graph.passes.size(); ++p)
+		{
+			if (graph.passes[p].culled)
+				str += "culled: \"" + graph.passes[p].name + "\"\n";
+		}
+
+		for (size_t r = 0; r < graph.resources.size(); ++r)
+		{
+			const RenderGraph_Resource& resource = graph.resources[r];
+			str += "resource \"" + resource.name + "\": ";
+			if (resource.type == RenderGraph_ResourceType::Image)
+				str += "image " + std::to_string(resource.imageDesc.width) + "x" + std::to_string(resource.imageDesc.height);
+			else
+				str += "buffer " + std::to_string(resource.bufferSize) + " bytes";
+			str += (resource.imported ? ", imported" : ", transient");
+
+			if (resource.firstPass == -1)
+				str += ", unused\n";
+			else
+				str += ", passes " + std::to_string(resource.firstPass) + "-" + std::to_string(resource.lastPass) +
+				(resource.aliasSlot != -1 ? ", slot " + std::to_string(resource.aliasSlot) : "") + "\n";
+		}
+
+		str += "Memory: " + std::to_string(graph.aliasSlots.size()) + " slots, " + std::to_string(graph.aliasedBytes) + " bytes aliased from " +
+			std::to_string(graph.transientBytes) + " bytes";
+		return str;
+	}
+}
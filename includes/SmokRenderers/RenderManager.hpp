@@ -2,7 +2,15 @@
 
 //defines a render manager for managing a frame and it's graph
 
-#include <SmokWindow/Desktop/DesktopWindow.h>
+#include <SmokRenderers/Profiler.hpp>
+#include <SmokRenderers/FrameStats.hpp>
+#include <SmokRenderers/Dispatch.hpp>
+#include <SmokRenderers/Util/StagingRing.hpp>
+#include <SmokRenderers/Util/RenderPass.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
 
 namespace Smok::Renderers
 {
@@ -11,10 +19,70 @@ namespace Smok::Renderers
 	{
 		bool isValid = false; //is the frame valid
 		uint32 imageIndex = 0; //the index into the image array in the swapchain
-		uint32 frameIndex = 0; //the current frame of the swapchain
-		uint32 currentFrame = 0; //the current frame of the game
+		uint32 frameIndex = 0; //the frame in flight, which per frame buffers are indexed by || the same as currentFrame
+		uint32 currentFrame = 0; //the frame in flight, which per frame descriptor sets and command buffers are indexed by
 		BTD_Math_U32Vec2 frameSize; //the size of the frame
 		VkFramebuffer framebuffer = VK_NULL_HANDLE; //swapchain frame buffers
+		FrameStats* stats = nullptr; //the stats the renderers add to, can be null
+		Dispatch* dispatch = nullptr; //where the renderers send their commands, null goes straight to Vulkan
+	};
+
+	//defines a swapchain that's been replaced, it's kept until every frame submitted before it was retired is done
+	//the recreate callback fills in the handles it took out of the swapchain
+	struct RetiredSwapchain
+	{
+		VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+		std::vector<VkFramebuffer> framebuffers;
+		std::vector<VkImageView> imageViews;
+		VkRenderPass renderpass = VK_NULL_HANDLE; //only set if the render pass was replaced
+
+		VmaAllocator allocator = VK_NULL_HANDLE; //frees the depth images
+		std::vector<VkImage> depthImages; std::vector<VmaAllocation> depthAllocations; //their views are in imageViews
+
+		uint64 retireFrame = 0; //the frames submitted when it was retired
+	};
+
+	//defines the result of recreating a swapchain
+	struct SwapchainRecreateResult
+	{
+		bool succeeded = false; //false if it can't be made right now, like when the window is minimized
+		VkFormat colorFormat = VK_FORMAT_UNDEFINED, depthFormat = VK_FORMAT_UNDEFINED; //the formats the render pass was made with
+	};
+
+	//recreates a swapchain in place || pass oldSwapchain as VkSwapchainCreateInfoKHR::oldSwapchain,
+	//move the old framebuffers and image views into retired instead of destroying them,
+	//and keep the render pass unless the formats changed, in which case move the old one into retired too
+	typedef std::function<SwapchainRecreateResult(SMWindow_Desktop_Swapchain* swapchain, VkSwapchainKHR oldSwapchain,
+		RetiredSwapchain& retired)> SwapchainRecreateCallback;
+
+	//called once a recreated swapchain has a new render pass, so pipelines can be remade against it
+	typedef std::function<void(SMWindow_Desktop_Swapchain* swapchain)> RenderPassChangedCallback;
+
+	//defines what the default swapchain recreate needs, for apps that don't set their own recreateSwapchain
+	struct DefaultSwapchainRecreateInfo
+	{
+		VkSurfaceKHR surface = VK_NULL_HANDLE; //the window's surface
+		std::function<VkExtent2D()> getFramebufferSize; //the window's framebuffer size, used when the surface doesn't give one || 0 while minimized
+		VmaAllocator allocator = VK_NULL_HANDLE; //makes the depth images
+		VkFormat depthFormat = VK_FORMAT_UNDEFINED; //the depth attachment of the swapchain's render pass, VK_FORMAT_UNDEFINED for none
+		VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR; //falls back to FIFO, which is always there
+		uint32 graphicsQueueFamily = 0, presentQueueFamily = 0; //the images are shared between them when they differ
+
+		//the image views the window library made for the first swapchain, they're retired with it
+		//|| the window library mustn't destroy them, or the swapchain, framebuffers and render pass, once a recreate has replaced them
+		std::vector<VkImageView> imageViews;
+	};
+
+	//defines the handles the default swapchain recreate made, so the next recreate can retire them
+	struct DefaultSwapchainRecreate
+	{
+		DefaultSwapchainRecreateInfo info;
+		SMWindow_Desktop_Swapchain* swapchain = nullptr; //the swapchain it recreates in place
+
+		bool ownsHandles = false; //are the swapchain's current handles it's own, false until the first recreate
+		VkRenderPass renderpass = VK_NULL_HANDLE; //the render pass it made, if the format changed
+		std::vector<VkImageView> imageViews;
+		std::vector<VkImage> depthImages; std::vector<VmaAllocation> depthAllocations; std::vector<VkImageView> depthViews;
 	};
 
 	//defines a render manager
@@ -23,18 +91,42 @@ namespace Smok::Renderers
 		VkSemaphore imageAvailableSemaphores[2];
 		VkSemaphore renderFinishedSemaphores[2];
 		VkFence inFlightFences[2];
-		VkFence imagesInFlight[3] = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE };
+		std::vector<VkFence> imagesInFlight = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE };
 
 		const uint8 maxFramesInFlight = 2;
 		size_t currentFrame = 0;
 
 		VkQueue graphicsQueue = VK_NULL_HANDLE, presentQueue = VK_NULL_HANDLE;
 		VkDevice device = VK_NULL_HANDLE;
+
+		//swapchain recreation
+		SwapchainRecreateCallback recreateSwapchain; //set by the app or RenderManager_UseDefaultSwapchainRecreate, without it out of date frames are just skipped
+		std::unique_ptr<DefaultSwapchainRecreate> defaultRecreate; //the state of the default recreate, if it's used
+		std::vector<RenderPassChangedCallback> renderPassChangedCallbacks;
+		bool swapchainNeedsRecreate = false; //set when acquire or present reports the swapchain out of date or suboptimal, or on resize
+		VkFormat colorFormat = VK_FORMAT_UNDEFINED, depthFormat = VK_FORMAT_UNDEFINED; //the formats of the current render pass, first set by InitRenderManager
+		uint32 swapchainRecreateCount = 0, renderPassChangeCount = 0;
+
+		uint64 submittedFrameCount = 0, completedFrameCount = 0; //used to know when retired swapchains are free
+		uint64 inFlightFrameNumbers[2] = { 0, 0 }; //the frame number each in flight fence was last submitted with
+		std::vector<RetiredSwapchain> retiredSwapchains;
+
+		Profiler* profiler = nullptr; //optional, NextFrame begins it's frames and SubmitFrame ends them
+
+		FrameStats frameStats; //the stats of the frame being made
+		FrameStats lastFrameStats; //the stats of the last submitted frame
+
+		Dispatch dispatch; //where the renderers send their commands || give it a trace to record every frame, and to the AssetManager with SetDispatch for the uploads
+
+		Util::StagingRing* stagingRing = nullptr; //optional, NextFrame begins it's frames and SubmitFrame flushes it before the frame is submitted
 	};
 
-	//initalizes the render manager
-	inline bool InitRenderManager(RenderManager* renderManager, SMGraphics_Core_GPU* GPU)
+	//initalizes the render manager || colorFormat and depthFormat are the formats of the swapchain's render pass, so the first recreate can tell if they changed
+	inline bool InitRenderManager(RenderManager* renderManager, SMGraphics_Core_GPU* GPU,
+		const VkFormat colorFormat = VK_FORMAT_UNDEFINED, const VkFormat depthFormat = VK_FORMAT_UNDEFINED)
 	{
+		renderManager->colorFormat = colorFormat; renderManager->depthFormat = depthFormat;
+
 		//creates rendering sync objects
 		VkSemaphoreCreateInfo semaphoreInfo = {};
 		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -59,15 +151,364 @@ namespace Smok::Renderers
 		return true;
 	}
 
+	//destroys a retired swapchain
+	inline void RetiredSwapchain_Destroy(RetiredSwapchain* retired, SMGraphics_Core_GPU* GPU)
+	{
+		for (size_t i = 0; i < retired->framebuffers.size(); ++i)
+			vkDestroyFramebuffer(GPU->device, retired->framebuffers[i], nullptr);
+		for (size_t i = 0; i < retired->imageViews.size(); ++i)
+			vkDestroyImageView(GPU->device, retired->imageViews[i], nullptr);
+		for (size_t i = 0; i < retired->depthImages.size(); ++i)
+			vmaDestroyImage(retired->allocator, retired->depthImages[i], retired->depthAllocations[i]);
+		if (retired->renderpass != VK_NULL_HANDLE)
+			vkDestroyRenderPass(GPU->device, retired->renderpass, nullptr);
+		if (retired->swapchain != VK_NULL_HANDLE)
+			vkDestroySwapchainKHR(GPU->device, retired->swapchain, nullptr);
+
+		*retired = RetiredSwapchain();
+	}
+
+	//destroys the retired swapchains every frame using them has finished with || checks the fences without waiting
+	inline void RenderManager_DestroyFinishedSwapchains(RenderManager* renderManager, SMGraphics_Core_GPU* GPU)
+	{
+		if (renderManager->retiredSwapchains.empty())
+			return;
+
+		for (size_t i = 0; i < renderManager->maxFramesInFlight; ++i)
+		{
+			if (vkGetFenceStatus(GPU->device, renderManager->inFlightFences[i]) == VK_SUCCESS)
+				renderManager->completedFrameCount = std::max(renderManager->completedFrameCount, renderManager->inFlightFrameNumbers[i]);
+		}
+
+		for (size_t i = 0; i < renderManager->retiredSwapchains.size();)
+		{
+			if (renderManager->retiredSwapchains[i].retireFrame <= renderManager->completedFrameCount)
+			{
+				RetiredSwapchain_Destroy(&renderManager->retiredSwapchains[i], GPU);
+				renderManager->retiredSwapchains.erase(renderManager->retiredSwapchains.begin() + i);
+			}
+			else
+				++i;
+		}
+	}
+
+	//asks for the swapchain to be recreated before the next frame, call it when the window resizes
+	inline void RenderManager_RequestSwapchainRecreate(RenderManager* renderManager) { renderManager->swapchainNeedsRecreate = true; }
+
+	//sets the formats of the current render pass, so a recreate can tell if it changed || InitRenderManager sets the first ones
+	inline void RenderManager_SetRenderPassFormats(RenderManager* renderManager, const VkFormat colorFormat, const VkFormat depthFormat)
+	{
+		renderManager->colorFormat = colorFormat; renderManager->depthFormat = depthFormat;
+	}
+
+	//destroys a set of images made by the default swapchain recreate
+	inline void DefaultSwapchainRecreate_DestroyImages(VkDevice device, VmaAllocator allocator, std::vector<VkImageView>& imageViews,
+		std::vector<VkImage>& depthImages, std::vector<VmaAllocation>& depthAllocations, std::vector<VkImageView>& depthViews)
+	{
+		for (size_t i = 0; i < imageViews.size(); ++i)
+			vkDestroyImageView(device, imageViews[i], nullptr);
+		for (size_t i = 0; i < depthViews.size(); ++i)
+			vkDestroyImageView(device, depthViews[i], nullptr);
+		for (size_t i = 0; i < depthImages.size(); ++i)
+			vmaDestroyImage(allocator, depthImages[i], depthAllocations[i]);
+
+		imageViews.clear(); depthViews.clear(); depthImages.clear(); depthAllocations.clear();
+	}
+
+	//picks the surface format, keeping the current one if the surface still has it
+	inline VkSurfaceFormatKHR DefaultSwapchainRecreate_PickFormat(const std::vector<VkSurfaceFormatKHR>& formats, const VkFormat currentFormat)
+	{
+		for (size_t i = 0; i < formats.size(); ++i)
+		{
+			if (formats[i].format == currentFormat)
+				return formats[i];
+		}
+		for (size_t i = 0; i < formats.size(); ++i)
+		{
+			if (formats[i].format == VK_FORMAT_B8G8R8A8_SRGB && formats[i].colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+				return formats[i];
+		}
+		return formats[0];
+	}
+
+	//recreates the swapchain from the old one, with new image views, depth images and framebuffers
+	//the render pass is kept unless the surface's format changed, the old handles are moved into retired
+	inline SwapchainRecreateResult DefaultSwapchainRecreate_Recreate(DefaultSwapchainRecreate* recreate, SMGraphics_Core_GPU* GPU,
+		const VkFormat currentColorFormat, SMWindow_Desktop_Swapchain* swapchain, VkSwapchainKHR oldSwapchain, RetiredSwapchain& retired)
+	{
+		const DefaultSwapchainRecreateInfo& info = recreate->info;
+		SwapchainRecreateResult result;
+
+		VkSurfaceCapabilitiesKHR capabilities = {};
+		if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(GPU->physicalDevice, info.surface, &capabilities) != VK_SUCCESS)
+			return result;
+
+		//the surface's size if it has one, otherwise the window's
+		VkExtent2D extent = capabilities.currentExtent;
+		if (extent.width == UINT32_MAX)
+		{
+			extent = (info.getFramebufferSize ? info.getFramebufferSize() : VkExtent2D{ 0, 0 });
+			extent.width = std::clamp(extent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+			extent.height = std::clamp(extent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+		}
+		if (extent.width == 0 || extent.height == 0)
+			return result; //minimized, tried again next frame
+
+		uint32 formatCount = 0;
+		vkGetPhysicalDeviceSurfaceFormatsKHR(GPU->physicalDevice, info.surface, &formatCount, nullptr);
+		std::vector<VkSurfaceFormatKHR> formats(formatCount);
+		vkGetPhysicalDeviceSurfaceFormatsKHR(GPU->physicalDevice, info.surface, &formatCount, formats.data());
+		if (formats.empty())
+			return result;
+		const VkSurfaceFormatKHR surfaceFormat = DefaultSwapchainRecreate_PickFormat(formats, currentColorFormat);
+
+		uint32 presentModeCount = 0;
+		vkGetPhysicalDeviceSurfacePresentModesKHR(GPU->physicalDevice, info.surface, &presentModeCount, nullptr);
+		std::vector<VkPresentModeKHR> presentModes(presentModeCount);
+		vkGetPhysicalDeviceSurfacePresentModesKHR(GPU->physicalDevice, info.surface, &presentModeCount, presentModes.data());
+		const VkPresentModeKHR presentMode = (std::find(presentModes.begin(), presentModes.end(), info.presentMode) != presentModes.end() ?
+			info.presentMode : VK_PRESENT_MODE_FIFO_KHR);
+
+		uint32 imageCount = capabilities.minImageCount + 1;
+		if (capabilities.maxImageCount > 0)
+			imageCount = std::min(imageCount, capabilities.maxImageCount);
+
+		//the old swapchain is retired by this, even if making the new one fails
+		const uint32 queueFamilies[2] = { info.graphicsQueueFamily, info.presentQueueFamily };
+		VkSwapchainCreateInfoKHR swapchainInfo = {};
+		swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+		swapchainInfo.surface = info.surface;
+		swapchainInfo.minImageCount = imageCount;
+		swapchainInfo.imageFormat = surfaceFormat.format;
+		swapchainInfo.imageColorSpace = surfaceFormat.colorSpace;
+		swapchainInfo.imageExtent = extent;
+		swapchainInfo.imageArrayLayers = 1;
+		swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		swapchainInfo.imageSharingMode = (queueFamilies[0] != queueFamilies[1] ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE);
+		swapchainInfo.queueFamilyIndexCount = (queueFamilies[0] != queueFamilies[1] ? 2 : 0);
+		swapchainInfo.pQueueFamilyIndices = queueFamilies;
+		swapchainInfo.preTransform = capabilities.currentTransform;
+		swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+		swapchainInfo.presentMode = presentMode;
+		swapchainInfo.clipped = VK_TRUE;
+		swapchainInfo.oldSwapchain = oldSwapchain;
+
+		VkSwapchainKHR newSwapchain = VK_NULL_HANDLE;
+		if (vkCreateSwapchainKHR(GPU->device, &swapchainInfo, nullptr, &newSwapchain) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Render Manager", "DefaultSwapchainRecreate_Recreate", "Failed to create the swapchain!");
+			return result;
+		}
+
+		vkGetSwapchainImagesKHR(GPU->device, newSwapchain, &imageCount, nullptr);
+		std::vector<VkImage> images(imageCount);
+		vkGetSwapchainImagesKHR(GPU->device, newSwapchain, &imageCount, images.data());
+
+		//a new render pass only if the format changed, the pipelines are remade against it
+		const bool formatChanged = (surfaceFormat.format != currentColorFormat);
+		VkRenderPass renderpass = swapchain->renderpass;
+		if (formatChanged)
+			renderpass = Util::RenderPass_Create(GPU->device, surfaceFormat.format, info.depthFormat, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+		std::vector<VkImageView> imageViews, depthViews;
+		std::vector<VkImage> depthImages; std::vector<VmaAllocation> depthAllocations;
+		std::vector<VkFramebuffer> framebuffers;
+		bool succeeded = (renderpass != VK_NULL_HANDLE);
+		for (uint32 i = 0; i < imageCount && succeeded; ++i)
+		{
+			VkImageViewCreateInfo viewInfo = {};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = images[i];
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = surfaceFormat.format;
+			viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			VkImageView view = VK_NULL_HANDLE;
+			succeeded = (vkCreateImageView(GPU->device, &viewInfo, nullptr, &view) == VK_SUCCESS);
+			if (succeeded)
+				imageViews.emplace_back(view);
+
+			//each image gets it's own depth, so frames in flight don't share one
+			VkImageView attachments[2] = { view, VK_NULL_HANDLE };
+			if (succeeded && info.depthFormat != VK_FORMAT_UNDEFINED)
+			{
+				VkImageCreateInfo depthInfo = {};
+				depthInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+				depthInfo.imageType = VK_IMAGE_TYPE_2D;
+				depthInfo.format = info.depthFormat;
+				depthInfo.extent = { extent.width, extent.height, 1 };
+				depthInfo.mipLevels = 1; depthInfo.arrayLayers = 1;
+				depthInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+				depthInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+				depthInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+				depthInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+				depthInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+				VmaAllocationCreateInfo allocInfo = {};
+				allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+				VkImage depthImage = VK_NULL_HANDLE; VmaAllocation depthAllocation = VK_NULL_HANDLE;
+				succeeded = (vmaCreateImage(info.allocator, &depthInfo, &allocInfo, &depthImage, &depthAllocation, nullptr) == VK_SUCCESS);
+				if (succeeded)
+				{
+					depthImages.emplace_back(depthImage); depthAllocations.emplace_back(depthAllocation);
+
+					viewInfo.image = depthImage;
+					viewInfo.format = info.depthFormat;
+					viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+					succeeded = (vkCreateImageView(GPU->device, &viewInfo, nullptr, &attachments[1]) == VK_SUCCESS);
+					if (succeeded)
+						depthViews.emplace_back(attachments[1]);
+				}
+			}
+
+			VkFramebufferCreateInfo framebufferInfo = {};
+			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			framebufferInfo.renderPass = renderpass;
+			framebufferInfo.attachmentCount = (info.depthFormat != VK_FORMAT_UNDEFINED ? 2 : 1);
+			framebufferInfo.pAttachments = attachments;
+			framebufferInfo.width = extent.width; framebufferInfo.height = extent.height;
+			framebufferInfo.layers = 1;
+			VkFramebuffer framebuffer = VK_NULL_HANDLE;
+			succeeded = succeeded && (vkCreateFramebuffer(GPU->device, &framebufferInfo, nullptr, &framebuffer) == VK_SUCCESS);
+			if (succeeded)
+				framebuffers.emplace_back(framebuffer);
+		}
+
+		if (!succeeded)
+		{
+			BTD_LogError("Smok Renderer", "Render Manager", "DefaultSwapchainRecreate_Recreate", "Failed to create the swapchain's framebuffers!");
+			for (size_t i = 0; i < framebuffers.size(); ++i)
+				vkDestroyFramebuffer(GPU->device, framebuffers[i], nullptr);
+			DefaultSwapchainRecreate_DestroyImages(GPU->device, info.allocator, imageViews, depthImages, depthAllocations, depthViews);
+			if (formatChanged && renderpass != VK_NULL_HANDLE)
+				vkDestroyRenderPass(GPU->device, renderpass, nullptr);
+			vkDestroySwapchainKHR(GPU->device, newSwapchain, nullptr);
+			return result;
+		}
+
+		//the old handles are kept until the frames using them are done
+		retired.framebuffers = swapchain->framebuffers;
+		retired.imageViews = (recreate->ownsHandles ? recreate->imageViews : info.imageViews);
+		retired.imageViews.insert(retired.imageViews.end(), recreate->depthViews.begin(), recreate->depthViews.end());
+		retired.allocator = info.allocator;
+		retired.depthImages = recreate->depthImages; retired.depthAllocations = recreate->depthAllocations;
+		if (formatChanged)
+			retired.renderpass = swapchain->renderpass;
+
+		recreate->imageViews = imageViews; recreate->depthViews = depthViews;
+		recreate->depthImages = depthImages; recreate->depthAllocations = depthAllocations;
+		if (formatChanged)
+			recreate->renderpass = renderpass;
+		recreate->ownsHandles = true;
+
+		swapchain->swapchain = newSwapchain;
+		swapchain->framebuffers = framebuffers;
+		swapchain->renderpass = renderpass;
+		swapchain->extents.width = extent.width; swapchain->extents.height = extent.height;
+
+		result.succeeded = true;
+		result.colorFormat = surfaceFormat.format; result.depthFormat = info.depthFormat;
+		return result;
+	}
+
+	//uses the default swapchain recreate, which builds the new swapchain itself from the old one
+	//call it after InitRenderManager, with the formats of the window library's render pass given there
+	inline void RenderManager_UseDefaultSwapchainRecreate(RenderManager* renderManager, SMGraphics_Core_GPU* GPU,
+		SMWindow_Desktop_Swapchain* swapchain, const DefaultSwapchainRecreateInfo& info)
+	{
+		renderManager->defaultRecreate = std::make_unique<DefaultSwapchainRecreate>();
+		renderManager->defaultRecreate->info = info;
+		renderManager->defaultRecreate->swapchain = swapchain;
+
+		DefaultSwapchainRecreate* recreate = renderManager->defaultRecreate.get();
+		renderManager->recreateSwapchain = [renderManager, recreate, GPU](SMWindow_Desktop_Swapchain* swapchain, VkSwapchainKHR oldSwapchain,
+			RetiredSwapchain& retired) {
+			return DefaultSwapchainRecreate_Recreate(recreate, GPU, renderManager->colorFormat, swapchain, oldSwapchain, retired);
+		};
+	}
+
+	//recreates the swapchain, retiring the old one until the frames using it are done
+	//pipelines are only remade if the render pass formats changed
+	inline bool RenderManager_RecreateSwapchain(RenderManager* renderManager, SMGraphics_Core_GPU* GPU, SMWindow_Desktop_Swapchain* swapchain)
+	{
+		if (!renderManager->recreateSwapchain)
+		{
+			BTD_LogError("Smok Renderer", "Render Manager", "RenderManager_RecreateSwapchain", "No swapchain recreate callback was set!");
+			return false;
+		}
+
+		RetiredSwapchain retired;
+		retired.swapchain = swapchain->swapchain;
+		retired.retireFrame = renderManager->submittedFrameCount;
+
+		const SwapchainRecreateResult result = renderManager->recreateSwapchain(swapchain, retired.swapchain, retired);
+		if (!result.succeeded)
+			return false; //tries again next frame, the old swapchain is still in use
+
+		renderManager->retiredSwapchains.emplace_back(retired);
+		renderManager->swapchainNeedsRecreate = false;
+		renderManager->swapchainRecreateCount++;
+
+		//the new images have never been drawn to
+		renderManager->imagesInFlight.assign(std::max(swapchain->framebuffers.size(), (size_t)1), VK_NULL_HANDLE);
+
+		//only a new render pass format needs the pipelines remade || unknown old formats can't be compared, so they count as changed
+		const bool formatChanged = (renderManager->colorFormat == VK_FORMAT_UNDEFINED ||
+			result.colorFormat != renderManager->colorFormat || result.depthFormat != renderManager->depthFormat);
+		RenderManager_SetRenderPassFormats(renderManager, result.colorFormat, result.depthFormat);
+		if (formatChanged)
+		{
+			renderManager->renderPassChangeCount++;
+			for (size_t i = 0; i < renderManager->renderPassChangedCallbacks.size(); ++i)
+				renderManager->renderPassChangedCallbacks[i](swapchain);
+		}
+
+		RenderManager_DestroyFinishedSwapchains(renderManager, GPU);
+		return true;
+	}
+
 	//shutsdown the render manager
 	inline void ShutdownRenderManager(RenderManager* renderManager, SMGraphics_Core_GPU* GPU)
 	{
+		//the retired swapchains have to go before the device does
+		if (!renderManager->retiredSwapchains.empty())
+		{
+			vkDeviceWaitIdle(GPU->device);
+			for (size_t i = 0; i < renderManager->retiredSwapchains.size(); ++i)
+				RetiredSwapchain_Destroy(&renderManager->retiredSwapchains[i], GPU);
+			renderManager->retiredSwapchains.clear();
+		}
+
+		//the default recreate's handles are in the swapchain, they're cleared out of it so the window library doesn't destroy them again
+		DefaultSwapchainRecreate* recreate = renderManager->defaultRecreate.get();
+		if (recreate && recreate->ownsHandles)
+		{
+			vkDeviceWaitIdle(GPU->device);
+
+			SMWindow_Desktop_Swapchain* swapchain = recreate->swapchain;
+			for (size_t i = 0; i < swapchain->framebuffers.size(); ++i)
+				vkDestroyFramebuffer(GPU->device, swapchain->framebuffers[i], nullptr);
+			DefaultSwapchainRecreate_DestroyImages(GPU->device, recreate->info.allocator, recreate->imageViews,
+				recreate->depthImages, recreate->depthAllocations, recreate->depthViews);
+			if (recreate->renderpass != VK_NULL_HANDLE && recreate->renderpass == swapchain->renderpass)
+			{
+				vkDestroyRenderPass(GPU->device, swapchain->renderpass, nullptr);
+				swapchain->renderpass = VK_NULL_HANDLE;
+			}
+			vkDestroySwapchainKHR(GPU->device, swapchain->swapchain, nullptr);
+
+			swapchain->swapchain = VK_NULL_HANDLE;
+			swapchain->framebuffers.clear();
+		}
+		renderManager->defaultRecreate.reset();
+		renderManager->recreateSwapchain = nullptr;
+
 		for (size_t i = 0; i < 2; i++) {
 			vkDestroySemaphore(GPU->device, renderManager->renderFinishedSemaphores[i], nullptr);
 			vkDestroySemaphore(GPU->device, renderManager->imageAvailableSemaphores[i], nullptr);
 			vkDestroyFence(GPU->device, renderManager->inFlightFences[i], nullptr);
 		}
-		renderManager->imagesInFlight[0] = VK_NULL_HANDLE; renderManager->imagesInFlight[1] = VK_NULL_HANDLE; renderManager->imagesInFlight[2] = VK_NULL_HANDLE;
+		renderManager->imagesInFlight.assign(renderManager->imagesInFlight.size(), VK_NULL_HANDLE);
 	}
 
 	//gets the next frame
@@ -79,24 +520,70 @@ namespace Smok::Renderers
 		/*if (!display || !display->isRunning || display->swapchain.swapchain == VK_NULL_HANDLE || display->displayWasCleanedUpEarly)
 			return Frame();*/
 
+		const auto fenceWaitStart = std::chrono::steady_clock::now();
 		vkWaitForFences(GPU->device, 1, &renderManager->inFlightFences[renderManager->currentFrame], VK_TRUE, UINT64_MAX); //waits for fence
+		renderManager->frameStats = FrameStats();
+		renderManager->frameStats.frameNumber = renderManager->submittedFrameCount;
+		renderManager->frameStats.nextFrameFenceWait = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fenceWaitStart).count();
+		if (renderManager->profiler)
+		{
+			//the fence is done, so the profiler can read back this slot's last GPU scopes
+			Profiler_BeginFrame(renderManager->profiler, (uint32)renderManager->currentFrame, fenceWaitStart);
+			Profiler_AddCPUScope(renderManager->profiler, "Wait For Frame Fence", fenceWaitStart, std::chrono::steady_clock::now());
+		}
+		renderManager->completedFrameCount = std::max(renderManager->completedFrameCount,
+			renderManager->inFlightFrameNumbers[renderManager->currentFrame]);
+		RenderManager_DestroyFinishedSwapchains(renderManager, GPU);
+
+		//frees the ring space this slot's uploads held
+		if (Util::StagingRing_IsValid(renderManager->stagingRing))
+			Util::StagingRing_BeginFrame(renderManager->stagingRing, (uint32)renderManager->currentFrame);
+
+		//recreates the swapchain if a resize or the last present asked for it
+		if (renderManager->swapchainNeedsRecreate && renderManager->recreateSwapchain &&
+			!RenderManager_RecreateSwapchain(renderManager, GPU, swapchain))
+			return false;
 
 		//gets next frame
+		ProfilerCPUScope acquireScope(renderManager->profiler, "Acquire Image");
 
 		VkResult result = vkAcquireNextImageKHR(GPU->device, swapchain->swapchain, UINT64_MAX,
 			renderManager->imageAvailableSemaphores[renderManager->currentFrame],  // must be a not signaled semaphore
 			VK_NULL_HANDLE,
 			&frame.imageIndex);
 
-		//if not valid
-		if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
+		//out of date can't be drawn to, so it's recreated and acquired again || the semaphore wasn't signaled, so it can be reused
+		if (result == VK_ERROR_OUT_OF_DATE_KHR)
+		{
+			renderManager->swapchainNeedsRecreate = true;
+			if (!renderManager->recreateSwapchain || !RenderManager_RecreateSwapchain(renderManager, GPU, swapchain))
+				return false;
+
+			result = vkAcquireNextImageKHR(GPU->device, swapchain->swapchain, UINT64_MAX,
+				renderManager->imageAvailableSemaphores[renderManager->currentFrame], VK_NULL_HANDLE, &frame.imageIndex);
+			if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+				return false;
+		}
+
+		//suboptimal still acquired a image, so the frame is drawn and the swapchain recreated before the next one
+		else if (result == VK_SUBOPTIMAL_KHR)
+			renderManager->swapchainNeedsRecreate = true;
+
+		else if (result != VK_SUCCESS)
 			return false;
 
+		if (frame.imageIndex >= renderManager->imagesInFlight.size())
+			renderManager->imagesInFlight.resize(frame.imageIndex + 1, VK_NULL_HANDLE);
+
 		//if is valid
 		frame.isValid = true;
 		frame.framebuffer = swapchain->framebuffers[frame.imageIndex];
-		frame.currentFrame;
+		frame.currentFrame = (uint32)renderManager->currentFrame;
+		frame.frameIndex = frame.currentFrame;
 		frame.frameSize = Smok_Util_Typepun(swapchain->extents, BTD_Math_U32Vec2);
+		frame.stats = &renderManager->frameStats;
+		frame.dispatch = &renderManager->dispatch;
+		Dispatch_BeginFrame(&renderManager->dispatch, renderManager->submittedFrameCount);
 
 		return true;
 	}
@@ -108,12 +595,25 @@ namespace Smok::Renderers
 		if (frame.framebuffer == VK_NULL_HANDLE)
 			return false;
 
-		//images in flight check
+		if (renderManager->profiler)
+			Profiler_BeginCPUScope(renderManager->profiler, "Submit Frame");
+
+		//images in flight check || the only wait, the frame slot's own fence was already waited on in NextFrame
+		const auto waitStart = std::chrono::steady_clock::now();
 		if (renderManager->imagesInFlight[frame.imageIndex] != VK_NULL_HANDLE) {
 			vkWaitForFences(GPU->device, 1, &renderManager->imagesInFlight[frame.imageIndex], VK_TRUE, UINT64_MAX);
 		}
+		const double submitFrameWait = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
 		renderManager->imagesInFlight[frame.imageIndex] = renderManager->inFlightFences[renderManager->currentFrame];
 
+		//every upload of the frame goes in one transfer submission, ahead of the frame on the same queue
+		if (Util::StagingRing_IsValid(renderManager->stagingRing))
+		{
+			Util::StagingRing_Flush(renderManager->stagingRing);
+			renderManager->frameStats.stagedBytes = renderManager->stagingRing->frameStats.stagedBytes;
+			renderManager->frameStats.stagingSubmitCount = renderManager->stagingRing->frameStats.submitCount;
+		}
+
 		//sumbits command buffers
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -137,8 +637,8 @@ namespace Smok::Renderers
 			BTD::Logger::LogError("Smok Renderers", "Render Manager", "SubmitFrame", "Failed to submit draw command buffer!");
 			return false;
 		}
-
-		vkDeviceWaitIdle(GPU->device); //wait for it to be done
+		renderManager->submittedFrameCount++;
+		renderManager->inFlightFrameNumbers[renderManager->currentFrame] = renderManager->submittedFrameCount;
 
 		//submits swapchains
 		VkPresentInfoKHR presentInfo = {};
@@ -152,11 +652,22 @@ namespace Smok::Renderers
 
 		presentInfo.pImageIndices = &frame.imageIndex;
 
-		vkQueuePresentKHR(GPU->presentQueue, &presentInfo);
-		vkDeviceWaitIdle(GPU->device);
+		//the next frame recreates the swapchain, the frame was still submitted so the frame in flight moves on
+		const VkResult presentResult = vkQueuePresentKHR(GPU->presentQueue, &presentInfo);
+		if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR)
+			renderManager->swapchainNeedsRecreate = true;
+
+		renderManager->frameStats.submitFrameWait = submitFrameWait;
+		renderManager->lastFrameStats = renderManager->frameStats;
 
 		renderManager->currentFrame = (renderManager->currentFrame + 1) % renderManager->maxFramesInFlight;
 
+		if (renderManager->profiler)
+		{
+			Profiler_EndCPUScope(renderManager->profiler);
+			Profiler_EndFrame(renderManager->profiler);
+		}
+
 		return true;
 	}
 
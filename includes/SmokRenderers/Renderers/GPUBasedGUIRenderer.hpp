@@ -20,6 +20,8 @@
 
 #include <SmokRenderers/AssetManager.hpp>
 
+#include <cfloat>
+
 namespace Smok::Renderers::GPUBased::GUIRenderer
 {
 	//defines a buffer for the camera buffer
@@ -79,6 +81,8 @@ namespace Smok::Renderers::GPUBased::GUIRenderer
 		//camera descriptor stuff
 		Graphics::Descriptor::DescriptorSetLayout cameraBufferDescriptorSetLayout;
 		Graphics::Descriptor::DescriptorSet cameraBufferDescSet;
+		CameraBuffer cameraData = {}; //the camera data waiting to be staged
+		uint32 dirtyCameraFrames = 0; //a bit for each frame slot whose camera buffer hasn't been staged the latest camera data yet
 
 		//object descriptor stuff
 		Graphics::Descriptor::DescriptorSetLayout objectBufferDescriptorSetLayout;
@@ -279,6 +283,9 @@ namespace Smok::Renderers::GPUBased::GUIRenderer
 
 			//appends the texture to the buffer, and gets it's position for the object to use
 			obj->obj.metadata.y = assetManager->textureBuffer.AddTexture(texture->view, sampler->sampler);
+
+			//GUI is drawn near it's textures' own size, so streamed ones always want every mip
+			assetManager->RequestTextureMips(textureID, FLT_MAX);
 		}
 
 		//calculates the indirect commands and mesh data
@@ -311,7 +318,7 @@ namespace Smok::Renderers::GPUBased::GUIRenderer
 			}
 
 			//generate final mega mesh buffer
-			Mesh::Util::MegaMeshBuffer_CreateBuffer(&assetManager->megaMeshBuffer, allocator, GPU, commandPool);
+			assetManager->CreateMegaMeshBuffer(commandPool);
 		}
 
 		//registers a camera
@@ -319,12 +326,33 @@ namespace Smok::Renderers::GPUBased::GUIRenderer
 		//updates the camera
 		inline void UpdateCamera(const CameraBuffer* camData)
 		{
+			//with a frame source flushing the staging ring, Render stages each frame slot's buffer once that slot is free again, so it goes up with the frame's other uploads
+			if (Util::StagingRing_IsFlushedPerFrame(&assetManager->stagingRing))
+			{
+				cameraData = *camData;
+				dirtyCameraFrames = ~0u;
+				return;
+			}
+
 			//copies data to GPU on all frames of the buffer
 			Smok::Graphics::Descriptor::DescriptorSet_UniformBuffer_UploadDataToGPU_AllBuffers(
 				&cameraBufferDescSet, "CameraBuffer",
 				allocator, GPU, (void*)camData, commandPool);
 		}
 
+		//stages the camera data into a frame slot's camera buffer, if the slot hasn't had it yet
+		inline void UploadCamera(const uint32 frameIndex)
+		{
+			const uint32 frameBit = (1u << frameIndex);
+			if (!(dirtyCameraFrames & frameBit))
+				return;
+
+			const auto& buffers = cameraBufferDescSet.uniformBuffers["CameraBuffer"].buffers;
+			if (frameIndex < buffers.size() && Util::StagingRing_UploadBuffer(&assetManager->stagingRing, buffers[frameIndex].buffer, 0,
+				&cameraData, sizeof(CameraBuffer), VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_UNIFORM_READ_BIT))
+				dirtyCameraFrames &= ~frameBit;
+		}
+
 		//renders
 		inline void Render(VkCommandBuffer& comBuffer, Frame& frame,
 			const std::vector<RenderBatch>& renderBatch,
@@ -336,6 +364,8 @@ namespace Smok::Renderers::GPUBased::GUIRenderer
 			if (!objCount)
 				return;
 
+			UploadCamera(frame.currentFrame);
+
 			//if the object count is larger then it was last frame, we resize the buffer
 			if (objCount > lastFrameObjectCount[frame.frameIndex])
 			{
@@ -374,7 +404,7 @@ namespace Smok::Renderers::GPUBased::GUIRenderer
 			{
 				//bind pipeline
 				Smok::Graphics::Pipeline::GraphicsPipeline_Bind(
-					assetManager->GetGraphicsPipeline(assetManager->GetNameByID(renderBatch[b].pipelineID).c_str()), comBuffer);
+					assetManager->GetGraphicsPipeline(renderBatch[b].pipelineID), comBuffer);
 
 				//sets viewport and scissor
 				Smok::Graphics::Pipeline::GraphicsPipeline_SetViewportAndScissor(
@@ -390,17 +420,16 @@ namespace Smok::Renderers::GPUBased::GUIRenderer
 					sets, 0, nullptr);
 
 				//if there is data to draw
-				if (assetManager->megaMeshBuffer.vertexBuffer.vertexCount > 0)
+				if (assetManager->GetMegaMeshBufferVertexCount() > 0)
 				{
 					//binds buffer
-					Smok::Mesh::Util::MegaMeshBuffer_Bind(&assetManager->megaMeshBuffer, comBuffer);
+					assetManager->BindMegaMeshBuffer(comBuffer);
 
 					//draws
 					for (uint32 i = 0; i < renderBatch[b].commands.size(); ++i)
 					{
-						Smok::Mesh::Util::MegaMeshBuffer_Draw(&assetManager->megaMeshBuffer,
-							comBuffer, renderBatch[b].commands[i].meshIndex,
-							renderBatch[b].commands[i].objIndex, objCount);
+						assetManager->DrawMegaMeshBuffer(comBuffer, renderBatch[b].commands[i].meshIndex,
+							renderBatch[b].commands[i].objIndex);
 					}
 				}
 			}
@@ -6,6 +6,7 @@
 #include <BTDSTD_C/Math/Vectors.h>
 
 #include <SmokRenderers/RenderManager.hpp>
+#include <SmokRenderers/RenderGraph.hpp>
 
 #include <SmokMesh/Mesh.hpp>
 #include <SmokTexture/Texture.hpp>
@@ -19,6 +20,10 @@
 #include <BTDSTD/Math/RenderMath.hpp>
 
 #include <SmokRenderers/AssetManager.hpp>
+#include <SmokRenderers/Culling/ClusterCuller.hpp>
+#include <SmokRenderers/Culling/GPUCuller.hpp>
+#include <SmokRenderers/Culling/OcclusionCuller.hpp>
+#include <SmokRenderers/Util/RenderPass.hpp>
 
 namespace Smok::Renderers::GPUBased::MeshRenderer
 {
@@ -29,6 +34,7 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 		glm::mat4 P[SMOK_RENDERER_CAMERA_BUFFER_ARRAY_LENGTH]; //the projection matrix
 		glm::mat4 V[SMOK_RENDERER_CAMERA_BUFFER_ARRAY_LENGTH]; //the view matrix
 		glm::mat4 PV[SMOK_RENDERER_CAMERA_BUFFER_ARRAY_LENGTH]; //the projection * view matrix
+		glm::vec4 viewport[SMOK_RENDERER_CAMERA_BUFFER_ARRAY_LENGTH]; //x, y, width, height of each view as fractions of the frame || only used by ViewMode::Viewports
 	};
 
 	//defines a object in the object GPU buffer
@@ -39,22 +45,44 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 		/*
 		x = camera index
 		y = texture index
-		z = mesh index
-		w = not used
+		z = mesh index, the mega mesh buffer mesh the entry is drawn with || quantized shaders read it's dequantize with this
+		w = the views the object is visible in as a bit mask, only set with more then one view || see ViewMode
 		*/
 	};
 
+	//defines a mesh in the mesh dequantize buffer, binding 1 of the object set, indexed by a entry's metadata.z
+	//only the quantized vertex format fills it, turning the positions into mesh space before the model matrix, position = offset + position * scale
+	//kept out of ObjectBuffer_Object so the full format's entries stay the same size || normals only use the model matrix
+	struct MeshDequantizeBuffer_Mesh
+	{
+		glm::vec4 scale = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+		glm::vec4 offset = glm::vec4(0.0f);
+	};
+
 	
 
 	//defines a buffer for all the mesh data
 
 	//defines a buffer for all the indirect render commands
 
+	//object indexing: every object buffer entry is one sub mesh of one object, and a draw's first instance is it's entry
+	//so the vertex shader reads it's object in O(1), with no per draw count or push constant
+	//this is the one rule every mesh shader follows, and what a pipeline is made for:
+	//	one view, or ViewMode::Multiview: objects[gl_InstanceIndex] || instanced draws read consecutive entries, multiview draws one instance
+	//	ViewMode::Viewports and ViewMode::Layered: objects[gl_BaseInstance], the view is gl_InstanceIndex - gl_BaseInstance
+	//		gl_BaseInstance needs the shaderDrawParameters feature, SetViewMode fails without it
+	//a pipeline for the Viewports or Layered modes can't draw a single view with instancing, so switching between them and one view needs both pipelines
+	//the GPU culler's indirect commands use the same first instance
+
 	//defines a indirect render command
 	struct RenderCommand
 	{
 		uint64 meshIndex = 0, //the mesh index
-			objIndex = 0; //the object index
+			objIndex = 0; //the object buffer entry of the first instance, drawn as the first instance
+
+		uint32 instanceCount = 1; //each instance reads the next object buffer entry || only above 1 with a single view
+		uint32 firstIndex = 0, indexCount = 0; //the range of the mesh's indices to draw || a index count of 0 draws the whole mesh
+		uint32 viewMask = 1; //the views the object is visible in
 	};
 
 	//defines a render batch
@@ -64,20 +92,61 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 
 		std::vector<ObjectBuffer_Object> objs; //the objects
 		std::vector<RenderCommand> commands; //the render commands
+
+		uint32 commandBase = 0, maxDrawCount = 0; //the range of command slots the GPU culler writes for this batch
 	};
 
 	//defines a sorted object data for a batch
 	struct ObjectBatch_Object
 	{
 		uint64 pipelineID = 0; //the graphics pipeline to use
+		uint64 staticMeshID = 0; //the static mesh, used by the GPU culler to find all it's LODs
 		
 		std::vector<uint32> megaMeshBufferIndexs; //the indexes into the mega mesh buffer to use
+		uint32 lodIndex = 0; //the LOD the mega mesh buffer indexes came from
+		uint32 triangleCount = 0, fullDetailTriangleCount = 0; //the triangles drawn at the picked LOD and at full detail
 		
 		//the textures
 
 		ObjectBuffer_Object obj; //the object data
 	};
 
+	//defines how several views are drawn in one pass
+	//with more then one view the first instance is always the object's entry, how shaders read it in each mode is under object indexing above
+	//every mode draws a object once, the shader clips the vertices of views not in the object's metadata.w mask
+	enum class ViewMode
+	{
+		Viewports = 0, //split screen, a instance per view up to the last that sees the object, with the view from gl_InstanceIndex - gl_BaseInstance
+			//the shader moves the view's clip space into it's camera buffer viewport and clips to it's edges, since the pipelines only have one viewport
+		Multiview, //VK_KHR_multiview, one draw covers every view with the view from gl_ViewIndex || the render pass's view mask can't change per draw
+		Layered, //when multiview isn't there, a instance per view up to the last that sees the object, the shader writes gl_Layer from gl_InstanceIndex - gl_BaseInstance
+
+		Count
+	};
+
+	//defines a view || it's camera is the camera buffer entry at the same index
+	struct RenderView
+	{
+		glm::vec4 viewport = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); //x, y, width, height as fractions of the frame || only used by ViewMode::Viewports
+	};
+
+	//defines the multi view stats of a frame
+	struct MultiViewStats
+	{
+		uint32 viewCount = 1; //the views drawn
+		uint32 uploadedObjectCount = 0; //the objects uploaded once and shared by every view
+		std::vector<uint32> objectsPerView; //the objects visible in each view
+	};
+
+	//defines the LOD stats of a frame
+	struct LODStats
+	{
+		uint32 objectCount = 0; //the objects drawn
+		uint64 triangleCount = 0; //the triangles drawn at the picked LODs
+		uint64 fullDetailTriangleCount = 0; //the triangles that would of been drawn without LODs
+		std::vector<uint32> objectsPerLOD; //the number of objects drawn at each LOD
+	};
+
 	//defines a GPU Based Mesh Renderer
 	class GPUMeshRenderer
 	{
@@ -95,11 +164,56 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 		Graphics::Descriptor::DescriptorSetLayout objectBufferDescriptorSetLayout;
 		Graphics::Descriptor::DescriptorSet objectBufferDescSet;
 		std::vector<uint32> lastFrameObjectCount; //stores the last frame of object size, so we can resize it
+		std::vector<uint32> lastFrameDequantizeCount; //the meshes each frame's mesh dequantize buffer holds, meshes are only ever added
+		std::vector<MeshDequantizeBuffer_Mesh> meshDequantizes; //scratch for the mesh dequantize buffer
 
 		//texture descriptor stuff
 		Graphics::Descriptor::DescriptorSetLayout textureDescriptorSetLayout;
 		Graphics::Descriptor::DescriptorSet textureDescSet;
 
+		CameraBuffer cameraData = {}; //the last camera data uploaded, used for picking LODs
+		uint32 dirtyCameraFrames = 0; //a bit for each frame slot whose camera buffer hasn't been staged the latest camera data yet
+		LODStats lodStats; //the LOD stats of the last calculated frame
+
+		bool clusterCulling = true; //culls the meshlets of meshes that have them
+		Culling::ClusterCullStats clusterCullStats; //the meshlet culling stats of the last calculated frame
+		std::vector<Culling::IndexRange> visibleRanges; //scratch for the visible meshlet ranges
+
+		bool GPUDrivenCulling = false; //culls and picks LODs in a compute pass, drawing with indirect commands
+		Culling::GPUCuller GPUCuller;
+		std::vector<Culling::GPUCull_Candidate> cullCandidates; //the candidates of the last calculated frame
+		std::vector<Culling::GPUCull_MeshDraw> cullMeshDraws; //every LOD of every sub mesh the GPU culler has seen
+		std::unordered_map<uint64, uint32> cullMeshDrawLookup; //static mesh ID -> it's first mesh draw || each sub mesh has one per LOD
+		float lodBias = 1.0f; //multiplies the screen size before the GPU culler picks LODs
+
+		bool occlusionCulling = false; //culls objects hidden behind others, using a depth pyramid
+		bool GPUOcclusion = false; //the GPU culler tests against a pyramid built from the depth attachment, otherwise the software rasterizer draws it
+		bool occlusionPhaseTwoPending = false; //the GPU culler's phase one was recorded this frame, so the rejected draws still need phase two
+		VkRenderPass occlusionPhaseTwoRenderPass = VK_NULL_HANDLE; //loads what phase one drew, for the render graph's recovered draws
+		VkFormat occlusionPhaseTwoFormats[2] = { VK_FORMAT_UNDEFINED, VK_FORMAT_UNDEFINED }; //the color and depth format it was made for
+		VkImageLayout occlusionPhaseTwoColorLayout = VK_IMAGE_LAYOUT_UNDEFINED; //the color final layout it was made for
+		Culling::OcclusionSettings occlusionSettings;
+		Culling::OcclusionCullStats occlusionCullStats; //the occlusion stats of the last calculated frame
+		Culling::GPUDepthPyramid occlusionGPUPyramid;
+		Culling::DepthBuffer occlusionDepth; //the occluders of the last calculated frame, only drawn by the software rasterizer
+		Culling::DepthPyramid occlusionPyramid; //the last pyramid built from occlusionDepth, tested against by the next frame
+		std::vector<glm::vec4> occlusionWorldSpheres; //scratch for the world bounds of each object
+		std::vector<uint32> occlusionRejected; //scratch for the objects rejected in phase one
+		std::vector<uint32> drawObjectIndexes; //the objects left to draw after occlusion culling
+		std::vector<uint32> objectBufferSources; //the object each object buffer entry was made from, for ValidateObjectIndices
+
+		ViewMode viewMode = ViewMode::Viewports; //how the views are drawn when there is more then one
+		VkRenderPass viewRenderPass = VK_NULL_HANDLE; //the render pass pipelines are made against for the multiview and layered modes
+		VkRenderPass pipelineRenderPass = VK_NULL_HANDLE; //the render pass the cached pipelines were last remade against
+		std::vector<RenderView> views; //the registered views || empty draws just camera 0
+		Culling::Frustum viewFrustums[SMOK_RENDERER_CAMERA_BUFFER_ARRAY_LENGTH]; //the world space frustum of each view
+		MultiViewStats multiViewStats; //the multi view stats of the last calculated frame
+
+		Profiler* profiler = nullptr; //optional, times calculating, culling and rendering
+		FrameStats* frameStats = nullptr; //the stats of the frame being rendered, can be null
+		Dispatch* dispatch = nullptr; //where the frame being rendered sends it's commands, null goes straight to Vulkan
+		uint32 seenMegaMeshBufferRebuildCount = 0; //the asset manager's rebuild count the last frame saw
+
 		SMGraphics_Core_GPU* GPU;
 		SMWindow_Desktop_Swapchain* swapchain;
 		VmaAllocator allocator;
@@ -128,7 +242,7 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 			Smok::Graphics::Descriptor::DescriptorSetPoolCreateInfo descriptorPoolCreateInfo;
 			descriptorPoolCreateInfo.maxSetCount = swapchain->framesInFlight * 3;
 			descriptorPoolCreateInfo.uniformBufferPoolCount = swapchain->framesInFlight;
-			descriptorPoolCreateInfo.uniformStorageBufferPoolCount = swapchain->framesInFlight;
+			descriptorPoolCreateInfo.uniformStorageBufferPoolCount = swapchain->framesInFlight * 2;
 			descriptorPoolCreateInfo.uniformSampler2DArrayPoolCount = swapchain->framesInFlight;
 
 			Smok::Graphics::Descriptor::DescriptorPool_Create(&descriptorPool, descriptorPoolCreateInfo, GPU);
@@ -159,9 +273,17 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 			UniformStorgaeBuffer_ObjectBuffer.shaderAccessStages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 			UniformStorgaeBuffer_ObjectBuffer.structMemSize = sizeof(ObjectBatch_Object);
 
+			//the quantized format's per mesh dequantize, only read by quantized shaders
+			Smok::Graphics::Util::Uniform::UniformStorageBuffer UniformStorgaeBuffer_MeshDequantizeBuffer;
+			UniformStorgaeBuffer_MeshDequantizeBuffer.name = "MeshDequantizeBuffer";
+			UniformStorgaeBuffer_MeshDequantizeBuffer.binding = 1;
+			UniformStorgaeBuffer_MeshDequantizeBuffer.shaderAccessStages = VK_SHADER_STAGE_VERTEX_BIT;
+			UniformStorgaeBuffer_MeshDequantizeBuffer.structMemSize = sizeof(MeshDequantizeBuffer_Mesh);
+
 			//defines a descriptor set layout
 			descriptorSetLayoutCreateInfo.uniforms.Clear();
 			descriptorSetLayoutCreateInfo.uniforms.uniformStorageBuffers.emplace_back(UniformStorgaeBuffer_ObjectBuffer);
+			descriptorSetLayoutCreateInfo.uniforms.uniformStorageBuffers.emplace_back(UniformStorgaeBuffer_MeshDequantizeBuffer);
 
 			Smok::Graphics::Descriptor::DescriptorSetLayout_Create(&objectBufferDescriptorSetLayout, descriptorSetLayoutCreateInfo, GPU);
 
@@ -170,6 +292,7 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 				allocator, GPU, swapchain->framesInFlight);
 
 			lastFrameObjectCount.resize(swapchain->framesInFlight, 0);
+			lastFrameDequantizeCount.resize(swapchain->framesInFlight, 0);
 
 			//--------------TEXTURE BUFFER DESC----------------//
 			descriptorSetLayoutCreateInfo.uniforms.Clear();
@@ -203,12 +326,37 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 			return true;
 		}
 
+		//inits only the CPU side of the renderer, for benchmarks and tools that call AddObject and CalculateCommandData without a device
+		//every asset the objects use must already be created, since nothing here can make GPU resources
+		//Render can only be called with a null backend dispatch in the frame, and Shutdown isn't needed
+		inline void InitCPUOnly(SMWindow_Desktop_Swapchain* _swapchain, AssetManager* _assetManager)
+		{
+			GPU = nullptr; allocator = VK_NULL_HANDLE; swapchain = _swapchain;
+			commandPool = nullptr;
+
+			assetManager = _assetManager;
+			graphicsPipelineLayout.pipelineLayout = VK_NULL_HANDLE;
+
+			//null sets, so recorded binds still have something to bind
+			cameraBufferDescSet.descriptorSets.assign(swapchain->framesInFlight, VK_NULL_HANDLE);
+			objectBufferDescSet.descriptorSets.assign(swapchain->framesInFlight, VK_NULL_HANDLE);
+			textureDescSet.descriptorSets.assign(swapchain->framesInFlight, VK_NULL_HANDLE);
+
+			lastFrameObjectCount.resize(swapchain->framesInFlight, 0);
+			lastFrameDequantizeCount.resize(swapchain->framesInFlight, 0);
+		}
+
 		//shutsdown the renderer
 		inline void Shutdown()
 		{
 			//wait for the GPU to finish
 			vkDeviceWaitIdle(GPU->device);
 
+			Culling::GPUCuller_Destroy(&GPUCuller);
+			Culling::GPUDepthPyramid_Destroy(&occlusionGPUPyramid);
+			if (occlusionPhaseTwoRenderPass != VK_NULL_HANDLE)
+				vkDestroyRenderPass(GPU->device, occlusionPhaseTwoRenderPass, nullptr);
+
 			Smok::Graphics::Pipeline::GraphicsPipelineLayout_Destroy(&graphicsPipelineLayout);
 
 			Smok::Graphics::Descriptor::DescriptorSet_Destroy(&textureDescSet, &descriptorPool, allocator, GPU);
@@ -226,6 +374,219 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 		//gets the texture descriptor set
 		inline Graphics::Descriptor::DescriptorSet* GetTextureDescriptorSet() { return &textureDescSet; }
 
+		//gets the LOD stats of the last calculated frame
+		inline const LODStats& GetLODStats() const { return lodStats; }
+
+		//gets the meshlet culling stats of the last calculated frame
+		inline const Culling::ClusterCullStats& GetClusterCullStats() const { return clusterCullStats; }
+
+		//sets if meshlets are culled || when off, meshes with meshlets are drawn whole
+		inline void SetClusterCulling(const bool enabled) { clusterCulling = enabled; }
+
+		//sets the profiler the renderer's CPU and GPU scopes go to || nullptr turns profiling off
+		inline void SetProfiler(Profiler* _profiler) { profiler = _profiler; }
+
+		//turns on GPU driven culling || the shader is shaders/GPUCull.comp compiled to SPIR-V
+		//useDrawIndirectCount needs drawIndirectCount support, without it every candidate is drawn with culled ones having 0 instances
+		//readBack keeps the GPU's commands host readable for VerifyGPUCulling || remaking the culler turns GPU occlusion culling off
+		inline bool EnableGPUDrivenCulling(const std::string& SPIRVPath, const bool useDrawIndirectCount, const bool readBack = false)
+		{
+			//quantized meshes need the dequantize of the LOD drawn, the GPU culler picks the LOD after the object's entry is written
+			if (assetManager->vertexFormat == MeshVertexFormat::Quantized)
+			{
+				BTD_LogError("Smok Renderer", "GPU Mesh Renderer", "EnableGPUDrivenCulling",
+					"GPU driven culling needs the full vertex format, the quantized format is not supported!");
+				return false;
+			}
+
+			if (GPUOcclusion)
+				SetOcclusionCulling(false);
+
+			Culling::GPUCuller_Destroy(&GPUCuller);
+			GPUDrivenCulling = Culling::GPUCuller_Init(&GPUCuller, GPU, allocator, SPIRVPath, swapchain->framesInFlight,
+				useDrawIndirectCount, readBack);
+			if (!GPUDrivenCulling)
+				Culling::GPUCuller_Destroy(&GPUCuller);
+
+			cullMeshDraws.clear(); cullMeshDrawLookup.clear();
+			return GPUDrivenCulling;
+		}
+
+		//turns on two phase occlusion culling in the GPU culler, against a depth pyramid the GPU builds from the depth attachment
+		//needs GPU driven culling || SPIRVPath is shaders/DepthPyramid.comp and cullSPIRVPath shaders/GPUCull.comp with OCCLUSION_CULLING, compiled to SPIR-V
+		//a frame is RecordGPUCulling, Render, RecordDepthPyramid, RecordGPUCullingPhaseTwo then RenderOcclusionPhaseTwo, or AddRenderGraphPasses
+		inline bool EnableGPUOcclusionCulling(const std::string& SPIRVPath, const std::string& cullSPIRVPath,
+			const Culling::OcclusionSettings& settings = Culling::OcclusionSettings())
+		{
+			//the rejected objects are re-tested and drawn by the GPU culler, so there's nothing to test them without it
+			if (!GPUDrivenCulling)
+			{
+				BTD_LogError("Smok Renderer", "GPU Mesh Renderer", "EnableGPUOcclusionCulling",
+					"GPU occlusion culling needs GPU driven culling, call EnableGPUDrivenCulling first!");
+				return false;
+			}
+
+			SetOcclusionCulling(false);
+			GPUOcclusion = Culling::GPUDepthPyramid_Init(&occlusionGPUPyramid, GPU, allocator, SPIRVPath, swapchain->framesInFlight,
+				settings.depthWidth, settings.depthHeight) && Culling::GPUCuller_InitOcclusion(&GPUCuller, cullSPIRVPath);
+			if (!GPUOcclusion)
+			{
+				Culling::GPUCuller_DestroyOcclusion(&GPUCuller);
+				Culling::GPUDepthPyramid_Destroy(&occlusionGPUPyramid);
+			}
+
+			occlusionCulling = GPUOcclusion; occlusionSettings = settings;
+			return GPUOcclusion;
+		}
+
+		//sets if objects are occlusion culled against occluders drawn by the CPU software rasterizer, the headless reference of EnableGPUOcclusionCulling
+		//meshes need their CPU data kept to be drawn as occluders
+		inline void SetOcclusionCulling(const bool enabled, const Culling::OcclusionSettings& settings = Culling::OcclusionSettings())
+		{
+			if (GPUOcclusion)
+			{
+				vkDeviceWaitIdle(GPU->device);
+				Culling::GPUCuller_DestroyOcclusion(&GPUCuller);
+				Culling::GPUDepthPyramid_Destroy(&occlusionGPUPyramid);
+				GPUOcclusion = false;
+			}
+
+			occlusionCulling = enabled; occlusionSettings = settings;
+			occlusionPhaseTwoPending = false;
+			occlusionPyramid.levels.clear();
+		}
+
+		//records building this frame's depth pyramid on the GPU from what Render drew, RecordGPUCullingPhaseTwo and the next frame's cull test against it
+		//must be recorded outside of a render pass once the depth is written || the depth must be sampleable and in depthLayout
+		inline void RecordDepthPyramid(VkCommandBuffer comBuffer, const Frame& frame, VkImageView depthView,
+			const uint32 depthWidth, const uint32 depthHeight, const VkImageLayout depthLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+		{
+			if (!occlusionCulling || !GPUOcclusion || GetViewCount() > 1)
+				return;
+
+			ProfilerCPUScope cpuScope(profiler, "Mesh Record Depth Pyramid");
+			ProfilerGPUScope gpuScope(profiler, comBuffer, "Mesh Depth Pyramid");
+			Culling::GPUDepthPyramid_RecordBuild(&occlusionGPUPyramid, comBuffer, frame.currentFrame, depthView, depthWidth, depthHeight,
+				depthLayout, frame.dispatch);
+			if (frame.stats)
+				frame.stats->dispatchCount += (uint32)occlusionGPUPyramid.levels.size();
+		}
+
+		//sets how several views are drawn || the multiview and layered modes need the render pass the pipelines will draw in
+		//fails if the device lacks what the mode's shaders need, multiview or shaderDrawParameters
+		inline bool SetViewMode(const ViewMode mode, VkRenderPass renderPass = VK_NULL_HANDLE)
+		{
+			//the device has to support what the mode's shaders use, see object indexing || without a device there's nothing to check
+			if (GPU)
+			{
+				const char* missing = nullptr;
+				if (mode == ViewMode::Multiview && !Util::Multiview_IsSupported(GPU->physicalDevice))
+					missing = "multiview";
+				else if ((mode == ViewMode::Viewports || mode == ViewMode::Layered) && !Util::ShaderDrawParameters_IsSupported(GPU->physicalDevice))
+					missing = "shaderDrawParameters, which gl_BaseInstance needs,";
+
+				if (missing)
+				{
+					BTD_LogError("Smok Renderer", "GPU Mesh Renderer", "SetViewMode",
+						std::string("The device doesn't support " + std::string(missing) + " the view mode is left unchanged!").c_str());
+					return false;
+				}
+			}
+
+			viewMode = mode; viewRenderPass = renderPass;
+			UpdatePipelineRenderPass();
+			return true;
+		}
+
+		//gets the render pass pipelines are made against, the view render pass when drawing several views into one
+		inline VkRenderPass GetPipelineRenderPass() const
+		{
+			return (viewRenderPass != VK_NULL_HANDLE && views.size() > 1 ? viewRenderPass : swapchain->renderpass);
+		}
+
+		//remakes the cached pipelines against the render pass they should draw in || use it in a RenderPassChangedCallback,
+		//so pipelines drawing into the view render pass aren't moved back to the swapchain's
+		inline void RemakePipelines()
+		{
+			pipelineRenderPass = GetPipelineRenderPass();
+			if (GPU)
+				assetManager->RemakeGraphicsPipelines(pipelineRenderPass);
+		}
+
+		//registers a view, returning it's index or -1 if they're all used || the view's camera is written into the camera buffer at that index
+		inline int32 RegisterView(const glm::mat4& P, const glm::mat4& V, const glm::vec4& viewport = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f))
+		{
+			if (views.size() >= SMOK_RENDERER_CAMERA_BUFFER_ARRAY_LENGTH)
+			{
+				BTD_LogError("Smok Renderer", "GPU Mesh Renderer", "RegisterView",
+					std::string("Can't register more then " + std::to_string(SMOK_RENDERER_CAMERA_BUFFER_ARRAY_LENGTH) + " views!").c_str());
+				return -1;
+			}
+
+			const uint32 index = (uint32)views.size();
+			views.emplace_back(RenderView()).viewport = viewport;
+			cameraData.viewport[index] = viewport;
+			SetViewCamera(index, P, V);
+			UpdatePipelineRenderPass();
+			return (int32)index;
+		}
+
+		//updates the camera of a view || call UpdateViews to upload it
+		inline void SetViewCamera(const uint32 index, const glm::mat4& P, const glm::mat4& V)
+		{
+			cameraData.P[index] = P; cameraData.V[index] = V;
+			cameraData.PV[index] = P * V;
+		}
+
+		//uploads the cameras of every view
+		inline void UpdateViews() { UpdateCamera(&cameraData); }
+
+		//removes all views, going back to drawing just camera 0
+		inline void ClearViews()
+		{
+			views.clear();
+			UpdatePipelineRenderPass();
+		}
+
+		//gets the number of views drawn
+		inline uint32 GetViewCount() const { return (views.size() > 1 ? (uint32)views.size() : 1); }
+
+		//gets the multi view stats of the last calculated frame
+		inline const MultiViewStats& GetMultiViewStats() const { return multiViewStats; }
+
+		//gets the occlusion culling stats of the last calculated frame
+		inline const Culling::OcclusionCullStats& GetOcclusionCullStats() const { return occlusionCullStats; }
+
+		//gets the occluder depth of the last calculated frame, only drawn by the software rasterizer
+		inline const Culling::DepthBuffer& GetOcclusionDepth() const { return occlusionDepth; }
+
+		//gets the pyramid the next frame is tested against
+		inline const Culling::DepthPyramid& GetOcclusionPyramid() const { return occlusionPyramid; }
+
+		//sets the LOD bias of the GPU culler || above 1 keeps detail longer
+		inline void SetLODBias(const float bias) { lodBias = bias; }
+
+		//picks the LOD of a static mesh based on how much of the screen it covers from the camera
+		inline uint32 SelectLOD(const StaticMesh* staticMesh, const glm::mat4& model, const uint32 cameraIndex = 0)
+		{
+			if (staticMesh->lods.size() < 2)
+				return 0;
+
+			const glm::vec4 worldSphere = Geometry::BoundingSphere_Transform(staticMesh->bounds.sphere, model);
+			const float screenSize = Geometry::BoundingSphere_CalculateScreenSize(worldSphere,
+				cameraData.V[cameraIndex], cameraData.P[cameraIndex]);
+
+			//the coarsest LOD the mesh is small enough for
+			uint32 lod = 0;
+			for (uint32 l = 1; l < staticMesh->lods.size(); ++l)
+			{
+				if (screenSize < staticMesh->lods[l].screenSize)
+					lod = l;
+			}
+
+			return lod;
+		}
+
 		//purges all objects in the object buffer
 		inline void PurgeAllObjects(const uint32& frameIndex)
 		{
@@ -263,8 +624,9 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 				return;
 
 			Smok::Graphics::Pipeline::GraphicsShader* shader = assetManager->CreateGraphicsShader(graphicsShaderID);
+			VkRenderPass renderPass = GetPipelineRenderPass();
 			Smok::Graphics::Pipeline::GraphicsPipeline* pipeline = assetManager->CreateGraphicsPipeline(graphicsPipelineID,
-				graphicsPipelineLayout.pipelineLayout, swapchain->renderpass);
+				graphicsPipelineLayout.pipelineLayout, renderPass);
 			Smok::Texture::Texture* texture = assetManager->CreateTexture(textureID, commandPool);
 			Smok::Graphics::Util::Image::Sampler2D* sampler = assetManager->CreateSampler2D(samplerID);
 
@@ -273,54 +635,745 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 
 			//sets the pipeline to use
 			obj->pipelineID = pipeline->assetID;
+			obj->staticMeshID = staticMeshID;
+
+			//model matrix
+			obj->obj.model = transform->CalculateModelMatrix_Force();
+
+			//picks the LOD from how big the object is on screen
+			obj->lodIndex = SelectLOD(staticMesh, obj->obj.model);
 
 			//matches the sought after mesh indices and the indexes into the mega mesh buffer
 
 			//if no mesh indexes were specificed, we get them all
-			obj->megaMeshBufferIndexs = staticMesh->megaMeshBufferIndexes;
+			if (staticMesh->lods.empty())
+				obj->megaMeshBufferIndexs = staticMesh->megaMeshBufferIndexes;
+			else
+			{
+				obj->megaMeshBufferIndexs = staticMesh->lods[obj->lodIndex].megaMeshBufferIndexes;
+				obj->triangleCount = staticMesh->lods[obj->lodIndex].triangleCount;
+				obj->fullDetailTriangleCount = staticMesh->lods[0].triangleCount;
+			}
 
 			//if they were specificed, we get only the specific ones
 
-			//model matrix
-			obj->obj.model = transform->CalculateModelMatrix_Force();
-
-			obj->obj.metadata.x = 0; //camera index
+			obj->obj.metadata.x = 0; //camera index || with several views the view comes from the instance instead
 
 			//appends the texture to the buffer, and gets it's position for the object to use
 			obj->obj.metadata.y = assetManager->textureBuffer.AddTexture(texture->view, sampler->sampler);
+
+			//asks for the texture mips the object's size on screen needs, when textures are streamed
+			if (assetManager->textureStreaming)
+			{
+				const glm::vec4 worldSphere = Geometry::BoundingSphere_Transform(staticMesh->bounds.sphere, obj->obj.model);
+				const float screenSize = Geometry::BoundingSphere_CalculateScreenSize(worldSphere, cameraData.V[0], cameraData.P[0]);
+				assetManager->RequestTextureMips(textureID, screenSize * (float)swapchain->extents.height);
+			}
 		}
 
 		//calculates the indirect commands and mesh data
 		inline void CalculateCommandData(const std::vector<ObjectBatch_Object>& objects,
 			std::vector<RenderBatch>& renderBatch, std::vector<ObjectBuffer_Object>& objectBufferObjects)
 		{
+			ProfilerCPUScope cpuScope(profiler, "Mesh Calculate Command Data");
+
 			renderBatch.clear(); renderBatch.reserve(2);
 			objectBufferObjects.clear(); objectBufferObjects.reserve(256);
 			
 			//goes through the objects
 			RenderBatch* batch = &renderBatch.emplace_back(RenderBatch());
 			batch->pipelineID = objects[0].pipelineID;
-			uint32 objIndex = 0;
+			objectBufferSources.clear();
+
+			lodStats.triangleCount = 0; lodStats.fullDetailTriangleCount = 0;
+			lodStats.objectsPerLOD.assign(assetManager->meshLODSettings.lodCount, 0);
+			clusterCullStats.Reset();
+
+			//removes the objects hidden behind others
+			CalculateDrawObjects(objects);
+			lodStats.objectCount = 0;
+
+			//the GPU culls and picks LODs itself
+			if (GPUDrivenCulling)
+			{
+				lodStats.objectCount = (uint32)drawObjectIndexes.size();
+				CalculateGPUCullCandidates(objects, *batch, objectBufferObjects);
+				assetManager->CreateMegaMeshBuffer(commandPool);
+				return;
+			}
+
+			//the camera in world space, for the meshlet backface cones
+			const glm::mat4 invView = glm::inverse(cameraData.V[0]);
+			const glm::vec4 cameraWorldPosition = invView[3];
+
+			//the frustum of each view, objects are only drawn in the views that see them
+			const uint32 viewCount = GetViewCount();
+			multiViewStats.viewCount = viewCount;
+			multiViewStats.objectsPerView.assign(viewCount, 0);
+			for (uint32 v = 0; v < viewCount && viewCount > 1; ++v)
+				viewFrustums[v] = Culling::Frustum_Extract(cameraData.PV[v]);
 
 			//makes a new batch
 
-			for (uint32 i = 0; i < objects.size(); ++i)
+			for (uint32 d = 0; d < drawObjectIndexes.size(); ++d)
 			{
+				const uint32 i = drawObjectIndexes[d];
+
+				const uint32 viewMask = CalculateViewMask(objects[i]);
+				if (!viewMask)
+					continue;
+
+				//the LOD stats only count what is emitted, so meshlets culled away come off the object's triangles
+				bool emitted = false;
+				uint64 culledTriangleCount = 0;
+
 				for (uint32 m = 0; m < objects[i].megaMeshBufferIndexs.size(); ++m)
 				{
-					//add object
-					objectBufferObjects.emplace_back(objects[i].obj);
-
-					//add command
-					RenderCommand* command = &batch->commands.emplace_back(RenderCommand());
-					command->meshIndex = objects[i].megaMeshBufferIndexs[m];
-					command->objIndex = i;
-					objIndex++;
+					const uint32 meshIndex = objects[i].megaMeshBufferIndexs[m];
+
+					//culls the meshlets of large meshes, if none are visible the mesh is skipped
+					//meshlets are culled against camera 0, so they're only used with a single view
+					const bool hasMeshlets = clusterCulling && viewCount == 1 && meshIndex < assetManager->megaMeshBufferMeshes.size() &&
+						!assetManager->megaMeshBufferMeshes[meshIndex].meshlets.empty();
+					if (hasMeshlets)
+					{
+						const glm::mat4& model = objects[i].obj.model;
+						const Culling::Frustum frustum = Culling::Frustum_Extract(cameraData.PV[0] * model);
+						const glm::vec4 cameraMeshPosition = glm::inverse(model) * cameraWorldPosition;
+
+						visibleRanges.clear();
+						const uint64 visibleBefore = clusterCullStats.trianglesVisible;
+						Culling::ClusterCuller_CullMeshlets(assetManager->megaMeshBufferMeshes[meshIndex].meshlets, frustum,
+							glm::vec3(cameraMeshPosition.x, cameraMeshPosition.y, cameraMeshPosition.z),
+							Culling::ClusterCuller_IsUniformScale(model), visibleRanges, clusterCullStats);
+						culledTriangleCount += assetManager->megaMeshBufferMeshes[meshIndex].subMesh.indexCount / 3 -
+							(clusterCullStats.trianglesVisible - visibleBefore);
+
+						if (visibleRanges.empty())
+							continue;
+					}
+					emitted = true;
+
+					//add object, the entry is the first instance of it's draws
+					const uint32 entry = (uint32)objectBufferObjects.size();
+					ObjectBuffer_Object* obj = &objectBufferObjects.emplace_back(objects[i].obj);
+					objectBufferSources.emplace_back(i);
+					if (viewCount > 1)
+						obj->metadata.w = (float)viewMask;
+
+					//quantized positions are relative to the mesh bounds, the shader dequantizes them with the mesh's entry in the mesh dequantize buffer
+					obj->metadata.z = (float)meshIndex;
+
+					//add command, or another instance of the last one when it draws the same mesh from the entry before
+					if (!hasMeshlets)
+					{
+						RenderCommand* last = (batch->commands.empty() ? nullptr : &batch->commands.back());
+						if (viewCount == 1 && last && last->meshIndex == meshIndex && last->indexCount == 0 &&
+							last->objIndex + last->instanceCount == entry)
+						{
+							last->instanceCount++;
+							continue;
+						}
+
+						RenderCommand* command = &batch->commands.emplace_back(RenderCommand());
+						command->meshIndex = meshIndex;
+						command->objIndex = entry;
+						command->viewMask = viewMask;
+					}
+
+					//add a command per visible range of meshlets
+					else
+					{
+						for (size_t r = 0; r < visibleRanges.size(); ++r)
+						{
+							RenderCommand* command = &batch->commands.emplace_back(RenderCommand());
+							command->meshIndex = meshIndex;
+							command->objIndex = entry;
+							command->firstIndex = visibleRanges[r].firstIndex;
+							command->indexCount = visibleRanges[r].indexCount;
+							command->viewMask = viewMask;
+						}
+					}
 				}
+
+				if (!emitted)
+					continue;
+
+				lodStats.objectCount++;
+				lodStats.triangleCount += (objects[i].triangleCount > culledTriangleCount ? objects[i].triangleCount - culledTriangleCount : 0);
+				lodStats.fullDetailTriangleCount += objects[i].fullDetailTriangleCount;
+				if (objects[i].lodIndex < lodStats.objectsPerLOD.size())
+					lodStats.objectsPerLOD[objects[i].lodIndex]++;
 			}
 
+			multiViewStats.uploadedObjectCount = (uint32)objectBufferObjects.size();
+
 			//generate final mega mesh buffer
-			Mesh::Util::MegaMeshBuffer_CreateBuffer(&assetManager->megaMeshBuffer, allocator, GPU, commandPool);
+			assetManager->CreateMegaMeshBuffer(commandPool);
+		}
+
+		//checks the object indexing of the last CalculateCommandData on the CPU, without a device
+		//every draw's first instance must be a object buffer entry made from a object that has the drawn mesh, and every entry must be drawn
+		inline bool ValidateObjectIndices(const std::vector<ObjectBatch_Object>& objects,
+			const std::vector<RenderBatch>& renderBatch, const std::vector<ObjectBuffer_Object>& objectBufferObjects, std::string* error = nullptr)
+		{
+			const auto fail = [error](const std::string& message) { if (error) *error = message; return false; };
+
+			if (objectBufferSources.size() != objectBufferObjects.size())
+				return fail("the object buffer has " + std::to_string(objectBufferObjects.size()) + " entries but " +
+					std::to_string(objectBufferSources.size()) + " sources");
+
+			const uint32 viewCount = GetViewCount();
+
+			//the GPU culler's candidates share a entry per object
+			std::vector<uint8> referenced(objectBufferObjects.size(), 0);
+			if (GPUDrivenCulling)
+			{
+				for (size_t c = 0; c < cullCandidates.size(); ++c)
+				{
+					if (cullCandidates[c].objectIndex >= objectBufferObjects.size())
+						return fail("cull candidate " + std::to_string(c) + " reads entry " + std::to_string(cullCandidates[c].objectIndex) + " out of range");
+					referenced[cullCandidates[c].objectIndex] = 1;
+				}
+			}
+
+			//each entry belongs to one mesh of it's object
+			std::vector<uint64> entryMeshes(objectBufferObjects.size(), UINT64_MAX);
+			for (size_t b = 0; b < renderBatch.size() && !GPUDrivenCulling; ++b)
+			{
+				for (size_t i = 0; i < renderBatch[b].commands.size(); ++i)
+				{
+					const RenderCommand& command = renderBatch[b].commands[i];
+					for (uint32 instance = 0; instance < command.instanceCount; ++instance)
+					{
+						const uint64 entry = command.objIndex + instance;
+						if (entry >= objectBufferObjects.size())
+							return fail("command " + std::to_string(i) + " reads entry " + std::to_string(entry) + " out of range");
+
+						const ObjectBatch_Object& source = objects[objectBufferSources[entry]];
+						if (std::find(source.megaMeshBufferIndexs.begin(), source.megaMeshBufferIndexs.end(), command.meshIndex) == source.megaMeshBufferIndexs.end())
+							return fail("entry " + std::to_string(entry) + " is drawn with mesh " + std::to_string(command.meshIndex) + " it's object doesn't have");
+						if (entryMeshes[entry] != UINT64_MAX && entryMeshes[entry] != command.meshIndex)
+							return fail("entry " + std::to_string(entry) + " is drawn with more then one mesh");
+						entryMeshes[entry] = command.meshIndex;
+
+						if (objectBufferObjects[entry].model != source.obj.model)
+							return fail("entry " + std::to_string(entry) + " doesn't hold the model of object " + std::to_string(objectBufferSources[entry]));
+						if ((uint32)objectBufferObjects[entry].metadata.z != command.meshIndex)
+							return fail("entry " + std::to_string(entry) + " doesn't hold the index of mesh " + std::to_string(command.meshIndex));
+
+						referenced[entry] = 1;
+					}
+
+					//with more then one view the draw still starts at the entry, and has a instance for every view that sees it
+					if (viewCount > 1)
+					{
+						uint32 instanceCount = 1, firstInstance = 0;
+						CalculateViewDraw(command, instanceCount, firstInstance);
+						if (firstInstance != command.objIndex)
+							return fail("command " + std::to_string(i) + " is drawn from instance " + std::to_string(firstInstance) + " instead of it's entry");
+						if (!command.viewMask || (command.viewMask >> viewCount) || (viewMode != ViewMode::Multiview && (command.viewMask >> instanceCount)))
+							return fail("command " + std::to_string(i) + " has views it isn't drawn in");
+						if ((uint32)objectBufferObjects[command.objIndex].metadata.w != command.viewMask)
+							return fail("entry " + std::to_string(command.objIndex) + " doesn't hold the view mask of command " + std::to_string(i));
+					}
+				}
+			}
+
+			for (size_t e = 0; e < referenced.size(); ++e)
+			{
+				if (!referenced[e])
+					return fail("entry " + std::to_string(e) + " is never drawn");
+			}
+
+			return true;
+		}
+
+		//culls a object against each view, returning a mask of the views that see it
+		inline uint32 CalculateViewMask(const ObjectBatch_Object& object)
+		{
+			const uint32 viewCount = GetViewCount();
+			if (viewCount == 1)
+			{
+				multiViewStats.objectsPerView[0]++;
+				return 1;
+			}
+
+			const StaticMesh* staticMesh = assetManager->GetStaticMesh(object.staticMeshID, true);
+			if (!staticMesh)
+				return 0;
+
+			const glm::vec4 worldSphere = Geometry::BoundingSphere_Transform(staticMesh->bounds.sphere, object.obj.model);
+			uint32 viewMask = 0;
+			for (uint32 v = 0; v < viewCount; ++v)
+			{
+				if (Culling::Frustum_TestSphere(viewFrustums[v], worldSphere))
+				{
+					viewMask |= (1u << v);
+					multiViewStats.objectsPerView[v]++;
+				}
+			}
+
+			return viewMask;
+		}
+
+		//remakes the cached pipelines when the render pass they draw in changed, since they're cached by asset ID and only made once
+		//the pipelines can be in use by frames in flight, but this only happens when the views are set up
+		inline void UpdatePipelineRenderPass()
+		{
+			if (!GPU || GetPipelineRenderPass() == pipelineRenderPass)
+				return;
+
+			vkDeviceWaitIdle(GPU->device);
+			RemakePipelines();
+		}
+
+		//sets the viewport and scissor, recording them as the ones the pipeline library sets
+		inline void SetViewportAndScissor(VkCommandBuffer& comBuffer, const BTD_Math_U32Vec2& size, const BTD_Math_U32Vec2& offset)
+		{
+			Dispatch_RecordSetViewport(dispatch, { (float)offset.x, (float)offset.y, (float)size.x, (float)size.y, 0.0f, 1.0f });
+			Dispatch_RecordSetScissor(dispatch, { { (int32)offset.x, (int32)offset.y }, { size.x, size.y } });
+			if (Dispatch_IsExecuting(dispatch))
+				Smok::Graphics::Pipeline::GraphicsPipeline_SetViewportAndScissor(comBuffer, size, offset);
+		}
+
+		//records the texture array being rewritten on every frame's set, as the writes the descriptor library makes
+		inline void RecordTextureWrites()
+		{
+			if (!Dispatch_GetTrace(dispatch))
+				return;
+
+			const Smok::Texture::TextureBuffer& textureBuffer = assetManager->textureBuffer;
+			std::vector<VkDescriptorImageInfo> imageInfos(textureBuffer.textureViews.size());
+			for (size_t i = 0; i < imageInfos.size(); ++i)
+				imageInfos[i] = { textureBuffer.textureSamplers[i], textureBuffer.textureViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+			for (size_t f = 0; f < textureDescSet.descriptorSets.size() && !imageInfos.empty(); ++f)
+			{
+				VkWriteDescriptorSet write = {};
+				write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				write.dstSet = textureDescSet.descriptorSets[f];
+				write.dstBinding = 0;
+				write.descriptorCount = (uint32)imageInfos.size();
+				write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				write.pImageInfo = imageInfos.data();
+				Dispatch_RecordDescriptorWrites(dispatch, 1, &write);
+			}
+		}
+
+		//gets the instances a command is drawn with when there's more then one view, the first instance is always the command's entry
+		//multiview draws it once, the other modes a instance per view up to the last that sees it, the view being the instance's offset from the entry
+		inline void CalculateViewDraw(const RenderCommand& command, uint32& instanceCount, uint32& firstInstance) const
+		{
+			firstInstance = (uint32)command.objIndex;
+			instanceCount = 1;
+			if (viewMode == ViewMode::Multiview)
+				return;
+
+			const uint32 viewCount = GetViewCount();
+			instanceCount = 0;
+			while (instanceCount < viewCount && (command.viewMask >> instanceCount))
+				instanceCount++;
+		}
+
+		//draws a batch's commands for every view
+		inline void DrawViews(VkCommandBuffer& comBuffer, const RenderBatch& batch)
+		{
+			for (uint32 i = 0; i < batch.commands.size(); ++i)
+			{
+				uint32 instanceCount = 1, firstInstance = 0;
+				CalculateViewDraw(batch.commands[i], instanceCount, firstInstance);
+				DrawViewCommand(comBuffer, batch.commands[i], instanceCount, firstInstance);
+			}
+		}
+
+		//draws a command with a given first instance and instance count
+		inline void DrawViewCommand(VkCommandBuffer& comBuffer, const RenderCommand& command, const uint32 instanceCount, const uint32 firstInstance)
+		{
+			const uint32 indexCount = (command.indexCount > 0 ? command.indexCount :
+				assetManager->megaMeshBufferMeshes[command.meshIndex].subMesh.indexCount);
+			assetManager->DrawMegaMeshBufferRange(comBuffer, command.meshIndex, command.firstIndex, indexCount, firstInstance, instanceCount, dispatch);
+			if (frameStats)
+				frameStats->AddDraw(indexCount, instanceCount);
+		}
+
+		//draws a object's meshes into the occlusion depth buffer
+		inline void DrawOccluder(const ObjectBatch_Object& object)
+		{
+			const StaticMesh* staticMesh = assetManager->GetStaticMesh(object.staticMeshID, true);
+			if (!staticMesh || staticMesh->meshes.empty())
+				return;
+
+			uint64 triangleCount = 0;
+			for (size_t m = 0; m < staticMesh->meshes.size(); ++m)
+				triangleCount += staticMesh->meshes[m].indices.size() / 3;
+			if (triangleCount > occlusionSettings.maxOccluderTriangleCount)
+				return;
+
+			const glm::mat4 PVM = cameraData.PV[0] * object.obj.model;
+			for (size_t m = 0; m < staticMesh->meshes.size(); ++m)
+				occlusionCullStats.occluderTriangleCount += Culling::SoftwareRasterizer_DrawMesh(&occlusionDepth, PVM, staticMesh->meshes[m]);
+			occlusionCullStats.occluderCount++;
+		}
+
+		//picks the objects to draw || with the software rasterizer they're occlusion culled here in two phases,
+		//GPU occlusion culling keeps them all, the GPU culler runs both phases on the draws
+		inline void CalculateDrawObjects(const std::vector<ObjectBatch_Object>& objects)
+		{
+			drawObjectIndexes.clear();
+			occlusionCullStats.Reset();
+
+			//the pyramid is from camera 0, so it can't cull for other views
+			if (!occlusionCulling || GetViewCount() > 1 || GPUOcclusion)
+			{
+				for (uint32 i = 0; i < objects.size(); ++i)
+					drawObjectIndexes.emplace_back(i);
+
+				//the GPU's counts stay on the GPU, so only what it tests is known
+				occlusionCullStats.GPUPyramid = (occlusionCulling && GPUOcclusion && GetViewCount() == 1);
+				if (occlusionCullStats.GPUPyramid)
+					occlusionCullStats.testedObjectCount = (uint32)objects.size();
+				return;
+			}
+
+			occlusionCullStats.testedObjectCount = (uint32)objects.size();
+			const glm::mat4& PV = cameraData.PV[0];
+
+			//phase one, tests against last frame's depth
+			occlusionRejected.clear();
+			occlusionWorldSpheres.resize(objects.size());
+			for (uint32 i = 0; i < objects.size(); ++i)
+			{
+				const StaticMesh* staticMesh = assetManager->GetStaticMesh(objects[i].staticMeshID, true);
+				occlusionWorldSpheres[i] = (staticMesh ? Geometry::BoundingSphere_Transform(staticMesh->bounds.sphere, objects[i].obj.model) :
+					glm::vec4(0.0f));
+
+				if (staticMesh && Culling::OcclusionCuller_IsOccluded(occlusionPyramid, occlusionWorldSpheres[i], PV))
+					occlusionRejected.emplace_back(i);
+				else
+					drawObjectIndexes.emplace_back(i);
+			}
+			occlusionCullStats.phaseOneOccludedCount = (uint32)occlusionRejected.size();
+
+			//the visible objects make this frame's depth
+			Culling::DepthBuffer_Clear(&occlusionDepth, occlusionSettings.depthWidth, occlusionSettings.depthHeight);
+			for (size_t d = 0; d < drawObjectIndexes.size(); ++d)
+				DrawOccluder(objects[drawObjectIndexes[d]]);
+			Culling::DepthPyramid_Build(&occlusionPyramid, occlusionDepth);
+
+			//phase two, tests the rejected objects again so ones uncovered this frame aren't lost
+			const size_t phaseOneCount = drawObjectIndexes.size();
+			for (size_t r = 0; r < occlusionRejected.size(); ++r)
+			{
+				if (!Culling::OcclusionCuller_IsOccluded(occlusionPyramid, occlusionWorldSpheres[occlusionRejected[r]], PV))
+					drawObjectIndexes.emplace_back(occlusionRejected[r]);
+			}
+
+			occlusionCullStats.phaseTwoRecoveredCount = (uint32)(drawObjectIndexes.size() - phaseOneCount);
+			occlusionCullStats.occludedObjectCount = occlusionCullStats.phaseOneOccludedCount - occlusionCullStats.phaseTwoRecoveredCount;
+
+			//the recovered objects are in the frame too, so the next frame's pyramid needs them
+			if (occlusionCullStats.phaseTwoRecoveredCount > 0)
+			{
+				for (size_t d = phaseOneCount; d < drawObjectIndexes.size(); ++d)
+					DrawOccluder(objects[drawObjectIndexes[d]]);
+				Culling::DepthPyramid_Build(&occlusionPyramid, occlusionDepth);
+			}
+		}
+
+		//gets the first mesh draw of a static mesh, adding all it's sub meshes and LODs to the table the first time
+		inline uint32 GetGPUCullMeshDraws(const uint64 staticMeshID, const StaticMesh* staticMesh)
+		{
+			auto it = cullMeshDrawLookup.find(staticMeshID);
+			if (it != cullMeshDrawLookup.end())
+				return it->second;
+
+			const uint32 first = (uint32)cullMeshDraws.size();
+			const uint32 lodCount = (staticMesh->lods.empty() ? 1 : (uint32)std::min(staticMesh->lods.size(), (size_t)SMOK_RENDERER_GPU_CULL_MAX_LODS));
+			const std::vector<StaticMesh_SubMesh>& baseSubMeshes = (staticMesh->lods.empty() ? staticMesh->subMeshes : staticMesh->lods[0].subMeshes);
+
+			for (size_t m = 0; m < baseSubMeshes.size(); ++m)
+			{
+				for (uint32 l = 0; l < lodCount; ++l)
+				{
+					//a LOD missing the sub mesh keeps the coarsest one it had
+					const StaticMesh_SubMesh* subMesh = &baseSubMeshes[m];
+					for (uint32 fallback = l; fallback > 0; --fallback)
+					{
+						if (m < staticMesh->lods[fallback].subMeshes.size())
+						{
+							subMesh = &staticMesh->lods[fallback].subMeshes[m];
+							break;
+						}
+					}
+
+					Culling::GPUCull_MeshDraw* draw = &cullMeshDraws.emplace_back(Culling::GPUCull_MeshDraw());
+					draw->indexCount = subMesh->indexCount;
+					draw->firstIndex = subMesh->firstIndex;
+					draw->vertexOffset = (int32)subMesh->firstVertex;
+				}
+			}
+
+			cullMeshDrawLookup[staticMeshID] = first;
+			return first;
+		}
+
+		//makes a GPU cull candidate per sub mesh of each object || every candidate gets a command slot in the batch
+		inline void CalculateGPUCullCandidates(const std::vector<ObjectBatch_Object>& objects,
+			RenderBatch& batch, std::vector<ObjectBuffer_Object>& objectBufferObjects)
+		{
+			cullCandidates.clear();
+			objectBufferSources.clear();
+
+			//the LOD stats are the LODs the shader will pick, not the CPU's, so they use the same push constants the cull does
+			const Culling::GPUCull_PushConstants pc = Culling::GPUCuller_CalculatePushConstants(cameraData.V[0], cameraData.P[0],
+				0, GPUCuller.useDrawIndirectCount, lodBias);
+
+			for (uint32 d = 0; d < drawObjectIndexes.size(); ++d)
+			{
+				const uint32 i = drawObjectIndexes[d];
+
+				StaticMesh* staticMesh = assetManager->GetStaticMesh(objects[i].staticMeshID, true);
+				if (!staticMesh)
+					continue;
+
+				const uint32 firstMeshDraw = GetGPUCullMeshDraws(objects[i].staticMeshID, staticMesh);
+				const uint32 lodCount = (staticMesh->lods.empty() ? 1 : (uint32)std::min(staticMesh->lods.size(), (size_t)SMOK_RENDERER_GPU_CULL_MAX_LODS));
+				const std::vector<StaticMesh_SubMesh>& baseSubMeshes = (staticMesh->lods.empty() ? staticMesh->subMeshes : staticMesh->lods[0].subMeshes);
+
+				//one object per static mesh, all it's sub meshes draw with it as their first instance
+				const uint32 objectIndex = (uint32)objectBufferObjects.size();
+				objectBufferObjects.emplace_back(objects[i].obj);
+				objectBufferSources.emplace_back(i);
+
+				for (uint32 m = 0; m < baseSubMeshes.size(); ++m)
+				{
+					Culling::GPUCull_Candidate* candidate = &cullCandidates.emplace_back(Culling::GPUCull_Candidate());
+					candidate->cullSphere = baseSubMeshes[m].bounds.sphere;
+					candidate->lodSphere = staticMesh->bounds.sphere;
+					for (uint32 l = 1; l < lodCount; ++l)
+						candidate->lodScreenSizes[l - 1] = staticMesh->lods[l].screenSize;
+
+					candidate->objectIndex = objectIndex;
+					candidate->firstLODMeshDraw = firstMeshDraw + m * lodCount;
+					candidate->lodCount = lodCount;
+					candidate->batchIndex = 0;
+					candidate->commandBase = batch.commandBase;
+					candidate->candidateIndex = batch.maxDrawCount++;
+				}
+
+				//every sub mesh shares the whole mesh's LOD sphere, so they all pick the same LOD
+				if (baseSubMeshes.empty())
+					continue;
+
+				const uint32 lod = Culling::GPUCuller_PickLOD(pc, cullCandidates.back(), objects[i].obj.model);
+				for (uint32 m = 0; m < baseSubMeshes.size(); ++m)
+				{
+					lodStats.triangleCount += cullMeshDraws[firstMeshDraw + m * lodCount + lod].indexCount / 3;
+					lodStats.fullDetailTriangleCount += cullMeshDraws[firstMeshDraw + m * lodCount].indexCount / 3;
+				}
+				if (lod < lodStats.objectsPerLOD.size())
+					lodStats.objectsPerLOD[lod]++;
+			}
+		}
+
+		//uploads the quantized meshes' dequantize into a frame's mesh dequantize buffer, when meshes were added since it was last filled
+		inline void UploadMeshDequantizeBuffer(const uint32 frameIndex)
+		{
+			const auto& meshes = assetManager->quantizedMegaMeshBuffer.meshes;
+			if (assetManager->vertexFormat != MeshVertexFormat::Quantized || meshes.size() <= lastFrameDequantizeCount[frameIndex])
+				return;
+
+			meshDequantizes.resize(meshes.size());
+			for (size_t i = 0; i < meshes.size(); ++i)
+			{
+				meshDequantizes[i].scale = meshes[i].dequantizeScale;
+				meshDequantizes[i].offset = meshes[i].dequantizeOffset;
+			}
+			const size_t byteSize = sizeof(MeshDequantizeBuffer_Mesh) * meshDequantizes.size();
+			lastFrameDequantizeCount[frameIndex] = (uint32)meshes.size();
+
+			//without a device there's no buffer, the upload is only recorded
+			if (!Dispatch_IsExecuting(dispatch))
+			{
+				Dispatch_RecordUpload(dispatch, 0, 0, meshDequantizes.data(), byteSize);
+				return;
+			}
+
+			VkWriteDescriptorSet descriptorWrite = {}; VkDescriptorBufferInfo bufferInfo = {};
+
+			bool state = false;
+			auto& dequantizeBuffer = objectBufferDescSet.uniformStorageBuffers["MeshDequantizeBuffer"];
+			Graphics::Descriptor::DescriptorSet_UniformStorageBuffer_RecreateBuffer(objectBufferDescSet.descriptorSets[frameIndex],
+				&dequantizeBuffer.buffers[frameIndex], state, byteSize, &descriptorWrite, &bufferInfo, allocator);
+			dequantizeBuffer.isSafeCopy[frameIndex] = state;
+
+			//updates bindings
+			descriptorWrite.dstBinding = 1;
+			Dispatch_UpdateDescriptorSets(dispatch, GPU->device, 1, &descriptorWrite);
+			if (frameStats)
+				frameStats->descriptorUpdateCount++;
+
+			Dispatch_Upload(dispatch, dequantizeBuffer.buffers[frameIndex].allocationInfo.pMappedData, (uint64)dequantizeBuffer.buffers[frameIndex].buffer, 0,
+				meshDequantizes.data(), byteSize);
+		}
+
+		//uploads the object buffer of a frame, growing it if needed
+		inline void UploadObjectBuffer(const uint32 frameIndex, const std::vector<ObjectBuffer_Object>& objectBufferObjects)
+		{
+			const size_t objCount = objectBufferObjects.size();
+
+			UploadMeshDequantizeBuffer(frameIndex);
+
+			//without a device there's no buffer, the upload is only recorded
+			if (!Dispatch_IsExecuting(dispatch))
+			{
+				Dispatch_RecordUpload(dispatch, 0, 0, objectBufferObjects.data(), sizeof(ObjectBuffer_Object) * objCount);
+				if (frameStats)
+					frameStats->objectBufferBytes += sizeof(ObjectBuffer_Object) * objCount;
+				return;
+			}
+
+			//if the object count is larger then it was last frame, we resize the buffer
+			if (objCount > lastFrameObjectCount[frameIndex])
+			{
+				VkWriteDescriptorSet descriptorWrite = {}; VkDescriptorBufferInfo bufferInfo = {};
+
+				bool state = false;
+				Graphics::Descriptor::DescriptorSet_UniformStorageBuffer_RecreateBuffer(objectBufferDescSet.descriptorSets[frameIndex],
+					&objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].buffers[frameIndex],
+					state,
+					sizeof(ObjectBuffer_Object) * objCount,
+					&descriptorWrite, &bufferInfo, allocator);
+			
+				//copies over if it's safe memory copy, just in case the reallocation threw it somewhere new
+				objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].isSafeCopy[frameIndex] = state;
+			
+				//updates bindings
+				Dispatch_UpdateDescriptorSets(dispatch, GPU->device, 1, &descriptorWrite);
+				if (frameStats)
+					frameStats->descriptorUpdateCount++;
+
+				lastFrameObjectCount[frameIndex] = objCount;
+			}
+
+			//copies object data || the buffer only grows, so only this frame's objects are copied
+			const auto& objectBuffer = objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].buffers[frameIndex];
+			Dispatch_Upload(dispatch, objectBuffer.allocationInfo.pMappedData, (uint64)objectBuffer.buffer, 0,
+				objectBufferObjects.data(), sizeof(ObjectBuffer_Object) * objCount);
+			if (frameStats)
+				frameStats->objectBufferBytes += sizeof(ObjectBuffer_Object) * objCount;
+		}
+
+		//checks if the GPU culler occlusion culls this frame || the pyramid is from camera 0, and there's nothing to test against until one's been built
+		inline bool IsGPUOcclusionCulling() const
+		{
+			return GPUDrivenCulling && occlusionCulling && GPUOcclusion && GetViewCount() == 1 && occlusionGPUPyramid.recorded;
+		}
+
+		//records the GPU culling of a frame || call outside the render pass, before Render
+		//with GPU occlusion culling this is phase one, the objects it rejects are drawn by RecordGPUCullingPhaseTwo and RenderOcclusionPhaseTwo
+		inline void RecordGPUCulling(VkCommandBuffer& comBuffer, Frame& frame,
+			const std::vector<RenderBatch>& renderBatch,
+			const std::vector<ObjectBuffer_Object>& objectBufferObjects)
+		{
+			occlusionPhaseTwoPending = false;
+			if (!GPUDrivenCulling || objectBufferObjects.empty())
+				return;
+
+			ProfilerCPUScope cpuScope(profiler, "Mesh Record GPU Culling");
+			ProfilerGPUScope gpuScope(profiler, comBuffer, "Mesh GPU Culling");
+			frameStats = frame.stats;
+			dispatch = frame.dispatch;
+			if (frameStats)
+				frameStats->dispatchCount++;
+
+			//the cull reads the object buffer, so it's uploaded here instead of in Render
+			UploadObjectBuffer(frame.currentFrame, objectBufferObjects);
+
+			uint32 commandCount = 0;
+			for (size_t b = 0; b < renderBatch.size(); ++b)
+				commandCount = std::max(commandCount, renderBatch[b].commandBase + renderBatch[b].maxDrawCount);
+
+			if (!Culling::GPUCuller_UploadMeshDraws(&GPUCuller, frame.currentFrame, cullMeshDraws) ||
+				!Culling::GPUCuller_UploadCandidates(&GPUCuller, frame.currentFrame, cullCandidates, commandCount, (uint32)renderBatch.size()))
+				return;
+
+			const auto& objectBuffer = objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].buffers[frame.currentFrame];
+			const Culling::GPUCull_PushConstants pc = Culling::GPUCuller_CalculatePushConstants(cameraData.V[0], cameraData.P[0],
+				(uint32)cullCandidates.size(), GPUCuller.useDrawIndirectCount, lodBias);
+			if (IsGPUOcclusionCulling())
+			{
+				Culling::GPUCuller_RecordOcclusionCull(&GPUCuller, comBuffer, frame.currentFrame, objectBuffer.buffer, objectBuffer.size, pc,
+					Culling::GPUCull_OcclusionPhase::PhaseOne, cameraData.PV[0], &occlusionGPUPyramid, dispatch);
+				occlusionPhaseTwoPending = true;
+			}
+			else
+				Culling::GPUCuller_RecordCull(&GPUCuller, comBuffer, frame.currentFrame, objectBuffer.buffer, objectBuffer.size, pc, dispatch);
+		}
+
+		//records the second occlusion phase of the GPU culler, re-testing what RecordGPUCulling rejected against this frame's pyramid
+		//call outside the render pass, after RecordDepthPyramid || does nothing if phase one wasn't recorded
+		inline void RecordGPUCullingPhaseTwo(VkCommandBuffer& comBuffer, Frame& frame)
+		{
+			if (!occlusionPhaseTwoPending)
+				return;
+
+			ProfilerCPUScope cpuScope(profiler, "Mesh Record GPU Culling Phase Two");
+			ProfilerGPUScope gpuScope(profiler, comBuffer, "Mesh GPU Culling Phase Two");
+			frameStats = frame.stats;
+			dispatch = frame.dispatch;
+			if (frameStats)
+				frameStats->dispatchCount++;
+
+			const auto& objectBuffer = objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].buffers[frame.currentFrame];
+			Culling::GPUCuller_RecordOcclusionCull(&GPUCuller, comBuffer, frame.currentFrame, objectBuffer.buffer, objectBuffer.size,
+				Culling::GPUCuller_CalculatePushConstants(cameraData.V[0], cameraData.P[0], (uint32)cullCandidates.size(),
+					GPUCuller.useDrawIndirectCount, lodBias), Culling::GPUCull_OcclusionPhase::PhaseTwo, cameraData.PV[0], &occlusionGPUPyramid, dispatch);
+		}
+
+		//checks the GPU culled commands of a frame against the CPU reference || needs readBack, call once the frame's fence has been waited on
+		//and before the next CalculateCommandData, since it reuses that frame's candidates
+		inline bool VerifyGPUCulling(const uint32 currentFrame, const std::vector<RenderBatch>& renderBatch,
+			const std::vector<ObjectBuffer_Object>& objectBufferObjects)
+		{
+			//a frame with nothing to cull has nothing to check
+			if (cullCandidates.empty() || objectBufferObjects.empty())
+				return true;
+
+			//the pyramid phase one tested against has been rebuilt by the time the frame is done, so the CPU can't redo it
+			if (GPUOcclusion)
+			{
+				BTD_LogError("Smok Renderer", "GPU Mesh Renderer", "VerifyGPUCulling",
+					"The GPU occlusion cull can't be checked against the CPU reference, turn occlusion culling off to verify the GPU culler!");
+				return false;
+			}
+
+			std::vector<VkDrawIndexedIndirectCommand> GPUCommands; std::vector<uint32> GPUCounts;
+			if (!Culling::GPUCuller_ReadBack(&GPUCuller, currentFrame, GPUCommands, GPUCounts))
+				return false;
+
+			std::vector<VkDrawIndexedIndirectCommand> CPUCommands(GPUCommands.size(), VkDrawIndexedIndirectCommand());
+			std::vector<uint32> CPUCounts(GPUCounts.size(), 0);
+			const Culling::GPUCull_PushConstants pc = Culling::GPUCuller_CalculatePushConstants(cameraData.V[0], cameraData.P[0],
+				(uint32)cullCandidates.size(), GPUCuller.useDrawIndirectCount, lodBias);
+			Culling::GPUCuller_CullCPU(pc, cullCandidates.data(), cullMeshDraws.data(),
+				&objectBufferObjects[0].model, sizeof(ObjectBuffer_Object), CPUCommands.data(), CPUCounts.data());
+
+			for (uint32 b = 0; b < renderBatch.size(); ++b)
+			{
+				const uint32 count = (GPUCuller.useDrawIndirectCount ? CPUCounts[b] : renderBatch[b].maxDrawCount);
+				if ((GPUCuller.useDrawIndirectCount && GPUCounts[b] != CPUCounts[b]) ||
+					!Culling::GPUCuller_CompareBatch(GPUCommands.data() + renderBatch[b].commandBase,
+						CPUCommands.data() + renderBatch[b].commandBase, count))
+				{
+					BTD_LogError("Smok Renderer", "GPU Mesh Renderer", "VerifyGPUCulling",
+						std::string("The GPU culled commands of batch " + std::to_string(b) + " don't match the CPU reference!").c_str());
+					return false;
+				}
+			}
+
+			return true;
 		}
 
 		//registers a camera
@@ -328,12 +1381,60 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 		//updates the camera
 		inline void UpdateCamera(const CameraBuffer* camData)
 		{
+			cameraData = *camData;
+
+			//with a frame source flushing the staging ring, Render stages each frame slot's buffer once that slot is free again, so it goes up with the frame's other uploads
+			if (Util::StagingRing_IsFlushedPerFrame(&assetManager->stagingRing))
+			{
+				dirtyCameraFrames = ~0u;
+				return;
+			}
+
 			//copies data to GPU on all frames of the buffer
 			Smok::Graphics::Descriptor::DescriptorSet_UniformBuffer_UploadDataToGPU_AllBuffers(
 				&cameraBufferDescSet, "CameraBuffer",
 				allocator, GPU, (void*)camData, commandPool);
 		}
 
+		//stages the camera data into a frame slot's camera buffer, if the slot hasn't had it yet
+		inline void UploadCamera(const uint32 frameIndex)
+		{
+			const uint32 frameBit = (1u << frameIndex);
+			if (!(dirtyCameraFrames & frameBit))
+				return;
+
+			const auto& buffers = cameraBufferDescSet.uniformBuffers["CameraBuffer"].buffers;
+			if (frameIndex < buffers.size() && Util::StagingRing_UploadBuffer(&assetManager->stagingRing, buffers[frameIndex].buffer, 0,
+				&cameraData, sizeof(CameraBuffer), VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_UNIFORM_READ_BIT))
+				dirtyCameraFrames &= ~frameBit;
+		}
+
+		//binds the pipeline, viewport and descriptor sets of a batch
+		inline void BindBatch(VkCommandBuffer& comBuffer, Frame& frame, const RenderBatch& batch)
+		{
+			//bind pipeline
+			Smok::Graphics::Pipeline::GraphicsPipeline* pipeline =
+				assetManager->GetGraphicsPipeline(batch.pipelineID);
+			Dispatch_RecordBindPipeline(dispatch, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline);
+			if (Dispatch_IsExecuting(dispatch))
+				Smok::Graphics::Pipeline::GraphicsPipeline_Bind(pipeline, comBuffer);
+
+			//sets viewport and scissor
+			SetViewportAndScissor(comBuffer, frame.frameSize, { 0, 0 });
+
+			//binds the descriptor sets
+			VkDescriptorSet sets[3] = { cameraBufferDescSet.descriptorSets[frame.currentFrame],
+			objectBufferDescSet.descriptorSets[frame.currentFrame],
+			textureDescSet.descriptorSets[frame.currentFrame] };
+			Dispatch_CmdBindDescriptorSets(dispatch, comBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+				graphicsPipelineLayout.pipelineLayout, 0, 3, sets);
+			if (frameStats)
+			{
+				frameStats->pipelineBindCount++;
+				frameStats->descriptorBindCount++;
+			}
+		}
+
 		//renders
 		inline void Render(VkCommandBuffer& comBuffer, Frame& frame,
 			const std::vector<RenderBatch>& renderBatch,
@@ -345,74 +1446,202 @@ namespace Smok::Renderers::GPUBased::MeshRenderer
 			if (!objCount)
 				return;
 
-			//if the object count is larger then it was last frame, we resize the buffer
-			if (objCount > lastFrameObjectCount[frame.frameIndex])
-			{
-				VkWriteDescriptorSet descriptorWrite = {}; VkDescriptorBufferInfo bufferInfo = {};
-
-				bool state = false;
-				Graphics::Descriptor::DescriptorSet_UniformStorageBuffer_RecreateBuffer(objectBufferDescSet.descriptorSets[frame.frameIndex],
-					&objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].buffers[frame.frameIndex],
-					state,
-					sizeof(ObjectBuffer_Object) * objCount,
-					&descriptorWrite, &bufferInfo, allocator);
-			
-				//copies over if it's safe memory copy, just in case the reallocation threw it somewhere new
-				objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].isSafeCopy[frame.frameIndex] = state;
-			
-				//updates bindings
-				vkUpdateDescriptorSets(GPU->device, 1, &descriptorWrite, 0, nullptr);
+			ProfilerCPUScope cpuScope(profiler, "Mesh Render");
+			ProfilerGPUScope gpuScope(profiler, comBuffer, "Mesh Render");
 
-				lastFrameObjectCount[frame.frameIndex] = objCount;
+			frameStats = frame.stats;
+			dispatch = frame.dispatch;
+			if (frameStats)
+			{
+				frameStats->batchCount += (uint32)renderBatch.size();
+				frameStats->megaMeshBufferRebuildCount += assetManager->megaMeshBufferRebuildCount - seenMegaMeshBufferRebuildCount;
 			}
+			seenMegaMeshBufferRebuildCount = assetManager->megaMeshBufferRebuildCount;
 
-			//copies object data
-			memcpy(objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].buffers[frame.frameIndex].allocationInfo.pMappedData,
-				objectBufferObjects.data(), objectBufferDescSet.uniformStorageBuffers["ObjectBuffer"].buffers[frame.frameIndex].size);// sizeof(ObjectBatch_Object)* objCount);
+			UploadCamera(frame.currentFrame);
+
+			//GPU culling already uploaded the objects
+			if (!GPUDrivenCulling)
+				UploadObjectBuffer(frame.currentFrame, objectBufferObjects);
 
 			//copies texture data
 			if (assetManager->textureBuffer.sizeHasChanged)
 			{
-				Graphics::Descriptor::DescriptorSet_UniformSampler2DArray_UploadDataToGPU_AllBuffers(&textureDescSet, "Textures",
-					GPU, assetManager->textureBuffer.textureViews.data(), assetManager->textureBuffer.textureSamplers.data(), assetManager->textureBuffer.textureSamplers.size());
+				RecordTextureWrites();
+				if (Dispatch_IsExecuting(dispatch))
+					Graphics::Descriptor::DescriptorSet_UniformSampler2DArray_UploadDataToGPU_AllBuffers(&textureDescSet, "Textures",
+						GPU, assetManager->textureBuffer.textureViews.data(), assetManager->textureBuffer.textureSamplers.data(), assetManager->textureBuffer.textureSamplers.size());
 				assetManager->textureBuffer.sizeHasChanged = false;
+				if (frameStats)
+				{
+					frameStats->textureArrayUploadCount++;
+					frameStats->descriptorUpdateCount++;
+				}
 			}
 
 			//goes through the batches
 			for (uint32 b = 0; b < renderBatch.size(); ++b)
 			{
-				//bind pipeline
-				Smok::Graphics::Pipeline::GraphicsPipeline_Bind(
-					assetManager->GetGraphicsPipeline(assetManager->GetNameByID(renderBatch[b].pipelineID).c_str()), comBuffer);
-
-				//sets viewport and scissor
-				Smok::Graphics::Pipeline::GraphicsPipeline_SetViewportAndScissor(
-					comBuffer,
-					frame.frameSize, { 0, 0 });
-
-				//binds the descriptor sets
-				VkDescriptorSet sets[3] = { cameraBufferDescSet.descriptorSets[frame.currentFrame],
-				objectBufferDescSet.descriptorSets[frame.currentFrame],
-				textureDescSet.descriptorSets[frame.currentFrame] };
-				vkCmdBindDescriptorSets(comBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-					graphicsPipelineLayout.pipelineLayout, 0, 3,
-					sets, 0, nullptr);
+				BindBatch(comBuffer, frame, renderBatch[b]);
 
 				//if there is data to draw
-				if (assetManager->megaMeshBuffer.vertexBuffer.vertexCount > 0)
+				if (assetManager->GetMegaMeshBufferVertexCount() > 0)
 				{
 					//binds buffer
-					Smok::Mesh::Util::MegaMeshBuffer_Bind(&assetManager->megaMeshBuffer, comBuffer);
+					assetManager->BindMegaMeshBuffer(comBuffer, dispatch);
+
+					//draws every view || the GPU culler only draws camera 0
+					if (GetViewCount() > 1 && !GPUDrivenCulling)
+					{
+						DrawViews(comBuffer, renderBatch[b]);
+						continue;
+					}
 
-					//draws
+					//draws what the GPU culler kept, or what occlusion phase one did
+					if (GPUDrivenCulling)
+					{
+						Culling::GPUCuller_DrawBatch(&GPUCuller, comBuffer, frame.currentFrame, b,
+							renderBatch[b].commandBase, renderBatch[b].maxDrawCount, Culling::GPUCull_OcclusionPhase::None, dispatch);
+						if (frameStats)
+							frameStats->indirectDrawCount++;
+						continue;
+					}
+
+					//draws, each command's object buffer entry is it's first instance
 					for (uint32 i = 0; i < renderBatch[b].commands.size(); ++i)
 					{
-						Smok::Mesh::Util::MegaMeshBuffer_Draw(&assetManager->megaMeshBuffer,
-							comBuffer, renderBatch[b].commands[i].meshIndex,
-							renderBatch[b].commands[i].objIndex, objCount);
+						const RenderCommand& command = renderBatch[b].commands[i];
+						DrawViewCommand(comBuffer, command, command.instanceCount, (uint32)command.objIndex);
 					}
 				}
 			}
 		}
+
+		//draws what the GPU culler's occlusion phase two recovered, into what Render drew || call after RecordGPUCullingPhaseTwo,
+		//in a render pass that loads the color and depth, does nothing if phase one wasn't recorded
+		inline void RenderOcclusionPhaseTwo(VkCommandBuffer& comBuffer, Frame& frame, const std::vector<RenderBatch>& renderBatch)
+		{
+			if (!occlusionPhaseTwoPending || !assetManager->GetMegaMeshBufferVertexCount())
+				return;
+
+			ProfilerCPUScope cpuScope(profiler, "Mesh Render Phase Two");
+			ProfilerGPUScope gpuScope(profiler, comBuffer, "Mesh Render Phase Two");
+			frameStats = frame.stats;
+			dispatch = frame.dispatch;
+
+			for (uint32 b = 0; b < renderBatch.size(); ++b)
+			{
+				BindBatch(comBuffer, frame, renderBatch[b]);
+				assetManager->BindMegaMeshBuffer(comBuffer, dispatch);
+				Culling::GPUCuller_DrawBatch(&GPUCuller, comBuffer, frame.currentFrame, b,
+					renderBatch[b].commandBase, renderBatch[b].maxDrawCount, Culling::GPUCull_OcclusionPhase::PhaseTwo, dispatch);
+				if (frameStats)
+					frameStats->indirectDrawCount++;
+			}
+		}
+
+		//gets the render pass the recovered draws go in, loading what renderPass drew || remade when the formats or color layout change
+		inline VkRenderPass GetOcclusionPhaseTwoRenderPass(const VkFormat colorFormat, const VkFormat depthFormat, const VkImageLayout colorFinalLayout)
+		{
+			if (occlusionPhaseTwoRenderPass != VK_NULL_HANDLE && occlusionPhaseTwoFormats[0] == colorFormat && occlusionPhaseTwoFormats[1] == depthFormat &&
+				occlusionPhaseTwoColorLayout == colorFinalLayout)
+				return occlusionPhaseTwoRenderPass;
+
+			if (occlusionPhaseTwoRenderPass != VK_NULL_HANDLE)
+			{
+				vkDeviceWaitIdle(GPU->device);
+				vkDestroyRenderPass(GPU->device, occlusionPhaseTwoRenderPass, nullptr);
+			}
+
+			occlusionPhaseTwoRenderPass = Util::RenderPass_Create(GPU->device, colorFormat, depthFormat, colorFinalLayout, 1, true);
+			occlusionPhaseTwoFormats[0] = colorFormat; occlusionPhaseTwoFormats[1] = depthFormat;
+			occlusionPhaseTwoColorLayout = colorFinalLayout;
+			return occlusionPhaseTwoRenderPass;
+		}
+
+		//adds the mesh passes to a render graph, the GPU cull when it's on, the draw into the color and depth targets, and the GPU occlusion depth pyramid when it's on
+		//the draw pass begins renderPass on the frame's framebuffer, call RenderGraph_SetFramebuffer with the next one each frame
+		//the frame, batches and objects are read when the graph is executed, so they have to live until then || returns the draw pass
+		//the final layouts are the ones renderPass leaves it's attachments in, the swapchain's render pass ends in PRESENT_SRC, and renderPass must store the depth
+		//with GPU occlusion culling the pyramid is followed by the phase two cull and a second draw of what it recovered, into phaseTwoPass if it's set,
+		//which loads the attachments in a render pass made from the targets' formats and needs the same framebuffer as the draw pass each frame
+		inline uint32 AddRenderGraphPasses(RenderGraph* graph, Frame* frame, const uint32 colorTarget, const uint32 depthTarget,
+			VkRenderPass renderPass, const std::vector<RenderBatch>* renderBatch, const std::vector<ObjectBuffer_Object>* objectBufferObjects,
+			const VkImageLayout colorFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+			const VkImageLayout depthFinalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, uint32* phaseTwoPass = nullptr)
+		{
+			if (phaseTwoPass)
+				*phaseTwoPass = UINT32_MAX;
+
+			//the cull does it's own barriers, the graph only has to keep it and order it before the draw
+			uint32 cullCommands = SMOK_RENDER_GRAPH_NO_RESOURCE;
+			if (GPUDrivenCulling)
+			{
+				cullCommands = RenderGraph_FindResource(*graph, "Mesh Cull Commands");
+				if (cullCommands == SMOK_RENDER_GRAPH_NO_RESOURCE)
+					cullCommands = RenderGraph_ImportBuffer(graph, "Mesh Cull Commands", VK_NULL_HANDLE, 0);
+
+				const uint32 cullPass = RenderGraph_AddPass(graph, "Mesh Cull", [this, frame, renderBatch, objectBufferObjects](VkCommandBuffer comBuffer) {
+					RecordGPUCulling(comBuffer, *frame, *renderBatch, *objectBufferObjects);
+				});
+				RenderGraph_Write(graph, cullPass, cullCommands, RenderGraph_Access::SelfSynchronized);
+			}
+
+			const uint32 drawPass = RenderGraph_AddPass(graph, "Mesh", [this, frame, renderBatch, objectBufferObjects](VkCommandBuffer comBuffer) {
+				Render(comBuffer, *frame, *renderBatch, *objectBufferObjects);
+			});
+			RenderGraph_Write(graph, drawPass, colorTarget, RenderGraph_Access::ColorAttachment);
+			if (depthTarget != SMOK_RENDER_GRAPH_NO_RESOURCE)
+				RenderGraph_Write(graph, drawPass, depthTarget, RenderGraph_Access::DepthAttachment, true);
+			if (cullCommands != SMOK_RENDER_GRAPH_NO_RESOURCE)
+				RenderGraph_Read(graph, drawPass, cullCommands, RenderGraph_Access::SelfSynchronized);
+
+			std::vector<VkClearValue> clearValues(2);
+			clearValues[0].color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+			clearValues[1].depthStencil = { 1.0f, 0 };
+			RenderGraph_SetRenderPass(graph, drawPass, renderPass, frame->framebuffer, { frame->frameSize.x, frame->frameSize.y }, clearValues);
+			RenderGraph_SetAttachmentFinalLayout(graph, drawPass, colorTarget, colorFinalLayout);
+			if (depthTarget != SMOK_RENDER_GRAPH_NO_RESOURCE)
+				RenderGraph_SetAttachmentFinalLayout(graph, drawPass, depthTarget, depthFinalLayout);
+
+			//the depth the draw wrote becomes the pyramid phase two and the next frame cull against || kept as a side effect, since the next frame reads it
+			if (!occlusionCulling || !GPUOcclusion || depthTarget == SMOK_RENDER_GRAPH_NO_RESOURCE)
+				return drawPass;
+
+			uint32 pyramid = RenderGraph_FindResource(*graph, "Mesh Depth Pyramid");
+			if (pyramid == SMOK_RENDER_GRAPH_NO_RESOURCE)
+				pyramid = RenderGraph_ImportBuffer(graph, "Mesh Depth Pyramid", VK_NULL_HANDLE, 0);
+
+			const uint32 pyramidPass = RenderGraph_AddPass(graph, "Mesh Depth Pyramid", [this, graph, frame, depthTarget](VkCommandBuffer comBuffer) {
+				const RenderGraph_Resource& depth = graph->resources[depthTarget];
+				RecordDepthPyramid(comBuffer, *frame, depth.imageView, depth.imageDesc.width, depth.imageDesc.height);
+			});
+			RenderGraph_Read(graph, pyramidPass, depthTarget, RenderGraph_Access::ComputeRead);
+			RenderGraph_Write(graph, pyramidPass, pyramid, RenderGraph_Access::SelfSynchronized);
+			RenderGraph_SetSideEffects(graph, pyramidPass);
+
+			//phase two re-tests what phase one rejected against the new pyramid, then draws what it recovered over the first draw
+			const uint32 phaseTwoCullPass = RenderGraph_AddPass(graph, "Mesh Cull Phase Two", [this, frame](VkCommandBuffer comBuffer) {
+				RecordGPUCullingPhaseTwo(comBuffer, *frame);
+			});
+			RenderGraph_Read(graph, phaseTwoCullPass, pyramid, RenderGraph_Access::SelfSynchronized);
+			RenderGraph_Write(graph, phaseTwoCullPass, cullCommands, RenderGraph_Access::SelfSynchronized);
+
+			const uint32 phaseTwoDrawPass = RenderGraph_AddPass(graph, "Mesh Phase Two", [this, frame, renderBatch](VkCommandBuffer comBuffer) {
+				RenderOcclusionPhaseTwo(comBuffer, *frame, *renderBatch);
+			});
+			RenderGraph_Write(graph, phaseTwoDrawPass, colorTarget, RenderGraph_Access::ColorAttachment);
+			RenderGraph_Write(graph, phaseTwoDrawPass, depthTarget, RenderGraph_Access::DepthAttachment);
+			RenderGraph_Read(graph, phaseTwoDrawPass, cullCommands, RenderGraph_Access::SelfSynchronized);
+
+			RenderGraph_SetRenderPass(graph, phaseTwoDrawPass, GetOcclusionPhaseTwoRenderPass(graph->resources[colorTarget].imageDesc.format,
+				graph->resources[depthTarget].imageDesc.format, colorFinalLayout), frame->framebuffer, { frame->frameSize.x, frame->frameSize.y }, {});
+			RenderGraph_SetAttachmentFinalLayout(graph, phaseTwoDrawPass, colorTarget, colorFinalLayout);
+			RenderGraph_SetAttachmentFinalLayout(graph, phaseTwoDrawPass, depthTarget, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+			if (phaseTwoPass)
+				*phaseTwoPass = phaseTwoDrawPass;
+			return drawPass;
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,470 @@
+#pragma once
+
+//defines a batched GUI quad renderer, each element is a small quad record instead of a object with a model matrix and a mesh
+//the quads are made in the vertex shader, with one instanced draw per run of quads sharing a texture and clip rect
+//the shaders are shaders/GUIQuad.vert and shaders/GUIQuad.frag
+
+#include <SmokRenderers/RenderManager.hpp>
+#include <SmokRenderers/RenderGraph.hpp>
+#include <SmokRenderers/Util/GPUBuffer.hpp>
+#include <SmokRenderers/Util/ShaderModule.hpp>
+#include <SmokRenderers/Util/TextureAtlas.hpp>
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+
+namespace Smok::Renderers::GPUBased::GUIRenderer
+{
+	//the texture slots a GUI quad can sample, matches the shader
+#define SMOK_RENDERER_GUI_TEXTURE_SLOTS 16
+
+	//the clip index of a quad that isn't clipped
+#define SMOK_RENDERER_GUI_NO_CLIP UINT32_MAX
+
+	//defines a GUI element || matches GUIQuad in the shader
+	struct GUIQuad
+	{
+		glm::vec4 rect = glm::vec4(0.0f); //x, y, width, height in pixels, from the top left
+		glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); //the top left and bottom right UVs
+		uint32 color = 0xFFFFFFFF; //RGBA8, R in the low byte
+		uint32 textureSlot = 0; //the texture it samples, 0 is the blank texture
+		uint32 clipIndex = SMOK_RENDERER_GUI_NO_CLIP; //the clip rect it's cut to
+		uint32 layer = 0; //higher layers draw on top
+	};
+
+	//defines a clip rect in pixels
+	struct GUIClipRect
+	{
+		int32 x = 0, y = 0;
+		uint32 width = 0, height = 0;
+	};
+
+	//defines a run of quads drawn with one instanced draw
+	struct GUIQuadBatch
+	{
+		uint32 firstQuad = 0; //the first instance
+		uint32 quadCount = 0; //the instance count
+		uint32 textureSlot = 0;
+		uint32 clipIndex = SMOK_RENDERER_GUI_NO_CLIP;
+	};
+
+	//defines the push constants of the GUI shaders
+	struct GUIQuad_PushConstants
+	{
+		glm::vec2 screenSize = glm::vec2(0.0f);
+		uint32 textureSlot = 0;
+		uint32 pad = 0;
+	};
+
+	//defines the stats of the last rendered frame
+	struct GUIQuadStats
+	{
+		uint32 quadCount = 0; //the quads drawn
+		uint32 drawCount = 0; //the draws they took
+		size_t uploadedBytes = 0; //the quad data copied to the GPU
+		bool uploadSkipped = false; //the frame's buffer already had the quads
+
+		//converts the stats into a human readable string
+		inline std::string ToString() const
+		{
+			return "GUI: " + std::to_string(quadCount) + " quads in " + std::to_string(drawCount) + " draws, " +
+				(uploadSkipped ? std::string("upload skipped") : std::to_string(uploadedBytes) + " bytes uploaded");
+		}
+	};
+
+	//packs a color into RGBA8
+	inline uint32 GUIQuad_PackColor(const glm::vec4& color)
+	{
+		auto toByte = [](const float c) { return (uint32)(std::min(std::max(c, 0.0f), 1.0f) * 255.0f + 0.5f); };
+		return toByte(color.x) | (toByte(color.y) << 8) | (toByte(color.z) << 16) | (toByte(color.w) << 24);
+	}
+
+	//makes a quad
+	inline GUIQuad GUIQuad_Create(const glm::vec4& rect, const glm::vec4& color, const uint32 textureSlot = 0,
+		const glm::vec4& uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), const uint32 clipIndex = SMOK_RENDERER_GUI_NO_CLIP, const uint32 layer = 0)
+	{
+		GUIQuad quad;
+		quad.rect = rect; quad.uvRect = uvRect;
+		quad.color = GUIQuad_PackColor(color);
+		quad.textureSlot = textureSlot; quad.clipIndex = clipIndex; quad.layer = layer;
+		return quad;
+	}
+
+	//points a quad at a image in a texture atlas || pageTextureSlot is the slot the entry's page was added to, the quad's UV rect is remapped into it
+	inline void GUIQuad_SetAtlasEntry(GUIQuad* quad, const Util::TextureAtlasEntry& entry, const uint32 pageTextureSlot)
+	{
+		quad->uvRect = Util::TextureAtlas_RemapUVRect(entry, quad->uvRect);
+		quad->textureSlot = pageTextureSlot;
+	}
+
+	//sorts the quads by layer, keeping the order they were added in inside a layer, and splits them into batches
+	//a new batch starts whenever the texture or clip rect changes, so draw order is kept
+	inline void GUIQuad_CalculateBatches(std::vector<GUIQuad>& quads, std::vector<GUIQuadBatch>& batches)
+	{
+		batches.clear();
+		if (quads.empty())
+			return;
+
+		std::stable_sort(quads.begin(), quads.end(), [](const GUIQuad& a, const GUIQuad& b) { return a.layer < b.layer; });
+
+		GUIQuadBatch* batch = nullptr;
+		for (uint32 i = 0; i < quads.size(); ++i)
+		{
+			if (!batch || batch->textureSlot != quads[i].textureSlot || batch->clipIndex != quads[i].clipIndex)
+			{
+				batch = &batches.emplace_back(GUIQuadBatch());
+				batch->firstQuad = i;
+				batch->textureSlot = quads[i].textureSlot;
+				batch->clipIndex = quads[i].clipIndex;
+			}
+
+			batch->quadCount++;
+		}
+	}
+
+	//gets the scissor of a clip rect, cut to the frame
+	inline VkRect2D GUIQuad_CalculateScissor(const std::vector<GUIClipRect>& clipRects, const uint32 clipIndex, const BTD_Math_U32Vec2& frameSize)
+	{
+		VkRect2D scissor = { { 0, 0 }, { frameSize.x, frameSize.y } };
+		if (clipIndex == SMOK_RENDERER_GUI_NO_CLIP || clipIndex >= clipRects.size())
+			return scissor;
+
+		const GUIClipRect& clip = clipRects[clipIndex];
+		const int64 minX = std::max((int64)clip.x, (int64)0), minY = std::max((int64)clip.y, (int64)0);
+		const int64 maxX = std::min((int64)clip.x + (int64)clip.width, (int64)frameSize.x);
+		const int64 maxY = std::min((int64)clip.y + (int64)clip.height, (int64)frameSize.y);
+
+		scissor.offset = { (int32)minX, (int32)minY };
+		scissor.extent = { (uint32)std::max(maxX - minX, (int64)0), (uint32)std::max(maxY - minY, (int64)0) };
+		return scissor;
+	}
+
+	//defines a GPU based GUI quad renderer
+	class GUIQuadRenderer
+	{
+		//vars
+	private:
+
+		VkDevice device = VK_NULL_HANDLE;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+
+		VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+		std::vector<VkDescriptorSet> descriptorSets; //per frame in flight
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		std::string vertexSPIRVPath = "", fragmentSPIRVPath = ""; //kept so the pipeline can be remade when the render pass changes
+
+		//per frame in flight
+		std::vector<Util::GPUBuffer> quadBuffers;
+		std::vector<VkBuffer> boundQuadBuffers; //the quad buffer each descriptor set points at
+		std::vector<uint64> uploadedVersions; //the content version in each quad buffer, 0 if unknown
+		std::vector<bool> texturesChanged; //the texture slots changed since the descriptor set was written
+
+		VkImageView textureViews[SMOK_RENDERER_GUI_TEXTURE_SLOTS];
+		VkSampler textureSamplers[SMOK_RENDERER_GUI_TEXTURE_SLOTS];
+		uint32 textureCount = 1; //slot 0 is the blank texture
+
+		GUIQuadStats stats; //the stats of the last rendered frame
+
+		Profiler* profiler = nullptr; //optional, times rendering
+
+		//methods
+	public:
+
+		//inits the renderer || the blank texture is slot 0, and fills the unused slots
+		inline bool Init(SMGraphics_Core_GPU* GPU, VmaAllocator _allocator, const uint32 framesInFlight, VkRenderPass renderPass,
+			const std::string& _vertexSPIRVPath, const std::string& _fragmentSPIRVPath,
+			VkImageView blankView, VkSampler blankSampler)
+		{
+			device = GPU->device; allocator = _allocator;
+			vertexSPIRVPath = _vertexSPIRVPath; fragmentSPIRVPath = _fragmentSPIRVPath;
+
+			for (uint32 i = 0; i < SMOK_RENDERER_GUI_TEXTURE_SLOTS; ++i)
+			{
+				textureViews[i] = blankView; textureSamplers[i] = blankSampler;
+			}
+			textureCount = 1;
+
+			//descriptor set layout || quads, textures
+			VkDescriptorSetLayoutBinding bindings[2] = {};
+			bindings[0].binding = 0;
+			bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[0].descriptorCount = 1;
+			bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+			bindings[1].binding = 1;
+			bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			bindings[1].descriptorCount = SMOK_RENDERER_GUI_TEXTURE_SLOTS;
+			bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+			VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutInfo.bindingCount = 2;
+			layoutInfo.pBindings = bindings;
+			if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "GUI Quad Renderer", "Init", "Failed to create the descriptor set layout!");
+				return false;
+			}
+
+			//descriptor pool and sets
+			VkDescriptorPoolSize poolSizes[2] = {};
+			poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			poolSizes[0].descriptorCount = framesInFlight;
+			poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			poolSizes[1].descriptorCount = SMOK_RENDERER_GUI_TEXTURE_SLOTS * framesInFlight;
+
+			VkDescriptorPoolCreateInfo poolInfo = {};
+			poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			poolInfo.maxSets = framesInFlight;
+			poolInfo.poolSizeCount = 2;
+			poolInfo.pPoolSizes = poolSizes;
+			if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "GUI Quad Renderer", "Init", "Failed to create the descriptor pool!");
+				return false;
+			}
+
+			std::vector<VkDescriptorSetLayout> layouts(framesInFlight, descriptorSetLayout);
+			descriptorSets.resize(framesInFlight);
+
+			VkDescriptorSetAllocateInfo allocInfo = {};
+			allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocInfo.descriptorPool = descriptorPool;
+			allocInfo.descriptorSetCount = framesInFlight;
+			allocInfo.pSetLayouts = layouts.data();
+			if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "GUI Quad Renderer", "Init", "Failed to allocate the descriptor sets!");
+				return false;
+			}
+
+			//pipeline
+			VkPushConstantRange pushConstantRange = {};
+			pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+			pushConstantRange.size = sizeof(GUIQuad_PushConstants);
+
+			VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+			pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			pipelineLayoutInfo.setLayoutCount = 1;
+			pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+			pipelineLayoutInfo.pushConstantRangeCount = 1;
+			pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+			if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "GUI Quad Renderer", "Init", "Failed to create the pipeline layout!");
+				return false;
+			}
+
+			if (!RemakePipeline(renderPass))
+				return false;
+
+			quadBuffers.resize(framesInFlight);
+			boundQuadBuffers.resize(framesInFlight, VK_NULL_HANDLE);
+			uploadedVersions.resize(framesInFlight, 0);
+			texturesChanged.resize(framesInFlight, true);
+
+			return true;
+		}
+
+		//shutsdown the renderer
+		inline void Shutdown()
+		{
+			if (device == VK_NULL_HANDLE)
+				return;
+
+			//wait for the GPU to finish
+			vkDeviceWaitIdle(device);
+
+			for (size_t i = 0; i < quadBuffers.size(); ++i)
+				Util::GPUBuffer_Destroy(&quadBuffers[i], allocator);
+			quadBuffers.clear(); boundQuadBuffers.clear(); uploadedVersions.clear();
+
+			if (pipeline != VK_NULL_HANDLE)
+				vkDestroyPipeline(device, pipeline, nullptr);
+			if (pipelineLayout != VK_NULL_HANDLE)
+				vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+			if (descriptorPool != VK_NULL_HANDLE)
+				vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+			if (descriptorSetLayout != VK_NULL_HANDLE)
+				vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+
+			pipeline = VK_NULL_HANDLE; pipelineLayout = VK_NULL_HANDLE;
+			descriptorPool = VK_NULL_HANDLE; descriptorSetLayout = VK_NULL_HANDLE;
+			device = VK_NULL_HANDLE;
+		}
+
+		//remakes the pipeline against a new render pass || the GPU must be done with the old one
+		inline bool RemakePipeline(VkRenderPass renderPass)
+		{
+			if (pipeline != VK_NULL_HANDLE)
+				vkDestroyPipeline(device, pipeline, nullptr);
+
+			pipeline = Util::ProceduralGraphicsPipeline_CreateFromFiles(device, vertexSPIRVPath, fragmentSPIRVPath, pipelineLayout, renderPass);
+			return pipeline != VK_NULL_HANDLE;
+		}
+
+		//adds a texture, returning it's slot || a texture already added gets it's old slot, a full table gets the blank slot
+		inline uint32 AddTexture(VkImageView view, VkSampler sampler)
+		{
+			for (uint32 i = 0; i < textureCount; ++i)
+			{
+				if (textureViews[i] == view && textureSamplers[i] == sampler)
+					return i;
+			}
+
+			if (textureCount >= SMOK_RENDERER_GUI_TEXTURE_SLOTS)
+			{
+				BTD_LogError("Smok Renderer", "GUI Quad Renderer", "AddTexture", "Out of texture slots, the blank texture is used instead!");
+				return 0;
+			}
+
+			textureViews[textureCount] = view; textureSamplers[textureCount] = sampler;
+			texturesChanged.assign(texturesChanged.size(), true);
+			return textureCount++;
+		}
+
+		//gets the stats of the last rendered frame
+		inline const GUIQuadStats& GetStats() const { return stats; }
+
+		//sets the profiler the renderer's CPU and GPU scopes go to || nullptr turns profiling off
+		inline void SetProfiler(Profiler* _profiler) { profiler = _profiler; }
+
+		//calculates the batches || sorts the quads by layer
+		inline void CalculateCommandData(std::vector<GUIQuad>& quads, std::vector<GUIQuadBatch>& batches)
+		{
+			ProfilerCPUScope cpuScope(profiler, "GUI Calculate Command Data");
+			GUIQuad_CalculateBatches(quads, batches);
+		}
+
+		//renders || call inside a render pass made against the one the pipeline was made with
+		//contentVersion is bumped by the caller whenever the quads change, the upload is skipped if the frame's buffer
+		//already has that version, 0 always uploads
+		inline void Render(VkCommandBuffer& comBuffer, Frame& frame,
+			const std::vector<GUIQuad>& quads, const std::vector<GUIQuadBatch>& batches,
+			const std::vector<GUIClipRect>& clipRects, const uint64 contentVersion = 0)
+		{
+			stats = GUIQuadStats();
+			if (quads.empty() || batches.empty() || pipeline == VK_NULL_HANDLE)
+				return;
+
+			ProfilerCPUScope cpuScope(profiler, "GUI Render");
+			ProfilerGPUScope gpuScope(profiler, comBuffer, "GUI Render");
+
+			//the frame's fence was waited on, so it's buffer is free
+			const uint32 frameIndex = frame.currentFrame % (uint32)quadBuffers.size();
+			const size_t quadBytes = sizeof(GUIQuad) * quads.size();
+			if (contentVersion != 0 && uploadedVersions[frameIndex] == contentVersion)
+				stats.uploadSkipped = true;
+			else
+			{
+				if (!Util::GPUBuffer_EnsureSize(&quadBuffers[frameIndex], allocator, quadBytes,
+					VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU))
+				{
+					uploadedVersions[frameIndex] = 0;
+					return;
+				}
+				Dispatch_RecordUpload(frame.dispatch, (uint64)quadBuffers[frameIndex].buffer, 0, quads.data(), quadBytes);
+				if (Dispatch_IsExecuting(frame.dispatch))
+					Util::GPUBuffer_Write(&quadBuffers[frameIndex], allocator, quads.data(), quadBytes);
+				uploadedVersions[frameIndex] = contentVersion;
+				stats.uploadedBytes = quadBytes;
+				if (frame.stats)
+					frame.stats->GUIQuadBytes += quadBytes;
+			}
+
+			//rewrites the descriptor set if the buffer was remade or a texture was added
+			if (boundQuadBuffers[frameIndex] != quadBuffers[frameIndex].buffer || texturesChanged[frameIndex])
+			{
+				VkDescriptorBufferInfo bufferInfo = { quadBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+				VkDescriptorImageInfo imageInfos[SMOK_RENDERER_GUI_TEXTURE_SLOTS];
+				for (uint32 i = 0; i < SMOK_RENDERER_GUI_TEXTURE_SLOTS; ++i)
+					imageInfos[i] = { textureSamplers[i], textureViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+				VkWriteDescriptorSet writes[2] = {};
+				writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[0].dstSet = descriptorSets[frameIndex];
+				writes[0].dstBinding = 0;
+				writes[0].descriptorCount = 1;
+				writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				writes[0].pBufferInfo = &bufferInfo;
+				writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[1].dstSet = descriptorSets[frameIndex];
+				writes[1].dstBinding = 1;
+				writes[1].descriptorCount = SMOK_RENDERER_GUI_TEXTURE_SLOTS;
+				writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				writes[1].pImageInfo = imageInfos;
+				Dispatch_UpdateDescriptorSets(frame.dispatch, device, 2, writes);
+
+				boundQuadBuffers[frameIndex] = quadBuffers[frameIndex].buffer;
+				texturesChanged[frameIndex] = false;
+				if (frame.stats)
+					frame.stats->descriptorUpdateCount++;
+			}
+
+			Dispatch_CmdBindPipeline(frame.dispatch, comBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			Dispatch_CmdBindDescriptorSets(frame.dispatch, comBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
+				&descriptorSets[frameIndex]);
+
+			VkViewport viewport = { 0.0f, 0.0f, (float)frame.frameSize.x, (float)frame.frameSize.y, 0.0f, 1.0f };
+			Dispatch_CmdSetViewport(frame.dispatch, comBuffer, viewport);
+
+			GUIQuad_PushConstants pc;
+			pc.screenSize = glm::vec2((float)frame.frameSize.x, (float)frame.frameSize.y);
+
+			//one instanced draw per batch, the scissor and texture slot only change between them
+			uint32 lastClipIndex = SMOK_RENDERER_GUI_NO_CLIP - 1;
+			for (size_t b = 0; b < batches.size(); ++b)
+			{
+				const GUIQuadBatch& batch = batches[b];
+				if (!batch.quadCount)
+					continue;
+
+				if (batch.clipIndex != lastClipIndex)
+				{
+					const VkRect2D scissor = GUIQuad_CalculateScissor(clipRects, batch.clipIndex, frame.frameSize);
+					Dispatch_CmdSetScissor(frame.dispatch, comBuffer, scissor);
+					lastClipIndex = batch.clipIndex;
+				}
+
+				pc.textureSlot = (batch.textureSlot < SMOK_RENDERER_GUI_TEXTURE_SLOTS ? batch.textureSlot : 0);
+				Dispatch_CmdPushConstants(frame.dispatch, comBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+					0, sizeof(GUIQuad_PushConstants), &pc);
+
+				Dispatch_CmdDraw(frame.dispatch, comBuffer, 6, batch.quadCount, 0, batch.firstQuad);
+				stats.quadCount += batch.quadCount;
+				stats.drawCount++;
+				if (frame.stats)
+					frame.stats->AddDraw(6, batch.quadCount);
+			}
+
+			if (frame.stats)
+			{
+				frame.stats->batchCount += stats.drawCount;
+				frame.stats->pipelineBindCount++;
+				frame.stats->descriptorBindCount++;
+			}
+		}
+
+		//adds the GUI pass to a render graph, drawing over the color target
+		//renderPass has to load the color target, the GUI is drawn on top of what's there || the frame, quads, batches and clip rects
+		//are read when the graph is executed, so they have to live until then, returns the pass
+		//colorFinalLayout is the layout renderPass leaves the color target in, the swapchain's render pass ends in PRESENT_SRC
+		inline uint32 AddRenderGraphPass(RenderGraph* graph, Frame* frame, const uint32 colorTarget, VkRenderPass renderPass,
+			const std::vector<GUIQuad>* quads, const std::vector<GUIQuadBatch>* batches, const std::vector<GUIClipRect>* clipRects,
+			const VkImageLayout colorFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+		{
+			const uint32 pass = RenderGraph_AddPass(graph, "GUI", [this, frame, quads, batches, clipRects](VkCommandBuffer comBuffer) {
+				Render(comBuffer, *frame, *quads, *batches, *clipRects);
+			});
+			RenderGraph_Write(graph, pass, colorTarget, RenderGraph_Access::ColorAttachment);
+			RenderGraph_SetRenderPass(graph, pass, renderPass, frame->framebuffer, { frame->frameSize.x, frame->frameSize.y }, {});
+			RenderGraph_SetAttachmentFinalLayout(graph, pass, colorTarget, colorFinalLayout);
+
+			return pass;
+		}
+	};
+}
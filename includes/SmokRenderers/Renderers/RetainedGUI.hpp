@@ -0,0 +1,219 @@
+#pragma once
+
+//defines retained GUI layers on top of the GUI quad renderer
+//each layer caches it's quads and batches, only dirty layers are re-batched and the quads are only uploaded when something changed
+
+#include <SmokRenderers/Renderers/GUIQuadRenderer.hpp>
+
+namespace Smok::Renderers::GPUBased::GUIRenderer
+{
+	//defines a retained GUI layer || the quad's clip indices point into the layer's own clip rects
+	struct GUILayer
+	{
+		std::string name = "";
+		int32 order = 0; //lower orders draw first
+		bool isVisible = true;
+		bool isDirty = true; //the quads changed since the batches were made
+
+		std::vector<GUIQuad> quads;
+		std::vector<GUIClipRect> clipRects;
+
+		//cached by the last rebuild
+		std::vector<GUIQuadBatch> batches; //first quad is into this layer's quads
+	};
+
+	//defines the rebuild stats of a frame
+	struct RetainedGUIStats
+	{
+		uint32 layerCount = 0; //the visible layers
+		uint32 rebuiltLayerCount = 0; //the layers re-batched
+		uint32 rebuiltQuadCount = 0; //the quads in the re-batched layers
+		uint32 quadCount = 0; //the quads drawn
+		bool wasCombined = false; //the layers were merged into new draw data
+
+		//converts the stats into a human readable string
+		inline std::string ToString() const
+		{
+			return "Retained GUI: " + std::to_string(rebuiltLayerCount) + "/" + std::to_string(layerCount) + " layers rebuilt, " +
+				std::to_string(rebuiltQuadCount) + "/" + std::to_string(quadCount) + " quads rebuilt" + (wasCombined ? "" : ", draw data reused");
+		}
+	};
+
+	//defines a set of retained GUI layers
+	struct RetainedGUI
+	{
+		std::vector<GUILayer> layers;
+		bool layoutChanged = true; //a layer was added, removed, reordered or shown/hidden
+
+		//the combined draw data of every visible layer
+		std::vector<GUIQuad> quads;
+		std::vector<GUIQuadBatch> batches;
+		std::vector<GUIClipRect> clipRects;
+		uint64 version = 0; //bumped every time the combined draw data changes, never 0 once built
+
+		RetainedGUIStats stats; //the stats of the last update
+	};
+
+	//adds a layer, returns it's index
+	inline uint32 RetainedGUI_AddLayer(RetainedGUI* gui, const std::string& name, const int32 order = 0)
+	{
+		GUILayer& layer = gui->layers.emplace_back(GUILayer());
+		layer.name = name; layer.order = order;
+		gui->layoutChanged = true;
+		return (uint32)gui->layers.size() - 1;
+	}
+
+	//gets a layer by name, returns nullptr if it doesn't exist
+	inline GUILayer* RetainedGUI_GetLayer(RetainedGUI* gui, const std::string& name)
+	{
+		for (size_t i = 0; i < gui->layers.size(); ++i)
+		{
+			if (gui->layers[i].name == name)
+				return &gui->layers[i];
+		}
+
+		return nullptr;
+	}
+
+	//gets a layer for editing, marking it dirty || returns nullptr if the index is bad
+	inline GUILayer* RetainedGUI_EditLayer(RetainedGUI* gui, const uint32 layer)
+	{
+		if (layer >= gui->layers.size())
+		{
+			BTD_LogError("Smok Renderer", "Retained GUI", "RetainedGUI_EditLayer", "Layer index is out of range!");
+			return nullptr;
+		}
+
+		gui->layers[layer].isDirty = true;
+		return &gui->layers[layer];
+	}
+
+	//replaces a layer's quads and clip rects
+	inline void RetainedGUI_SetLayer(RetainedGUI* gui, const uint32 layer, const std::vector<GUIQuad>& quads,
+		const std::vector<GUIClipRect>& clipRects = {})
+	{
+		GUILayer* l = RetainedGUI_EditLayer(gui, layer);
+		if (!l)
+			return;
+
+		l->quads = quads;
+		l->clipRects = clipRects;
+	}
+
+	//shows or hides a layer, this doesn't re-batch it
+	inline void RetainedGUI_SetLayerVisible(RetainedGUI* gui, const uint32 layer, const bool isVisible)
+	{
+		if (layer >= gui->layers.size() || gui->layers[layer].isVisible == isVisible)
+			return;
+
+		gui->layers[layer].isVisible = isVisible;
+		gui->layoutChanged = true;
+	}
+
+	//sets the order of a layer, this doesn't re-batch it
+	inline void RetainedGUI_SetLayerOrder(RetainedGUI* gui, const uint32 layer, const int32 order)
+	{
+		if (layer >= gui->layers.size() || gui->layers[layer].order == order)
+			return;
+
+		gui->layers[layer].order = order;
+		gui->layoutChanged = true;
+	}
+
+	//removes a layer || the indices of the layers after it move down by one
+	inline void RetainedGUI_RemoveLayer(RetainedGUI* gui, const uint32 layer)
+	{
+		if (layer >= gui->layers.size())
+			return;
+
+		gui->layers.erase(gui->layers.begin() + layer);
+		gui->layoutChanged = true;
+	}
+
+	//re-batches the dirty layers and combines the layers if anything changed, call once a frame before rendering
+	inline void RetainedGUI_Update(RetainedGUI* gui)
+	{
+		RetainedGUIStats& stats = gui->stats;
+		stats = RetainedGUIStats();
+
+		//re-batches the dirty layers
+		bool anyRebuilt = false;
+		for (size_t i = 0; i < gui->layers.size(); ++i)
+		{
+			GUILayer& layer = gui->layers[i];
+			if (!layer.isDirty)
+				continue;
+
+			GUIQuad_CalculateBatches(layer.quads, layer.batches);
+			layer.isDirty = false;
+			anyRebuilt |= layer.isVisible;
+
+			stats.rebuiltLayerCount++;
+			stats.rebuiltQuadCount += (uint32)layer.quads.size();
+		}
+
+		//draws the layers by order, keeping the order they were added in for equal orders
+		std::vector<uint32> drawOrder;
+		drawOrder.reserve(gui->layers.size());
+		for (uint32 i = 0; i < gui->layers.size(); ++i)
+		{
+			if (gui->layers[i].isVisible)
+				drawOrder.emplace_back(i);
+		}
+		std::stable_sort(drawOrder.begin(), drawOrder.end(), [gui](const uint32 a, const uint32 b) {
+			return gui->layers[a].order < gui->layers[b].order;
+		});
+		stats.layerCount = (uint32)drawOrder.size();
+
+		if (!anyRebuilt && !gui->layoutChanged)
+		{
+			stats.quadCount = (uint32)gui->quads.size();
+			return;
+		}
+
+		//combines the cached layers, the batches are only offset, not remade
+		gui->quads.clear(); gui->batches.clear(); gui->clipRects.clear();
+		for (size_t i = 0; i < drawOrder.size(); ++i)
+		{
+			const GUILayer& layer = gui->layers[drawOrder[i]];
+			const uint32 quadBase = (uint32)gui->quads.size(), clipBase = (uint32)gui->clipRects.size();
+
+			gui->quads.insert(gui->quads.end(), layer.quads.begin(), layer.quads.end());
+			gui->clipRects.insert(gui->clipRects.end(), layer.clipRects.begin(), layer.clipRects.end());
+			for (size_t b = 0; b < layer.batches.size(); ++b)
+			{
+				GUIQuadBatch batch = layer.batches[b];
+				batch.firstQuad += quadBase;
+				if (batch.clipIndex != SMOK_RENDERER_GUI_NO_CLIP)
+					batch.clipIndex = (batch.clipIndex < layer.clipRects.size() ? batch.clipIndex + clipBase : SMOK_RENDERER_GUI_NO_CLIP);
+				gui->batches.emplace_back(batch);
+			}
+		}
+
+		gui->layoutChanged = false;
+		gui->version++;
+		stats.quadCount = (uint32)gui->quads.size();
+		stats.wasCombined = true;
+	}
+
+	//renders the GUI || call RetainedGUI_Update first, the upload is skipped if the frame's buffer already has the draw data
+	inline void RetainedGUI_Render(RetainedGUI* gui, GUIQuadRenderer* renderer, VkCommandBuffer& comBuffer, Frame& frame)
+	{
+		renderer->Render(comBuffer, frame, gui->quads, gui->batches, gui->clipRects, gui->version);
+	}
+
+	//adds the GUI pass to a render graph, drawing over the color target || the GUI and frame are read when the graph is executed
+	//colorFinalLayout is the layout renderPass leaves the color target in
+	inline uint32 RetainedGUI_AddRenderGraphPass(RetainedGUI* gui, GUIQuadRenderer* renderer, RenderGraph* graph, Frame* frame,
+		const uint32 colorTarget, VkRenderPass renderPass, const VkImageLayout colorFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+	{
+		const uint32 pass = RenderGraph_AddPass(graph, "Retained GUI", [gui, renderer, frame](VkCommandBuffer comBuffer) {
+			RetainedGUI_Render(gui, renderer, comBuffer, *frame);
+		});
+		RenderGraph_Write(graph, pass, colorTarget, RenderGraph_Access::ColorAttachment);
+		RenderGraph_SetRenderPass(graph, pass, renderPass, frame->framebuffer, { frame->frameSize.x, frame->frameSize.y }, {});
+		RenderGraph_SetAttachmentFinalLayout(graph, pass, colorTarget, colorFinalLayout);
+
+		return pass;
+	}
+}
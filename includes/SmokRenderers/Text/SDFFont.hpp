@@ -0,0 +1,347 @@
+#pragma once
+
+//defines a signed distance field font, one atlas of glyph distance fields serves every text size
+//the glyph bitmaps come from the caller's rasterizer (FreeType, stb_truetype, a baked sheet), made at the font's base size
+//the font's metrics are saved in a decl file and it's atlas in a binary file, so it can be made offline and loaded at runtime
+
+#include <SmokRenderers/Util/StagingRing.hpp>
+
+#include <SmokGraphics/Pipeline/GraphicsPipeline.hpp>
+
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <cmath>
+
+namespace Smok::Renderers::Text
+{
+	//the default distance in pixels the field spreads past a glyph's edge
+#define SMOK_RENDERER_SDF_FONT_DEFAULT_SPREAD 4
+
+	//defines a glyph bitmap from the caller's rasterizer || 8 bit coverage, 255 is inside
+	struct GlyphBitmap
+	{
+		uint32 codepoint = 0;
+		uint32 width = 0, height = 0;
+		std::vector<uint8> coverage; //row major, width * height
+
+		int32 bearingX = 0, bearingY = 0; //from the pen to the bitmap's top left, y up
+		float advance = 0.0f; //how far the pen moves
+	};
+
+	//defines a glyph in the atlas || metrics are in pixels at the base size, the rect includes the spread
+	struct SDFFont_Glyph
+	{
+		uint32 codepoint = 0;
+		uint32 atlasX = 0, atlasY = 0, width = 0, height = 0;
+		glm::vec4 uvRect = glm::vec4(0.0f); //the top left and bottom right UVs
+
+		float bearingX = 0.0f, bearingY = 0.0f; //from the pen to the rect's top left, y up
+		float advance = 0.0f;
+	};
+
+	//defines a signed distance field font
+	struct SDFFont
+	{
+		std::string name = "";
+		float baseSize = 32.0f; //the pixel size the glyphs were rasterized at
+		float lineHeight = 38.0f; //the distance between baselines at the base size
+		uint32 spread = SMOK_RENDERER_SDF_FONT_DEFAULT_SPREAD;
+
+		uint32 atlasWidth = 0, atlasHeight = 0;
+		std::vector<uint8> atlas; //R8, 128 is the glyph edge, higher is inside
+
+		std::unordered_map<uint32, SDFFont_Glyph> glyphs; //by codepoint
+		uint32 fallbackCodepoint = '?'; //drawn for codepoints the font doesn't have
+	};
+
+	//the squared distance transform of one row or column || Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions"
+	inline void SDFFont_DistanceTransform1D(const float* f, float* d, const uint32 n, std::vector<uint32>& v, std::vector<float>& z)
+	{
+		const float inf = 1e20f;
+		v.resize(n); z.resize(n + 1);
+
+		uint32 k = 0;
+		v[0] = 0; z[0] = -inf; z[1] = inf;
+		for (uint32 q = 1; q < n; ++q)
+		{
+			float s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (2.0f * (float)q - 2.0f * (float)v[k]);
+			while (s <= z[k])
+			{
+				k--;
+				s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (2.0f * (float)q - 2.0f * (float)v[k]);
+			}
+
+			k++;
+			v[k] = q; z[k] = s; z[k + 1] = inf;
+		}
+
+		k = 0;
+		for (uint32 q = 0; q < n; ++q)
+		{
+			while (z[k + 1] < (float)q)
+				k++;
+			d[q] = ((float)q - (float)v[k]) * ((float)q - (float)v[k]) + f[v[k]];
+		}
+	}
+
+	//the squared distance of every pixel to the nearest pixel marked 0 || grid is width * height, 0 or a large value, done in place
+	inline void SDFFont_DistanceTransform2D(std::vector<float>& grid, const uint32 width, const uint32 height)
+	{
+		std::vector<float> f(std::max(width, height)), d(std::max(width, height));
+		std::vector<uint32> v; std::vector<float> z;
+
+		//columns then rows
+		for (uint32 x = 0; x < width; ++x)
+		{
+			for (uint32 y = 0; y < height; ++y)
+				f[y] = grid[(size_t)y * width + x];
+			SDFFont_DistanceTransform1D(f.data(), d.data(), height, v, z);
+			for (uint32 y = 0; y < height; ++y)
+				grid[(size_t)y * width + x] = d[y];
+		}
+
+		for (uint32 y = 0; y < height; ++y)
+		{
+			SDFFont_DistanceTransform1D(&grid[(size_t)y * width], d.data(), width, v, z);
+			memcpy(&grid[(size_t)y * width], d.data(), sizeof(float) * width);
+		}
+	}
+
+	//makes the distance field of a glyph bitmap, padded by the spread on every side || 128 is the edge, higher is inside
+	inline void SDFFont_GenerateDistanceField(const GlyphBitmap& glyph, const uint32 spread,
+		std::vector<uint8>& field, uint32& fieldWidth, uint32& fieldHeight)
+	{
+		fieldWidth = glyph.width + spread * 2; fieldHeight = glyph.height + spread * 2;
+		const size_t pixelCount = (size_t)fieldWidth * (size_t)fieldHeight;
+
+		//the distance to the nearest inside pixel, and to the nearest outside pixel
+		const float inf = 1e20f;
+		std::vector<float> toInside(pixelCount, inf), toOutside(pixelCount, 0.0f);
+		for (uint32 y = 0; y < glyph.height; ++y)
+		{
+			for (uint32 x = 0; x < glyph.width; ++x)
+			{
+				if (glyph.coverage[(size_t)y * glyph.width + x] < 128)
+					continue;
+
+				const size_t i = (size_t)(y + spread) * fieldWidth + (x + spread);
+				toInside[i] = 0.0f; toOutside[i] = inf;
+			}
+		}
+
+		SDFFont_DistanceTransform2D(toInside, fieldWidth, fieldHeight);
+		SDFFont_DistanceTransform2D(toOutside, fieldWidth, fieldHeight);
+
+		//the spread maps to the full 0 to 255 range
+		field.resize(pixelCount);
+		const float scale = 0.5f / (float)std::max(spread, (uint32)1);
+		for (size_t i = 0; i < pixelCount; ++i)
+		{
+			const float signedDistance = std::sqrt(toOutside[i]) - std::sqrt(toInside[i]);
+			const float value = std::min(std::max(0.5f + signedDistance * scale, 0.0f), 1.0f);
+			field[i] = (uint8)(value * 255.0f + 0.5f);
+		}
+	}
+
+	//builds a font from glyph bitmaps, packing their distance fields into one atlas
+	//the atlas is atlasWidth wide and grows to the power of two height that fits
+	inline bool SDFFont_Build(SDFFont* font, const std::string& name, const std::vector<GlyphBitmap>& glyphBitmaps,
+		const float baseSize, const float lineHeight, const uint32 spread = SMOK_RENDERER_SDF_FONT_DEFAULT_SPREAD, const uint32 atlasWidth = 512)
+	{
+		font->name = name; font->baseSize = baseSize; font->lineHeight = lineHeight; font->spread = spread;
+		font->glyphs.clear();
+
+		//makes the fields
+		struct Field { uint32 glyph = 0, width = 0, height = 0; std::vector<uint8> pixels; };
+		std::vector<Field> fields(glyphBitmaps.size());
+		for (size_t i = 0; i < glyphBitmaps.size(); ++i)
+		{
+			if (glyphBitmaps[i].coverage.size() < (size_t)glyphBitmaps[i].width * (size_t)glyphBitmaps[i].height)
+			{
+				BTD_LogError("Smok Renderer", "SDF Font", "SDFFont_Build",
+					std::string("Glyph " + std::to_string(glyphBitmaps[i].codepoint) + " in \"" + name + "\" has less coverage then it's size!").c_str());
+				return false;
+			}
+
+			fields[i].glyph = (uint32)i;
+			SDFFont_GenerateDistanceField(glyphBitmaps[i], spread, fields[i].pixels, fields[i].width, fields[i].height);
+			if (fields[i].width > atlasWidth)
+			{
+				BTD_LogError("Smok Renderer", "SDF Font", "SDFFont_Build",
+					std::string("Glyph " + std::to_string(glyphBitmaps[i].codepoint) + " in \"" + name + "\" is wider then the atlas!").c_str());
+				return false;
+			}
+		}
+
+		//packs tallest first into shelves, with a pixel of padding so linear filtering doesn't bleed
+		std::sort(fields.begin(), fields.end(), [](const Field& a, const Field& b) { return a.height > b.height; });
+		uint32 penX = 0, penY = 0, shelfHeight = 0;
+		std::vector<glm::uvec2> positions(fields.size());
+		for (size_t i = 0; i < fields.size(); ++i)
+		{
+			if (penX + fields[i].width > atlasWidth)
+			{
+				penX = 0; penY += shelfHeight + 1; shelfHeight = 0;
+			}
+
+			positions[i] = glm::uvec2(penX, penY);
+			penX += fields[i].width + 1;
+			shelfHeight = std::max(shelfHeight, fields[i].height);
+		}
+
+		uint32 atlasHeight = 1;
+		while (atlasHeight < penY + shelfHeight)
+			atlasHeight *= 2;
+
+		font->atlasWidth = atlasWidth; font->atlasHeight = atlasHeight;
+		font->atlas.assign((size_t)atlasWidth * (size_t)atlasHeight, 0);
+
+		//copies the fields and makes the glyphs
+		for (size_t i = 0; i < fields.size(); ++i)
+		{
+			const Field& field = fields[i];
+			const GlyphBitmap& bitmap = glyphBitmaps[field.glyph];
+			for (uint32 y = 0; y < field.height; ++y)
+				memcpy(&font->atlas[(size_t)(positions[i].y + y) * atlasWidth + positions[i].x], &field.pixels[(size_t)y * field.width], field.width);
+
+			SDFFont_Glyph glyph;
+			glyph.codepoint = bitmap.codepoint;
+			glyph.atlasX = positions[i].x; glyph.atlasY = positions[i].y;
+			glyph.width = field.width; glyph.height = field.height;
+			glyph.bearingX = (float)bitmap.bearingX - (float)spread;
+			glyph.bearingY = (float)bitmap.bearingY + (float)spread;
+			glyph.advance = bitmap.advance;
+			font->glyphs[glyph.codepoint] = glyph;
+		}
+
+		//UVs
+		for (auto& [codepoint, glyph] : font->glyphs)
+		{
+			glyph.uvRect = glm::vec4((float)glyph.atlasX / (float)atlasWidth, (float)glyph.atlasY / (float)atlasHeight,
+				(float)(glyph.atlasX + glyph.width) / (float)atlasWidth, (float)(glyph.atlasY + glyph.height) / (float)atlasHeight);
+		}
+
+		return true;
+	}
+
+	//gets a glyph, or the fallback if the font doesn't have it || returns nullptr if neither exist
+	inline const SDFFont_Glyph* SDFFont_GetGlyph(const SDFFont* font, const uint32 codepoint)
+	{
+		auto glyph = font->glyphs.find(codepoint);
+		if (glyph != font->glyphs.end())
+			return &glyph->second;
+
+		glyph = font->glyphs.find(font->fallbackCodepoint);
+		return (glyph != font->glyphs.end() ? &glyph->second : nullptr);
+	}
+
+	//writes a decl file for a font and it's atlas binary
+	inline bool SDFFont_WriteDeclFile(const SDFFont* font, const std::string& declFilePath, const std::string& atlasBinaryPath)
+	{
+		YAML::Emitter emitter;
+
+		emitter << YAML::BeginMap;
+
+		emitter << YAML::Key << "assetName" << YAML::DoubleQuoted << font->name;
+		emitter << YAML::Key << "atlasBinaryPath" << YAML::DoubleQuoted << atlasBinaryPath;
+		emitter << YAML::Key << "baseSize" << font->baseSize;
+		emitter << YAML::Key << "lineHeight" << font->lineHeight;
+		emitter << YAML::Key << "spread" << font->spread;
+		emitter << YAML::Key << "atlasWidth" << font->atlasWidth;
+		emitter << YAML::Key << "atlasHeight" << font->atlasHeight;
+		emitter << YAML::Key << "fallbackCodepoint" << font->fallbackCodepoint;
+
+		emitter << YAML::Key << "glyphs" << YAML::BeginSeq;
+		for (const auto& [codepoint, glyph] : font->glyphs)
+		{
+			emitter << YAML::Flow << YAML::BeginSeq << glyph.codepoint << glyph.atlasX << glyph.atlasY << glyph.width << glyph.height
+				<< glyph.bearingX << glyph.bearingY << glyph.advance << YAML::EndSeq;
+		}
+		emitter << YAML::EndSeq;
+
+		emitter << YAML::EndMap;
+
+		BTD::IO::File file; file.Open(declFilePath, BTD::IO::FileOP::TextWrite_OpenCreateStart);
+		file.Write(emitter.c_str());
+		file.Close();
+
+		//the atlas is raw R8 pixels
+		std::ofstream atlasFile(atlasBinaryPath, std::ios::binary);
+		if (!atlasFile.is_open())
+		{
+			BTD_LogError("Smok Renderer", "SDF Font", "SDFFont_WriteDeclFile",
+				std::string("Failed to write the atlas binary at \"" + atlasBinaryPath + "\"").c_str());
+			return false;
+		}
+		atlasFile.write((const char*)font->atlas.data(), (std::streamsize)font->atlas.size());
+
+		return true;
+	}
+
+	//loads a font from it's decl file and atlas binary
+	inline bool SDFFont_LoadDeclFile(SDFFont* font, const std::string& declFilePath)
+	{
+		YAML::Node data = YAML::LoadFile(declFilePath);
+		if (!data)
+		{
+			BTD_LogError("Smok Renderer", "SDF Font", "SDFFont_LoadDeclFile",
+				std::string("Failed to load a font decl file at \"" + declFilePath + "\"").c_str());
+			return false;
+		}
+
+		*font = SDFFont();
+		font->name = data["assetName"].as<std::string>();
+		const std::string atlasBinaryPath = data["atlasBinaryPath"].as<std::string>();
+		font->baseSize = data["baseSize"].as<float>();
+		font->lineHeight = data["lineHeight"].as<float>();
+		font->spread = data["spread"].as<uint32>();
+		font->atlasWidth = data["atlasWidth"].as<uint32>();
+		font->atlasHeight = data["atlasHeight"].as<uint32>();
+		font->fallbackCodepoint = data["fallbackCodepoint"].as<uint32>();
+
+		YAML::Node glyphs = data["glyphs"];
+		for (size_t i = 0; i < glyphs.size(); ++i)
+		{
+			YAML::Node g = glyphs[i];
+
+			SDFFont_Glyph glyph;
+			glyph.codepoint = g[(size_t)0].as<uint32>();
+			glyph.atlasX = g[(size_t)1].as<uint32>(); glyph.atlasY = g[(size_t)2].as<uint32>();
+			glyph.width = g[(size_t)3].as<uint32>(); glyph.height = g[(size_t)4].as<uint32>();
+			glyph.bearingX = g[(size_t)5].as<float>(); glyph.bearingY = g[(size_t)6].as<float>();
+			glyph.advance = g[(size_t)7].as<float>();
+			glyph.uvRect = glm::vec4((float)glyph.atlasX / (float)font->atlasWidth, (float)glyph.atlasY / (float)font->atlasHeight,
+				(float)(glyph.atlasX + glyph.width) / (float)font->atlasWidth, (float)(glyph.atlasY + glyph.height) / (float)font->atlasHeight);
+			font->glyphs[glyph.codepoint] = glyph;
+		}
+
+		std::ifstream atlasFile(atlasBinaryPath, std::ios::binary);
+		font->atlas.resize((size_t)font->atlasWidth * (size_t)font->atlasHeight);
+		if (!atlasFile.is_open() || !atlasFile.read((char*)font->atlas.data(), (std::streamsize)font->atlas.size()))
+		{
+			BTD_LogError("Smok Renderer", "SDF Font", "SDFFont_LoadDeclFile",
+				std::string("Failed to load the atlas binary at \"" + atlasBinaryPath + "\"").c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	//creates the font's atlas on the GPU || upload it with Util::GPUImage_RecordUpload or Util::GPUImage_UploadNow before it's sampled
+	//with a staging ring the upload is queued into it instead, and is done once the ring is flushed
+	inline bool SDFFont_CreateGPUAtlas(Util::GPUImage* GPUAtlas, const SDFFont* font, VkDevice device, VmaAllocator allocator,
+		Util::StagingRing* stagingRing = nullptr)
+	{
+		const bool staged = Util::StagingRing_IsValid(stagingRing);
+		if (!Util::GPUImage_Create(GPUAtlas, device, allocator, VK_FORMAT_R8_UNORM, font->atlasWidth, font->atlasHeight,
+			(staged ? nullptr : font->atlas.data()), font->atlas.size()) ||
+			(staged && !Util::StagingRing_UploadImage(stagingRing, GPUAtlas, font->atlas.data(), font->atlas.size())))
+		{
+			BTD_LogError("Smok Renderer", "SDF Font", "SDFFont_CreateGPUAtlas", std::string("Failed to create the atlas of \"" + font->name + "\"").c_str());
+			return false;
+		}
+
+		return true;
+	}
+}
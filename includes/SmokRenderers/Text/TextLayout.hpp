@@ -0,0 +1,191 @@
+#pragma once
+
+//defines laying out strings with a SDF font into GUI quads, and a cache of layouts keyed by font, size and string
+//every glyph of a font samples the same atlas, so a string is one GUI batch and one draw
+
+#include <SmokRenderers/Text/SDFFont.hpp>
+#include <SmokRenderers/Renderers/GUIQuadRenderer.hpp>
+
+namespace Smok::Renderers::Text
+{
+	//defines a laid out string || the quads are relative to the pen's start on the first baseline, with y down
+	struct TextLayout
+	{
+		std::vector<Smok::Renderers::GPUBased::GUIRenderer::GUIQuad> quads;
+		float width = 0.0f, height = 0.0f; //the size of the text's box
+		float ascent = 0.0f; //from the top of the box to the first baseline
+	};
+
+	//decodes the next codepoint of a UTF-8 string || bad bytes are returned as U+FFFD
+	inline uint32 Text_DecodeUTF8(const std::string& text, size_t& i)
+	{
+		const uint8 c = (uint8)text[i++];
+		if (c < 0x80)
+			return c;
+
+		uint32 length = 0, codepoint = 0;
+		if ((c & 0xE0) == 0xC0) { length = 1; codepoint = c & 0x1F; }
+		else if ((c & 0xF0) == 0xE0) { length = 2; codepoint = c & 0x0F; }
+		else if ((c & 0xF8) == 0xF0) { length = 3; codepoint = c & 0x07; }
+		else
+			return 0xFFFD;
+
+		for (uint32 b = 0; b < length; ++b)
+		{
+			if (i >= text.size() || ((uint8)text[i] & 0xC0) != 0x80)
+				return 0xFFFD;
+			codepoint = (codepoint << 6) | ((uint8)text[i++] & 0x3F);
+		}
+
+		return codepoint;
+	}
+
+	//lays out a string at a pixel size || '\n' starts a new line, glyphs are placed by their advance, there's no kerning
+	inline void Text_Layout(const SDFFont* font, const float size, const std::string& text, TextLayout& layout)
+	{
+		layout = TextLayout();
+		if (font->baseSize <= 0.0f)
+			return;
+
+		const float scale = size / font->baseSize;
+		const float lineHeight = font->lineHeight * scale;
+		layout.ascent = size;
+
+		float penX = 0.0f, baseline = 0.0f;
+		uint32 lineCount = 1;
+		for (size_t i = 0; i < text.size();)
+		{
+			const uint32 codepoint = Text_DecodeUTF8(text, i);
+			if (codepoint == '\n')
+			{
+				penX = 0.0f; baseline += lineHeight; lineCount++;
+				continue;
+			}
+
+			const SDFFont_Glyph* glyph = SDFFont_GetGlyph(font, codepoint);
+			if (!glyph)
+				continue;
+
+			//glyphs with nothing to draw, like spaces, only move the pen
+			if (glyph->width > font->spread * 2 && glyph->height > font->spread * 2)
+			{
+				Smok::Renderers::GPUBased::GUIRenderer::GUIQuad& quad = layout.quads.emplace_back();
+				quad.rect = glm::vec4(penX + glyph->bearingX * scale, baseline - glyph->bearingY * scale,
+					(float)glyph->width * scale, (float)glyph->height * scale);
+				quad.uvRect = glyph->uvRect;
+			}
+
+			penX += glyph->advance * scale;
+			layout.width = std::max(layout.width, penX);
+		}
+
+		layout.height = lineHeight * (float)lineCount;
+	}
+
+	//adds a laid out string's quads to a GUI quad list, with the pen's start at position
+	inline void Text_AppendQuads(const TextLayout& layout, const glm::vec2& position, const glm::vec4& color, const uint32 textureSlot,
+		std::vector<Smok::Renderers::GPUBased::GUIRenderer::GUIQuad>& quads,
+		const uint32 clipIndex = SMOK_RENDERER_GUI_NO_CLIP, const uint32 layer = 0)
+	{
+		const uint32 packedColor = Smok::Renderers::GPUBased::GUIRenderer::GUIQuad_PackColor(color);
+
+		quads.reserve(quads.size() + layout.quads.size());
+		for (size_t i = 0; i < layout.quads.size(); ++i)
+		{
+			Smok::Renderers::GPUBased::GUIRenderer::GUIQuad quad = layout.quads[i];
+			quad.rect.x += position.x; quad.rect.y += position.y;
+			quad.color = packedColor; quad.textureSlot = textureSlot; quad.clipIndex = clipIndex; quad.layer = layer;
+			quads.emplace_back(quad);
+		}
+	}
+
+	//defines the stats of a layout cache
+	struct TextLayoutCacheStats
+	{
+		uint32 hitCount = 0, missCount = 0; //since the last end of frame
+		uint32 evictedCount = 0; //by the last end of frame
+		uint32 entryCount = 0;
+
+		//converts the stats into a human readable string
+		inline std::string ToString() const
+		{
+			return "Text Layout Cache: " + std::to_string(hitCount) + " hits, " + std::to_string(missCount) + " misses, " +
+				std::to_string(entryCount) + " entries, " + std::to_string(evictedCount) + " evicted";
+		}
+	};
+
+	//defines a cache of laid out strings keyed by font, size and string
+	struct TextLayoutCache
+	{
+		struct Entry
+		{
+			TextLayout layout;
+			uint64 lastUsedFrame = 0;
+		};
+
+		std::unordered_map<std::string, Entry> entries;
+		uint64 frame = 0;
+		uint32 maxUnusedFrames = 120; //layouts not used for this many frames are evicted
+
+		TextLayoutCacheStats stats;
+	};
+
+	//makes the key of a layout || the font's address, the size's bits and the string
+	inline std::string TextLayoutCache_MakeKey(const SDFFont* font, const float size, const std::string& text)
+	{
+		std::string key;
+		key.resize(sizeof(font) + sizeof(size));
+		memcpy(&key[0], &font, sizeof(font));
+		memcpy(&key[sizeof(font)], &size, sizeof(size));
+		key += text;
+		return key;
+	}
+
+	//gets the layout of a string, laying it out if it's not cached || the reference is valid until the next end of frame
+	inline const TextLayout& TextLayoutCache_Get(TextLayoutCache* cache, const SDFFont* font, const float size, const std::string& text)
+	{
+		auto [entry, isNew] = cache->entries.try_emplace(TextLayoutCache_MakeKey(font, size, text));
+		if (isNew)
+		{
+			Text_Layout(font, size, text, entry->second.layout);
+			cache->stats.missCount++;
+		}
+		else
+			cache->stats.hitCount++;
+
+		entry->second.lastUsedFrame = cache->frame;
+		return entry->second.layout;
+	}
+
+	//evicts the layouts that haven't been used in a while and resets the per frame stats, call once a frame
+	inline void TextLayoutCache_EndFrame(TextLayoutCache* cache)
+	{
+		cache->stats.evictedCount = 0;
+		for (auto entry = cache->entries.begin(); entry != cache->entries.end();)
+		{
+			if (cache->frame - entry->second.lastUsedFrame > cache->maxUnusedFrames)
+			{
+				entry = cache->entries.erase(entry);
+				cache->stats.evictedCount++;
+			}
+			else
+				++entry;
+		}
+
+		cache->stats.entryCount = (uint32)cache->entries.size();
+		cache->stats.hitCount = 0; cache->stats.missCount = 0;
+		cache->frame++;
+	}
+
+	//drops every cached layout of a font, call before the font is changed or freed
+	inline void TextLayoutCache_RemoveFont(TextLayoutCache* cache, const SDFFont* font)
+	{
+		for (auto entry = cache->entries.begin(); entry != cache->entries.end();)
+		{
+			if (entry->first.size() >= sizeof(font) && memcmp(entry->first.data(), &font, sizeof(font)) == 0)
+				entry = cache->entries.erase(entry);
+			else
+				++entry;
+		}
+	}
+}
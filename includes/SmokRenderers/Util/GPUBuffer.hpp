@@ -0,0 +1,72 @@
+#pragma once
+
+//defines a simple VMA backed buffer for the renderer's own GPU data
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+namespace Smok::Renderers::Util
+{
+	//defines a GPU buffer
+	struct GPUBuffer
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		VmaAllocationInfo allocationInfo = {};
+		size_t size = 0; //the size the buffer was made with
+	};
+
+	//creates a buffer || host visible buffers are persistently mapped
+	inline bool GPUBuffer_Create(GPUBuffer* buffer, VmaAllocator allocator, const size_t size,
+		VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage)
+	{
+		VkBufferCreateInfo bufferInfo = {};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = usage;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.usage = memoryUsage;
+		if (memoryUsage != VMA_MEMORY_USAGE_GPU_ONLY)
+			allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &buffer->buffer, &buffer->allocation, &buffer->allocationInfo) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Buffer", "GPUBuffer_Create", "Failed to create a GPU buffer!");
+			*buffer = GPUBuffer();
+			return false;
+		}
+
+		buffer->size = size;
+		return true;
+	}
+
+	//destroys a buffer
+	inline void GPUBuffer_Destroy(GPUBuffer* buffer, VmaAllocator allocator)
+	{
+		if (buffer->buffer != VK_NULL_HANDLE)
+			vmaDestroyBuffer(allocator, buffer->buffer, buffer->allocation);
+		*buffer = GPUBuffer();
+	}
+
+	//makes sure a buffer is at least the given size, remaking it if it's too small || the old contents are lost
+	//the caller has to make sure the GPU is done with the old buffer
+	inline bool GPUBuffer_EnsureSize(GPUBuffer* buffer, VmaAllocator allocator, const size_t size,
+		VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage)
+	{
+		if (buffer->buffer != VK_NULL_HANDLE && buffer->size >= size)
+			return true;
+
+		GPUBuffer_Destroy(buffer, allocator);
+
+		//grows with some slack, so a slowly growing scene doesn't remake it every frame
+		return GPUBuffer_Create(buffer, allocator, size + size / 2, usage, memoryUsage);
+	}
+
+	//copies data into a mapped buffer
+	inline void GPUBuffer_Write(GPUBuffer* buffer, VmaAllocator allocator, const void* data, const size_t size, const size_t offset = 0)
+	{
+		memcpy((uint8*)buffer->allocationInfo.pMappedData + offset, data, size);
+		vmaFlushAllocation(allocator, buffer->allocation, offset, size);
+	}
+}
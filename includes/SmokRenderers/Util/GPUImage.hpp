@@ -0,0 +1,172 @@
+#pragma once
+
+//defines a sampled 2D image filled from CPU pixels through a staging buffer, used by font atlases and texture atlas pages
+
+#include <SmokRenderers/Util/GPUBuffer.hpp>
+#include <SmokRenderers/Dispatch.hpp>
+
+namespace Smok::Renderers::Util
+{
+	//defines a sampled image and the staging buffer it's filled from
+	struct GPUImage
+	{
+		VkImage image = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		uint32 width = 0, height = 0, mipLevels = 1;
+
+		GPUBuffer stagingBuffer; //freed once the upload is done
+		std::vector<size_t> levelOffsets; //where each mip starts in the staging buffer
+	};
+
+	//destroys a image
+	inline void GPUImage_Destroy(GPUImage* image, VkDevice device, VmaAllocator allocator)
+	{
+		GPUBuffer_Destroy(&image->stagingBuffer, allocator);
+		if (image->view != VK_NULL_HANDLE)
+			vkDestroyImageView(device, image->view, nullptr);
+		if (image->image != VK_NULL_HANDLE)
+			vmaDestroyImage(allocator, image->image, image->allocation);
+
+		*image = GPUImage();
+	}
+
+	//creates a image and fills a staging buffer with it's pixels || call GPUImage_RecordUpload or GPUImage_UploadNow before it's sampled
+	//pixels holds every mip tightly packed, levelOffsets is where each one starts || null pixels skips the staging buffer, for uploading through a StagingRing
+	inline bool GPUImage_Create(GPUImage* image, VkDevice device, VmaAllocator allocator, const VkFormat format,
+		const uint32 width, const uint32 height, const void* pixels, const size_t byteSize,
+		const std::vector<size_t>& levelOffsets = { 0 })
+	{
+		image->format = format; image->width = width; image->height = height;
+		image->mipLevels = (uint32)levelOffsets.size();
+		image->levelOffsets = levelOffsets;
+
+		VkImageCreateInfo imageInfo = {};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.format = format;
+		imageInfo.extent = { width, height, 1 };
+		imageInfo.mipLevels = image->mipLevels;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT; //a source so it's mips can be copied into a smaller image
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+		if (vmaCreateImage(allocator, &imageInfo, &allocInfo, &image->image, &image->allocation, nullptr) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Image", "GPUImage_Create", "Failed to create the image!");
+			return false;
+		}
+
+		VkImageViewCreateInfo viewInfo = {};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = image->image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = format;
+		viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, image->mipLevels, 0, 1 };
+		if (vkCreateImageView(device, &viewInfo, nullptr, &image->view) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Image", "GPUImage_Create", "Failed to create the image view!");
+			GPUImage_Destroy(image, device, allocator);
+			return false;
+		}
+
+		if (!pixels)
+			return true;
+
+		if (!GPUBuffer_Create(&image->stagingBuffer, allocator, byteSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY))
+		{
+			GPUImage_Destroy(image, device, allocator);
+			return false;
+		}
+		GPUBuffer_Write(&image->stagingBuffer, allocator, pixels, byteSize);
+
+		return true;
+	}
+
+	//records the copy from the staging buffer into every mip, leaving it ready for fragment shaders to read
+	//a traced dispatch also records the staged pixels, so a replay with the staging buffer mapped can copy them
+	inline void GPUImage_RecordUpload(GPUImage* image, VkCommandBuffer comBuffer, Dispatch* dispatch = nullptr)
+	{
+		Dispatch_RecordUpload(dispatch, (uint64)image->stagingBuffer.buffer, 0, image->stagingBuffer.allocationInfo.pMappedData, image->stagingBuffer.size);
+
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image->image;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, image->mipLevels, 0, 1 };
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = 0; barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		std::vector<VkBufferImageCopy> copies(image->mipLevels);
+		for (uint32 i = 0; i < image->mipLevels; ++i)
+		{
+			copies[i] = {};
+			copies[i].bufferOffset = image->levelOffsets[i];
+			copies[i].imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 };
+			copies[i].imageExtent = { std::max(image->width >> i, (uint32)1), std::max(image->height >> i, (uint32)1), 1 };
+		}
+		Dispatch_CmdCopyBufferToImage(dispatch, comBuffer, image->stagingBuffer.buffer, image->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			(uint32)copies.size(), copies.data());
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL; barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	//frees the staging buffer || the upload must be done on the GPU
+	inline void GPUImage_ReleaseStaging(GPUImage* image, VmaAllocator allocator)
+	{
+		GPUBuffer_Destroy(&image->stagingBuffer, allocator);
+	}
+
+	//uploads the image and waits for it, then frees the staging buffer || for load time, it stalls the graphics queue
+	inline bool GPUImage_UploadNow(GPUImage* image, SMGraphics_Core_GPU* GPU, VmaAllocator allocator, SMGraphics_Pool_CommandPool* commandPool,
+		Dispatch* dispatch = nullptr)
+	{
+		VkCommandBufferAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = commandPool->pool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer comBuffer = VK_NULL_HANDLE;
+		if (vkAllocateCommandBuffers(GPU->device, &allocInfo, &comBuffer) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "GPU Image", "GPUImage_UploadNow", "Failed to allocate a command buffer!");
+			return false;
+		}
+
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(comBuffer, &beginInfo);
+		GPUImage_RecordUpload(image, comBuffer, dispatch);
+		vkEndCommandBuffer(comBuffer);
+
+		VkSubmitInfo submitInfo = {};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &comBuffer;
+		const bool submitted = (vkQueueSubmit(GPU->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS);
+		if (submitted)
+			vkQueueWaitIdle(GPU->graphicsQueue);
+		else
+			BTD_LogError("Smok Renderer", "GPU Image", "GPUImage_UploadNow", "Failed to submit the upload!");
+
+		vkFreeCommandBuffers(GPU->device, commandPool->pool, 1, &comBuffer);
+		if (submitted)
+			GPUImage_ReleaseStaging(image, allocator);
+
+		return submitted;
+	}
+}
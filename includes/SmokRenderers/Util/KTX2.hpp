@@ -0,0 +1,272 @@
+#pragma once
+
+//defines reading and writing KTX2 containers of a single 2D image with pre-generated mips
+//supercompressed (Basis, Zstd), array, cube and 3D containers are not supported
+//a container whose format the device can't sample is decoded to RGBA8 on load
+
+#include <SmokRenderers/Util/TextureCompression.hpp>
+
+#include <fstream>
+#include <string>
+
+#define SMOK_RENDERER_KTX2_HEADER_SIZE 80 //the identifier, header and index
+#define SMOK_RENDERER_KTX2_LEVEL_INDEX_SIZE 24 //byte offset, byte length and uncompressed byte length a level
+
+namespace Smok::Renderers::Util
+{
+	//the 12 byte KTX2 identifier, «KTX 20»\r\n\x1A\n
+	static const uint8 KTX2_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	//defines a loaded KTX2 image
+	struct KTX2Texture
+	{
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		uint32 width = 0, height = 0; //of level 0, even when it's not loaded
+		uint32 levelCount = 0; //in the file
+		uint32 firstLevel = 0; //the finest level loaded
+
+		std::vector<uint8> data; //every loaded mip tightly packed, firstLevel first
+		std::vector<size_t> levelOffsets; //where each loaded mip starts in data
+		std::vector<size_t> levelSizes; //the bytes of each loaded mip
+	};
+
+	//gets the size of a mip level
+	inline uint32 KTX2Texture_GetLevelExtent(const uint32 extent, const uint32 level) { return std::max(extent >> level, 1u); }
+
+	//reads a little endian value from a buffer
+	template<typename T>
+	inline T KTX2_Read(const uint8* data, const size_t offset)
+	{
+		T value = 0;
+		for (size_t i = 0; i < sizeof(T); ++i)
+			value |= (T)data[offset + i] << (i * 8);
+		return value;
+	}
+
+	//writes a little endian value into a buffer
+	template<typename T>
+	inline void KTX2_Write(std::vector<uint8>& data, const size_t offset, const T value)
+	{
+		for (size_t i = 0; i < sizeof(T); ++i)
+			data[offset + i] = (uint8)(((uint64)value >> (i * 8)) & 0xFF);
+	}
+
+	//loads a KTX2 file, only reading the levels from firstLevel down || a firstLevel past the last level just reads the header
+	inline bool KTX2_LoadFile(KTX2Texture* texture, const std::string& path, const uint32 firstLevel = 0)
+	{
+		std::ifstream file(path, std::ios::ate | std::ios::binary);
+		if (!file.is_open())
+		{
+			BTD_LogError("Smok Renderer", "KTX2", "KTX2_LoadFile", std::string("Failed to open \"" + path + "\"").c_str());
+			return false;
+		}
+
+		const size_t fileSize = (size_t)file.tellg();
+		uint8 header[SMOK_RENDERER_KTX2_HEADER_SIZE] = {};
+		file.seekg(0);
+		file.read((char*)header, sizeof(header));
+		if (!file.good() || memcmp(header, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+		{
+			BTD_LogError("Smok Renderer", "KTX2", "KTX2_LoadFile", std::string("\"" + path + "\" is not a KTX2 file").c_str());
+			return false;
+		}
+
+		const VkFormat format = (VkFormat)KTX2_Read<uint32>(header, 12);
+		const uint32 width = KTX2_Read<uint32>(header, 20), height = KTX2_Read<uint32>(header, 24);
+		const uint32 depth = KTX2_Read<uint32>(header, 28), layerCount = KTX2_Read<uint32>(header, 32);
+		const uint32 faceCount = KTX2_Read<uint32>(header, 36), levelCount = std::max(KTX2_Read<uint32>(header, 40), 1u);
+		const uint32 supercompression = KTX2_Read<uint32>(header, 44);
+
+		bool sRGB = false;
+		const TextureCompression compression = TextureCompression_FromFormat(format, sRGB);
+		if (compression == TextureCompression::Count || supercompression != 0 ||
+			width == 0 || height == 0 || depth > 1 || layerCount > 1 || faceCount != 1)
+		{
+			BTD_LogError("Smok Renderer", "KTX2", "KTX2_LoadFile", std::string("\"" + path +
+				"\" is not a single 2D RGBA8, BC1, BC3, BC5 or BC7 image without supercompression").c_str());
+			return false;
+		}
+
+		std::vector<uint8> levelIndex((size_t)levelCount * SMOK_RENDERER_KTX2_LEVEL_INDEX_SIZE);
+		file.read((char*)levelIndex.data(), (std::streamsize)levelIndex.size());
+		if (!file.good())
+		{
+			BTD_LogError("Smok Renderer", "KTX2", "KTX2_LoadFile", std::string("\"" + path + "\" has a cut off level index").c_str());
+			return false;
+		}
+
+		//the levels are stored smallest first, but packed level 0 first for the GPU image
+		*texture = KTX2Texture();
+		texture->format = format; texture->width = width; texture->height = height;
+		texture->levelCount = levelCount; texture->firstLevel = std::min(firstLevel, levelCount);
+		for (uint32 l = 0; l < levelCount; ++l)
+		{
+			const size_t indexOffset = (size_t)l * SMOK_RENDERER_KTX2_LEVEL_INDEX_SIZE;
+			const uint64 byteOffset = KTX2_Read<uint64>(levelIndex.data(), indexOffset), byteLength = KTX2_Read<uint64>(levelIndex.data(), indexOffset + 8);
+			const size_t expectedSize = TextureCompression_GetLevelByteSize(compression,
+				KTX2Texture_GetLevelExtent(width, l), KTX2Texture_GetLevelExtent(height, l));
+
+			if (byteLength != expectedSize || byteOffset + byteLength > fileSize)
+			{
+				BTD_LogError("Smok Renderer", "KTX2", "KTX2_LoadFile", std::string("\"" + path + "\" has a bad level " + std::to_string(l)).c_str());
+				*texture = KTX2Texture();
+				return false;
+			}
+
+			if (l < texture->firstLevel)
+				continue;
+
+			texture->levelOffsets.emplace_back(texture->data.size());
+			texture->levelSizes.emplace_back((size_t)byteLength);
+			texture->data.resize(texture->data.size() + (size_t)byteLength);
+			file.seekg((std::streamoff)byteOffset);
+			file.read((char*)&texture->data[texture->levelOffsets.back()], (std::streamsize)byteLength);
+		}
+
+		if (!file.good())
+		{
+			BTD_LogError("Smok Renderer", "KTX2", "KTX2_LoadFile", std::string("Failed to read the levels of \"" + path + "\"").c_str());
+			*texture = KTX2Texture();
+			return false;
+		}
+
+		return true;
+	}
+
+	//builds the basic data format descriptor of a format
+	inline std::vector<uint8> KTX2_BuildDFD(const TextureCompression compression, const bool sRGB)
+	{
+		//each sample is the bit offset, bit length - 1, channel ID, and the lower and upper values
+		struct Sample { uint16 bitOffset; uint8 bitLength; uint8 channel; uint32 upper; };
+		std::vector<Sample> samples;
+		uint8 colorModel = 1, blockDimension = 0; //RGBSDA, 1x1
+		switch (compression)
+		{
+		case TextureCompression::BC1: colorModel = 128; samples = { { 0, 63, 0, 0xFFFFFFFF } }; break;
+		case TextureCompression::BC3: colorModel = 130; samples = { { 0, 63, 15, 0xFFFFFFFF }, { 64, 63, 0, 0xFFFFFFFF } }; break;
+		case TextureCompression::BC5: colorModel = 132; samples = { { 0, 63, 0, 0xFFFFFFFF }, { 64, 63, 1, 0xFFFFFFFF } }; break;
+		case TextureCompression::BC7: colorModel = 134; samples = { { 0, 127, 0, 0xFFFFFFFF } }; break;
+		default: samples = { { 0, 7, 0, 255 }, { 8, 7, 1, 255 }, { 16, 7, 2, 255 }, { 24, 7, 15, 255 } }; break;
+		}
+		if (compression != TextureCompression::None)
+			blockDimension = 3; //4x4, stored as size - 1
+
+		const uint32 blockSize = 24 + (uint32)samples.size() * 16;
+		std::vector<uint8> dfd(4 + blockSize, 0);
+		KTX2_Write<uint32>(dfd, 0, (uint32)dfd.size());
+		KTX2_Write<uint32>(dfd, 4, 0); //Khronos vendor, basic descriptor
+		KTX2_Write<uint16>(dfd, 8, 2); //version 1.3
+		KTX2_Write<uint16>(dfd, 10, (uint16)blockSize);
+		dfd[12] = colorModel; dfd[13] = 1; //BT.709 primaries
+		dfd[14] = (sRGB ? 2 : 1); //sRGB or linear transfer
+		dfd[15] = 0; //straight alpha
+		dfd[16] = blockDimension; dfd[17] = blockDimension;
+		dfd[20] = (uint8)TextureCompression_GetBlockBytes(compression);
+
+		for (size_t s = 0; s < samples.size(); ++s)
+		{
+			const size_t offset = 28 + s * 16;
+			KTX2_Write<uint16>(dfd, offset, samples[s].bitOffset);
+			dfd[offset + 2] = samples[s].bitLength;
+			dfd[offset + 3] = samples[s].channel;
+			KTX2_Write<uint32>(dfd, offset + 8, 0);
+			KTX2_Write<uint32>(dfd, offset + 12, samples[s].upper);
+		}
+
+		return dfd;
+	}
+
+	//writes a KTX2 file
+	inline bool KTX2_WriteFile(const KTX2Texture& texture, const std::string& path)
+	{
+		bool sRGB = false;
+		const TextureCompression compression = TextureCompression_FromFormat(texture.format, sRGB);
+		if (compression == TextureCompression::Count || texture.firstLevel != 0 || texture.levelOffsets.empty() || texture.levelOffsets.size() != texture.levelSizes.size())
+		{
+			BTD_LogError("Smok Renderer", "KTX2", "KTX2_WriteFile", std::string("Can not write \"" + path + "\", it's missing levels or has a format KTX2 files can't hold here").c_str());
+			return false;
+		}
+
+		const uint32 levelCount = (uint32)texture.levelOffsets.size();
+		const std::vector<uint8> dfd = KTX2_BuildDFD(compression, sRGB);
+		const size_t dfdOffset = SMOK_RENDERER_KTX2_HEADER_SIZE + (size_t)levelCount * SMOK_RENDERER_KTX2_LEVEL_INDEX_SIZE;
+
+		//every level is aligned to the lcm of the block size and 4, which is the block size for these formats
+		const size_t alignment = TextureCompression_GetBlockBytes(compression);
+		std::vector<uint8> bytes(dfdOffset + dfd.size(), 0);
+		memcpy(bytes.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+		KTX2_Write<uint32>(bytes, 12, (uint32)texture.format);
+		KTX2_Write<uint32>(bytes, 16, 1); //type size
+		KTX2_Write<uint32>(bytes, 20, texture.width); KTX2_Write<uint32>(bytes, 24, texture.height);
+		KTX2_Write<uint32>(bytes, 28, 0); KTX2_Write<uint32>(bytes, 32, 0); KTX2_Write<uint32>(bytes, 36, 1);
+		KTX2_Write<uint32>(bytes, 40, levelCount);
+		KTX2_Write<uint32>(bytes, 44, 0); //no supercompression
+		KTX2_Write<uint32>(bytes, 48, (uint32)dfdOffset); KTX2_Write<uint32>(bytes, 52, (uint32)dfd.size());
+		memcpy(&bytes[dfdOffset], dfd.data(), dfd.size());
+
+		//the smallest level goes first
+		for (uint32 l = levelCount; l-- > 0;)
+		{
+			bytes.resize((bytes.size() + alignment - 1) / alignment * alignment, 0);
+			const size_t indexOffset = SMOK_RENDERER_KTX2_HEADER_SIZE + (size_t)l * SMOK_RENDERER_KTX2_LEVEL_INDEX_SIZE;
+			KTX2_Write<uint64>(bytes, indexOffset, (uint64)bytes.size());
+			KTX2_Write<uint64>(bytes, indexOffset + 8, (uint64)texture.levelSizes[l]);
+			KTX2_Write<uint64>(bytes, indexOffset + 16, (uint64)texture.levelSizes[l]);
+			bytes.insert(bytes.end(), texture.data.begin() + (ptrdiff_t)texture.levelOffsets[l],
+				texture.data.begin() + (ptrdiff_t)(texture.levelOffsets[l] + texture.levelSizes[l]));
+		}
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			BTD_LogError("Smok Renderer", "KTX2", "KTX2_WriteFile", std::string("Failed to open \"" + path + "\"").c_str());
+			return false;
+		}
+
+		file.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+		return file.good();
+	}
+
+	//checks if the device can sample a format with optimal tiling
+	inline bool KTX2_IsFormatSampleable(VkPhysicalDevice physicalDevice, const VkFormat format)
+	{
+		VkFormatProperties properties = {};
+		vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+		return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+	}
+
+	//decodes every mip of a compressed texture into RGBA8, keeping it's sRGB
+	inline void KTX2Texture_Decompress(KTX2Texture* texture)
+	{
+		bool sRGB = false;
+		const TextureCompression compression = TextureCompression_FromFormat(texture->format, sRGB);
+		if (compression == TextureCompression::None || compression == TextureCompression::Count)
+			return;
+
+		KTX2Texture decoded;
+		decoded.format = TextureCompression_GetFormat(TextureCompression::None, sRGB);
+		decoded.width = texture->width; decoded.height = texture->height;
+		decoded.levelCount = texture->levelCount; decoded.firstLevel = texture->firstLevel;
+		std::vector<uint8> pixels;
+		for (uint32 l = 0; l < (uint32)texture->levelOffsets.size(); ++l)
+		{
+			BlockCompression_Decode(compression, &texture->data[texture->levelOffsets[l]],
+				KTX2Texture_GetLevelExtent(texture->width, texture->firstLevel + l), KTX2Texture_GetLevelExtent(texture->height, texture->firstLevel + l), pixels);
+			decoded.levelOffsets.emplace_back(decoded.data.size());
+			decoded.levelSizes.emplace_back(pixels.size());
+			decoded.data.insert(decoded.data.end(), pixels.begin(), pixels.end());
+		}
+
+		*texture = std::move(decoded);
+	}
+
+	//falls back to RGBA8 when the device can't sample the texture's format || returns true if it fell back
+	inline bool KTX2Texture_MakeSampleable(KTX2Texture* texture, VkPhysicalDevice physicalDevice)
+	{
+		if (KTX2_IsFormatSampleable(physicalDevice, texture->format))
+			return false;
+
+		KTX2Texture_Decompress(texture);
+		return true;
+	}
+}
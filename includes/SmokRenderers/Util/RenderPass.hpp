@@ -0,0 +1,123 @@
+#pragma once
+
+//creates the simple one subpass render passes the renderers draw into when they don't have a swapchain's
+//can draw several views at once with VK_KHR_multiview (core in Vulkan 1.1)
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+namespace Smok::Renderers::Util
+{
+	//checks if the device supports multiview || the feature still has to be turned on when making the device
+	inline bool Multiview_IsSupported(VkPhysicalDevice physicalDevice)
+	{
+		VkPhysicalDeviceMultiviewFeatures multiviewFeatures = {};
+		multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &multiviewFeatures;
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+		return multiviewFeatures.multiview == VK_TRUE;
+	}
+
+	//checks if the device supports shaderDrawParameters, which gl_BaseInstance needs || the feature still has to be turned on when making the device
+	inline bool ShaderDrawParameters_IsSupported(VkPhysicalDevice physicalDevice)
+	{
+		VkPhysicalDeviceShaderDrawParametersFeatures drawParametersFeatures = {};
+		drawParametersFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &drawParametersFeatures;
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+		return drawParametersFeatures.shaderDrawParameters == VK_TRUE;
+	}
+
+	//creates a render pass with a color and optional depth attachment || depthFormat can be VK_FORMAT_UNDEFINED for no depth
+	//with a viewCount above 1 every view is drawn into the layers of a array image,
+	//the framebuffer's attachments need viewCount layers and the framebuffer itself 1 layer
+	//load keeps what's already in the attachments instead of clearing them, they have to be in the attachment layouts
+	//the depth is stored, since the occlusion depth pyramid and a loading render pass read it after the pass
+	inline VkRenderPass RenderPass_Create(VkDevice device, const VkFormat colorFormat, const VkFormat depthFormat,
+		const VkImageLayout colorFinalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, const uint32 viewCount = 1, const bool load = false)
+	{
+		VkAttachmentDescription attachments[2] = {};
+		attachments[0].format = colorFormat;
+		attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+		attachments[0].loadOp = (load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR);
+		attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachments[0].initialLayout = (load ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED);
+		attachments[0].finalLayout = colorFinalLayout;
+
+		attachments[1].format = depthFormat;
+		attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+		attachments[1].loadOp = (load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR);
+		attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachments[1].initialLayout = (load ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED);
+		attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		const bool hasDepth = (depthFormat != VK_FORMAT_UNDEFINED);
+		VkAttachmentReference colorRef = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+		VkAttachmentReference depthRef = { 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+		VkSubpassDescription subpass = {};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 1;
+		subpass.pColorAttachments = &colorRef;
+		subpass.pDepthStencilAttachment = (hasDepth ? &depthRef : nullptr);
+
+		//waits on the last use of the attachments, and makes the color visible to copies and shaders after the pass
+		VkSubpassDependency dependencies[2] = {};
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+		dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+			(load ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT : 0);
+
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+		//every view is drawn in the one subpass, and they're close enough to be correlated
+		const uint32 viewMask = (1u << viewCount) - 1;
+		VkRenderPassMultiviewCreateInfo multiviewInfo = {};
+		multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+		multiviewInfo.subpassCount = 1;
+		multiviewInfo.pViewMasks = &viewMask;
+		multiviewInfo.correlationMaskCount = 1;
+		multiviewInfo.pCorrelationMasks = &viewMask;
+
+		VkRenderPassCreateInfo renderPassInfo = {};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.pNext = (viewCount > 1 ? &multiviewInfo : nullptr);
+		renderPassInfo.attachmentCount = (hasDepth ? 2 : 1);
+		renderPassInfo.pAttachments = attachments;
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = 2;
+		renderPassInfo.pDependencies = dependencies;
+
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+			BTD_LogError("Smok Renderer", "Render Pass", "RenderPass_Create", "Failed to create a render pass!");
+
+		return renderPass;
+	}
+
+	//creates a render pass that draws every view into the layers of a array image
+	inline VkRenderPass MultiviewRenderPass_Create(VkDevice device, const VkFormat colorFormat, const VkFormat depthFormat,
+		const uint32 viewCount, const VkImageLayout colorFinalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+	{
+		return RenderPass_Create(device, colorFormat, depthFormat, colorFinalLayout, viewCount);
+	}
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+//loads SPIR-V shader modules for the renderer's own compute and procedural graphics passes
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+#include <fstream>
+
+namespace Smok::Renderers::Util
+{
+	//loads a SPIR-V file into a shader module
+	inline VkShaderModule ShaderModule_LoadFromFile(VkDevice device, const std::string& SPIRVPath)
+	{
+		std::ifstream file(SPIRVPath, std::ios::ate | std::ios::binary);
+		if (!file.is_open())
+		{
+			BTD_LogError("Smok Renderer", "Shader Module", "ShaderModule_LoadFromFile",
+				std::string("Failed to open a SPIR-V file at \"" + SPIRVPath + "\"").c_str());
+			return VK_NULL_HANDLE;
+		}
+
+		const size_t fileSize = (size_t)file.tellg();
+		std::vector<uint32> code((fileSize + 3) / 4);
+		file.seekg(0);
+		file.read((char*)code.data(), fileSize);
+		file.close();
+
+		VkShaderModuleCreateInfo createInfo = {};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = fileSize;
+		createInfo.pCode = code.data();
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Shader Module", "ShaderModule_LoadFromFile",
+				std::string("Failed to create a shader module from \"" + SPIRVPath + "\"").c_str());
+			return VK_NULL_HANDLE;
+		}
+
+		return shaderModule;
+	}
+
+	//creates a compute pipeline from a SPIR-V file || specialization sets the shader's constant_id constants, so one shader can make several pipelines
+	inline VkPipeline ComputePipeline_CreateFromFile(VkDevice device, const std::string& SPIRVPath, VkPipelineLayout pipelineLayout,
+		const VkSpecializationInfo* specialization = nullptr)
+	{
+		VkShaderModule shaderModule = ShaderModule_LoadFromFile(device, SPIRVPath);
+		if (shaderModule == VK_NULL_HANDLE)
+			return VK_NULL_HANDLE;
+
+		VkComputePipelineCreateInfo pipelineInfo = {};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.stage.pSpecializationInfo = specialization;
+		pipelineInfo.layout = pipelineLayout;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+			BTD_LogError("Smok Renderer", "Shader Module", "ComputePipeline_CreateFromFile",
+				std::string("Failed to create a compute pipeline from \"" + SPIRVPath + "\"").c_str());
+
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+		return pipeline;
+	}
+
+	//creates a graphics pipeline from SPIR-V files that has no vertex input, the vertex shader makes it's vertices from the vertex and instance index
+	//draws alpha blended triangles with no depth and no culling, the viewport and scissor are dynamic
+	inline VkPipeline ProceduralGraphicsPipeline_CreateFromFiles(VkDevice device, const std::string& vertexSPIRVPath, const std::string& fragmentSPIRVPath,
+		VkPipelineLayout pipelineLayout, VkRenderPass renderPass)
+	{
+		VkShaderModule vertexModule = ShaderModule_LoadFromFile(device, vertexSPIRVPath);
+		VkShaderModule fragmentModule = ShaderModule_LoadFromFile(device, fragmentSPIRVPath);
+		if (vertexModule == VK_NULL_HANDLE || fragmentModule == VK_NULL_HANDLE)
+		{
+			if (vertexModule != VK_NULL_HANDLE)
+				vkDestroyShaderModule(device, vertexModule, nullptr);
+			if (fragmentModule != VK_NULL_HANDLE)
+				vkDestroyShaderModule(device, fragmentModule, nullptr);
+			return VK_NULL_HANDLE;
+		}
+
+		VkPipelineShaderStageCreateInfo stages[2] = {};
+		stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+		stages[0].module = vertexModule;
+		stages[0].pName = "main";
+		stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+		stages[1].module = fragmentModule;
+		stages[1].pName = "main";
+
+		VkPipelineVertexInputStateCreateInfo vertexInput = {};
+		vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+		VkPipelineViewportStateCreateInfo viewportState = {};
+		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportState.viewportCount = 1;
+		viewportState.scissorCount = 1;
+
+		VkPipelineRasterizationStateCreateInfo rasterizer = {};
+		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+		rasterizer.cullMode = VK_CULL_MODE_NONE;
+		rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		rasterizer.lineWidth = 1.0f;
+
+		VkPipelineMultisampleStateCreateInfo multisampling = {};
+		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		//the render passes have a depth attachment, it's just not used
+		VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencil.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+
+		VkPipelineColorBlendAttachmentState blendAttachment = {};
+		blendAttachment.blendEnable = VK_TRUE;
+		blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+		blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+		blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+		VkPipelineColorBlendStateCreateInfo colorBlend = {};
+		colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlend.attachmentCount = 1;
+		colorBlend.pAttachments = &blendAttachment;
+
+		VkDynamicState dynamicStates[2] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		VkPipelineDynamicStateCreateInfo dynamicState = {};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = 2;
+		dynamicState.pDynamicStates = dynamicStates;
+
+		VkGraphicsPipelineCreateInfo pipelineInfo = {};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.stageCount = 2;
+		pipelineInfo.pStages = stages;
+		pipelineInfo.pVertexInputState = &vertexInput;
+		pipelineInfo.pInputAssemblyState = &inputAssembly;
+		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pRasterizationState = &rasterizer;
+		pipelineInfo.pMultisampleState = &multisampling;
+		pipelineInfo.pDepthStencilState = &depthStencil;
+		pipelineInfo.pColorBlendState = &colorBlend;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = pipelineLayout;
+		pipelineInfo.renderPass = renderPass;
+		pipelineInfo.subpass = 0;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+			BTD_LogError("Smok Renderer", "Shader Module", "ProceduralGraphicsPipeline_CreateFromFiles",
+				std::string("Failed to create a graphics pipeline from \"" + vertexSPIRVPath + "\" and \"" + fragmentSPIRVPath + "\"").c_str());
+
+		vkDestroyShaderModule(device, vertexModule, nullptr);
+		vkDestroyShaderModule(device, fragmentModule, nullptr);
+		return pipeline;
+	}
+}
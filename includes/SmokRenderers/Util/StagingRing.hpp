@@ -0,0 +1,630 @@
+#pragma once
+
+//defines a persistently mapped staging ring shared by every upload
+//uploads are copied into the ring and their copies queued, then a flush records them all into one command buffer and submits it once
+//each frame slot has a fence, the ring space a slot used is only reused once it's fence has signaled
+//the copies go on the graphics queue, or on a dedicated transfer queue with the ownership of what they write handed over to graphics
+//with a traced dispatch, the staged bytes are recorded as uploads into the ring buffer and the flush's barriers and copies as commands
+//copies between images already on the GPU go with the flush too, always on the graphics queue since the images they read are owned by it
+
+#include <SmokRenderers/Util/GPUImage.hpp>
+
+#include <string>
+
+#define SMOK_RENDERER_STAGING_RING_DEFAULT_SIZE (64 * 1024 * 1024) //the default size of the ring in bytes
+#define SMOK_RENDERER_STAGING_RING_ALIGNMENT 16 //every upload starts on this alignment, enough for any texel block or vertex
+
+namespace Smok::Renderers::Util
+{
+	//defines the stats of the ring
+	struct StagingRingStats
+	{
+		uint64 stagedBytes = 0; //copied into the ring
+		uint32 submitCount = 0; //transfer submissions
+		uint32 bufferCopyCount = 0, imageUploadCount = 0;
+		uint32 imageCopyCount = 0; //copies between images, which use no ring space
+		uint32 stallCount = 0; //times a upload had to wait for the GPU to free ring space
+
+		//adds another stats
+		inline void Merge(const StagingRingStats& other)
+		{
+			stagedBytes += other.stagedBytes; submitCount += other.submitCount;
+			bufferCopyCount += other.bufferCopyCount; imageUploadCount += other.imageUploadCount;
+			imageCopyCount += other.imageCopyCount;
+			stallCount += other.stallCount;
+		}
+
+		//converts the stats into a human readable string
+		inline std::string ToString() const
+		{
+			return "Staging Ring: " + std::to_string(stagedBytes) + " bytes staged, " + std::to_string(submitCount) + " submits, " +
+				std::to_string(bufferCopyCount) + " buffer copies, " + std::to_string(imageUploadCount) + " image uploads, " +
+				std::to_string(imageCopyCount) + " image copies, " + std::to_string(stallCount) + " stalls";
+		}
+	};
+
+	//defines a queued copy into a buffer
+	struct StagingRing_BufferCopy
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkBufferCopy region = {};
+		VkPipelineStageFlags dstStages = 0; VkAccessFlags dstAccess = 0; //how the buffer is read after
+	};
+
+	//defines a queued upload into every mip of a image
+	struct StagingRing_ImageUpload
+	{
+		VkImage image = VK_NULL_HANDLE;
+		uint32 mipLevels = 1;
+		size_t firstCopy = 0, copyCount = 0; //the range in the ring's image copies
+	};
+
+	//defines a queued copy of some of a image's mips into every mip of another image
+	struct StagingRing_ImageToImageCopy
+	{
+		VkImage srcImage = VK_NULL_HANDLE, dstImage = VK_NULL_HANDLE;
+		uint32 srcFirstLevel = 0, mipLevels = 1; //the source mips copied, from srcFirstLevel into the destination's level 0
+		size_t firstCopy = 0, copyCount = 0; //the range in the ring's image to image regions
+	};
+
+	//defines a frame slot of the ring
+	struct StagingRing_Frame
+	{
+		VkCommandBuffer comBuffer = VK_NULL_HANDLE; //the copies || freed once the fence signals
+		VkCommandBuffer acquireComBuffer = VK_NULL_HANDLE; //takes ownership on the graphics queue, only with a dedicated transfer queue
+		VkSemaphore transferDone = VK_NULL_HANDLE; //signaled by the transfer queue, waited on by the acquire
+		VkFence fence = VK_NULL_HANDLE;
+		bool inFlight = false; //was submitted and hasn't been waited on
+		size_t usedBytes = 0; //the ring bytes the submission holds, including alignment and wrap padding
+	};
+
+	//defines the staging ring
+	struct StagingRing
+	{
+		GPUBuffer buffer; //persistently mapped
+		size_t head = 0; //where the next upload goes
+		size_t usedBytes = 0; //held by queued and in flight uploads
+		size_t pendingBytes = 0; //held by queued uploads, not yet flushed
+
+		std::vector<StagingRing_Frame> frames;
+		uint32 currentFrame = 0;
+		bool flushedPerFrame = false; //a frame source begins and flushes it every frame, set by the first StagingRing_BeginFrame
+
+		std::vector<StagingRing_BufferCopy> bufferCopies; //queued since the last flush
+		std::vector<StagingRing_ImageUpload> imageUploads;
+		std::vector<VkBufferImageCopy> imageCopies;
+		std::vector<StagingRing_ImageToImageCopy> imageToImageCopies;
+		std::vector<VkImageCopy> imageToImageRegions;
+
+		StagingRingStats frameStats; //since the last StagingRing_BeginFrame
+		StagingRingStats totalStats;
+
+		SMGraphics_Core_GPU* GPU = nullptr;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+		SMGraphics_Pool_CommandPool* commandPool = nullptr; //the graphics queue's pool
+
+		Dispatch* dispatch = nullptr; //where the flush's commands go, null goes straight to Vulkan
+		VkQueue queue = VK_NULL_HANDLE; //where the copies are submitted
+
+		//the dedicated transfer queue, set by StagingRing_UseTransferQueue
+		bool usesTransferQueue = false;
+		VkCommandPool transferCommandPool = VK_NULL_HANDLE;
+		uint32 transferQueueFamily = VK_QUEUE_FAMILY_IGNORED, graphicsQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+	};
+
+	//finds the best queue family for uploads, one with transfers and neither graphics nor compute, then one without graphics
+	//returns the graphics family if the device has nothing else || request a queue from it when making the device, then give it to StagingRing_UseTransferQueue
+	inline uint32 StagingRing_FindTransferQueueFamily(VkPhysicalDevice physicalDevice, const uint32 graphicsQueueFamily)
+	{
+		uint32 familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+
+		uint32 bestFamily = graphicsQueueFamily, bestScore = 0;
+		for (uint32 i = 0; i < familyCount; ++i)
+		{
+			const VkQueueFlags flags = families[i].queueFlags;
+			if (!(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT) || families[i].queueCount == 0)
+				continue;
+
+			//the copy engine only queues are the ones that run alongside rendering
+			const uint32 score = ((flags & VK_QUEUE_COMPUTE_BIT) ? 1 : 2);
+			if (score > bestScore)
+			{
+				bestFamily = i; bestScore = score;
+			}
+		}
+
+		return bestFamily;
+	}
+
+	//creates the ring || the command pool's queue family has to support transfers
+	inline bool StagingRing_Create(StagingRing* ring, SMGraphics_Core_GPU* GPU, VmaAllocator allocator, SMGraphics_Pool_CommandPool* commandPool,
+		const uint32 frameCount, const size_t size = SMOK_RENDERER_STAGING_RING_DEFAULT_SIZE)
+	{
+		ring->GPU = GPU; ring->allocator = allocator; ring->commandPool = commandPool;
+		ring->queue = GPU->graphicsQueue;
+
+		if (!GPUBuffer_Create(&ring->buffer, allocator, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY))
+		{
+			BTD_LogError("Smok Renderer", "Staging Ring", "StagingRing_Create", "Failed to create the ring buffer!");
+			return false;
+		}
+
+		VkFenceCreateInfo fenceInfo = {};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		ring->frames.resize(std::max(frameCount, (uint32)1));
+		for (size_t i = 0; i < ring->frames.size(); ++i)
+		{
+			if (vkCreateFence(GPU->device, &fenceInfo, nullptr, &ring->frames[i].fence) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "Staging Ring", "StagingRing_Create", "Failed to create a frame fence!");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//waits for a frame slot's submission and frees the ring space it held
+	inline void StagingRing_RetireFrame(StagingRing* ring, StagingRing_Frame& frame)
+	{
+		if (!frame.inFlight)
+			return;
+
+		vkWaitForFences(ring->GPU->device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+		vkFreeCommandBuffers(ring->GPU->device, (ring->usesTransferQueue ? ring->transferCommandPool : ring->commandPool->pool), 1, &frame.comBuffer);
+		if (frame.acquireComBuffer != VK_NULL_HANDLE)
+			vkFreeCommandBuffers(ring->GPU->device, ring->commandPool->pool, 1, &frame.acquireComBuffer);
+		frame.comBuffer = VK_NULL_HANDLE; frame.acquireComBuffer = VK_NULL_HANDLE;
+		frame.inFlight = false;
+
+		ring->usedBytes -= frame.usedBytes;
+		frame.usedBytes = 0;
+
+		//with nothing held, the next upload can use the whole ring
+		if (ring->usedBytes == 0)
+			ring->head = 0;
+	}
+
+	//destroys the ring, waiting for it's submissions first
+	inline void StagingRing_Destroy(StagingRing* ring)
+	{
+		if (!ring->GPU)
+			return;
+
+		for (size_t i = 0; i < ring->frames.size(); ++i)
+		{
+			StagingRing_RetireFrame(ring, ring->frames[i]);
+			if (ring->frames[i].fence != VK_NULL_HANDLE)
+				vkDestroyFence(ring->GPU->device, ring->frames[i].fence, nullptr);
+			if (ring->frames[i].transferDone != VK_NULL_HANDLE)
+				vkDestroySemaphore(ring->GPU->device, ring->frames[i].transferDone, nullptr);
+		}
+		if (ring->transferCommandPool != VK_NULL_HANDLE)
+			vkDestroyCommandPool(ring->GPU->device, ring->transferCommandPool, nullptr);
+
+		GPUBuffer_Destroy(&ring->buffer, ring->allocator);
+		*ring = StagingRing();
+	}
+
+	//is the ring made
+	inline bool StagingRing_IsValid(const StagingRing* ring) { return ring && ring->buffer.buffer != VK_NULL_HANDLE; }
+
+	//is a frame source (the RenderManager or a HeadlessFrameSource) flushing the ring with every frame || per frame uploads queued without one would never go up
+	inline bool StagingRing_IsFlushedPerFrame(const StagingRing* ring) { return StagingRing_IsValid(ring) && ring->flushedPerFrame; }
+
+	//submits the copies on a dedicated transfer queue, so they run alongside rendering instead of in line with it
+	//the queue has to come from a family the device was made with || a family the same as graphics keeps the ring on the graphics queue
+	//the ring's uploads must have been flushed and waited on first || uploads only go into newly made resources, so graphics never has to release them first
+	inline bool StagingRing_UseTransferQueue(StagingRing* ring, VkQueue transferQueue, const uint32 transferQueueFamily, const uint32 graphicsQueueFamily)
+	{
+		if (transferQueue == VK_NULL_HANDLE || transferQueueFamily == graphicsQueueFamily)
+			return true;
+
+		VkCommandPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = transferQueueFamily;
+		if (vkCreateCommandPool(ring->GPU->device, &poolInfo, nullptr, &ring->transferCommandPool) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Staging Ring", "StagingRing_UseTransferQueue", "Failed to create the transfer command pool!");
+			return false;
+		}
+
+		VkSemaphoreCreateInfo semaphoreInfo = {};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		for (size_t i = 0; i < ring->frames.size(); ++i)
+		{
+			if (vkCreateSemaphore(ring->GPU->device, &semaphoreInfo, nullptr, &ring->frames[i].transferDone) != VK_SUCCESS)
+			{
+				BTD_LogError("Smok Renderer", "Staging Ring", "StagingRing_UseTransferQueue", "Failed to create a frame semaphore!");
+				return false;
+			}
+		}
+
+		ring->usesTransferQueue = true;
+		ring->queue = transferQueue;
+		ring->transferQueueFamily = transferQueueFamily; ring->graphicsQueueFamily = graphicsQueueFamily;
+		return true;
+	}
+
+	//allocates and begins a one time command buffer
+	inline bool StagingRing_BeginCommandBuffer(StagingRing* ring, VkCommandPool pool, VkCommandBuffer& comBuffer)
+	{
+		VkCommandBufferAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = pool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(ring->GPU->device, &allocInfo, &comBuffer) != VK_SUCCESS)
+		{
+			BTD_LogError("Smok Renderer", "Staging Ring", "StagingRing_BeginCommandBuffer", "Failed to allocate a command buffer!");
+			comBuffer = VK_NULL_HANDLE;
+			return false;
+		}
+
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(comBuffer, &beginInfo);
+		return true;
+	}
+
+	//records the barriers that leave the uploads readable || with a transfer queue, it records the release on it or the matching acquire on graphics
+	//the buffer barriers cover each copy's range, the images go from transfer dst to shader read only
+	inline void StagingRing_RecordReadBarriers(StagingRing* ring, VkCommandBuffer comBuffer, const bool acquire)
+	{
+		const bool transfersOwnership = ring->usesTransferQueue;
+		const uint32 srcFamily = (transfersOwnership ? ring->transferQueueFamily : VK_QUEUE_FAMILY_IGNORED);
+		const uint32 dstFamily = (transfersOwnership ? ring->graphicsQueueFamily : VK_QUEUE_FAMILY_IGNORED);
+
+		//the release only makes the writes available, the acquire makes them visible to the readers
+		const bool release = (transfersOwnership && !acquire);
+		VkPipelineStageFlags readStages = 0;
+
+		std::vector<VkBufferMemoryBarrier> bufferBarriers(ring->bufferCopies.size());
+		for (size_t i = 0; i < ring->bufferCopies.size(); ++i)
+		{
+			const StagingRing_BufferCopy& copy = ring->bufferCopies[i];
+			VkBufferMemoryBarrier& barrier = bufferBarriers[i];
+			barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.srcQueueFamilyIndex = srcFamily; barrier.dstQueueFamilyIndex = dstFamily;
+			barrier.buffer = copy.buffer;
+			barrier.offset = copy.region.dstOffset; barrier.size = copy.region.size;
+			barrier.srcAccessMask = (acquire ? 0 : VK_ACCESS_TRANSFER_WRITE_BIT);
+			barrier.dstAccessMask = (release ? 0 : copy.dstAccess);
+			readStages |= copy.dstStages;
+		}
+
+		std::vector<VkImageMemoryBarrier> imageBarriers(ring->imageUploads.size());
+		for (size_t i = 0; i < ring->imageUploads.size(); ++i)
+		{
+			VkImageMemoryBarrier& barrier = imageBarriers[i];
+			barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcQueueFamilyIndex = srcFamily; barrier.dstQueueFamilyIndex = dstFamily;
+			barrier.image = ring->imageUploads[i].image;
+			barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, ring->imageUploads[i].mipLevels, 0, 1 };
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL; barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = (acquire ? 0 : VK_ACCESS_TRANSFER_WRITE_BIT);
+			barrier.dstAccessMask = (release ? 0 : VK_ACCESS_SHADER_READ_BIT);
+		}
+		if (!imageBarriers.empty())
+			readStages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+		const VkPipelineStageFlags srcStages = (acquire ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT);
+		const VkPipelineStageFlags dstStages = (release || !readStages ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : readStages);
+		Dispatch_CmdPipelineBarrier(ring->dispatch, comBuffer, srcStages, dstStages, 0, 0, nullptr,
+			(uint32)bufferBarriers.size(), bufferBarriers.data(), (uint32)imageBarriers.size(), imageBarriers.data());
+	}
+
+	//records the queued copies between images, which have to be on the graphics queue
+	//the sources go from shader read only to transfer src and back, after the fragment shaders of earlier submissions are done reading them
+	inline void StagingRing_RecordImageToImageCopies(StagingRing* ring, VkCommandBuffer comBuffer)
+	{
+		if (ring->imageToImageCopies.empty())
+			return;
+
+		const size_t copyCount = ring->imageToImageCopies.size();
+		std::vector<VkImageMemoryBarrier> barriers(copyCount * 2);
+		for (size_t i = 0; i < copyCount; ++i)
+		{
+			const StagingRing_ImageToImageCopy& copy = ring->imageToImageCopies[i];
+			VkImageMemoryBarrier& src = barriers[i * 2];
+			src = {};
+			src.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			src.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; src.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			src.image = copy.srcImage;
+			src.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, copy.srcFirstLevel, copy.mipLevels, 0, 1 };
+			src.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; src.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			src.srcAccessMask = 0; src.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+			VkImageMemoryBarrier& dst = barriers[i * 2 + 1];
+			dst = src;
+			dst.image = copy.dstImage;
+			dst.subresourceRange.baseMipLevel = 0;
+			dst.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; dst.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			dst.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		}
+		Dispatch_CmdPipelineBarrier(ring->dispatch, comBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, (uint32)barriers.size(), barriers.data());
+
+		for (size_t i = 0; i < copyCount; ++i)
+		{
+			const StagingRing_ImageToImageCopy& copy = ring->imageToImageCopies[i];
+			Dispatch_CmdCopyImage(ring->dispatch, comBuffer, copy.srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				copy.dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32)copy.copyCount, &ring->imageToImageRegions[copy.firstCopy]);
+		}
+
+		//both images are left for the fragment shaders
+		for (size_t i = 0; i < barriers.size(); ++i)
+		{
+			barriers[i].srcAccessMask = (i % 2 ? VK_ACCESS_TRANSFER_WRITE_BIT : 0);
+			barriers[i].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			barriers[i].oldLayout = barriers[i].newLayout; barriers[i].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		}
+		Dispatch_CmdPipelineBarrier(ring->dispatch, comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, (uint32)barriers.size(), barriers.data());
+	}
+
+	//records every queued copy into a command buffer and submits it once, with the current frame slot's fence
+	//with a transfer queue, the copies are submitted there and a graphics submission waits on them to take ownership, later graphics work is ordered after it
+	//waits for the slot's last submission first if it's still in flight || does nothing if nothing was queued
+	inline bool StagingRing_Flush(StagingRing* ring)
+	{
+		if (ring->bufferCopies.empty() && ring->imageUploads.empty() && ring->imageToImageCopies.empty())
+			return true;
+
+		StagingRing_Frame& frame = ring->frames[ring->currentFrame];
+		StagingRing_RetireFrame(ring, frame);
+
+		VkCommandPool copyPool = (ring->usesTransferQueue ? ring->transferCommandPool : ring->commandPool->pool);
+		if (!StagingRing_BeginCommandBuffer(ring, copyPool, frame.comBuffer))
+			return false;
+
+		//every image goes to transfer dst in one barrier
+		std::vector<VkImageMemoryBarrier> imageBarriers(ring->imageUploads.size());
+		for (size_t i = 0; i < ring->imageUploads.size(); ++i)
+		{
+			VkImageMemoryBarrier& barrier = imageBarriers[i];
+			barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = ring->imageUploads[i].image;
+			barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, ring->imageUploads[i].mipLevels, 0, 1 };
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcAccessMask = 0; barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		}
+		if (!imageBarriers.empty())
+			Dispatch_CmdPipelineBarrier(ring->dispatch, frame.comBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				0, 0, nullptr, 0, nullptr, (uint32)imageBarriers.size(), imageBarriers.data());
+
+		//the buffer copies, one call per run of copies into the same buffer
+		std::vector<VkBufferCopy> regions;
+		for (size_t i = 0; i < ring->bufferCopies.size(); ++i)
+		{
+			const StagingRing_BufferCopy& copy = ring->bufferCopies[i];
+			regions.emplace_back(copy.region);
+
+			if (i + 1 == ring->bufferCopies.size() || ring->bufferCopies[i + 1].buffer != copy.buffer)
+			{
+				Dispatch_CmdCopyBuffer(ring->dispatch, frame.comBuffer, ring->buffer.buffer, copy.buffer, (uint32)regions.size(), regions.data());
+				regions.clear();
+			}
+		}
+
+		for (size_t i = 0; i < ring->imageUploads.size(); ++i)
+		{
+			const StagingRing_ImageUpload& upload = ring->imageUploads[i];
+			Dispatch_CmdCopyBufferToImage(ring->dispatch, frame.comBuffer, ring->buffer.buffer, upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				(uint32)upload.copyCount, &ring->imageCopies[upload.firstCopy]);
+		}
+
+		//on one queue this makes the copies visible to later submissions, with a transfer queue it's the release
+		StagingRing_RecordReadBarriers(ring, frame.comBuffer, false);
+		if (!ring->usesTransferQueue)
+			StagingRing_RecordImageToImageCopies(ring, frame.comBuffer);
+		vkEndCommandBuffer(frame.comBuffer);
+
+		//the acquire has to match the release exactly, so it's recorded from the same queued copies
+		if (ring->usesTransferQueue)
+		{
+			if (!StagingRing_BeginCommandBuffer(ring, ring->commandPool->pool, frame.acquireComBuffer))
+			{
+				vkFreeCommandBuffers(ring->GPU->device, copyPool, 1, &frame.comBuffer);
+				frame.comBuffer = VK_NULL_HANDLE;
+				return false;
+			}
+			StagingRing_RecordReadBarriers(ring, frame.acquireComBuffer, true);
+			StagingRing_RecordImageToImageCopies(ring, frame.acquireComBuffer);
+			vkEndCommandBuffer(frame.acquireComBuffer);
+		}
+
+		VkSubmitInfo submitInfo = {};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &frame.comBuffer;
+		if (ring->usesTransferQueue)
+		{
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &frame.transferDone;
+		}
+
+		//the fence goes on the last submission, the acquire can only finish after the copies
+		vkResetFences(ring->GPU->device, 1, &frame.fence);
+		bool submitted = (vkQueueSubmit(ring->queue, 1, &submitInfo, (ring->usesTransferQueue ? VK_NULL_HANDLE : frame.fence)) == VK_SUCCESS);
+		if (submitted && ring->usesTransferQueue)
+		{
+			const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			VkSubmitInfo acquireInfo = {};
+			acquireInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			acquireInfo.waitSemaphoreCount = 1;
+			acquireInfo.pWaitSemaphores = &frame.transferDone;
+			acquireInfo.pWaitDstStageMask = &waitStage;
+			acquireInfo.commandBufferCount = 1;
+			acquireInfo.pCommandBuffers = &frame.acquireComBuffer;
+			submitted = (vkQueueSubmit(ring->GPU->graphicsQueue, 1, &acquireInfo, frame.fence) == VK_SUCCESS);
+
+			//the copies are already on the transfer queue, so the command buffers can't be freed until it's idle
+			if (!submitted)
+				vkQueueWaitIdle(ring->queue);
+		}
+
+		if (!submitted)
+		{
+			BTD_LogError("Smok Renderer", "Staging Ring", "StagingRing_Flush", "Failed to submit the uploads!");
+			vkFreeCommandBuffers(ring->GPU->device, copyPool, 1, &frame.comBuffer);
+			if (frame.acquireComBuffer != VK_NULL_HANDLE)
+				vkFreeCommandBuffers(ring->GPU->device, ring->commandPool->pool, 1, &frame.acquireComBuffer);
+			frame.comBuffer = VK_NULL_HANDLE; frame.acquireComBuffer = VK_NULL_HANDLE;
+			return false;
+		}
+
+		frame.inFlight = true;
+		frame.usedBytes = ring->pendingBytes;
+		ring->pendingBytes = 0;
+		ring->bufferCopies.clear(); ring->imageUploads.clear(); ring->imageCopies.clear();
+		ring->imageToImageCopies.clear(); ring->imageToImageRegions.clear();
+		ring->frameStats.submitCount++; ring->totalStats.submitCount++;
+		return true;
+	}
+
+	//moves the ring to a frame slot, waiting for the slot's last submission and freeing it's space || call once per frame before any uploads
+	inline void StagingRing_BeginFrame(StagingRing* ring, const uint32 frameIndex)
+	{
+		ring->currentFrame = frameIndex % (uint32)ring->frames.size();
+		ring->flushedPerFrame = true;
+		StagingRing_RetireFrame(ring, ring->frames[ring->currentFrame]);
+		ring->frameStats = StagingRingStats();
+	}
+
+	//flushes the queued uploads and waits for every submission || for load time and before destroying what the uploads write to
+	inline bool StagingRing_FlushAndWait(StagingRing* ring)
+	{
+		const bool flushed = StagingRing_Flush(ring);
+		for (size_t i = 0; i < ring->frames.size(); ++i)
+			StagingRing_RetireFrame(ring, ring->frames[i]);
+
+		return flushed;
+	}
+
+	//reserves ring space for a upload, stalling on the GPU if the ring is full || fails if the upload is bigger then the ring
+	inline bool StagingRing_Allocate(StagingRing* ring, const size_t size, size_t& offset)
+	{
+		const size_t capacity = ring->buffer.size;
+		if (size > capacity)
+		{
+			BTD_LogError("Smok Renderer", "Staging Ring", "StagingRing_Allocate",
+				std::string("A upload of " + std::to_string(size) + " bytes is bigger then the " + std::to_string(capacity) + " byte ring!").c_str());
+			return false;
+		}
+
+		for (uint32 attempt = 0; attempt < 2; ++attempt)
+		{
+			//fits after the head, or wraps to the start wasting the end
+			const size_t aligned = (ring->head + SMOK_RENDERER_STAGING_RING_ALIGNMENT - 1) & ~(size_t)(SMOK_RENDERER_STAGING_RING_ALIGNMENT - 1);
+			const bool wraps = (aligned + size > capacity);
+			const size_t needed = (wraps ? capacity - ring->head + size : aligned - ring->head + size);
+			if (ring->usedBytes + needed <= capacity)
+			{
+				offset = (wraps ? 0 : aligned);
+				ring->head = offset + size;
+				ring->usedBytes += needed; ring->pendingBytes += needed;
+				return true;
+			}
+
+			//full, submits what's queued and waits for everything in flight to free the ring
+			ring->frameStats.stallCount++; ring->totalStats.stallCount++;
+			if (!StagingRing_FlushAndWait(ring))
+				return false;
+		}
+
+		return false;
+	}
+
+	//copies data into the ring and queues a copy into a buffer
+	//dstStages and dstAccess are how the buffer is read after, like VK_PIPELINE_STAGE_VERTEX_INPUT_BIT and VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+	inline bool StagingRing_UploadBuffer(StagingRing* ring, VkBuffer buffer, const VkDeviceSize bufferOffset, const void* data, const size_t size,
+		const VkPipelineStageFlags dstStages, const VkAccessFlags dstAccess)
+	{
+		size_t offset = 0;
+		if (!size || !StagingRing_Allocate(ring, size, offset))
+			return false;
+
+		Dispatch_RecordUpload(ring->dispatch, (uint64)ring->buffer.buffer, offset, data, size);
+		GPUBuffer_Write(&ring->buffer, ring->allocator, data, size, offset);
+
+		StagingRing_BufferCopy copy;
+		copy.buffer = buffer;
+		copy.region = { (VkDeviceSize)offset, bufferOffset, (VkDeviceSize)size };
+		copy.dstStages = dstStages; copy.dstAccess = dstAccess;
+		ring->bufferCopies.emplace_back(copy);
+
+		ring->frameStats.stagedBytes += size; ring->totalStats.stagedBytes += size;
+		ring->frameStats.bufferCopyCount++; ring->totalStats.bufferCopyCount++;
+		return true;
+	}
+
+	//copies a image's pixels into the ring and queues the copy into every mip, leaving it ready for fragment shaders to read
+	//pixels holds every mip tightly packed at the image's levelOffsets || make the image with GPUImage_Create and no pixels
+	inline bool StagingRing_UploadImage(StagingRing* ring, const GPUImage* image, const void* pixels, const size_t byteSize)
+	{
+		size_t offset = 0;
+		if (!byteSize || !StagingRing_Allocate(ring, byteSize, offset))
+			return false;
+
+		Dispatch_RecordUpload(ring->dispatch, (uint64)ring->buffer.buffer, offset, pixels, byteSize);
+		GPUBuffer_Write(&ring->buffer, ring->allocator, pixels, byteSize, offset);
+
+		StagingRing_ImageUpload upload;
+		upload.image = image->image;
+		upload.mipLevels = image->mipLevels;
+		upload.firstCopy = ring->imageCopies.size(); upload.copyCount = image->mipLevels;
+		for (uint32 i = 0; i < image->mipLevels; ++i)
+		{
+			VkBufferImageCopy copy = {};
+			copy.bufferOffset = offset + (i < image->levelOffsets.size() ? image->levelOffsets[i] : 0);
+			copy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 };
+			copy.imageExtent = { std::max(image->width >> i, (uint32)1), std::max(image->height >> i, (uint32)1), 1 };
+			ring->imageCopies.emplace_back(copy);
+		}
+		ring->imageUploads.emplace_back(upload);
+
+		ring->frameStats.stagedBytes += byteSize; ring->totalStats.stagedBytes += byteSize;
+		ring->frameStats.imageUploadCount++; ring->totalStats.imageUploadCount++;
+		return true;
+	}
+
+	//queues a copy of the source's mips from srcFirstLevel into every mip of the destination, both have to be the same format
+	//the source has to be left for the fragment shaders, like a image from StagingRing_UploadImage || make the destination with GPUImage_Create and no pixels
+	inline bool StagingRing_CopyImage(StagingRing* ring, const GPUImage* srcImage, const uint32 srcFirstLevel, const GPUImage* dstImage)
+	{
+		if (srcImage->format != dstImage->format || srcFirstLevel + dstImage->mipLevels > srcImage->mipLevels)
+		{
+			BTD_LogError("Smok Renderer", "Staging Ring", "StagingRing_CopyImage",
+				"The destination's mips aren't in the source, or they don't share a format!");
+			return false;
+		}
+
+		StagingRing_ImageToImageCopy copy;
+		copy.srcImage = srcImage->image; copy.dstImage = dstImage->image;
+		copy.srcFirstLevel = srcFirstLevel; copy.mipLevels = dstImage->mipLevels;
+		copy.firstCopy = ring->imageToImageRegions.size(); copy.copyCount = dstImage->mipLevels;
+		for (uint32 i = 0; i < dstImage->mipLevels; ++i)
+		{
+			VkImageCopy region = {};
+			region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, srcFirstLevel + i, 0, 1 };
+			region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 };
+			region.extent = { std::max(dstImage->width >> i, (uint32)1), std::max(dstImage->height >> i, (uint32)1), 1 };
+			ring->imageToImageRegions.emplace_back(region);
+		}
+		ring->imageToImageCopies.emplace_back(copy);
+
+		ring->frameStats.imageCopyCount++; ring->totalStats.imageCopyCount++;
+		return true;
+	}
+}
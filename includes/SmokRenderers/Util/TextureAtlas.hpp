@@ -0,0 +1,353 @@
+#pragma once
+
+//defines a texture atlas, small RGBA8 textures are packed into shared pages so things using different ones can still be batched
+//pages are packed with a skyline packer, each image gets a border of it's edge texels copied outward so filtering doesn't bleed
+//with mips, every image is placed on a grid of the smallest mip's texel size so no mip mixes two images
+
+#include <SmokRenderers/Util/StagingRing.hpp>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+
+#include <unordered_map>
+#include <algorithm>
+
+namespace Smok::Renderers::Util
+{
+	//defines a span of the skyline
+	struct SkylinePacker_Node
+	{
+		uint32 x = 0, y = 0, width = 0;
+	};
+
+	//defines a skyline rect packer || places each rect as low as it can, then as far left
+	struct SkylinePacker
+	{
+		uint32 width = 0, height = 0;
+		std::vector<SkylinePacker_Node> skyline;
+		uint64 usedArea = 0;
+	};
+
+	//resets a skyline packer
+	inline void SkylinePacker_Init(SkylinePacker* packer, const uint32 width, const uint32 height)
+	{
+		packer->width = width; packer->height = height;
+		packer->skyline.clear();
+		packer->skyline.emplace_back(SkylinePacker_Node{ 0, 0, width });
+		packer->usedArea = 0;
+	}
+
+	//gets the y a rect would sit at if placed at a node || returns false if it doesn't fit
+	inline bool SkylinePacker_Fit(const SkylinePacker* packer, const size_t node, const uint32 width, const uint32 height, uint32& y)
+	{
+		const uint32 x = packer->skyline[node].x;
+		if (x + width > packer->width)
+			return false;
+
+		y = 0;
+		uint32 widthLeft = width;
+		for (size_t i = node; widthLeft > 0; ++i)
+		{
+			y = std::max(y, packer->skyline[i].y);
+			if (y + height > packer->height)
+				return false;
+
+			widthLeft -= std::min(widthLeft, packer->skyline[i].width);
+		}
+
+		return true;
+	}
+
+	//places a rect || returns false if it doesn't fit
+	inline bool SkylinePacker_Insert(SkylinePacker* packer, const uint32 width, const uint32 height, uint32& outX, uint32& outY)
+	{
+		//finds the lowest top, then the narrowest node
+		size_t bestNode = SIZE_MAX;
+		uint32 bestTop = UINT32_MAX, bestWidth = UINT32_MAX;
+		for (size_t i = 0; i < packer->skyline.size(); ++i)
+		{
+			uint32 y = 0;
+			if (!SkylinePacker_Fit(packer, i, width, height, y))
+				continue;
+
+			if (y + height < bestTop || (y + height == bestTop && packer->skyline[i].width < bestWidth))
+			{
+				bestNode = i; bestTop = y + height; bestWidth = packer->skyline[i].width;
+				outX = packer->skyline[i].x; outY = y;
+			}
+		}
+
+		if (bestNode == SIZE_MAX)
+			return false;
+
+		//raises the skyline under the rect
+		packer->skyline.insert(packer->skyline.begin() + bestNode, SkylinePacker_Node{ outX, outY + height, width });
+		for (size_t i = bestNode + 1; i < packer->skyline.size();)
+		{
+			SkylinePacker_Node& node = packer->skyline[i];
+			const uint32 rectRight = outX + width;
+			if (node.x >= rectRight)
+				break;
+
+			const uint32 overlap = std::min(rectRight - node.x, node.width);
+			node.x += overlap; node.width -= overlap;
+			if (node.width == 0)
+				packer->skyline.erase(packer->skyline.begin() + i);
+			else
+				break;
+		}
+
+		//merges neighbours at the same height
+		for (size_t i = 0; i + 1 < packer->skyline.size();)
+		{
+			if (packer->skyline[i].y == packer->skyline[i + 1].y)
+			{
+				packer->skyline[i].width += packer->skyline[i + 1].width;
+				packer->skyline.erase(packer->skyline.begin() + i + 1);
+			}
+			else
+				++i;
+		}
+
+		packer->usedArea += (uint64)width * (uint64)height;
+		return true;
+	}
+
+	//defines the settings of a texture atlas
+	struct TextureAtlasSettings
+	{
+		uint32 pageSize = 1024; //pages are square
+		uint32 padding = 2; //the border copied out from each image's edge
+		uint32 mipLevels = 1; //the mips every page has, more need coarser placement
+		uint32 maxImageSize = 256; //bigger images aren't packed, they should stay their own texture
+	};
+
+	//defines where a image is in the atlas
+	struct TextureAtlasEntry
+	{
+		uint32 page = 0;
+		uint32 x = 0, y = 0, width = 0, height = 0; //in texels, without the border
+		glm::vec4 uvRect = glm::vec4(0.0f); //the top left and bottom right UVs in the page
+	};
+
+	//defines a page of the atlas
+	struct TextureAtlasPage
+	{
+		SkylinePacker packer; //in blocks of the placement grid
+		std::vector<uint8> pixels; //RGBA8, the top mip
+		GPUImage image;
+		bool isDirty = true; //images were added since it was uploaded
+	};
+
+	//defines a texture atlas
+	struct TextureAtlas
+	{
+		TextureAtlasSettings settings;
+		std::vector<TextureAtlasPage> pages;
+		std::unordered_map<uint64, TextureAtlasEntry> entries; //by the ID of the texture
+	};
+
+	//gets the placement grid size, every image starts on it so the smallest mip never mixes images
+	inline uint32 TextureAtlas_GetBlockSize(const TextureAtlas* atlas)
+	{
+		return 1u << (std::max(atlas->settings.mipLevels, (uint32)1) - 1);
+	}
+
+	//resets a atlas || destroy it first if it has pages on the GPU
+	inline void TextureAtlas_Init(TextureAtlas* atlas, const TextureAtlasSettings& settings)
+	{
+		*atlas = TextureAtlas();
+		atlas->settings = settings;
+
+		//the page has to be a whole number of blocks
+		const uint32 blockSize = TextureAtlas_GetBlockSize(atlas);
+		atlas->settings.pageSize = std::max((atlas->settings.pageSize / blockSize) * blockSize, blockSize);
+	}
+
+	//gets a image's entry || returns nullptr if it's not in the atlas
+	inline const TextureAtlasEntry* TextureAtlas_GetEntry(const TextureAtlas* atlas, const uint64& ID)
+	{
+		auto entry = atlas->entries.find(ID);
+		return (entry != atlas->entries.end() ? &entry->second : nullptr);
+	}
+
+	//adds a RGBA8 image || returns nullptr if it's too big to pack, a image already added returns it's old entry
+	inline const TextureAtlasEntry* TextureAtlas_AddImage(TextureAtlas* atlas, const uint64& ID, const uint8* pixels,
+		const uint32 width, const uint32 height)
+	{
+		if (const TextureAtlasEntry* entry = TextureAtlas_GetEntry(atlas, ID))
+			return entry;
+
+		const TextureAtlasSettings& settings = atlas->settings;
+		if (width == 0 || height == 0 || width > settings.maxImageSize || height > settings.maxImageSize)
+			return nullptr;
+
+		//the padded size in blocks
+		const uint32 blockSize = TextureAtlas_GetBlockSize(atlas);
+		const uint32 paddedWidth = width + settings.padding * 2, paddedHeight = height + settings.padding * 2;
+		const uint32 blockWidth = (paddedWidth + blockSize - 1) / blockSize, blockHeight = (paddedHeight + blockSize - 1) / blockSize;
+		const uint32 pageBlocks = settings.pageSize / blockSize;
+		if (blockWidth > pageBlocks || blockHeight > pageBlocks)
+		{
+			BTD_LogError("Smok Renderer", "Texture Atlas", "TextureAtlas_AddImage", "The image and it's padding are bigger then a page!");
+			return nullptr;
+		}
+
+		//tries the existing pages, then makes a new one
+		uint32 page = 0, blockX = 0, blockY = 0;
+		for (; page < atlas->pages.size(); ++page)
+		{
+			if (SkylinePacker_Insert(&atlas->pages[page].packer, blockWidth, blockHeight, blockX, blockY))
+				break;
+		}
+		if (page == atlas->pages.size())
+		{
+			TextureAtlasPage& newPage = atlas->pages.emplace_back();
+			SkylinePacker_Init(&newPage.packer, pageBlocks, pageBlocks);
+			newPage.pixels.assign((size_t)settings.pageSize * settings.pageSize * 4, 0);
+			SkylinePacker_Insert(&newPage.packer, blockWidth, blockHeight, blockX, blockY);
+		}
+
+		//copies the image with it's edges extruded into the padding and the rest of the rounded up blocks
+		//|| the rounding is part of what mips average, leaving it zero would darken the image's edges in the coarse mips
+		TextureAtlasPage& dst = atlas->pages[page];
+		const uint32 originX = blockX * blockSize, originY = blockY * blockSize;
+		const uint32 areaWidth = blockWidth * blockSize, areaHeight = blockHeight * blockSize;
+		for (uint32 y = 0; y < areaHeight; ++y)
+		{
+			const uint32 srcY = (uint32)std::min(std::max((int32)y - (int32)settings.padding, (int32)0), (int32)height - 1);
+			for (uint32 x = 0; x < areaWidth; ++x)
+			{
+				const uint32 srcX = (uint32)std::min(std::max((int32)x - (int32)settings.padding, (int32)0), (int32)width - 1);
+				memcpy(&dst.pixels[((size_t)(originY + y) * settings.pageSize + (originX + x)) * 4],
+					&pixels[((size_t)srcY * width + srcX) * 4], 4);
+			}
+		}
+		dst.isDirty = true;
+
+		TextureAtlasEntry& entry = atlas->entries[ID];
+		entry.page = page;
+		entry.x = originX + settings.padding; entry.y = originY + settings.padding;
+		entry.width = width; entry.height = height;
+		const float pageSize = (float)settings.pageSize;
+		entry.uvRect = glm::vec4((float)entry.x / pageSize, (float)entry.y / pageSize,
+			(float)(entry.x + width) / pageSize, (float)(entry.y + height) / pageSize);
+
+		return &entry;
+	}
+
+	//loads a image file and adds it || returns nullptr if it can't be loaded or is too big to pack
+	inline const TextureAtlasEntry* TextureAtlas_AddImageFile(TextureAtlas* atlas, const uint64& ID, const std::string& path)
+	{
+		if (const TextureAtlasEntry* entry = TextureAtlas_GetEntry(atlas, ID))
+			return entry;
+
+		int width = 0, height = 0, channels = 0;
+		stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+		if (!pixels)
+		{
+			BTD_LogError("Smok Renderer", "Texture Atlas", "TextureAtlas_AddImageFile",
+				std::string("Failed to load a image at \"" + path + "\", " + stbi_failure_reason()).c_str());
+			return nullptr;
+		}
+
+		const TextureAtlasEntry* entry = TextureAtlas_AddImage(atlas, ID, pixels, (uint32)width, (uint32)height);
+		stbi_image_free(pixels);
+		return entry;
+	}
+
+	//maps a UV in a image to the UV in it's page
+	inline glm::vec2 TextureAtlas_RemapUV(const TextureAtlasEntry& entry, const glm::vec2& uv)
+	{
+		return glm::vec2(entry.uvRect.x + (entry.uvRect.z - entry.uvRect.x) * uv.x,
+			entry.uvRect.y + (entry.uvRect.w - entry.uvRect.y) * uv.y);
+	}
+
+	//maps a top left, bottom right UV rect in a image to the one in it's page
+	inline glm::vec4 TextureAtlas_RemapUVRect(const TextureAtlasEntry& entry, const glm::vec4& uvRect)
+	{
+		const glm::vec2 topLeft = TextureAtlas_RemapUV(entry, glm::vec2(uvRect.x, uvRect.y));
+		const glm::vec2 bottomRight = TextureAtlas_RemapUV(entry, glm::vec2(uvRect.z, uvRect.w));
+		return glm::vec4(topLeft.x, topLeft.y, bottomRight.x, bottomRight.y);
+	}
+
+	//makes the mips of a page with a box filter || the result holds every mip tightly packed
+	inline void TextureAtlas_GenerateMips(const TextureAtlas* atlas, const TextureAtlasPage& page,
+		std::vector<uint8>& mips, std::vector<size_t>& levelOffsets)
+	{
+		const uint32 mipLevels = std::max(atlas->settings.mipLevels, (uint32)1);
+		levelOffsets.assign(1, 0);
+		mips = page.pixels;
+
+		uint32 size = atlas->settings.pageSize;
+		for (uint32 level = 1; level < mipLevels && size > 1; ++level)
+		{
+			const size_t srcOffset = levelOffsets.back();
+			const uint32 srcSize = size;
+			size /= 2;
+
+			levelOffsets.emplace_back(mips.size());
+			mips.resize(mips.size() + (size_t)size * size * 4);
+			for (uint32 y = 0; y < size; ++y)
+			{
+				for (uint32 x = 0; x < size; ++x)
+				{
+					for (uint32 c = 0; c < 4; ++c)
+					{
+						const uint8* src = &mips[srcOffset + ((size_t)(y * 2) * srcSize + x * 2) * 4 + c];
+						const uint32 sum = src[0] + src[4] + src[(size_t)srcSize * 4] + src[(size_t)srcSize * 4 + 4];
+						mips[levelOffsets.back() + ((size_t)y * size + x) * 4 + c] = (uint8)((sum + 2) / 4);
+					}
+				}
+			}
+		}
+	}
+
+	//uploads the pages that changed, remaking their images || for load time, it stalls the graphics queue
+	//with a staging ring the uploads are queued into it instead, and are done once the ring is flushed
+	//the page's views change, so anything sampling a dirty page has to be rebound
+	inline bool TextureAtlas_CreatePages(TextureAtlas* atlas, SMGraphics_Core_GPU* GPU, VmaAllocator allocator, SMGraphics_Pool_CommandPool* commandPool,
+		StagingRing* stagingRing = nullptr)
+	{
+		const bool staged = StagingRing_IsValid(stagingRing);
+		std::vector<uint8> mips; std::vector<size_t> levelOffsets;
+		for (size_t i = 0; i < atlas->pages.size(); ++i)
+		{
+			TextureAtlasPage& page = atlas->pages[i];
+			if (!page.isDirty)
+				continue;
+
+			if (page.image.image != VK_NULL_HANDLE)
+			{
+				//the old image may still have a upload queued
+				if (staged)
+					StagingRing_FlushAndWait(stagingRing);
+				vkDeviceWaitIdle(GPU->device);
+				GPUImage_Destroy(&page.image, GPU->device, allocator);
+			}
+
+			TextureAtlas_GenerateMips(atlas, page, mips, levelOffsets);
+			if (!GPUImage_Create(&page.image, GPU->device, allocator, VK_FORMAT_R8G8B8A8_UNORM, atlas->settings.pageSize, atlas->settings.pageSize,
+				(staged ? nullptr : mips.data()), mips.size(), levelOffsets) ||
+				!(staged ? StagingRing_UploadImage(stagingRing, &page.image, mips.data(), mips.size()) : GPUImage_UploadNow(&page.image, GPU, allocator, commandPool)))
+			{
+				BTD_LogError("Smok Renderer", "Texture Atlas", "TextureAtlas_CreatePages", std::string("Failed to upload page " + std::to_string(i)).c_str());
+				return false;
+			}
+
+			page.isDirty = false;
+		}
+
+		return true;
+	}
+
+	//destroys the atlas's pages on the GPU and clears it
+	inline void TextureAtlas_Destroy(TextureAtlas* atlas, VkDevice device, VmaAllocator allocator)
+	{
+		for (size_t i = 0; i < atlas->pages.size(); ++i)
+			GPUImage_Destroy(&atlas->pages[i].image, device, allocator);
+
+		TextureAtlas_Init(atlas, atlas->settings);
+	}
+}
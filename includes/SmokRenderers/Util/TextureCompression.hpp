@@ -0,0 +1,680 @@
+#pragma once
+
+//defines the block compressed texture formats and a CPU encoder and decoder for them
+//BC1 is 8 bytes per 4x4 block (8x smaller then RGBA8), BC3, BC5 and BC7 are 16 (4x smaller)
+//the encoder is for the cook step, the decoder is the fallback for devices that can't sample them
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace Smok::Renderers::Util
+{
+	//defines how a texture is compressed
+	enum class TextureCompression
+	{
+		None = 0, //RGBA8
+		BC1, //RGB with 1 bit alpha, for color maps without smooth alpha
+		BC3, //RGBA, BC1 color with a separate alpha block
+		BC5, //two channels, for normal maps
+		BC7, //RGBA at high quality, the encoder only makes mode 6 blocks
+
+		Count
+	};
+
+	//gets the Vulkan format of a compression || BC5 has no sRGB format
+	inline VkFormat TextureCompression_GetFormat(const TextureCompression compression, const bool sRGB)
+	{
+		switch (compression)
+		{
+		case TextureCompression::BC1: return (sRGB ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK);
+		case TextureCompression::BC3: return (sRGB ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK);
+		case TextureCompression::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+		case TextureCompression::BC7: return (sRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK);
+		default: return (sRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM);
+		}
+	}
+
+	//gets the compression of a Vulkan format || returns Count if it's not one of them
+	inline TextureCompression TextureCompression_FromFormat(const VkFormat format, bool& sRGB)
+	{
+		sRGB = false;
+		switch (format)
+		{
+		case VK_FORMAT_R8G8B8A8_SRGB: sRGB = true; return TextureCompression::None;
+		case VK_FORMAT_R8G8B8A8_UNORM: return TextureCompression::None;
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK: case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: sRGB = true; return TextureCompression::BC1;
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK: case VK_FORMAT_BC1_RGBA_UNORM_BLOCK: return TextureCompression::BC1;
+		case VK_FORMAT_BC3_SRGB_BLOCK: sRGB = true; return TextureCompression::BC3;
+		case VK_FORMAT_BC3_UNORM_BLOCK: return TextureCompression::BC3;
+		case VK_FORMAT_BC5_UNORM_BLOCK: return TextureCompression::BC5;
+		case VK_FORMAT_BC7_SRGB_BLOCK: sRGB = true; return TextureCompression::BC7;
+		case VK_FORMAT_BC7_UNORM_BLOCK: return TextureCompression::BC7;
+		default: return TextureCompression::Count;
+		}
+	}
+
+	//gets the bytes of a 4x4 block, or of a pixel when it's not compressed
+	inline uint32 TextureCompression_GetBlockBytes(const TextureCompression compression)
+	{
+		return (compression == TextureCompression::None ? 4 : (compression == TextureCompression::BC1 ? 8 : 16));
+	}
+
+	//gets the bytes of a mip level
+	inline size_t TextureCompression_GetLevelByteSize(const TextureCompression compression, const uint32 width, const uint32 height)
+	{
+		if (compression == TextureCompression::None)
+			return (size_t)width * height * 4;
+
+		return (size_t)((width + 3) / 4) * ((height + 3) / 4) * TextureCompression_GetBlockBytes(compression);
+	}
+
+	//---encoding
+
+	//packs a color into 565
+	inline uint16 BlockCompression_PackRGB565(const int32 r, const int32 g, const int32 b)
+	{
+		return (uint16)((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+	}
+
+	//unpacks a 565 color into 8 bits a channel
+	inline void BlockCompression_UnpackRGB565(const uint16 color, int32* rgb)
+	{
+		const int32 r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+		rgb[0] = (r << 3) | (r >> 2); rgb[1] = (g << 2) | (g >> 4); rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	//finds the two pixels at the ends of the block's principal axis, over the first channelCount channels
+	inline void BlockCompression_FindEndpoints(const uint8* pixels, const uint32 channelCount, float* minColor, float* maxColor)
+	{
+		float mean[4] = {};
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			for (uint32 c = 0; c < channelCount; ++c)
+				mean[c] += pixels[i * 4 + c] / 16.0f;
+		}
+
+		float covariance[4][4] = {};
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			for (uint32 a = 0; a < channelCount; ++a)
+			{
+				for (uint32 b = 0; b < channelCount; ++b)
+					covariance[a][b] += (pixels[i * 4 + a] - mean[a]) * (pixels[i * 4 + b] - mean[b]);
+			}
+		}
+
+		//power iteration for the principal axis
+		float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (uint32 iteration = 0; iteration < 8; ++iteration)
+		{
+			float next[4] = {}, length = 0.0f;
+			for (uint32 a = 0; a < channelCount; ++a)
+			{
+				for (uint32 b = 0; b < channelCount; ++b)
+					next[a] += covariance[a][b] * axis[b];
+				length = std::max(length, std::fabs(next[a]));
+			}
+			if (length <= 0.0f)
+				break;
+			for (uint32 a = 0; a < channelCount; ++a)
+				axis[a] = next[a] / length;
+		}
+
+		float minDot = 0.0f, maxDot = 0.0f;
+		uint32 minIndex = 0, maxIndex = 0;
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			float dot = 0.0f;
+			for (uint32 c = 0; c < channelCount; ++c)
+				dot += (pixels[i * 4 + c] - mean[c]) * axis[c];
+
+			if (i == 0 || dot < minDot) { minDot = dot; minIndex = i; }
+			if (i == 0 || dot > maxDot) { maxDot = dot; maxIndex = i; }
+		}
+
+		for (uint32 c = 0; c < channelCount; ++c)
+		{
+			minColor[c] = pixels[minIndex * 4 + c];
+			maxColor[c] = pixels[maxIndex * 4 + c];
+		}
+	}
+
+	//gets the squared distance between a pixel and a color over the first channelCount channels
+	inline int32 BlockCompression_Distance(const uint8* pixel, const int32* color, const uint32 channelCount)
+	{
+		int32 distance = 0;
+		for (uint32 c = 0; c < channelCount; ++c)
+			distance += (pixel[c] - color[c]) * (pixel[c] - color[c]);
+		return distance;
+	}
+
+	//picks the nearest BC1 palette entry for every pixel || returns the total error
+	inline int32 BlockCompression_PickBC1Indices(const uint8* pixels, const uint16 color0, const uint16 color1, const bool threeColor,
+		uint32& indices)
+	{
+		int32 palette[4][3];
+		BlockCompression_UnpackRGB565(color0, palette[0]); BlockCompression_UnpackRGB565(color1, palette[1]);
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			palette[2][c] = (threeColor ? (palette[0][c] + palette[1][c]) / 2 : (2 * palette[0][c] + palette[1][c]) / 3);
+			palette[3][c] = (threeColor ? 0 : (palette[0][c] + 2 * palette[1][c]) / 3);
+		}
+
+		indices = 0;
+		int32 error = 0;
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			const uint8* pixel = &pixels[i * 4];
+
+			//transparent pixels take the punch through index
+			if (threeColor && pixel[3] < 128)
+			{
+				indices |= 3u << (i * 2);
+				continue;
+			}
+
+			uint32 best = 0; int32 bestDistance = INT32_MAX;
+			for (uint32 p = 0; p < (threeColor ? 3u : 4u); ++p)
+			{
+				const int32 distance = BlockCompression_Distance(pixel, palette[p], 3);
+				if (distance < bestDistance) { bestDistance = distance; best = p; }
+			}
+			indices |= best << (i * 2);
+			error += bestDistance;
+		}
+
+		return error;
+	}
+
+	//encodes a BC1 block from 16 RGBA pixels || alphaPunchThrough uses the 3 color mode for blocks with transparent pixels,
+	//off for the color half of BC3, which is always read as 4 colors
+	inline void BlockCompression_EncodeBC1Block(const uint8* pixels, uint8* block, const bool alphaPunchThrough)
+	{
+		bool threeColor = false;
+		for (uint32 i = 0; i < 16 && alphaPunchThrough; ++i)
+			threeColor |= (pixels[i * 4 + 3] < 128);
+
+		float minColor[4], maxColor[4];
+		BlockCompression_FindEndpoints(pixels, 3, minColor, maxColor);
+		uint16 color0 = BlockCompression_PackRGB565((int32)maxColor[0], (int32)maxColor[1], (int32)maxColor[2]);
+		uint16 color1 = BlockCompression_PackRGB565((int32)minColor[0], (int32)minColor[1], (int32)minColor[2]);
+
+		//4 colors needs color0 > color1, 3 colors needs color0 <= color1
+		if ((!threeColor && color0 < color1) || (threeColor && color0 > color1))
+			std::swap(color0, color1);
+
+		uint32 indices = 0;
+		int32 error = BlockCompression_PickBC1Indices(pixels, color0, color1, threeColor, indices);
+
+		//one least squares pass to move the endpoints to where the picked indices want them
+		if (!threeColor && color0 != color1)
+		{
+			static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+			float aa = 0.0f, bb = 0.0f, ab = 0.0f, ax[3] = {}, bx[3] = {};
+			for (uint32 i = 0; i < 16; ++i)
+			{
+				const float a = weights[(indices >> (i * 2)) & 3], b = 1.0f - a;
+				aa += a * a; bb += b * b; ab += a * b;
+				for (uint32 c = 0; c < 3; ++c)
+				{
+					ax[c] += a * pixels[i * 4 + c]; bx[c] += b * pixels[i * 4 + c];
+				}
+			}
+
+			const float determinant = aa * bb - ab * ab;
+			if (std::fabs(determinant) > 1e-6f)
+			{
+				int32 end0[3], end1[3];
+				for (uint32 c = 0; c < 3; ++c)
+				{
+					end0[c] = std::clamp((int32)std::lround((ax[c] * bb - bx[c] * ab) / determinant), 0, 255);
+					end1[c] = std::clamp((int32)std::lround((bx[c] * aa - ax[c] * ab) / determinant), 0, 255);
+				}
+
+				uint16 refined0 = BlockCompression_PackRGB565(end0[0], end0[1], end0[2]);
+				uint16 refined1 = BlockCompression_PackRGB565(end1[0], end1[1], end1[2]);
+				if (refined0 < refined1)
+					std::swap(refined0, refined1);
+
+				uint32 refinedIndices = 0;
+				const int32 refinedError = BlockCompression_PickBC1Indices(pixels, refined0, refined1, false, refinedIndices);
+				if (refined0 != refined1 && refinedError < error)
+				{
+					color0 = refined0; color1 = refined1; indices = refinedIndices; error = refinedError;
+				}
+			}
+		}
+
+		block[0] = (uint8)(color0 & 0xFF); block[1] = (uint8)(color0 >> 8);
+		block[2] = (uint8)(color1 & 0xFF); block[3] = (uint8)(color1 >> 8);
+		for (uint32 i = 0; i < 4; ++i)
+			block[4 + i] = (uint8)((indices >> (i * 8)) & 0xFF);
+	}
+
+	//encodes a BC4 block from one channel of 16 RGBA pixels
+	inline void BlockCompression_EncodeBC4Block(const uint8* pixels, const uint32 channel, uint8* block)
+	{
+		int32 minValue = 255, maxValue = 0;
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			minValue = std::min(minValue, (int32)pixels[i * 4 + channel]);
+			maxValue = std::max(maxValue, (int32)pixels[i * 4 + channel]);
+		}
+
+		//the 8 value mode, with endpoint 0 the max
+		int32 palette[8] = { maxValue, minValue };
+		for (int32 i = 1; i < 7; ++i)
+			palette[i + 1] = ((7 - i) * maxValue + i * minValue) / 7;
+
+		uint64 indices = 0;
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			const int32 value = pixels[i * 4 + channel];
+			uint64 best = 0; int32 bestDistance = INT32_MAX;
+			for (uint32 p = 0; p < 8; ++p)
+			{
+				const int32 distance = std::abs(value - palette[p]);
+				if (distance < bestDistance) { bestDistance = distance; best = p; }
+			}
+			indices |= best << (i * 3);
+		}
+
+		block[0] = (uint8)maxValue; block[1] = (uint8)minValue;
+		for (uint32 i = 0; i < 6; ++i)
+			block[2 + i] = (uint8)((indices >> (i * 8)) & 0xFF);
+	}
+
+	//writes bits into a 128 bit block, lowest bit first
+	inline void BlockCompression_WriteBits(uint8* block, uint32& bitOffset, const uint32 value, const uint32 bitCount)
+	{
+		for (uint32 i = 0; i < bitCount; ++i, ++bitOffset)
+		{
+			if ((value >> i) & 1)
+				block[bitOffset / 8] |= (uint8)(1 << (bitOffset % 8));
+		}
+	}
+
+	//reads bits from a 128 bit block, lowest bit first
+	inline uint32 BlockCompression_ReadBits(const uint8* block, uint32& bitOffset, const uint32 bitCount)
+	{
+		uint32 value = 0;
+		for (uint32 i = 0; i < bitCount; ++i, ++bitOffset)
+			value |= (uint32)((block[bitOffset / 8] >> (bitOffset % 8)) & 1) << i;
+		return value;
+	}
+
+	//the BC7 interpolation weights for 2, 3 and 4 bit indices
+	inline const uint8* BlockCompression_GetBC7Weights(const uint32 indexBits)
+	{
+		static const uint8 weights2[4] = { 0, 21, 43, 64 };
+		static const uint8 weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+		static const uint8 weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+		return (indexBits == 2 ? weights2 : (indexBits == 3 ? weights3 : weights4));
+	}
+
+	//encodes a BC7 mode 6 block from 16 RGBA pixels, a single subset with 7 bit RGBA endpoints, a p bit each and 4 bit indices
+	inline void BlockCompression_EncodeBC7Block(const uint8* pixels, uint8* block)
+	{
+		float minColor[4], maxColor[4];
+		BlockCompression_FindEndpoints(pixels, 4, minColor, maxColor);
+
+		//quantizes each endpoint to 7 bits with the p bit that fits it best
+		int32 endpoints[2][4]; uint32 pBits[2], quantized[2][4];
+		const float* ends[2] = { minColor, maxColor };
+		for (uint32 e = 0; e < 2; ++e)
+		{
+			int32 bestError = INT32_MAX;
+			for (uint32 p = 0; p < 2; ++p)
+			{
+				int32 error = 0; uint32 values[4]; int32 expanded[4];
+				for (uint32 c = 0; c < 4; ++c)
+				{
+					values[c] = (uint32)std::clamp((int32)std::lround((ends[e][c] - (float)p) / 2.0f), 0, 127);
+					expanded[c] = (int32)((values[c] << 1) | p);
+					error += (int32)((expanded[c] - ends[e][c]) * (expanded[c] - ends[e][c]));
+				}
+				if (error < bestError)
+				{
+					bestError = error; pBits[e] = p;
+					for (uint32 c = 0; c < 4; ++c) { quantized[e][c] = values[c]; endpoints[e][c] = expanded[c]; }
+				}
+			}
+		}
+
+		const uint8* weights = BlockCompression_GetBC7Weights(4);
+		int32 palette[16][4];
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			for (uint32 c = 0; c < 4; ++c)
+				palette[i][c] = ((64 - weights[i]) * endpoints[0][c] + weights[i] * endpoints[1][c] + 32) >> 6;
+		}
+
+		uint32 indices[16];
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			int32 bestDistance = INT32_MAX;
+			for (uint32 p = 0; p < 16; ++p)
+			{
+				const int32 distance = BlockCompression_Distance(&pixels[i * 4], palette[p], 4);
+				if (distance < bestDistance) { bestDistance = distance; indices[i] = p; }
+			}
+		}
+
+		//the first index's top bit isn't stored, so it has to be 0
+		if (indices[0] >= 8)
+		{
+			for (uint32 c = 0; c < 4; ++c)
+				std::swap(quantized[0][c], quantized[1][c]);
+			std::swap(pBits[0], pBits[1]);
+			for (uint32 i = 0; i < 16; ++i)
+				indices[i] = 15 - indices[i];
+		}
+
+		std::fill(block, block + 16, (uint8)0);
+		uint32 bitOffset = 0;
+		BlockCompression_WriteBits(block, bitOffset, 1 << 6, 7);
+		for (uint32 c = 0; c < 4; ++c)
+		{
+			BlockCompression_WriteBits(block, bitOffset, quantized[0][c], 7);
+			BlockCompression_WriteBits(block, bitOffset, quantized[1][c], 7);
+		}
+		BlockCompression_WriteBits(block, bitOffset, pBits[0], 1);
+		BlockCompression_WriteBits(block, bitOffset, pBits[1], 1);
+		for (uint32 i = 0; i < 16; ++i)
+			BlockCompression_WriteBits(block, bitOffset, indices[i], (i == 0 ? 3 : 4));
+	}
+
+	//gets the 16 RGBA pixels of a block, repeating the edge pixels for blocks hanging off the image
+	inline void BlockCompression_GatherBlock(const uint8* rgba, const uint32 width, const uint32 height, const uint32 blockX, const uint32 blockY,
+		uint8* pixels)
+	{
+		for (uint32 y = 0; y < 4; ++y)
+		{
+			for (uint32 x = 0; x < 4; ++x)
+			{
+				const uint32 srcX = std::min(blockX * 4 + x, width - 1), srcY = std::min(blockY * 4 + y, height - 1);
+				memcpy(&pixels[(y * 4 + x) * 4], &rgba[((size_t)srcY * width + srcX) * 4], 4);
+			}
+		}
+	}
+
+	//encodes a RGBA8 image || None just copies it
+	inline void BlockCompression_Encode(const TextureCompression compression, const uint8* rgba, const uint32 width, const uint32 height,
+		std::vector<uint8>& output)
+	{
+		output.resize(TextureCompression_GetLevelByteSize(compression, width, height));
+		if (compression == TextureCompression::None)
+		{
+			memcpy(output.data(), rgba, output.size());
+			return;
+		}
+
+		const uint32 blocksX = (width + 3) / 4, blocksY = (height + 3) / 4, blockBytes = TextureCompression_GetBlockBytes(compression);
+		uint8 pixels[64];
+		for (uint32 by = 0; by < blocksY; ++by)
+		{
+			for (uint32 bx = 0; bx < blocksX; ++bx)
+			{
+				BlockCompression_GatherBlock(rgba, width, height, bx, by, pixels);
+				uint8* block = &output[((size_t)by * blocksX + bx) * blockBytes];
+				switch (compression)
+				{
+				case TextureCompression::BC1: BlockCompression_EncodeBC1Block(pixels, block, true); break;
+				case TextureCompression::BC3: BlockCompression_EncodeBC4Block(pixels, 3, block); BlockCompression_EncodeBC1Block(pixels, block + 8, false); break;
+				case TextureCompression::BC5: BlockCompression_EncodeBC4Block(pixels, 0, block); BlockCompression_EncodeBC4Block(pixels, 1, block + 8); break;
+				case TextureCompression::BC7: BlockCompression_EncodeBC7Block(pixels, block); break;
+				default: break;
+				}
+			}
+		}
+	}
+
+	//---decoding
+
+	//decodes a BC1 block into 16 RGBA pixels || fourColorOnly is for the color half of BC3
+	inline void BlockCompression_DecodeBC1Block(const uint8* block, uint8* pixels, const bool fourColorOnly)
+	{
+		const uint16 color0 = (uint16)(block[0] | (block[1] << 8)), color1 = (uint16)(block[2] | (block[3] << 8));
+		int32 palette[4][4];
+		BlockCompression_UnpackRGB565(color0, palette[0]); BlockCompression_UnpackRGB565(color1, palette[1]);
+		palette[0][3] = 255; palette[1][3] = 255;
+
+		const bool threeColor = (!fourColorOnly && color0 <= color1);
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			palette[2][c] = (threeColor ? (palette[0][c] + palette[1][c]) / 2 : (2 * palette[0][c] + palette[1][c]) / 3);
+			palette[3][c] = (threeColor ? 0 : (palette[0][c] + 2 * palette[1][c]) / 3);
+		}
+		palette[2][3] = 255; palette[3][3] = (threeColor ? 0 : 255);
+
+		const uint32 indices = (uint32)block[4] | ((uint32)block[5] << 8) | ((uint32)block[6] << 16) | ((uint32)block[7] << 24);
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			const uint32 index = (indices >> (i * 2)) & 3;
+			for (uint32 c = 0; c < 4; ++c)
+				pixels[i * 4 + c] = (uint8)palette[index][c];
+		}
+	}
+
+	//decodes a BC4 block into one channel of 16 RGBA pixels
+	inline void BlockCompression_DecodeBC4Block(const uint8* block, uint8* pixels, const uint32 channel)
+	{
+		const int32 value0 = block[0], value1 = block[1];
+		int32 palette[8] = { value0, value1 };
+		if (value0 > value1)
+		{
+			for (int32 i = 1; i < 7; ++i)
+				palette[i + 1] = ((7 - i) * value0 + i * value1) / 7;
+		}
+		else
+		{
+			for (int32 i = 1; i < 5; ++i)
+				palette[i + 1] = ((5 - i) * value0 + i * value1) / 5;
+			palette[6] = 0; palette[7] = 255;
+		}
+
+		uint64 indices = 0;
+		for (uint32 i = 0; i < 6; ++i)
+			indices |= (uint64)block[2 + i] << (i * 8);
+		for (uint32 i = 0; i < 16; ++i)
+			pixels[i * 4 + channel] = (uint8)palette[(indices >> (i * 3)) & 7];
+	}
+
+	//the BC7 2 subset partitions, bit i is the subset of pixel i
+	inline uint32 BlockCompression_GetBC7Partition2(const uint32 partition, const uint32 pixel)
+	{
+		static const uint16 partitions[64] = {
+			0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+			0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+			0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+			0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22 };
+		return (partitions[partition] >> pixel) & 1;
+	}
+
+	//the BC7 3 subset partitions, 2 bits a pixel, pixel 0 lowest
+	inline uint32 BlockCompression_GetBC7Partition3(const uint32 partition, const uint32 pixel)
+	{
+		static const uint8 partitions[64][16] = {
+			{0,0,1,1,0,0,1,1,0,2,2,1,2,2,2,2}, {0,0,0,1,0,0,1,1,2,2,1,1,2,2,2,1}, {0,0,0,0,2,0,0,1,2,2,1,1,2,2,1,1}, {0,2,2,2,0,0,2,2,0,0,1,1,0,1,1,1},
+			{0,0,0,0,0,0,0,0,1,1,2,2,1,1,2,2}, {0,0,1,1,0,0,1,1,0,0,2,2,0,0,2,2}, {0,0,2,2,0,0,2,2,1,1,1,1,1,1,1,1}, {0,0,1,1,0,0,1,1,2,2,1,1,2,2,1,1},
+			{0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2}, {0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2}, {0,0,0,0,1,1,1,1,2,2,2,2,2,2,2,2}, {0,0,1,2,0,0,1,2,0,0,1,2,0,0,1,2},
+			{0,1,1,2,0,1,1,2,0,1,1,2,0,1,1,2}, {0,1,2,2,0,1,2,2,0,1,2,2,0,1,2,2}, {0,0,1,1,0,1,1,2,1,1,2,2,1,2,2,2}, {0,0,1,1,2,0,0,1,2,2,0,0,2,2,2,0},
+			{0,0,0,1,0,0,1,1,0,1,1,2,1,1,2,2}, {0,1,1,1,0,0,1,1,2,0,0,1,2,2,0,0}, {0,0,0,0,1,1,2,2,1,1,2,2,1,1,2,2}, {0,0,2,2,0,0,2,2,0,0,2,2,1,1,1,1},
+			{0,1,1,1,0,1,1,1,0,2,2,2,0,2,2,2}, {0,0,0,1,0,0,0,1,2,2,2,1,2,2,2,1}, {0,0,0,0,0,0,1,1,0,1,2,2,0,1,2,2}, {0,0,0,0,1,1,0,0,2,2,1,0,2,2,1,0},
+			{0,1,2,2,0,1,2,2,0,0,1,1,0,0,0,0}, {0,0,1,2,0,0,1,2,1,1,2,2,2,2,2,2}, {0,1,1,0,1,2,2,1,1,2,2,1,0,1,1,0}, {0,0,0,0,0,1,1,0,1,2,2,1,1,2,2,1},
+			{0,0,2,2,1,1,0,2,1,1,0,2,0,0,2,2}, {0,1,1,0,0,1,1,0,2,0,0,2,2,2,2,2}, {0,0,1,1,0,1,2,2,0,1,2,2,0,0,1,1}, {0,0,0,0,2,0,0,0,2,2,1,1,2,2,2,1},
+			{0,0,0,0,0,0,0,2,1,1,2,2,1,2,2,2}, {0,2,2,2,0,0,2,2,0,0,1,2,0,0,1,1}, {0,0,1,1,0,0,1,2,0,0,2,2,0,2,2,2}, {0,1,2,0,0,1,2,0,0,1,2,0,0,1,2,0},
+			{0,0,0,0,1,1,1,1,2,2,2,2,0,0,0,0}, {0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0}, {0,1,2,0,2,0,1,2,1,2,0,1,0,1,2,0}, {0,0,1,1,2,2,0,0,1,1,2,2,0,0,1,1},
+			{0,0,1,1,1,1,2,2,2,2,0,0,0,0,1,1}, {0,1,0,1,0,1,0,1,2,2,2,2,2,2,2,2}, {0,0,0,0,0,0,0,0,2,1,2,1,2,1,2,1}, {0,0,2,2,1,1,2,2,0,0,2,2,1,1,2,2},
+			{0,0,2,2,0,0,1,1,0,0,2,2,0,0,1,1}, {0,2,2,0,1,2,2,1,0,2,2,0,1,2,2,1}, {0,1,0,1,2,2,2,2,2,2,2,2,0,1,0,1}, {0,0,0,0,2,1,2,1,2,1,2,1,2,1,2,1},
+			{0,1,0,1,0,1,0,1,0,1,0,1,2,2,2,2}, {0,2,2,2,0,1,1,1,0,2,2,2,0,1,1,1}, {0,0,0,2,1,1,1,2,0,0,0,2,1,1,1,2}, {0,0,0,0,2,1,1,2,2,1,1,2,2,1,1,2},
+			{0,2,2,2,0,1,1,1,0,1,1,1,0,2,2,2}, {0,0,0,2,1,1,1,2,1,1,1,2,0,0,0,2}, {0,1,1,0,0,1,1,0,0,1,1,0,2,2,2,2}, {0,0,0,0,0,0,0,0,2,1,1,2,2,1,1,2},
+			{0,1,1,0,0,1,1,0,2,2,2,2,2,2,2,2}, {0,0,2,2,0,0,1,1,0,0,1,1,0,0,2,2}, {0,0,2,2,1,1,2,2,1,1,2,2,0,0,2,2}, {0,0,0,0,0,0,0,0,0,0,0,0,2,1,1,2},
+			{0,0,0,2,0,0,0,1,0,0,0,2,0,0,0,1}, {0,2,2,2,1,2,2,2,0,2,2,2,1,2,2,2}, {0,1,0,1,2,2,2,2,2,2,2,2,2,2,2,2}, {0,1,1,1,2,0,1,1,2,2,0,1,2,2,2,0} };
+		return partitions[partition][pixel];
+	}
+
+	//gets the pixel whose index drops it's top bit, for a subset of a BC7 partition
+	inline uint32 BlockCompression_GetBC7Anchor(const uint32 subsetCount, const uint32 partition, const uint32 subset)
+	{
+		static const uint8 anchors2[64] = {
+			15,15,15,15,15,15,15,15, 15,15,15,15,15,15,15,15, 15, 2, 8, 2, 2, 8, 8,15, 2, 8, 2, 2, 8, 8, 2, 2,
+			15,15, 6, 8, 2, 8,15,15, 2, 8, 2, 2, 2,15,15, 6, 6, 2, 6, 8,15,15, 2, 2, 15,15,15,15,15, 2, 2,15 };
+		static const uint8 anchors3Second[64] = {
+			3, 3,15,15, 8, 3,15,15, 8, 8, 6, 6, 6, 5, 3, 3, 3, 3, 8,15, 3, 3, 6,10, 5, 8, 8, 6, 8, 5,15,15,
+			8,15, 3, 5, 6,10, 8,15,15, 3,15, 5,15,15,15,15, 3,15, 5, 5, 5, 8, 5,10, 5,10, 8,13,15,12, 3, 3 };
+		static const uint8 anchors3Third[64] = {
+			15, 8, 8, 3,15,15, 3, 8, 15,15,15,15,15,15,15, 8, 15, 8,15, 3,15, 8,15, 8, 3,15, 6,10,15,15,10, 8,
+			15, 3,15,10,10, 8, 9,10, 6,15, 8,15, 3, 6, 6, 8, 15, 3,15,15,15,15,15,15, 15,15,15,15, 3,15,15, 8 };
+
+		if (subset == 0)
+			return 0;
+		if (subsetCount == 2)
+			return anchors2[partition];
+		return (subset == 1 ? anchors3Second[partition] : anchors3Third[partition]);
+	}
+
+	//expands a endpoint channel of bitCount bits into 8 bits
+	inline int32 BlockCompression_ExpandBC7Channel(const uint32 value, const uint32 bitCount)
+	{
+		const uint32 shifted = value << (8 - bitCount);
+		return (int32)(shifted | (shifted >> bitCount));
+	}
+
+	//decodes a BC7 block of any mode into 16 RGBA pixels || reserved blocks decode to transparent black
+	inline void BlockCompression_DecodeBC7Block(const uint8* block, uint8* pixels)
+	{
+		//subsets, partition bits, rotation bits, index selection bits, color bits, alpha bits, endpoint p bits, shared p bits, index bits, secondary index bits
+		static const uint8 modes[8][10] = {
+			{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 }, { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 }, { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 }, { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+			{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 }, { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 }, { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 }, { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 } };
+
+		uint32 mode = 0;
+		while (mode < 8 && !((block[0] >> mode) & 1))
+			mode++;
+		if (mode == 8)
+		{
+			std::fill(pixels, pixels + 64, (uint8)0);
+			return;
+		}
+
+		const uint8* info = modes[mode];
+		const uint32 subsetCount = info[0], colorBits = info[4], alphaBits = info[5], indexBits = info[8], secondaryIndexBits = info[9];
+		uint32 bitOffset = mode + 1;
+		const uint32 partition = BlockCompression_ReadBits(block, bitOffset, info[1]);
+		const uint32 rotation = BlockCompression_ReadBits(block, bitOffset, info[2]);
+		const uint32 indexSelection = BlockCompression_ReadBits(block, bitOffset, info[3]);
+
+		//every endpoint's red, then green, blue and alpha
+		uint32 endpoints[6][4] = {};
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			for (uint32 e = 0; e < subsetCount * 2; ++e)
+				endpoints[e][c] = BlockCompression_ReadBits(block, bitOffset, colorBits);
+		}
+		for (uint32 e = 0; e < subsetCount * 2 && alphaBits > 0; ++e)
+			endpoints[e][3] = BlockCompression_ReadBits(block, bitOffset, alphaBits);
+
+		//the p bits add a bit under every channel
+		uint32 pBits[6] = {};
+		const bool hasPBits = (info[6] || info[7]);
+		if (info[6])
+		{
+			for (uint32 e = 0; e < subsetCount * 2; ++e)
+				pBits[e] = BlockCompression_ReadBits(block, bitOffset, 1);
+		}
+		else if (info[7])
+		{
+			for (uint32 s = 0; s < subsetCount; ++s)
+				pBits[s * 2] = pBits[s * 2 + 1] = BlockCompression_ReadBits(block, bitOffset, 1);
+		}
+
+		int32 colors[6][4];
+		for (uint32 e = 0; e < subsetCount * 2; ++e)
+		{
+			for (uint32 c = 0; c < 4; ++c)
+			{
+				const uint32 bits = (c < 3 ? colorBits : alphaBits);
+				if (bits == 0)
+				{
+					colors[e][c] = 255;
+					continue;
+				}
+				const uint32 value = (hasPBits ? (endpoints[e][c] << 1) | pBits[e] : endpoints[e][c]);
+				colors[e][c] = BlockCompression_ExpandBC7Channel(value, bits + (hasPBits ? 1 : 0));
+			}
+		}
+
+		uint32 subsets[16], indices[16], secondaryIndices[16] = {};
+		for (uint32 i = 0; i < 16; ++i)
+			subsets[i] = (subsetCount == 1 ? 0 : (subsetCount == 2 ? BlockCompression_GetBC7Partition2(partition, i) : BlockCompression_GetBC7Partition3(partition, i)));
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			const bool isAnchor = (BlockCompression_GetBC7Anchor(subsetCount, partition, subsets[i]) == i);
+			indices[i] = BlockCompression_ReadBits(block, bitOffset, indexBits - (isAnchor ? 1 : 0));
+		}
+		for (uint32 i = 0; i < 16 && secondaryIndexBits > 0; ++i)
+			secondaryIndices[i] = BlockCompression_ReadBits(block, bitOffset, secondaryIndexBits - (i == 0 ? 1 : 0));
+
+		//the index selection bit swaps which indices color and alpha use
+		const uint8* colorWeights = BlockCompression_GetBC7Weights(indexSelection ? secondaryIndexBits : indexBits);
+		const uint8* alphaWeights = BlockCompression_GetBC7Weights(secondaryIndexBits > 0 && !indexSelection ? secondaryIndexBits : indexBits);
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			const int32* color0 = colors[subsets[i] * 2]; const int32* color1 = colors[subsets[i] * 2 + 1];
+			const uint32 colorIndex = (indexSelection ? secondaryIndices[i] : indices[i]);
+			const uint32 alphaIndex = (secondaryIndexBits > 0 && !indexSelection ? secondaryIndices[i] : indices[i]);
+
+			uint8* pixel = &pixels[i * 4];
+			for (uint32 c = 0; c < 3; ++c)
+				pixel[c] = (uint8)(((64 - colorWeights[colorIndex]) * color0[c] + colorWeights[colorIndex] * color1[c] + 32) >> 6);
+			pixel[3] = (uint8)(((64 - alphaWeights[alphaIndex]) * color0[3] + alphaWeights[alphaIndex] * color1[3] + 32) >> 6);
+
+			if (rotation > 0)
+				std::swap(pixel[3], pixel[rotation - 1]);
+		}
+	}
+
+	//decodes a compressed image into RGBA8 || BC5 decodes to red and green, with blue 0 and alpha 255
+	inline void BlockCompression_Decode(const TextureCompression compression, const uint8* data, const uint32 width, const uint32 height,
+		std::vector<uint8>& rgba)
+	{
+		rgba.resize((size_t)width * height * 4);
+		if (compression == TextureCompression::None)
+		{
+			memcpy(rgba.data(), data, rgba.size());
+			return;
+		}
+
+		const uint32 blocksX = (width + 3) / 4, blocksY = (height + 3) / 4, blockBytes = TextureCompression_GetBlockBytes(compression);
+		uint8 pixels[64];
+		for (uint32 by = 0; by < blocksY; ++by)
+		{
+			for (uint32 bx = 0; bx < blocksX; ++bx)
+			{
+				const uint8* block = &data[((size_t)by * blocksX + bx) * blockBytes];
+				switch (compression)
+				{
+				case TextureCompression::BC1: BlockCompression_DecodeBC1Block(block, pixels, false); break;
+				case TextureCompression::BC3: BlockCompression_DecodeBC1Block(block + 8, pixels, true); BlockCompression_DecodeBC4Block(block, pixels, 3); break;
+				case TextureCompression::BC5:
+					for (uint32 i = 0; i < 16; ++i) { pixels[i * 4 + 2] = 0; pixels[i * 4 + 3] = 255; }
+					BlockCompression_DecodeBC4Block(block, pixels, 0); BlockCompression_DecodeBC4Block(block + 8, pixels, 1);
+					break;
+				case TextureCompression::BC7: BlockCompression_DecodeBC7Block(block, pixels); break;
+				default: break;
+				}
+
+				//only the pixels inside the image are kept
+				for (uint32 y = 0; y < 4 && by * 4 + y < height; ++y)
+				{
+					for (uint32 x = 0; x < 4 && bx * 4 + x < width; ++x)
+						memcpy(&rgba[(((size_t)by * 4 + y) * width + bx * 4 + x) * 4], &pixels[(y * 4 + x) * 4], 4);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+//defines the texture cook step, turning a source image into a KTX2 file with it's full mip chain block compressed
+//the mips are made and compressed once here, so loading is just a copy into the staging ring
+//BC7 for color, BC5 for normal maps, BC1 for color without smooth alpha, BC3 where BC7 is too slow to encode
+
+#include <SmokRenderers/Util/KTX2.hpp>
+
+#include <stb_image.h>
+
+namespace Smok::Renderers::Util
+{
+	//defines how a texture is cooked
+	struct TextureCookSettings
+	{
+		TextureCompression compression = TextureCompression::BC7;
+		bool sRGB = true; //color data, mips are averaged in linear space || BC5 is always linear
+		bool generateMips = true; //every level down to 1x1
+	};
+
+	//converts a sRGB channel to linear
+	inline float TextureCook_SRGBToLinear(const uint8 value)
+	{
+		const float v = value / 255.0f;
+		return (v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f));
+	}
+
+	//converts a linear channel to sRGB
+	inline uint8 TextureCook_LinearToSRGB(const float value)
+	{
+		const float v = (value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f);
+		return (uint8)std::clamp((int32)std::lround(v * 255.0f), 0, 255);
+	}
+
+	//makes the mip chain of a RGBA8 image with a box filter, every level tightly packed with level 0 first
+	//odd sizes repeat their last row and column || sRGB averages the color channels in linear space
+	inline void TextureCook_GenerateMips(const uint8* rgba, const uint32 width, const uint32 height, const bool sRGB,
+		std::vector<uint8>& mips, std::vector<size_t>& levelOffsets)
+	{
+		float toLinear[256];
+		for (uint32 i = 0; i < 256; ++i)
+			toLinear[i] = (sRGB ? TextureCook_SRGBToLinear((uint8)i) : i / 255.0f);
+
+		mips.assign(rgba, rgba + (size_t)width * height * 4);
+		levelOffsets.assign(1, 0);
+
+		uint32 srcWidth = width, srcHeight = height;
+		while (srcWidth > 1 || srcHeight > 1)
+		{
+			const size_t srcOffset = levelOffsets.back();
+			const uint32 dstWidth = std::max(srcWidth / 2, 1u), dstHeight = std::max(srcHeight / 2, 1u);
+
+			levelOffsets.emplace_back(mips.size());
+			mips.resize(mips.size() + (size_t)dstWidth * dstHeight * 4);
+			for (uint32 y = 0; y < dstHeight; ++y)
+			{
+				const uint32 y0 = std::min(y * 2, srcHeight - 1), y1 = std::min(y * 2 + 1, srcHeight - 1);
+				for (uint32 x = 0; x < dstWidth; ++x)
+				{
+					const uint32 x0 = std::min(x * 2, srcWidth - 1), x1 = std::min(x * 2 + 1, srcWidth - 1);
+					const uint8* src[4] = {
+						&mips[srcOffset + ((size_t)y0 * srcWidth + x0) * 4], &mips[srcOffset + ((size_t)y0 * srcWidth + x1) * 4],
+						&mips[srcOffset + ((size_t)y1 * srcWidth + x0) * 4], &mips[srcOffset + ((size_t)y1 * srcWidth + x1) * 4] };
+
+					uint8* dst = &mips[levelOffsets.back() + ((size_t)y * dstWidth + x) * 4];
+					for (uint32 c = 0; c < 3; ++c)
+					{
+						const float sum = (toLinear[src[0][c]] + toLinear[src[1][c]] + toLinear[src[2][c]] + toLinear[src[3][c]]) / 4.0f;
+						dst[c] = (sRGB ? TextureCook_LinearToSRGB(sum) : (uint8)std::clamp((int32)std::lround(sum * 255.0f), 0, 255));
+					}
+					dst[3] = (uint8)((src[0][3] + src[1][3] + src[2][3] + src[3][3] + 2) / 4);
+				}
+			}
+
+			srcWidth = dstWidth; srcHeight = dstHeight;
+		}
+	}
+
+	//cooks a RGBA8 image into a KTX2 texture
+	inline bool TextureCook_Cook(const uint8* rgba, const uint32 width, const uint32 height, const TextureCookSettings& settings, KTX2Texture* texture)
+	{
+		if (!rgba || width == 0 || height == 0 || settings.compression == TextureCompression::Count)
+		{
+			BTD_LogError("Smok Renderer", "Texture Cook", "TextureCook_Cook", "Can not cook a empty image or one without a compression");
+			return false;
+		}
+
+		const bool sRGB = (settings.sRGB && settings.compression != TextureCompression::BC5);
+		std::vector<uint8> mips; std::vector<size_t> levelOffsets = { 0 };
+		if (settings.generateMips)
+			TextureCook_GenerateMips(rgba, width, height, sRGB, mips, levelOffsets);
+		else
+			mips.assign(rgba, rgba + (size_t)width * height * 4);
+
+		*texture = KTX2Texture();
+		texture->format = TextureCompression_GetFormat(settings.compression, sRGB);
+		texture->width = width; texture->height = height;
+		texture->levelCount = (uint32)levelOffsets.size();
+
+		std::vector<uint8> encoded;
+		for (uint32 l = 0; l < (uint32)levelOffsets.size(); ++l)
+		{
+			BlockCompression_Encode(settings.compression, &mips[levelOffsets[l]],
+				KTX2Texture_GetLevelExtent(width, l), KTX2Texture_GetLevelExtent(height, l), encoded);
+			texture->levelOffsets.emplace_back(texture->data.size());
+			texture->levelSizes.emplace_back(encoded.size());
+			texture->data.insert(texture->data.end(), encoded.begin(), encoded.end());
+		}
+
+		return true;
+	}
+
+	//cooks a image file stb_image can read into a KTX2 file
+	inline bool TextureCook_CookFile(const std::string& sourcePath, const std::string& KTX2Path, const TextureCookSettings& settings = TextureCookSettings())
+	{
+		int32 width = 0, height = 0, channels = 0;
+		stbi_uc* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, 4);
+		if (!pixels)
+		{
+			BTD_LogError("Smok Renderer", "Texture Cook", "TextureCook_CookFile",
+				std::string("Failed to load a image at \"" + sourcePath + "\", " + stbi_failure_reason()).c_str());
+			return false;
+		}
+
+		KTX2Texture texture;
+		const bool cooked = TextureCook_Cook(pixels, (uint32)width, (uint32)height, settings, &texture);
+		stbi_image_free(pixels);
+
+		return (cooked && KTX2_WriteFile(texture, KTX2Path));
+	}
+}
@@ -0,0 +1,496 @@
+#pragma once
+
+//defines mip streaming for KTX2 textures, a texture starts with only it's coarse mips resident and streams finer ones in as the objects using it get bigger on screen
+//finer mips are evicted once nothing has needed them for a while, or when the textures want more then the VRAM budget
+//a texture's image only holds it's resident mips, so changing them makes a new image and view
+//finer mips are read and decoded on a loader thread and uploaded through the staging ring once they're done, evicting copies the coarse mips already on the GPU
+//the old image is kept until every frame in flight that could have sampled it is done, so nothing waits on the GPU or the disk
+
+#include <SmokRenderers/Util/KTX2.hpp>
+#include <SmokRenderers/Util/StagingRing.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#define SMOK_RENDERER_TEXTURE_STREAMING_DEFAULT_BUDGET (256ull * 1024 * 1024) //the default VRAM budget of the streamed textures in bytes
+#define SMOK_RENDERER_TEXTURE_STREAMING_NO_REQUEST UINT32_MAX //no object asked for a texture this frame
+
+namespace Smok::Renderers::Util
+{
+	//defines the settings of mip streaming
+	struct TextureStreamingSettings
+	{
+		uint64 budgetBytes = SMOK_RENDERER_TEXTURE_STREAMING_DEFAULT_BUDGET; //the VRAM every streamed texture's resident mips can use
+		uint32 initialSize = 64; //a texture starts with the mips no bigger then this resident, they're never evicted
+		uint64 maxUploadBytesPerFrame = 16 * 1024 * 1024; //gives the loader thread at most this much to read a frame, so a camera cut doesn't hitch || one texture always can
+		uint32 evictionDelay = 120; //frames a texture keeps it's finer mips after nothing needed them
+		float mipBias = 0.0f; //added to the level a texture needs, above 0 streams in less detail
+	};
+
+	//defines the stats of mip streaming
+	struct TextureStreamingStats
+	{
+		uint64 residentBytes = 0; //of every streamed texture's image
+		uint64 neededBytes = 0; //if every streamed texture had the mips it needs
+		uint64 streamedInBytes = 0; //uploaded this frame
+		uint32 streamInCount = 0, evictionCount = 0; //textures that got finer or coarser mips this frame
+		uint32 deferredCount = 0; //textures that need finer mips, but the budget or upload limit held them back
+		uint32 loadCount = 0; //reads given to the loader thread this frame
+		uint32 loadingCount = 0; //reads the loader thread hasn't finished
+
+		//converts the stats into a human readable string
+		inline std::string ToString() const
+		{
+			return "Texture Streaming: " + std::to_string(residentBytes) + " / " + std::to_string(neededBytes) + " bytes resident / needed, " +
+				std::to_string(streamedInBytes) + " bytes streamed in, " + std::to_string(streamInCount) + " stream ins, " +
+				std::to_string(evictionCount) + " evictions, " + std::to_string(deferredCount) + " deferred, " +
+				std::to_string(loadCount) + " loads, " + std::to_string(loadingCount) + " loading";
+		}
+	};
+
+	//defines a streamed texture
+	struct StreamedTexture
+	{
+		std::string KTX2Path = "";
+		VkFormat format = VK_FORMAT_UNDEFINED; //of the image, RGBA8 when the device can't sample the file's format
+		bool decompress = false; //the file's levels are decoded to RGBA8 as they're streamed in
+		uint32 width = 0, height = 0; //of level 0
+		std::vector<size_t> levelSizes; //the image bytes of every level
+		uint32 coarsestLevel = 0; //the finest of the initial mips, always resident
+
+		GPUImage image; //holds the levels from residentLevel down
+		uint32 residentLevel = 0;
+
+		uint32 loadingLevel = SMOK_RENDERER_TEXTURE_STREAMING_NO_REQUEST; //the level the loader thread is reading, if any
+		uint64 loadingBytes = 0; //the bytes the read adds once it's resident
+
+		uint32 requestedLevel = SMOK_RENDERER_TEXTURE_STREAMING_NO_REQUEST; //the finest level objects asked for this frame
+		uint32 neededLevel = 0; //what the streamer is working towards
+		uint64 lastRequestFrame = 0;
+	};
+
+	//defines a image that was swapped out, destroyed once the frames in flight are done with it
+	struct TextureStreaming_RetiredImage
+	{
+		GPUImage image;
+		uint64 frame = 0;
+	};
+
+	//defines a texture's image and view being swapped, anything holding the old view has to take the new one
+	struct TextureStreaming_Swap
+	{
+		uint64 ID = 0;
+		VkImageView oldView = VK_NULL_HANDLE;
+		const StreamedTexture* texture = nullptr;
+	};
+
+	//defines a read of a texture's levels from level down, done on the loader thread
+	struct TextureStreaming_Load
+	{
+		uint64 ID = 0;
+		std::string KTX2Path = "";
+		uint32 level = 0;
+		bool decompress = false;
+
+		KTX2Texture file; //filled by the loader thread, decoded to RGBA8 if decompress is set
+		bool loaded = false;
+	};
+
+	//defines the thread that reads and decodes the levels being streamed in
+	struct TextureStreaming_Loader
+	{
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable wake;
+
+		std::deque<TextureStreaming_Load> queued; //waiting for the thread
+		std::vector<TextureStreaming_Load> finished; //waiting for TextureStreaming_Update to swap them in
+		bool stop = false;
+
+		//stops the thread, dropping the reads it hasn't started
+		inline ~TextureStreaming_Loader()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_all();
+			if (thread.joinable())
+				thread.join();
+		}
+	};
+
+	//defines the mip streamer
+	struct TextureStreamer
+	{
+		TextureStreamingSettings settings;
+		uint32 framesInFlight = 2;
+
+		std::unordered_map<uint64, StreamedTexture> textures; //keyed by texture ID
+		std::vector<TextureStreaming_RetiredImage> retiredImages;
+		uint64 frame = 0;
+		uint64 residentBytes = 0;
+		uint64 loadingBytes = 0; //the bytes the reads on the loader thread add once they're resident
+
+		std::unique_ptr<TextureStreaming_Loader> loader; //started by the first stream in
+
+		TextureStreamingStats frameStats; //of the last update
+	};
+
+	//gets the bytes of a texture's image with the levels from level down
+	inline uint64 StreamedTexture_GetBytes(const StreamedTexture* texture, const uint32 level)
+	{
+		uint64 bytes = 0;
+		for (size_t l = level; l < texture->levelSizes.size(); ++l)
+			bytes += texture->levelSizes[l];
+		return bytes;
+	}
+
+	//gets the finest level a texture needs when it covers this many pixels on screen || assumes it's UVs span the object once
+	inline uint32 StreamedTexture_GetLevelForPixels(const StreamedTexture* texture, const float screenPixels, const float mipBias)
+	{
+		if (screenPixels <= 0.0f)
+			return texture->coarsestLevel;
+
+		const float level = std::log2((float)std::max(texture->width, texture->height) / screenPixels) + mipBias;
+		return (level <= 0.0f ? 0 : std::min((uint32)level, texture->coarsestLevel));
+	}
+
+	//destroys the retired images the frames in flight are done with || force destroys them all, the caller has to make sure the GPU is idle
+	inline void TextureStreaming_DestroyRetiredImages(TextureStreamer* streamer, VkDevice device, VmaAllocator allocator, const bool force)
+	{
+		size_t kept = 0;
+		for (size_t i = 0; i < streamer->retiredImages.size(); ++i)
+		{
+			if (force || streamer->frame > streamer->retiredImages[i].frame + streamer->framesInFlight)
+				GPUImage_Destroy(&streamer->retiredImages[i].image, device, allocator);
+			else
+				streamer->retiredImages[kept++] = streamer->retiredImages[i];
+		}
+		streamer->retiredImages.resize(kept);
+	}
+
+	//the loader thread, reads and decodes the queued loads until it's stopped
+	inline void TextureStreaming_RunLoader(TextureStreaming_Loader* loader)
+	{
+		std::unique_lock<std::mutex> lock(loader->mutex);
+		while (true)
+		{
+			loader->wake.wait(lock, [loader]() { return loader->stop || !loader->queued.empty(); });
+			if (loader->stop)
+				return;
+
+			TextureStreaming_Load load = std::move(loader->queued.front());
+			loader->queued.pop_front();
+			lock.unlock();
+
+			load.loaded = KTX2_LoadFile(&load.file, load.KTX2Path, load.level);
+			if (load.loaded && load.decompress)
+				KTX2Texture_Decompress(&load.file);
+
+			lock.lock();
+			loader->finished.emplace_back(std::move(load));
+		}
+	}
+
+	//gives a read of a texture's levels from level down to the loader thread, starting it if it isn't
+	inline void TextureStreaming_QueueLoad(TextureStreamer* streamer, const uint64 ID, StreamedTexture* texture, const uint32 level)
+	{
+		if (!streamer->loader)
+		{
+			streamer->loader = std::make_unique<TextureStreaming_Loader>();
+			streamer->loader->thread = std::thread(TextureStreaming_RunLoader, streamer->loader.get());
+		}
+
+		TextureStreaming_Load load;
+		load.ID = ID; load.KTX2Path = texture->KTX2Path;
+		load.level = level; load.decompress = texture->decompress;
+		{
+			std::lock_guard<std::mutex> lock(streamer->loader->mutex);
+			streamer->loader->queued.emplace_back(std::move(load));
+		}
+		streamer->loader->wake.notify_one();
+
+		texture->loadingLevel = level;
+		texture->loadingBytes = StreamedTexture_GetBytes(texture, level) - StreamedTexture_GetBytes(texture, texture->residentLevel);
+		streamer->loadingBytes += texture->loadingBytes;
+	}
+
+	//destroys the streamer and every streamed texture's image || the caller has to make sure the GPU is idle
+	inline void TextureStreaming_Destroy(TextureStreamer* streamer, VkDevice device, VmaAllocator allocator)
+	{
+		streamer->loader.reset();
+		TextureStreaming_DestroyRetiredImages(streamer, device, allocator, true);
+		for (auto& texture : streamer->textures)
+			GPUImage_Destroy(&texture.second.image, device, allocator);
+
+		const TextureStreamingSettings settings = streamer->settings;
+		const uint32 framesInFlight = streamer->framesInFlight;
+		*streamer = TextureStreamer();
+		streamer->settings = settings; streamer->framesInFlight = framesInFlight;
+	}
+
+	//swaps a texture to a image with the levels from level down || the old image is retired
+	inline void StreamedTexture_SwapImage(TextureStreamer* streamer, StreamedTexture* texture, const GPUImage& image, const uint32 level)
+	{
+		if (texture->image.image != VK_NULL_HANDLE)
+		{
+			TextureStreaming_RetiredImage& retired = streamer->retiredImages.emplace_back();
+			retired.image = texture->image; retired.frame = streamer->frame;
+			streamer->residentBytes -= StreamedTexture_GetBytes(texture, texture->residentLevel);
+		}
+
+		texture->image = image;
+		texture->residentLevel = level;
+		streamer->residentBytes += StreamedTexture_GetBytes(texture, level);
+	}
+
+	//remakes a texture's image with the levels from level down, from a file read from that level
+	//with the staging ring valid it's uploaded once the ring is flushed, without it the graphics queue is stalled
+	inline bool StreamedTexture_MakeResident(TextureStreamer* streamer, StreamedTexture* texture, const uint32 level, const KTX2Texture& file,
+		SMGraphics_Core_GPU* GPU, VmaAllocator allocator, StagingRing* stagingRing, SMGraphics_Pool_CommandPool* commandPool)
+	{
+		const bool staged = StagingRing_IsValid(stagingRing);
+		GPUImage image;
+		if (!GPUImage_Create(&image, GPU->device, allocator, texture->format,
+			KTX2Texture_GetLevelExtent(texture->width, level), KTX2Texture_GetLevelExtent(texture->height, level),
+			(staged ? nullptr : file.data.data()), file.data.size(), file.levelOffsets))
+			return false;
+
+		const bool uploaded = (staged ? StagingRing_UploadImage(stagingRing, &image, file.data.data(), file.data.size()) :
+			GPUImage_UploadNow(&image, GPU, allocator, commandPool));
+		if (!uploaded)
+		{
+			GPUImage_Destroy(&image, GPU->device, allocator);
+			return false;
+		}
+
+		StreamedTexture_SwapImage(streamer, texture, image, level);
+		return true;
+	}
+
+	//remakes a texture's image with the levels from level down, reading them from it's file on this thread
+	inline bool StreamedTexture_LoadResident(TextureStreamer* streamer, StreamedTexture* texture, const uint32 level,
+		SMGraphics_Core_GPU* GPU, VmaAllocator allocator, StagingRing* stagingRing, SMGraphics_Pool_CommandPool* commandPool)
+	{
+		KTX2Texture file;
+		if (!KTX2_LoadFile(&file, texture->KTX2Path, level))
+			return false;
+		if (texture->decompress)
+			KTX2Texture_Decompress(&file);
+
+		return StreamedTexture_MakeResident(streamer, texture, level, file, GPU, allocator, stagingRing, commandPool);
+	}
+
+	//drops a texture's levels finer then level, copying the ones it keeps out of it's current image
+	//without a staging ring to queue the copy, the kept levels are read from the file again
+	inline bool StreamedTexture_Evict(TextureStreamer* streamer, StreamedTexture* texture, const uint32 level,
+		SMGraphics_Core_GPU* GPU, VmaAllocator allocator, StagingRing* stagingRing, SMGraphics_Pool_CommandPool* commandPool)
+	{
+		if (!StagingRing_IsValid(stagingRing) || texture->image.image == VK_NULL_HANDLE || level < texture->residentLevel)
+			return StreamedTexture_LoadResident(streamer, texture, level, GPU, allocator, stagingRing, commandPool);
+
+		//only the level count matters, the image is filled by the copy
+		GPUImage image;
+		const std::vector<size_t> levelOffsets(texture->levelSizes.size() - level, 0);
+		if (!GPUImage_Create(&image, GPU->device, allocator, texture->format,
+			KTX2Texture_GetLevelExtent(texture->width, level), KTX2Texture_GetLevelExtent(texture->height, level),
+			nullptr, StreamedTexture_GetBytes(texture, level), levelOffsets))
+			return false;
+
+		if (!StagingRing_CopyImage(stagingRing, &texture->image, level - texture->residentLevel, &image))
+		{
+			GPUImage_Destroy(&image, GPU->device, allocator);
+			return false;
+		}
+
+		StreamedTexture_SwapImage(streamer, texture, image, level);
+		return true;
+	}
+
+	//registers a KTX2 texture for streaming and makes it's initial mips resident || returns nullptr if it fails
+	//the initial mips are small and the texture needs a image right away, so they're read on this thread
+	inline StreamedTexture* TextureStreaming_Register(TextureStreamer* streamer, const uint64 ID, const std::string& KTX2Path,
+		SMGraphics_Core_GPU* GPU, VmaAllocator allocator, StagingRing* stagingRing, SMGraphics_Pool_CommandPool* commandPool)
+	{
+		auto existing = streamer->textures.find(ID);
+		if (existing != streamer->textures.end())
+			return &existing->second;
+
+		//only reads the header
+		KTX2Texture header;
+		if (!KTX2_LoadFile(&header, KTX2Path, UINT32_MAX))
+			return nullptr;
+
+		StreamedTexture texture;
+		texture.KTX2Path = KTX2Path;
+		texture.width = header.width; texture.height = header.height;
+		texture.decompress = !KTX2_IsFormatSampleable(GPU->physicalDevice, header.format);
+
+		bool sRGB = false;
+		const TextureCompression fileCompression = TextureCompression_FromFormat(header.format, sRGB);
+		const TextureCompression compression = (texture.decompress ? TextureCompression::None : fileCompression);
+		texture.format = (texture.decompress ? TextureCompression_GetFormat(TextureCompression::None, sRGB) : header.format);
+		for (uint32 l = 0; l < header.levelCount; ++l)
+		{
+			const uint32 width = KTX2Texture_GetLevelExtent(texture.width, l), height = KTX2Texture_GetLevelExtent(texture.height, l);
+			texture.levelSizes.emplace_back(TextureCompression_GetLevelByteSize(compression, width, height));
+			if (std::max(width, height) > streamer->settings.initialSize)
+				texture.coarsestLevel = std::min(l + 1, header.levelCount - 1);
+		}
+
+		texture.residentLevel = texture.coarsestLevel; texture.neededLevel = texture.coarsestLevel;
+		texture.lastRequestFrame = streamer->frame;
+		StreamedTexture* streamed = &streamer->textures[ID];
+		*streamed = texture;
+		if (!StreamedTexture_LoadResident(streamer, streamed, texture.coarsestLevel, GPU, allocator, stagingRing, commandPool))
+		{
+			streamer->textures.erase(ID);
+			return nullptr;
+		}
+
+		return streamed;
+	}
+
+	//asks for a texture to have the mips a object covering this many pixels on screen needs || the finest ask of a frame wins
+	inline void TextureStreaming_Request(TextureStreamer* streamer, const uint64 ID, const float screenPixels)
+	{
+		auto texture = streamer->textures.find(ID);
+		if (texture == streamer->textures.end())
+			return;
+
+		const uint32 level = StreamedTexture_GetLevelForPixels(&texture->second, screenPixels, streamer->settings.mipBias);
+		texture->second.requestedLevel = std::min(texture->second.requestedLevel, level);
+	}
+
+	//streams mips in and out for this frame's requests, call once a frame after the objects were added
+	//fills swaps with every texture whose image changed || finer mips are swapped in the frame the loader thread finishes reading them
+	inline void TextureStreaming_Update(TextureStreamer* streamer, SMGraphics_Core_GPU* GPU, VmaAllocator allocator,
+		StagingRing* stagingRing, SMGraphics_Pool_CommandPool* commandPool, std::vector<TextureStreaming_Swap>& swaps)
+	{
+		streamer->frame++;
+		streamer->frameStats = TextureStreamingStats();
+		TextureStreaming_DestroyRetiredImages(streamer, GPU->device, allocator, false);
+
+		//swaps in the levels the loader thread finished, unless nothing needs them anymore
+		std::vector<TextureStreaming_Load> finished;
+		if (streamer->loader)
+		{
+			std::lock_guard<std::mutex> lock(streamer->loader->mutex);
+			finished.swap(streamer->loader->finished);
+		}
+		for (size_t i = 0; i < finished.size(); ++i)
+		{
+			auto entry = streamer->textures.find(finished[i].ID);
+			if (entry == streamer->textures.end())
+				continue;
+
+			StreamedTexture* texture = &entry->second;
+			streamer->loadingBytes -= texture->loadingBytes;
+			texture->loadingLevel = SMOK_RENDERER_TEXTURE_STREAMING_NO_REQUEST; texture->loadingBytes = 0;
+			if (!finished[i].loaded || finished[i].level >= texture->residentLevel || texture->neededLevel >= texture->residentLevel)
+				continue;
+
+			const VkImageView oldView = texture->image.view;
+			if (StreamedTexture_MakeResident(streamer, texture, finished[i].level, finished[i].file, GPU, allocator, stagingRing, commandPool))
+			{
+				swaps.push_back({ entry->first, oldView, texture });
+				streamer->frameStats.streamedInBytes += StreamedTexture_GetBytes(texture, texture->residentLevel);
+				streamer->frameStats.streamInCount++;
+			}
+		}
+
+		//swaps a texture to it's coarser levels from level down
+		auto evict = [&](const uint64 ID, StreamedTexture* texture, const uint32 level) {
+			const VkImageView oldView = texture->image.view;
+			if (!StreamedTexture_Evict(streamer, texture, level, GPU, allocator, stagingRing, commandPool))
+				return false;
+
+			swaps.push_back({ ID, oldView, texture });
+			streamer->frameStats.evictionCount++;
+			return true;
+		};
+
+		//works out what each texture needs, evicting the mips nothing needs anymore
+		std::vector<std::pair<uint64, StreamedTexture*>> streamIns, evictable;
+		for (auto& entry : streamer->textures)
+		{
+			StreamedTexture* texture = &entry.second;
+			if (texture->requestedLevel != SMOK_RENDERER_TEXTURE_STREAMING_NO_REQUEST)
+			{
+				texture->neededLevel = texture->requestedLevel;
+				texture->lastRequestFrame = streamer->frame;
+			}
+			else if (streamer->frame - texture->lastRequestFrame > streamer->settings.evictionDelay)
+				texture->neededLevel = texture->coarsestLevel;
+			texture->requestedLevel = SMOK_RENDERER_TEXTURE_STREAMING_NO_REQUEST;
+			streamer->frameStats.neededBytes += StreamedTexture_GetBytes(texture, texture->neededLevel);
+
+			//a texture with a read in flight waits for it
+			const bool loading = (texture->loadingLevel != SMOK_RENDERER_TEXTURE_STREAMING_NO_REQUEST);
+			if (loading)
+				streamer->frameStats.loadingCount++;
+
+			if (texture->neededLevel > texture->residentLevel)
+				evict(entry.first, texture, texture->neededLevel);
+			else if (texture->neededLevel < texture->residentLevel && !loading)
+				streamIns.push_back({ entry.first, texture });
+
+			if (!loading && texture->lastRequestFrame < streamer->frame && texture->neededLevel >= texture->residentLevel &&
+				texture->residentLevel < texture->coarsestLevel)
+				evictable.push_back({ entry.first, texture });
+		}
+
+		//the textures the most levels short go first, then the ones used the longest ago are evicted first
+		std::sort(streamIns.begin(), streamIns.end(), [](const auto& a, const auto& b) {
+			return (a.second->residentLevel - a.second->neededLevel) > (b.second->residentLevel - b.second->neededLevel); });
+		std::sort(evictable.begin(), evictable.end(), [](const auto& a, const auto& b) {
+			return a.second->lastRequestFrame < b.second->lastRequestFrame; });
+
+		//the reads in flight already have their bytes set aside in the budget
+		size_t nextEvictable = 0;
+		uint64 loadBytes = 0;
+		for (size_t i = 0; i < streamIns.size(); ++i)
+		{
+			StreamedTexture* texture = streamIns[i].second;
+			const uint64 residentBytes = StreamedTexture_GetBytes(texture, texture->residentLevel);
+			const uint64 neededBytes = StreamedTexture_GetBytes(texture, texture->neededLevel);
+
+			//makes room by evicting textures this frame didn't use
+			while (streamer->residentBytes + streamer->loadingBytes - residentBytes + neededBytes > streamer->settings.budgetBytes &&
+				nextEvictable < evictable.size())
+			{
+				StreamedTexture* evicted = evictable[nextEvictable].second;
+				if (evict(evictable[nextEvictable].first, evicted, evicted->coarsestLevel))
+					evicted->neededLevel = evicted->coarsestLevel;
+				nextEvictable++;
+			}
+
+			//the finest level that fits in the budget
+			uint32 level = texture->neededLevel;
+			const uint64 availableBytes = streamer->residentBytes + streamer->loadingBytes - residentBytes;
+			while (level < texture->residentLevel && availableBytes + StreamedTexture_GetBytes(texture, level) > streamer->settings.budgetBytes)
+				level++;
+
+			const uint64 levelBytes = StreamedTexture_GetBytes(texture, level);
+			if (level >= texture->residentLevel || (loadBytes > 0 && loadBytes + levelBytes > streamer->settings.maxUploadBytesPerFrame))
+			{
+				streamer->frameStats.deferredCount++;
+				continue;
+			}
+
+			TextureStreaming_QueueLoad(streamer, streamIns[i].first, texture, level);
+			loadBytes += levelBytes;
+			streamer->frameStats.loadCount++;
+			streamer->frameStats.loadingCount++;
+			if (level != texture->neededLevel)
+				streamer->frameStats.deferredCount++;
+		}
+
+		streamer->frameStats.residentBytes = streamer->residentBytes;
+	}
+}
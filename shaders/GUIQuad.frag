@@ -0,0 +1,26 @@
+#version 450
+
+//GUI quads, tints the batch's texture by the quad's color
+
+//compile with: glslangValidator -V GUIQuad.frag -o GUIQuad.frag.spv
+
+#define SMOK_RENDERER_GUI_TEXTURE_SLOTS 16
+
+layout(set = 0, binding = 1) uniform sampler2D textures[SMOK_RENDERER_GUI_TEXTURE_SLOTS];
+
+layout(push_constant) uniform PushConstants
+{
+	vec2 screenSize;
+	uint textureSlot; //the same for the whole draw, so indexing the array with it is allowed without descriptor indexing
+	uint pad;
+} pc;
+
+layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec4 inColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+	outColor = inColor * texture(textures[pc.textureSlot], inUV);
+}
@@ -0,0 +1,48 @@
+#version 450
+
+//GUI quads, each instance is one quad made from it's record in the quad buffer, there's no vertex buffer
+//must match Smok::Renderers::GPUBased::GUIRenderer::GUIQuad
+
+//compile with: glslangValidator -V GUIQuad.vert -o GUIQuad.vert.spv
+
+struct GUIQuad
+{
+	vec4 rect; //x, y, width, height in pixels, from the top left
+	vec4 uvRect; //the top left and bottom right UVs
+	uint color; //RGBA8
+	uint textureSlot; //the texture it samples, the batch's slot is the one used
+	uint clipIndex; //the clip rect, applied as the batch's scissor
+	uint layer; //the layer it was sorted by
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer QuadBuffer
+{
+	GUIQuad quads[];
+};
+
+layout(push_constant) uniform PushConstants
+{
+	vec2 screenSize;
+	uint textureSlot;
+	uint pad;
+} pc;
+
+layout(location = 0) out vec2 outUV;
+layout(location = 1) out vec4 outColor;
+
+//two triangles
+const vec2 corners[6] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+	vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main()
+{
+	//gl_InstanceIndex includes the first instance, which is the batch's first quad
+	GUIQuad quad = quads[gl_InstanceIndex];
+	vec2 corner = corners[gl_VertexIndex];
+
+	vec2 pixel = quad.rect.xy + corner * quad.rect.zw;
+	gl_Position = vec4(pixel / pc.screenSize * 2.0 - 1.0, 0.0, 1.0);
+
+	outUV = mix(quad.uvRect.xy, quad.uvRect.zw, corner);
+	outColor = unpackUnorm4x8(quad.color);
+}
@@ -0,0 +1,32 @@
+#version 450
+
+//GUI text, the batch's texture is a SDF font atlas, used with GUIQuad.vert
+//the edge is antialiased by the field's screen space rate of change, so it stays sharp at any size
+
+//compile with: glslangValidator -V GUIText.frag -o GUIText.frag.spv
+
+#define SMOK_RENDERER_GUI_TEXTURE_SLOTS 16
+
+layout(set = 0, binding = 1) uniform sampler2D textures[SMOK_RENDERER_GUI_TEXTURE_SLOTS];
+
+layout(push_constant) uniform PushConstants
+{
+	vec2 screenSize;
+	uint textureSlot;
+	uint pad;
+} pc;
+
+layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec4 inColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+	//0.5 is the glyph's edge
+	float dist = texture(textures[pc.textureSlot], inUV).r;
+	float width = max(fwidth(dist) * 0.7, 0.0001);
+	float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+
+	outColor = vec4(inColor.rgb, inColor.a * alpha);
+}
@@ -0,0 +1,110 @@
+//tests culling meshlets on the CPU, which needs no device
+
+#include "Test.hpp"
+
+#include <SmokRenderers/Culling/ClusterCuller.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Smok::Renderers;
+
+//adds a unit quad centered on a point as two triangles, facing +Z or -Z
+static void AddQuad(Smok::Mesh::Mesh& mesh, const glm::vec3& center, const bool facesForward)
+{
+	const uint32 first = (uint32)mesh.vertices.size();
+	const glm::vec3 corners[4] = { glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(0.5f, -0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(-0.5f, 0.5f, 0.0f) };
+	for (uint32 i = 0; i < 4; ++i)
+	{
+		Smok::Mesh::Vertex* vertex = &mesh.vertices.emplace_back(Smok::Mesh::Vertex());
+		vertex->position = center + corners[i];
+		vertex->normal = glm::vec3(0.0f, 0.0f, (facesForward ? 1.0f : -1.0f));
+	}
+
+	const uint32 forward[6] = { 0, 1, 2, 0, 2, 3 }, backward[6] = { 0, 2, 1, 0, 3, 2 };
+	for (uint32 i = 0; i < 6; ++i)
+		mesh.indices.emplace_back(first + (facesForward ? forward[i] : backward[i]));
+}
+
+//five quads, one meshlet each, seen by a camera on +Z looking at the origin
+//two visible quads next to each other, one off to the side, one facing away and one more visible
+static std::vector<Geometry::Meshlet> BuildTestMeshlets(Culling::Frustum& frustum, glm::vec3& cameraPosition)
+{
+	Smok::Mesh::Mesh mesh;
+	AddQuad(mesh, glm::vec3(0.0f, 0.0f, 0.0f), true);
+	AddQuad(mesh, glm::vec3(1.0f, 0.0f, 0.0f), true);
+	AddQuad(mesh, glm::vec3(100.0f, 0.0f, 0.0f), true);
+	AddQuad(mesh, glm::vec3(0.0f, 1.0f, 0.0f), false);
+	AddQuad(mesh, glm::vec3(-1.0f, 0.0f, 0.0f), true);
+
+	cameraPosition = glm::vec3(0.0f, 0.0f, 5.0f);
+	const glm::mat4 P = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+	const glm::mat4 V = glm::lookAt(cameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	frustum = Culling::Frustum_Extract(P * V);
+
+	return Geometry::Meshlet_Build(mesh.vertices, mesh.indices, 4, 2);
+}
+
+//frustum and backface cone rejection, with the visible neighbours merged into one range
+SMOK_RENDERER_TEST(ClusterCuller_CullsFrustumAndBackfaces)
+{
+	Culling::Frustum frustum; glm::vec3 cameraPosition;
+	const std::vector<Geometry::Meshlet> meshlets = BuildTestMeshlets(frustum, cameraPosition);
+	SMOK_RENDERER_TEST_REQUIRE(meshlets.size() == 5);
+
+	std::vector<Culling::IndexRange> ranges; Culling::ClusterCullStats stats;
+	Culling::ClusterCuller_CullMeshlets(meshlets, frustum, cameraPosition, true, ranges, stats);
+
+	SMOK_RENDERER_TEST_CHECK(stats.clustersTested == 5);
+	SMOK_RENDERER_TEST_CHECK(stats.clustersVisible == 3);
+	SMOK_RENDERER_TEST_CHECK(stats.frustumCulled == 1);
+	SMOK_RENDERER_TEST_CHECK(stats.backfaceCulled == 1);
+	SMOK_RENDERER_TEST_CHECK(stats.trianglesTested == 10);
+	SMOK_RENDERER_TEST_CHECK(stats.trianglesVisible == 6);
+	SMOK_RENDERER_TEST_CHECK(stats.rangesEmitted == 2);
+
+	SMOK_RENDERER_TEST_REQUIRE(ranges.size() == 2);
+	SMOK_RENDERER_TEST_CHECK(ranges[0].firstIndex == 0 && ranges[0].indexCount == 12);
+	SMOK_RENDERER_TEST_CHECK(ranges[1].firstIndex == 24 && ranges[1].indexCount == 6);
+}
+
+//without cone culling, like under a non uniform scale, the quad facing away is drawn and joins the last range
+SMOK_RENDERER_TEST(ClusterCuller_ConeCullingOff)
+{
+	Culling::Frustum frustum; glm::vec3 cameraPosition;
+	const std::vector<Geometry::Meshlet> meshlets = BuildTestMeshlets(frustum, cameraPosition);
+	SMOK_RENDERER_TEST_REQUIRE(meshlets.size() == 5);
+
+	std::vector<Culling::IndexRange> ranges; Culling::ClusterCullStats stats;
+	Culling::ClusterCuller_CullMeshlets(meshlets, frustum, cameraPosition, false, ranges, stats);
+
+	SMOK_RENDERER_TEST_CHECK(stats.clustersVisible == 4);
+	SMOK_RENDERER_TEST_CHECK(stats.frustumCulled == 1);
+	SMOK_RENDERER_TEST_CHECK(stats.backfaceCulled == 0);
+
+	SMOK_RENDERER_TEST_REQUIRE(ranges.size() == 2);
+	SMOK_RENDERER_TEST_CHECK(ranges[0].firstIndex == 0 && ranges[0].indexCount == 12);
+	SMOK_RENDERER_TEST_CHECK(ranges[1].firstIndex == 18 && ranges[1].indexCount == 12);
+
+	SMOK_RENDERER_TEST_CHECK(!Culling::ClusterCuller_IsUniformScale(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 1.0f))));
+	SMOK_RENDERER_TEST_CHECK(Culling::ClusterCuller_IsUniformScale(glm::scale(glm::mat4(1.0f), glm::vec3(3.0f))));
+}
+
+//a camera behind the mesh sees the quads facing away from the front
+SMOK_RENDERER_TEST(ClusterCuller_CullsFromBehind)
+{
+	Culling::Frustum frustum; glm::vec3 cameraPosition;
+	const std::vector<Geometry::Meshlet> meshlets = BuildTestMeshlets(frustum, cameraPosition);
+	SMOK_RENDERER_TEST_REQUIRE(meshlets.size() == 5);
+
+	cameraPosition = glm::vec3(0.0f, 0.0f, -5.0f);
+	const glm::mat4 P = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+	frustum = Culling::Frustum_Extract(P * glm::lookAt(cameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	std::vector<Culling::IndexRange> ranges; Culling::ClusterCullStats stats;
+	Culling::ClusterCuller_CullMeshlets(meshlets, frustum, cameraPosition, true, ranges, stats);
+
+	SMOK_RENDERER_TEST_CHECK(stats.clustersVisible == 1);
+	SMOK_RENDERER_TEST_CHECK(stats.backfaceCulled == 3);
+	SMOK_RENDERER_TEST_REQUIRE(ranges.size() == 1);
+	SMOK_RENDERER_TEST_CHECK(ranges[0].firstIndex == 18 && ranges[0].indexCount == 6);
+}
@@ -0,0 +1,174 @@
+//tests recording and replaying command traces through the null backend, which needs no device
+
+#include "Test.hpp"
+
+#include <SmokRenderers/Renderers/GPUBasedMeshRenderer.hpp>
+
+#include <cstdio>
+
+using namespace Smok::Renderers;
+
+//records a frame with every kind of command that isn't a bind or draw
+static void RecordTransferFrame(Dispatch* dispatch)
+{
+	VkCommandBuffer comBuffer = VK_NULL_HANDLE;
+	VkBuffer buffer = (VkBuffer)0x10, otherBuffer = (VkBuffer)0x20;
+	VkImage image = (VkImage)0x30, otherImage = (VkImage)0x60;
+
+	Dispatch_BeginFrame(dispatch, 7);
+
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	VkBufferMemoryBarrier bufferBarrier = {};
+	bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = buffer; bufferBarrier.size = VK_WHOLE_SIZE;
+
+	VkImageMemoryBarrier imageBarrier = {};
+	imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageBarrier.image = image;
+	imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	imageBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, 1 };
+
+	Dispatch_CmdPipelineBarrier(dispatch, comBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+		1, &memoryBarrier, 1, &bufferBarrier, 1, &imageBarrier);
+	Dispatch_CmdFillBuffer(dispatch, comBuffer, buffer, 16, 64, 0);
+
+	const VkBufferCopy bufferCopies[2] = { { 0, 128, 32 }, { 64, 0, 16 } };
+	Dispatch_CmdCopyBuffer(dispatch, comBuffer, buffer, otherBuffer, 2, bufferCopies);
+
+	VkBufferImageCopy imageCopy = {};
+	imageCopy.bufferOffset = 256;
+	imageCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1 };
+	imageCopy.imageOffset = { -1, 2, 0 };
+	imageCopy.imageExtent = { 32, 16, 1 };
+	Dispatch_CmdCopyBufferToImage(dispatch, comBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
+	Dispatch_CmdCopyImageToBuffer(dispatch, comBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, otherBuffer, 1, &imageCopy);
+
+	VkImageCopy imageToImageCopies[2] = {};
+	for (uint32 i = 0; i < 2; ++i)
+	{
+		imageToImageCopies[i].srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 2 + i, 0, 1 };
+		imageToImageCopies[i].dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 };
+		imageToImageCopies[i].dstOffset = { 0, -3, 0 };
+		imageToImageCopies[i].extent = { 64u >> i, 32u >> i, 1 };
+	}
+	Dispatch_CmdCopyImage(dispatch, comBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, otherImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		2, imageToImageCopies);
+
+	VkClearValue clearValues[2] = {};
+	clearValues[0].color.float32[0] = 0.25f; clearValues[0].color.float32[3] = 1.0f;
+	clearValues[1].depthStencil = { 1.0f, 0 };
+	VkRenderPassBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	beginInfo.renderPass = (VkRenderPass)0x40; beginInfo.framebuffer = (VkFramebuffer)0x50;
+	beginInfo.renderArea = { { 0, 0 }, { 1280, 720 } };
+	beginInfo.clearValueCount = 2; beginInfo.pClearValues = clearValues;
+	Dispatch_CmdBeginRenderPass(dispatch, comBuffer, beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	Dispatch_CmdDraw(dispatch, comBuffer, 3, 1, 0, 0);
+	Dispatch_CmdEndRenderPass(dispatch, comBuffer);
+}
+
+//a replay through a null dispatch re-records the trace byte for byte
+SMOK_RENDERER_TEST(CommandTrace_ReplaysBarriersFillsCopiesAndRenderPasses)
+{
+	CommandTrace recorded;
+	Dispatch recorder;
+	recorder.backend = DispatchBackend::Null; recorder.trace = &recorded;
+	RecordTransferFrame(&recorder);
+
+	SMOK_RENDERER_TEST_CHECK(recorded.commandCounts[(size_t)CommandTrace_Op::PipelineBarrier] == 1);
+	SMOK_RENDERER_TEST_CHECK(recorded.commandCounts[(size_t)CommandTrace_Op::FillBuffer] == 1);
+	SMOK_RENDERER_TEST_CHECK(recorded.commandCounts[(size_t)CommandTrace_Op::CopyBuffer] == 1);
+	SMOK_RENDERER_TEST_CHECK(recorded.commandCounts[(size_t)CommandTrace_Op::CopyBufferToImage] == 1);
+	SMOK_RENDERER_TEST_CHECK(recorded.commandCounts[(size_t)CommandTrace_Op::CopyImageToBuffer] == 1);
+	SMOK_RENDERER_TEST_CHECK(recorded.commandCounts[(size_t)CommandTrace_Op::CopyImage] == 1);
+	SMOK_RENDERER_TEST_CHECK(recorded.commandCounts[(size_t)CommandTrace_Op::BeginRenderPass] == 1);
+	SMOK_RENDERER_TEST_CHECK(recorded.commandCounts[(size_t)CommandTrace_Op::EndRenderPass] == 1);
+
+	CommandTrace replayed;
+	Dispatch replayer;
+	replayer.backend = DispatchBackend::Null; replayer.trace = &replayed;
+	const CommandTraceReplayStats stats = CommandTrace_Replay(recorded, VK_NULL_HANDLE, &replayer, CommandTraceReplay());
+
+	SMOK_RENDERER_TEST_CHECK(stats.succeeded);
+	SMOK_RENDERER_TEST_CHECK(stats.frameCount == 1);
+	SMOK_RENDERER_TEST_CHECK(stats.drawCount == 1);
+	SMOK_RENDERER_TEST_CHECK(stats.commandCount == recorded.commandCount);
+	SMOK_RENDERER_TEST_CHECK(replayed.data == recorded.data);
+
+	//a cut off trace fails instead of replaying half a command
+	CommandTrace cutOff = recorded;
+	cutOff.data.resize(cutOff.data.size() - 3);
+	replayed = CommandTrace();
+	SMOK_RENDERER_TEST_CHECK(!CommandTrace_Replay(cutOff, VK_NULL_HANDLE, &replayer, CommandTraceReplay()).succeeded);
+}
+
+//a render graph executed through a null dispatch traces it's barriers
+SMOK_RENDERER_TEST(CommandTrace_RecordsRenderGraphBarriers)
+{
+	RenderGraph graph;
+	const uint32 color = RenderGraph_CreateImage(&graph, "Color", { VK_FORMAT_R8G8B8A8_UNORM, 64, 64, 1 });
+	const uint32 writePass = RenderGraph_AddPass(&graph, "Write", [](VkCommandBuffer) {});
+	RenderGraph_Write(&graph, writePass, color, RenderGraph_Access::ColorAttachment, true);
+	const uint32 readPass = RenderGraph_AddPass(&graph, "Read", [](VkCommandBuffer) {});
+	RenderGraph_Read(&graph, readPass, color, RenderGraph_Access::FragmentRead);
+	RenderGraph_SetSideEffects(&graph, readPass);
+	SMOK_RENDERER_TEST_REQUIRE(RenderGraph_Compile(&graph));
+
+	uint64 barrierGroups = (graph.finalBarriers.empty() ? 0 : 1);
+	for (size_t o = 0; o < graph.order.size(); ++o)
+		barrierGroups += (graph.order[o].barriers.empty() ? 0 : 1);
+	SMOK_RENDERER_TEST_CHECK(barrierGroups > 0);
+
+	CommandTrace trace;
+	Dispatch dispatch;
+	dispatch.backend = DispatchBackend::Null; dispatch.trace = &trace;
+	SMOK_RENDERER_TEST_CHECK(RenderGraph_Execute(&graph, VK_NULL_HANDLE, &dispatch));
+	SMOK_RENDERER_TEST_CHECK(trace.commandCounts[(size_t)CommandTrace_Op::PipelineBarrier] == barrierGroups);
+}
+
+//a file whose data size doesn't match what's in it is rejected before anything is allocated
+SMOK_RENDERER_TEST(CommandTrace_LoadFileChecksTheDataSize)
+{
+	CommandTrace recorded;
+	Dispatch recorder;
+	recorder.backend = DispatchBackend::Null; recorder.trace = &recorded;
+	RecordTransferFrame(&recorder);
+
+	const std::string path = "SmokRenderers-Tests-CommandTrace.smtr";
+	SMOK_RENDERER_TEST_REQUIRE(CommandTrace_WriteFile(recorded, path));
+
+	CommandTrace loaded;
+	SMOK_RENDERER_TEST_CHECK(CommandTrace_LoadFile(&loaded, path));
+	SMOK_RENDERER_TEST_CHECK(loaded.data == recorded.data && loaded.commandCount == recorded.commandCount);
+
+	//the data size is the third count, after the magic and version
+	std::vector<uint8> bytes;
+	{
+		std::ifstream file(path, std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	SMOK_RENDERER_TEST_REQUIRE(bytes.size() > sizeof(uint32) * 2 + sizeof(uint64) * 3);
+
+	const auto writeBytes = [&](const std::vector<uint8>& contents) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write((const char*)contents.data(), (std::streamsize)contents.size());
+	};
+
+	std::vector<uint8> huge = bytes;
+	const uint64 hugeSize = 0x7FFFFFFFFFFFull;
+	memcpy(huge.data() + sizeof(uint32) * 2 + sizeof(uint64) * 2, &hugeSize, sizeof(uint64));
+	writeBytes(huge);
+	SMOK_RENDERER_TEST_CHECK(!CommandTrace_LoadFile(&loaded, path));
+	SMOK_RENDERER_TEST_CHECK(loaded.data.empty() && loaded.commandCount == 0);
+
+	std::vector<uint8> cutOff(bytes.begin(), bytes.end() - 5);
+	writeBytes(cutOff);
+	SMOK_RENDERER_TEST_CHECK(!CommandTrace_LoadFile(&loaded, path));
+
+	std::remove(path.c_str());
+}
@@ -0,0 +1,252 @@
+//tests the GPU culler's shader against it's CPU reference on a headless device, like lavapipe
+//needs shaders/GPUCull.comp compiled to GPUCull.comp.spv in --data, skips without it or a device
+
+#include "TestDevice.hpp"
+
+#include <SmokRenderers/Renderers/GPUBasedMeshRenderer.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Smok::Renderers;
+
+//defines a scene for the culler, a grid of objects around a camera split over two batches
+struct GPUCullTestScene
+{
+	std::vector<GPUBased::MeshRenderer::ObjectBuffer_Object> objects;
+	std::vector<Culling::GPUCull_Candidate> candidates;
+	std::vector<Culling::GPUCull_MeshDraw> meshDraws;
+	uint32 batchDrawCounts[2] = { 0, 0 };
+	uint32 commandCount = 0;
+	glm::mat4 V = glm::mat4(1.0f), P = glm::mat4(1.0f);
+};
+
+//makes the scene || two meshes with three LODs each, objects on a 20 x 20 grid so some are behind and beside the camera
+static GPUCullTestScene BuildGPUCullTestScene()
+{
+	GPUCullTestScene scene;
+
+	for (uint32 m = 0; m < 2; ++m)
+	{
+		for (uint32 l = 0; l < 3; ++l)
+		{
+			Culling::GPUCull_MeshDraw* draw = &scene.meshDraws.emplace_back(Culling::GPUCull_MeshDraw());
+			draw->indexCount = (300 >> l) * 3;
+			draw->firstIndex = (m * 3 + l) * 1000;
+			draw->vertexOffset = (int32)(m * 3 + l) * 500;
+		}
+	}
+
+	for (uint32 x = 0; x < 20; ++x)
+	{
+		for (uint32 z = 0; z < 20; ++z)
+		{
+			const uint32 objectIndex = (uint32)scene.objects.size();
+			GPUBased::MeshRenderer::ObjectBuffer_Object* object = &scene.objects.emplace_back(GPUBased::MeshRenderer::ObjectBuffer_Object());
+			object->model = glm::translate(glm::mat4(1.0f), glm::vec3(((float)x - 9.5f) * 10.0f, 0.0f, ((float)z - 9.5f) * 10.0f));
+
+			//every other object has a second sub mesh
+			for (uint32 m = 0; m < 1 + (objectIndex % 2); ++m)
+			{
+				const uint32 batch = (x + z) % 2;
+				Culling::GPUCull_Candidate* candidate = &scene.candidates.emplace_back(Culling::GPUCull_Candidate());
+				candidate->cullSphere = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f + (float)m);
+				candidate->lodSphere = glm::vec4(0.0f, 0.0f, 0.0f, 2.0f);
+				candidate->lodScreenSizes = glm::vec4(0.2f, 0.05f, 0.0f, 0.0f);
+				candidate->objectIndex = objectIndex;
+				candidate->firstLODMeshDraw = m * 3;
+				candidate->lodCount = 3;
+				candidate->batchIndex = batch;
+				candidate->candidateIndex = scene.batchDrawCounts[batch]++;
+			}
+		}
+	}
+
+	//batch 1's commands follow batch 0's
+	for (size_t c = 0; c < scene.candidates.size(); ++c)
+		scene.candidates[c].commandBase = (scene.candidates[c].batchIndex == 1 ? scene.batchDrawCounts[0] : 0);
+	scene.commandCount = scene.batchDrawCounts[0] + scene.batchDrawCounts[1];
+
+	scene.P = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 60.0f);
+	scene.V = glm::lookAt(glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	return scene;
+}
+
+//culls the scene on the device and on the CPU, checking they wrote the same commands
+static void GPUCuller_CheckAgainstCPU(Smok::Renderers::Test::TestContext* test, Test::TestDevice* device,
+	const std::string& SPIRVPath, const bool compact)
+{
+	const GPUCullTestScene scene = BuildGPUCullTestScene();
+
+	Culling::GPUCuller culler;
+	SMOK_RENDERER_TEST_REQUIRE(Culling::GPUCuller_Init(&culler, &device->GPU, device->allocator, SPIRVPath, 1, compact, true));
+
+	Util::GPUBuffer objectBuffer;
+	SMOK_RENDERER_TEST_REQUIRE(Util::GPUBuffer_Create(&objectBuffer, device->allocator, sizeof(scene.objects[0]) * scene.objects.size(),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU));
+	Util::GPUBuffer_Write(&objectBuffer, device->allocator, scene.objects.data(), sizeof(scene.objects[0]) * scene.objects.size());
+
+	//the mesh draws go up in two steps, like a frame that sees a new static mesh, so the appended upload is what's read
+	const std::vector<Culling::GPUCull_MeshDraw> firstMeshDraws(scene.meshDraws.begin(), scene.meshDraws.begin() + 3);
+	SMOK_RENDERER_TEST_CHECK(Culling::GPUCuller_UploadMeshDraws(&culler, 0, firstMeshDraws));
+	SMOK_RENDERER_TEST_CHECK(Culling::GPUCuller_UploadMeshDraws(&culler, 0, scene.meshDraws));
+	SMOK_RENDERER_TEST_CHECK(Culling::GPUCuller_UploadCandidates(&culler, 0, scene.candidates, scene.commandCount, 2));
+
+	Culling::GPUCull_PushConstants pc = Culling::GPUCuller_CalculatePushConstants(scene.V, scene.P,
+		(uint32)scene.candidates.size(), compact);
+	SMOK_RENDERER_TEST_CHECK(Test::TestDevice_Submit(device, [&](VkCommandBuffer comBuffer) {
+		Culling::GPUCuller_RecordCull(&culler, comBuffer, 0, objectBuffer.buffer, objectBuffer.size, pc);
+	}));
+
+	std::vector<VkDrawIndexedIndirectCommand> GPUCommands; std::vector<uint32> GPUCounts;
+	SMOK_RENDERER_TEST_CHECK(Culling::GPUCuller_ReadBack(&culler, 0, GPUCommands, GPUCounts));
+
+	std::vector<VkDrawIndexedIndirectCommand> CPUCommands(scene.commandCount, VkDrawIndexedIndirectCommand());
+	std::vector<uint32> CPUCounts(2, 0);
+	Culling::GPUCuller_CullCPU(pc, scene.candidates.data(), scene.meshDraws.data(),
+		&scene.objects[0].model, sizeof(scene.objects[0]), CPUCommands.data(), CPUCounts.data());
+
+	//the scene has to cull something and keep something, or the comparison proves nothing
+	if (compact)
+	{
+		SMOK_RENDERER_TEST_CHECK(CPUCounts[0] + CPUCounts[1] > 0);
+		SMOK_RENDERER_TEST_CHECK(CPUCounts[0] + CPUCounts[1] < scene.candidates.size());
+	}
+
+	if (GPUCommands.size() == scene.commandCount && GPUCounts.size() == 2)
+	{
+		for (uint32 b = 0; b < 2; ++b)
+		{
+			const uint32 commandBase = (b == 1 ? scene.batchDrawCounts[0] : 0);
+			if (compact)
+				SMOK_RENDERER_TEST_CHECK(GPUCounts[b] == CPUCounts[b]);
+			SMOK_RENDERER_TEST_CHECK(Culling::GPUCuller_CompareBatch(GPUCommands.data() + commandBase, CPUCommands.data() + commandBase,
+				(compact ? CPUCounts[b] : scene.batchDrawCounts[b])));
+		}
+	}
+	else
+		SMOK_RENDERER_TEST_CHECK(GPUCommands.size() == scene.commandCount && GPUCounts.size() == 2);
+
+	Util::GPUBuffer_Destroy(&objectBuffer, device->allocator);
+	Culling::GPUCuller_Destroy(&culler);
+}
+
+//the compacted commands and counts, as drawn with vkCmdDrawIndexedIndirectCount
+SMOK_RENDERER_TEST(GPUCuller_CompactedMatchesCPUReference)
+{
+	const std::string SPIRVPath = Test::Test_GetDataPath(test, "GPUCull.comp.spv");
+	if (!Test::Test_FileExists(SPIRVPath))
+		SMOK_RENDERER_TEST_SKIP("no " + SPIRVPath + ", compile shaders/GPUCull.comp with glslc");
+
+	Test::TestDevice device;
+	SMOK_RENDERER_TEST_REQUIRE_DEVICE(device);
+	GPUCuller_CheckAgainstCPU(test, &device, SPIRVPath, true);
+	Test::TestDevice_Destroy(&device);
+}
+
+//every slot written with culled draws having 0 instances, as drawn without drawIndirectCount
+SMOK_RENDERER_TEST(GPUCuller_UncompactedMatchesCPUReference)
+{
+	const std::string SPIRVPath = Test::Test_GetDataPath(test, "GPUCull.comp.spv");
+	if (!Test::Test_FileExists(SPIRVPath))
+		SMOK_RENDERER_TEST_SKIP("no " + SPIRVPath + ", compile shaders/GPUCull.comp with glslc");
+
+	Test::TestDevice device;
+	SMOK_RENDERER_TEST_REQUIRE_DEVICE(device);
+	GPUCuller_CheckAgainstCPU(test, &device, SPIRVPath, false);
+	Test::TestDevice_Destroy(&device);
+}
+
+//the CPU reference on it's own, so the scene's expectations are checked even without a device
+SMOK_RENDERER_TEST(GPUCuller_CPUReferenceCullsAndPicksLODs)
+{
+	const GPUCullTestScene scene = BuildGPUCullTestScene();
+
+	std::vector<VkDrawIndexedIndirectCommand> commands(scene.commandCount, VkDrawIndexedIndirectCommand());
+	std::vector<uint32> counts(2, 0);
+	Culling::GPUCull_PushConstants pc = Culling::GPUCuller_CalculatePushConstants(scene.V, scene.P, (uint32)scene.candidates.size(), true);
+	Culling::GPUCuller_CullCPU(pc, scene.candidates.data(), scene.meshDraws.data(),
+		&scene.objects[0].model, sizeof(scene.objects[0]), commands.data(), counts.data());
+
+	const uint32 visibleCount = counts[0] + counts[1];
+	SMOK_RENDERER_TEST_CHECK(visibleCount > 0);
+	SMOK_RENDERER_TEST_CHECK(visibleCount < scene.candidates.size());
+
+	//near objects keep full detail, far ones drop to a coarser LOD
+	bool sawFull = false, sawCoarse = false;
+	for (uint32 b = 0; b < 2; ++b)
+	{
+		const uint32 commandBase = (b == 1 ? scene.batchDrawCounts[0] : 0);
+		for (uint32 i = 0; i < counts[b]; ++i)
+		{
+			const VkDrawIndexedIndirectCommand& command = commands[commandBase + i];
+			SMOK_RENDERER_TEST_CHECK(command.instanceCount == 1);
+			SMOK_RENDERER_TEST_CHECK(command.firstInstance < scene.objects.size());
+			sawFull = sawFull || command.indexCount == 900;
+			sawCoarse = sawCoarse || command.indexCount < 900;
+		}
+	}
+	SMOK_RENDERER_TEST_CHECK(sawFull);
+	SMOK_RENDERER_TEST_CHECK(sawCoarse);
+
+	//without compaction every slot is written
+	std::vector<VkDrawIndexedIndirectCommand> slots(scene.commandCount, VkDrawIndexedIndirectCommand());
+	std::vector<uint32> unusedCounts(2, 0);
+	pc.compact = 0;
+	Culling::GPUCuller_CullCPU(pc, scene.candidates.data(), scene.meshDraws.data(),
+		&scene.objects[0].model, sizeof(scene.objects[0]), slots.data(), unusedCounts.data());
+
+	uint32 instanced = 0;
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		SMOK_RENDERER_TEST_CHECK(slots[i].indexCount > 0);
+		instanced += slots[i].instanceCount;
+	}
+	SMOK_RENDERER_TEST_CHECK(instanced == visibleCount);
+}
+
+//the two occlusion phases of the CPU reference draw every visible candidate once, phase two recovering what phase one wrongly rejected
+SMOK_RENDERER_TEST(GPUCuller_CPUReferenceOcclusionPhasesRecoverRejected)
+{
+	const GPUCullTestScene scene = BuildGPUCullTestScene();
+	const uint32 candidateCount = (uint32)scene.candidates.size();
+	const Culling::GPUCull_PushConstants pc = Culling::GPUCuller_CalculatePushConstants(scene.V, scene.P, candidateCount, true);
+	const glm::mat4 PV = scene.P * scene.V;
+
+	std::vector<VkDrawIndexedIndirectCommand> commands(scene.commandCount, VkDrawIndexedIndirectCommand());
+	std::vector<uint32> counts(2, 0);
+	Culling::GPUCuller_CullCPU(pc, scene.candidates.data(), scene.meshDraws.data(),
+		&scene.objects[0].model, sizeof(scene.objects[0]), commands.data(), counts.data());
+	const uint32 visibleCount = counts[0] + counts[1];
+
+	//last frame's depth covers everything, this frame's is empty
+	const uint32 width = 64, height = 32;
+	const std::vector<float> nearDepth((size_t)width * height, 0.0f), farDepth((size_t)width * height, 1.0f);
+	Culling::DepthPyramid lastPyramid, newPyramid;
+	Culling::DepthPyramid_Build(&lastPyramid, nearDepth.data(), width, height);
+	Culling::DepthPyramid_Build(&newPyramid, farDepth.data(), width, height);
+
+	//phase one writes the first half of the commands and counts, phase two the second
+	std::vector<VkDrawIndexedIndirectCommand> phaseCommands(scene.commandCount * 2, VkDrawIndexedIndirectCommand());
+	std::vector<uint32> phaseCounts(4, 0), rejected(candidateCount, 0);
+	Culling::GPUCuller_CullCPU(pc, scene.candidates.data(), scene.meshDraws.data(), &scene.objects[0].model, sizeof(scene.objects[0]),
+		phaseCommands.data(), phaseCounts.data(), Culling::GPUCull_OcclusionPhase::PhaseOne, &lastPyramid, PV, rejected.data());
+
+	uint32 rejectedCount = 0;
+	for (uint32 i = 0; i < candidateCount; ++i)
+		rejectedCount += rejected[i];
+	SMOK_RENDERER_TEST_CHECK(rejectedCount > 0);
+	SMOK_RENDERER_TEST_CHECK(phaseCounts[0] + phaseCounts[1] + rejectedCount == visibleCount);
+
+	Culling::GPUCuller_CullCPU(pc, scene.candidates.data(), scene.meshDraws.data(), &scene.objects[0].model, sizeof(scene.objects[0]),
+		phaseCommands.data() + scene.commandCount, phaseCounts.data() + 2, Culling::GPUCull_OcclusionPhase::PhaseTwo, &newPyramid, PV,
+		rejected.data());
+	SMOK_RENDERER_TEST_CHECK(phaseCounts[2] + phaseCounts[3] == rejectedCount);
+	SMOK_RENDERER_TEST_CHECK(phaseCounts[0] + phaseCounts[1] + phaseCounts[2] + phaseCounts[3] == visibleCount);
+
+	//against a pyramid that still hides them nothing is recovered
+	std::vector<uint32> hiddenCounts(2, 0);
+	Culling::GPUCuller_CullCPU(pc, scene.candidates.data(), scene.meshDraws.data(), &scene.objects[0].model, sizeof(scene.objects[0]),
+		phaseCommands.data() + scene.commandCount, hiddenCounts.data(), Culling::GPUCull_OcclusionPhase::PhaseTwo, &lastPyramid, PV,
+		rejected.data());
+	SMOK_RENDERER_TEST_CHECK(hiddenCounts[0] + hiddenCounts[1] == 0);
+}
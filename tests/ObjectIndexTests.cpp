@@ -0,0 +1,223 @@
+//tests the object buffer entries the mesh renderer draws with, on the CPU side renderer, which needs no device
+
+#include "Test.hpp"
+
+#include <SmokRenderers/Renderers/GPUBasedMeshRenderer.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Smok::Renderers;
+using namespace Smok::Renderers::GPUBased;
+using namespace Smok::Renderers::GPUBased::MeshRenderer;
+
+//defines the assets of the test scene
+struct ObjectIndexScene
+{
+	std::vector<uint64> shaderIDs, pipelineIDs, meshIDs;
+	uint64 textureID = 0, samplerID = 0;
+};
+
+//gets a fake handle, so the asset manager thinks a asset was already made and never touches the device
+template<typename T>
+static T StandInHandle(const uint64 value) { return (T)(uintptr_t)value; }
+
+//registers two pipelines and three meshes, the last with two sub meshes, as if they were loaded and uploaded
+static void CreateSceneAssets(AssetManager* assetManager, ObjectIndexScene* scene)
+{
+	uint64 handle = 1;
+	for (uint32 i = 0; i < 2; ++i)
+	{
+		Smok::Graphics::Pipeline::GraphicsShader* shader = assetManager->RegisterGraphicsShader(("ObjectIndexShader_" + std::to_string(i)).c_str(), "");
+		shader->fMod = StandInHandle<VkShaderModule>(handle++);
+		scene->shaderIDs.emplace_back(shader->assetID);
+
+		Smok::Graphics::Pipeline::GraphicsPipeline* pipeline = assetManager->RegisterGraphicsPipeline(("ObjectIndexPipeline_" + std::to_string(i)).c_str(), "", shader->assetID);
+		pipeline->pipeline = StandInHandle<VkPipeline>(handle++);
+		scene->pipelineIDs.emplace_back(pipeline->assetID);
+	}
+
+	Smok::Texture::Texture* texture = assetManager->RegisterTexture("ObjectIndexTexture", "");
+	texture->image = StandInHandle<VkImage>(handle++);
+	texture->view = StandInHandle<VkImageView>(handle++);
+	scene->textureID = texture->assetID;
+	scene->samplerID = assetManager->RegisterSampler2D("ObjectIndexSampler", "")->assetID;
+	assetManager->samplerAssets[scene->samplerID].sampler = StandInHandle<VkSampler>(handle++);
+
+	uint32 megaMeshBufferIndex = 0;
+	for (uint32 i = 0; i < 3; ++i)
+	{
+		StaticMesh* staticMesh = assetManager->RegisterStaticMesh(("ObjectIndexMesh_" + std::to_string(i)).c_str(), "");
+		staticMesh->isLoaded = true;
+		staticMesh->bounds.min = glm::vec3(-1.0f); staticMesh->bounds.max = glm::vec3(1.0f);
+		staticMesh->bounds.sphere = glm::vec4(0.0f, 0.0f, 0.0f, 1.7320508f);
+
+		for (uint32 m = 0; m < (i == 2 ? 2u : 1u); ++m)
+		{
+			StaticMesh_SubMesh subMesh;
+			subMesh.megaMeshBufferIndex = megaMeshBufferIndex++;
+			subMesh.indexCount = 36;
+			subMesh.bounds = staticMesh->bounds;
+			staticMesh->megaMeshBufferIndexes.emplace_back(subMesh.megaMeshBufferIndex);
+			staticMesh->subMeshes.emplace_back(subMesh);
+
+			MegaMeshBuffer_MeshEntry entry;
+			entry.subMesh = subMesh;
+			assetManager->megaMeshBufferMeshes.emplace_back(entry);
+		}
+		scene->meshIDs.emplace_back(staticMesh->assetID);
+	}
+
+	//the draws only check there are vertices, the stand-in buffer has no data behind it
+	assetManager->megaMeshBuffer.vertexCount = megaMeshBufferIndex * 24;
+}
+
+//adds objects in a row along X, spread over the pipelines and meshes so some draws are instanced
+static void AddSceneObjects(GPUMeshRenderer* renderer, const ObjectIndexScene& scene, std::vector<BTD::Math::Transform>& transforms,
+	std::vector<ObjectBatch_Object>& objects)
+{
+	transforms.assign(24, BTD::Math::Transform());
+	for (uint32 i = 0; i < transforms.size(); ++i)
+	{
+		renderer->AddObject(&transforms[i], scene.meshIDs[(i / 2) % scene.meshIDs.size()], scene.shaderIDs[i / 12], scene.pipelineIDs[i / 12],
+			scene.textureID, scene.samplerID, objects);
+	}
+
+	//the model matrices are placed straight on the objects, where AddObject put the transform's
+	for (size_t i = 0; i < objects.size(); ++i)
+		objects[i].obj.model = glm::translate(glm::mat4(1.0f), glm::vec3(-30.0f + 2.5f * (float)i, 0.0f, 0.0f));
+}
+
+//records a frame into a trace, returning the number of commands drawn
+static uint64 RecordFrame(GPUMeshRenderer* renderer, const std::vector<RenderBatch>& renderBatch,
+	const std::vector<ObjectBuffer_Object>& objectBufferObjects, CommandTrace* trace)
+{
+	Dispatch dispatch;
+	dispatch.backend = DispatchBackend::Null; dispatch.trace = trace;
+	Frame frame;
+	frame.isValid = true; frame.frameSize = { 1280, 720 }; frame.dispatch = &dispatch;
+	VkCommandBuffer comBuffer = VK_NULL_HANDLE;
+	renderer->Render(comBuffer, frame, renderBatch, objectBufferObjects);
+
+	uint64 commandCount = 0;
+	for (size_t b = 0; b < renderBatch.size(); ++b)
+		commandCount += renderBatch[b].commands.size();
+	return commandCount;
+}
+
+//with one view each draw starts at it's entry and instanced draws read the entries after it
+SMOK_RENDERER_TEST(ObjectIndex_SingleViewDrawsStartAtTheirEntry)
+{
+	AssetManager assetManager;
+	assetManager.IDRegistery.iDRegistery.nextID = 1;
+	ObjectIndexScene scene;
+	CreateSceneAssets(&assetManager, &scene);
+
+	SMWindow_Desktop_Swapchain swapchain = {};
+	swapchain.framesInFlight = 2;
+	GPUMeshRenderer renderer;
+	renderer.InitCPUOnly(&swapchain, &assetManager);
+	renderer.RegisterView(glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f),
+		glm::lookAt(glm::vec3(0.0f, 0.0f, 40.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	std::vector<BTD::Math::Transform> transforms;
+	std::vector<ObjectBatch_Object> objects;
+	AddSceneObjects(&renderer, scene, transforms, objects);
+
+	std::vector<RenderBatch> renderBatch;
+	std::vector<ObjectBuffer_Object> objectBufferObjects;
+	renderer.CalculateCommandData(objects, renderBatch, objectBufferObjects);
+	SMOK_RENDERER_TEST_REQUIRE(!objectBufferObjects.empty());
+
+	std::string error;
+	SMOK_RENDERER_TEST_CHECK(renderer.ValidateObjectIndices(objects, renderBatch, objectBufferObjects, &error));
+	if (!error.empty())
+		std::printf("  %s\n", error.c_str());
+
+	//every entry is drawn exactly once, the instances of a draw being consecutive entries
+	uint64 instanceCount = 0;
+	bool instanced = false;
+	for (size_t b = 0; b < renderBatch.size(); ++b)
+	{
+		for (size_t i = 0; i < renderBatch[b].commands.size(); ++i)
+		{
+			instanceCount += renderBatch[b].commands[i].instanceCount;
+			instanced |= (renderBatch[b].commands[i].instanceCount > 1);
+		}
+	}
+	SMOK_RENDERER_TEST_CHECK(instanceCount == objectBufferObjects.size());
+	SMOK_RENDERER_TEST_CHECK(instanced);
+
+	CommandTrace trace;
+	const uint64 commandCount = RecordFrame(&renderer, renderBatch, objectBufferObjects, &trace);
+	SMOK_RENDERER_TEST_CHECK(trace.commandCounts[(size_t)CommandTrace_Op::DrawIndexed] == commandCount);
+
+	//a draw moved off it's entry is caught
+	SMOK_RENDERER_TEST_REQUIRE(!renderBatch.empty() && !renderBatch[0].commands.empty());
+	renderBatch[0].commands[0].objIndex = objectBufferObjects.size();
+	SMOK_RENDERER_TEST_CHECK(!renderer.ValidateObjectIndices(objects, renderBatch, objectBufferObjects));
+}
+
+//with several views every mode draws each command once, starting at it's entry, with a instance for each view that sees it
+SMOK_RENDERER_TEST(ObjectIndex_EveryViewModeDrawsFromTheEntry)
+{
+	AssetManager assetManager;
+	assetManager.IDRegistery.iDRegistery.nextID = 1;
+	ObjectIndexScene scene;
+	CreateSceneAssets(&assetManager, &scene);
+
+	SMWindow_Desktop_Swapchain swapchain = {};
+	swapchain.framesInFlight = 2;
+	GPUMeshRenderer renderer;
+	renderer.InitCPUOnly(&swapchain, &assetManager);
+
+	//a view of the middle of the row, one of the left end and one of the right end, so objects are seen by different views
+	const glm::mat4 P = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 1000.0f);
+	renderer.RegisterView(P, glm::lookAt(glm::vec3(0.0f, 0.0f, 8.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec4(0.0f, 0.0f, 1.0f, 0.5f));
+	renderer.RegisterView(P, glm::lookAt(glm::vec3(-25.0f, 0.0f, 8.0f), glm::vec3(-25.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+		glm::vec4(0.0f, 0.5f, 0.5f, 0.5f));
+	renderer.RegisterView(P, glm::lookAt(glm::vec3(25.0f, 0.0f, 8.0f), glm::vec3(25.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+		glm::vec4(0.5f, 0.5f, 0.5f, 0.5f));
+	SMOK_RENDERER_TEST_REQUIRE(renderer.GetViewCount() == 3);
+
+	std::vector<BTD::Math::Transform> transforms;
+	std::vector<ObjectBatch_Object> objects;
+	AddSceneObjects(&renderer, scene, transforms, objects);
+
+	const ViewMode modes[3] = { ViewMode::Viewports, ViewMode::Multiview, ViewMode::Layered };
+	for (uint32 m = 0; m < 3; ++m)
+	{
+		renderer.SetViewMode(modes[m]);
+
+		std::vector<RenderBatch> renderBatch;
+		std::vector<ObjectBuffer_Object> objectBufferObjects;
+		renderer.CalculateCommandData(objects, renderBatch, objectBufferObjects);
+		SMOK_RENDERER_TEST_REQUIRE(!objectBufferObjects.empty());
+
+		std::string error;
+		SMOK_RENDERER_TEST_CHECK(renderer.ValidateObjectIndices(objects, renderBatch, objectBufferObjects, &error));
+		if (!error.empty())
+			std::printf("  mode %u: %s\n", m, error.c_str());
+
+		//the end views only see their end of the row, so some objects skip the first view
+		bool skipsAView = false;
+		for (size_t b = 0; b < renderBatch.size(); ++b)
+		{
+			for (size_t i = 0; i < renderBatch[b].commands.size(); ++i)
+			{
+				const RenderCommand& command = renderBatch[b].commands[i];
+				uint32 instanceCount = 0, firstInstance = 0;
+				renderer.CalculateViewDraw(command, instanceCount, firstInstance);
+
+				SMOK_RENDERER_TEST_CHECK(command.instanceCount == 1);
+				SMOK_RENDERER_TEST_CHECK(firstInstance == command.objIndex);
+				SMOK_RENDERER_TEST_CHECK(instanceCount == (modes[m] == ViewMode::Multiview ? 1u : (command.viewMask & 4u ? 3u : (command.viewMask & 2u ? 2u : 1u))));
+				skipsAView |= ((command.viewMask & 1u) == 0);
+			}
+		}
+		SMOK_RENDERER_TEST_CHECK(skipsAView);
+
+		CommandTrace trace;
+		const uint64 commandCount = RecordFrame(&renderer, renderBatch, objectBufferObjects, &trace);
+		SMOK_RENDERER_TEST_CHECK(trace.commandCounts[(size_t)CommandTrace_Op::DrawIndexed] == commandCount);
+	}
+}
@@ -0,0 +1,199 @@
+//tests occlusion culling against the GPU's depth pyramid and against the software rasterizer reference
+//the shader test needs shaders/DepthPyramid.comp compiled to DepthPyramid.comp.spv in --data, and skips without it or a device
+
+#include "TestDevice.hpp"
+
+#include <SmokRenderers/Culling/OcclusionCuller.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Smok::Renderers;
+
+//the size of the depth attachment the GPU path reduces from, not a multiple of the pyramid so the footprints overlap
+#define OCCLUSION_TEST_DEPTH_WIDTH 1000
+#define OCCLUSION_TEST_DEPTH_HEIGHT 500
+
+//defines a scene with a wall in front of the camera and spheres around it
+struct OcclusionTestScene
+{
+	Smok::Mesh::Mesh wall;
+	glm::mat4 PV = glm::mat4(1.0f);
+
+	std::vector<glm::vec4> spheres;
+	std::vector<bool> expectOccluded;
+};
+
+//makes the scene || a 8 x 8 wall 10 units away, one sphere behind it, one in front, one beside and one on it's edge
+static OcclusionTestScene BuildOcclusionTestScene()
+{
+	OcclusionTestScene scene;
+
+	const glm::vec3 corners[4] = { glm::vec3(-4.0f, -4.0f, -10.0f), glm::vec3(4.0f, -4.0f, -10.0f), glm::vec3(4.0f, 4.0f, -10.0f), glm::vec3(-4.0f, 4.0f, -10.0f) };
+	for (uint32 i = 0; i < 4; ++i)
+		scene.wall.vertices.emplace_back(Smok::Mesh::Vertex()).position = corners[i];
+	scene.wall.indices = { 0, 1, 2, 0, 2, 3 };
+
+	const glm::mat4 P = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+	const glm::mat4 V = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	scene.PV = P * V;
+
+	scene.spheres = { glm::vec4(0.0f, 0.0f, -20.0f, 1.0f), glm::vec4(0.0f, 0.0f, -5.0f, 1.0f),
+		glm::vec4(15.0f, 0.0f, -20.0f, 1.0f), glm::vec4(8.0f, 0.0f, -20.0f, 1.0f) };
+	scene.expectOccluded = { true, false, false, false };
+	return scene;
+}
+
+//draws the wall into a depth buffer, like the depth attachment of the last frame
+static Culling::DepthBuffer DrawOcclusionTestDepth(const OcclusionTestScene& scene, const uint32 width, const uint32 height)
+{
+	Culling::DepthBuffer depth;
+	Culling::DepthBuffer_Clear(&depth, width, height);
+	Culling::SoftwareRasterizer_DrawMesh(&depth, scene.PV, scene.wall);
+	return depth;
+}
+
+//checks a pyramid culls the scene's spheres the way it should
+static void CheckOcclusionTestScene(Smok::Renderers::Test::TestContext* test, const OcclusionTestScene& scene, const Culling::DepthPyramid& pyramid)
+{
+	for (size_t i = 0; i < scene.spheres.size(); ++i)
+		SMOK_RENDERER_TEST_CHECK(Culling::OcclusionCuller_IsOccluded(pyramid, scene.spheres[i], scene.PV) == scene.expectOccluded[i]);
+}
+
+//the pyramid the GPU reduces from a full size depth attachment culls the same as the software rasterizer's reference
+SMOK_RENDERER_TEST(OcclusionCuller_GPUPyramidMatchesSoftwareReference)
+{
+	const OcclusionTestScene scene = BuildOcclusionTestScene();
+	const Culling::OcclusionSettings settings;
+
+	//the reference, occluders drawn straight into a pyramid sized depth buffer
+	Culling::DepthPyramid reference;
+	Culling::DepthPyramid_Build(&reference, DrawOcclusionTestDepth(scene, settings.depthWidth, settings.depthHeight));
+
+	//the GPU path, reduced from the depth attachment
+	const Culling::DepthBuffer depth = DrawOcclusionTestDepth(scene, OCCLUSION_TEST_DEPTH_WIDTH, OCCLUSION_TEST_DEPTH_HEIGHT);
+	Culling::DepthPyramid GPUPyramid;
+	Culling::DepthPyramid_BuildFromDepth(&GPUPyramid, depth.depth.data(), depth.width, depth.height, settings.depthWidth, settings.depthHeight);
+
+	SMOK_RENDERER_TEST_REQUIRE(GPUPyramid.levels.size() == reference.levels.size());
+	SMOK_RENDERER_TEST_CHECK(GPUPyramid.levels[0].width == settings.depthWidth && GPUPyramid.levels[0].height == settings.depthHeight);
+	SMOK_RENDERER_TEST_CHECK(GPUPyramid.levels.back().width == 1 && GPUPyramid.levels.back().height == 1);
+
+	CheckOcclusionTestScene(test, scene, reference);
+	CheckOcclusionTestScene(test, scene, GPUPyramid);
+
+	//level 0 is conservative, every depth texel is behind or at the pyramid texel it falls in
+	uint32 closerCount = 0;
+	for (uint32 y = 0; y < depth.height; ++y)
+	{
+		for (uint32 x = 0; x < depth.width; ++x)
+		{
+			const uint32 px = (x * settings.depthWidth) / depth.width, py = (y * settings.depthHeight) / depth.height;
+			if (GPUPyramid.levels[0].depth[(size_t)py * settings.depthWidth + px] < depth.depth[(size_t)y * depth.width + x])
+				closerCount++;
+		}
+	}
+	SMOK_RENDERER_TEST_CHECK(closerCount == 0);
+
+	//the levels below 0 are built the same on both paths
+	Culling::DepthPyramid rebuilt;
+	Culling::DepthPyramid_Build(&rebuilt, GPUPyramid.levels[0].depth.data(), GPUPyramid.levels[0].width, GPUPyramid.levels[0].height);
+	for (size_t l = 0; l < rebuilt.levels.size(); ++l)
+		SMOK_RENDERER_TEST_CHECK(rebuilt.levels[l].depth == GPUPyramid.levels[l].depth);
+
+	//without a pyramid nothing is culled
+	SMOK_RENDERER_TEST_CHECK(!Culling::OcclusionCuller_IsOccluded(Culling::DepthPyramid(), scene.spheres[0], scene.PV));
+}
+
+//builds the pyramid on a device from a real depth image and checks it against the CPU reference, level by level
+SMOK_RENDERER_TEST(OcclusionCuller_ShaderPyramidMatchesCPUReference)
+{
+	const std::string SPIRVPath = Test::Test_GetDataPath(test, "DepthPyramid.comp.spv");
+	if (!Test::Test_FileExists(SPIRVPath))
+		SMOK_RENDERER_TEST_SKIP("no " + SPIRVPath + ", compile shaders/DepthPyramid.comp with glslc");
+
+	Test::TestDevice device;
+	SMOK_RENDERER_TEST_REQUIRE_DEVICE(device);
+
+	const OcclusionTestScene scene = BuildOcclusionTestScene();
+	const Culling::OcclusionSettings settings;
+	const Culling::DepthBuffer depth = DrawOcclusionTestDepth(scene, OCCLUSION_TEST_DEPTH_WIDTH, OCCLUSION_TEST_DEPTH_HEIGHT);
+
+	//the depth attachment, filled with the rasterized depth
+	VkImageCreateInfo imageInfo = {};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = VK_FORMAT_D32_SFLOAT;
+	imageInfo.extent = { depth.width, depth.height, 1 };
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VmaAllocationCreateInfo allocInfo = {};
+	allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+	VkImage depthImage = VK_NULL_HANDLE; VmaAllocation depthAllocation = VK_NULL_HANDLE;
+	SMOK_RENDERER_TEST_REQUIRE(vmaCreateImage(device.allocator, &imageInfo, &allocInfo, &depthImage, &depthAllocation, nullptr) == VK_SUCCESS);
+
+	VkImageViewCreateInfo viewInfo = {};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = depthImage;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = VK_FORMAT_D32_SFLOAT;
+	viewInfo.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+	VkImageView depthView = VK_NULL_HANDLE;
+	SMOK_RENDERER_TEST_CHECK(vkCreateImageView(device.GPU.device, &viewInfo, nullptr, &depthView) == VK_SUCCESS);
+
+	Util::GPUBuffer staging;
+	SMOK_RENDERER_TEST_CHECK(Util::GPUBuffer_Create(&staging, device.allocator, sizeof(float) * depth.depth.size(),
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY));
+	Util::GPUBuffer_Write(&staging, device.allocator, depth.depth.data(), sizeof(float) * depth.depth.size());
+
+	Culling::GPUDepthPyramid GPUPyramid;
+	SMOK_RENDERER_TEST_CHECK(Culling::GPUDepthPyramid_Init(&GPUPyramid, &device.GPU, device.allocator, SPIRVPath, 1,
+		settings.depthWidth, settings.depthHeight));
+
+	SMOK_RENDERER_TEST_CHECK(Test::TestDevice_Submit(&device, [&](VkCommandBuffer comBuffer) {
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = depthImage;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(comBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkBufferImageCopy copy = {};
+		copy.imageSubresource = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1 };
+		copy.imageExtent = { depth.width, depth.height, 1 };
+		vkCmdCopyBufferToImage(comBuffer, staging.buffer, depthImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL; barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(comBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		Culling::GPUDepthPyramid_RecordBuild(&GPUPyramid, comBuffer, 0, depthView, depth.width, depth.height);
+	}));
+
+	Culling::DepthPyramid readBack, reference;
+	SMOK_RENDERER_TEST_CHECK(Culling::GPUDepthPyramid_ReadBack(&GPUPyramid, 0, &readBack));
+	Culling::DepthPyramid_BuildFromDepth(&reference, depth.depth.data(), depth.width, depth.height, settings.depthWidth, settings.depthHeight);
+
+	//a max of the same floats is exact, so every level matches to the bit
+	SMOK_RENDERER_TEST_REQUIRE(readBack.levels.size() == reference.levels.size());
+	for (size_t l = 0; l < reference.levels.size(); ++l)
+	{
+		SMOK_RENDERER_TEST_CHECK(readBack.levels[l].width == reference.levels[l].width && readBack.levels[l].height == reference.levels[l].height);
+		SMOK_RENDERER_TEST_CHECK(readBack.levels[l].depth == reference.levels[l].depth);
+	}
+	CheckOcclusionTestScene(test, scene, readBack);
+
+	Culling::GPUDepthPyramid_Destroy(&GPUPyramid);
+	Util::GPUBuffer_Destroy(&staging, device.allocator);
+	if (depthView != VK_NULL_HANDLE)
+		vkDestroyImageView(device.GPU.device, depthView, nullptr);
+	vmaDestroyImage(device.allocator, depthImage, depthAllocation);
+	Test::TestDevice_Destroy(&device);
+}
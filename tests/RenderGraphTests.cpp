@@ -0,0 +1,149 @@
+//tests compiling a render graph, which needs no device
+
+#include "Test.hpp"
+
+#include <SmokRenderers/Renderers/GPUBasedMeshRenderer.hpp>
+
+using namespace Smok::Renderers;
+
+//finds the barrier of a resource before a pass in the compiled order, or null
+static const RenderGraph_Barrier* FindBarrier(const RenderGraph& graph, const uint32 pass, const uint32 resource)
+{
+	for (size_t o = 0; o < graph.order.size(); ++o)
+	{
+		if (graph.order[o].pass != pass)
+			continue;
+
+		for (size_t b = 0; b < graph.order[o].barriers.size(); ++b)
+		{
+			if (graph.order[o].barriers[b].resource == resource)
+				return &graph.order[o].barriers[b];
+		}
+	}
+
+	return nullptr;
+}
+
+//a deferred frame into the swapchain, with a pass nothing reads and a GUI drawn over the swapchain after the render pass presented it
+SMOK_RENDERER_TEST(RenderGraph_CompilesOrderCullingBarriersAndAliasing)
+{
+	RenderGraph graph;
+	const uint32 backbuffer = RenderGraph_ImportImage(&graph, "Backbuffer", { VK_FORMAT_B8G8R8A8_UNORM, 1920, 1080, 1 },
+		VK_NULL_HANDLE, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	const uint32 gBuffer = RenderGraph_CreateImage(&graph, "GBuffer", { VK_FORMAT_R8G8B8A8_UNORM, 1920, 1080, 1 });
+	const uint32 depth = RenderGraph_CreateImage(&graph, "Depth", { VK_FORMAT_D32_SFLOAT, 1920, 1080, 1 });
+	const uint32 lighting = RenderGraph_CreateImage(&graph, "Lighting", { VK_FORMAT_R16G16B16A16_SFLOAT, 1920, 1080, 1 });
+	const uint32 debug = RenderGraph_CreateImage(&graph, "Debug", { VK_FORMAT_R8G8B8A8_UNORM, 1920, 1080, 1 });
+
+	const uint32 gBufferPass = RenderGraph_AddPass(&graph, "GBuffer", [](VkCommandBuffer) {});
+	RenderGraph_Write(&graph, gBufferPass, gBuffer, RenderGraph_Access::ColorAttachment, true);
+	RenderGraph_Write(&graph, gBufferPass, depth, RenderGraph_Access::DepthAttachment, true);
+
+	const uint32 debugPass = RenderGraph_AddPass(&graph, "Debug", [](VkCommandBuffer) {});
+	RenderGraph_Write(&graph, debugPass, debug, RenderGraph_Access::ColorAttachment, true);
+
+	const uint32 lightingPass = RenderGraph_AddPass(&graph, "Lighting", [](VkCommandBuffer) {});
+	RenderGraph_Read(&graph, lightingPass, gBuffer, RenderGraph_Access::FragmentRead);
+	RenderGraph_Write(&graph, lightingPass, lighting, RenderGraph_Access::ColorAttachment, true);
+
+	const uint32 tonemapPass = RenderGraph_AddPass(&graph, "Tonemap", [](VkCommandBuffer) {});
+	RenderGraph_Read(&graph, tonemapPass, lighting, RenderGraph_Access::FragmentRead);
+	RenderGraph_Write(&graph, tonemapPass, backbuffer, RenderGraph_Access::ColorAttachment, true);
+	RenderGraph_SetAttachmentFinalLayout(&graph, tonemapPass, backbuffer, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+	const uint32 GUIPass = RenderGraph_AddPass(&graph, "GUI", [](VkCommandBuffer) {});
+	RenderGraph_Write(&graph, GUIPass, backbuffer, RenderGraph_Access::ColorAttachment);
+	RenderGraph_SetAttachmentFinalLayout(&graph, GUIPass, backbuffer, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+	SMOK_RENDERER_TEST_REQUIRE(RenderGraph_Compile(&graph));
+
+	//order and culling
+	SMOK_RENDERER_TEST_CHECK(graph.passes[debugPass].culled);
+	SMOK_RENDERER_TEST_REQUIRE(graph.order.size() == 4);
+	SMOK_RENDERER_TEST_CHECK(graph.order[0].pass == gBufferPass);
+	SMOK_RENDERER_TEST_CHECK(graph.order[1].pass == lightingPass);
+	SMOK_RENDERER_TEST_CHECK(graph.order[2].pass == tonemapPass);
+	SMOK_RENDERER_TEST_CHECK(graph.order[3].pass == GUIPass);
+	SMOK_RENDERER_TEST_CHECK(graph.resources[debug].firstPass == -1);
+
+	//barriers
+	const RenderGraph_Barrier* gBufferRead = FindBarrier(graph, lightingPass, gBuffer);
+	SMOK_RENDERER_TEST_REQUIRE(gBufferRead != nullptr);
+	SMOK_RENDERER_TEST_CHECK(gBufferRead->oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	SMOK_RENDERER_TEST_CHECK(gBufferRead->newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	SMOK_RENDERER_TEST_CHECK(gBufferRead->srcStage == VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+	SMOK_RENDERER_TEST_CHECK(gBufferRead->dstStage == VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+	SMOK_RENDERER_TEST_CHECK((gBufferRead->srcAccess & VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT) != 0);
+
+	//the tonemap render pass left the backbuffer presentable, so the GUI moves it from there and nothing is left to do after
+	const RenderGraph_Barrier* GUIWrite = FindBarrier(graph, GUIPass, backbuffer);
+	SMOK_RENDERER_TEST_REQUIRE(GUIWrite != nullptr);
+	SMOK_RENDERER_TEST_CHECK(GUIWrite->oldLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	SMOK_RENDERER_TEST_CHECK(GUIWrite->newLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	SMOK_RENDERER_TEST_CHECK(graph.finalBarriers.empty());
+
+	//aliasing || the depth is dead before the lighting is made, the GBuffer overlaps both
+	SMOK_RENDERER_TEST_CHECK(graph.resources[depth].aliasSlot != -1);
+	SMOK_RENDERER_TEST_CHECK(graph.resources[depth].aliasSlot == graph.resources[lighting].aliasSlot);
+	SMOK_RENDERER_TEST_CHECK(graph.resources[gBuffer].aliasSlot != graph.resources[lighting].aliasSlot);
+	SMOK_RENDERER_TEST_CHECK(graph.aliasSlots.size() == 2);
+	SMOK_RENDERER_TEST_CHECK(graph.aliasedBytes < graph.transientBytes);
+	SMOK_RENDERER_TEST_CHECK(graph.aliasedBytes == (VkDeviceSize)1920 * 1080 * (8 + 4));
+
+	//the first use of the aliased lighting image waits on the depth that used the memory before it
+	const RenderGraph_Barrier* lightingWrite = FindBarrier(graph, lightingPass, lighting);
+	SMOK_RENDERER_TEST_REQUIRE(lightingWrite != nullptr);
+	SMOK_RENDERER_TEST_CHECK(lightingWrite->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED);
+	SMOK_RENDERER_TEST_CHECK((lightingWrite->srcStage & VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) != 0);
+}
+
+//without the render pass's final layout the graph would think the swapchain is still a color attachment and move it to present itself
+SMOK_RENDERER_TEST(RenderGraph_FinalLayoutWithoutRenderPassLayout)
+{
+	RenderGraph graph;
+	const uint32 backbuffer = RenderGraph_ImportImage(&graph, "Backbuffer", { VK_FORMAT_B8G8R8A8_UNORM, 64, 64, 1 },
+		VK_NULL_HANDLE, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	const uint32 pass = RenderGraph_AddPass(&graph, "Draw", [](VkCommandBuffer) {});
+	RenderGraph_Write(&graph, pass, backbuffer, RenderGraph_Access::ColorAttachment, true);
+
+	SMOK_RENDERER_TEST_REQUIRE(RenderGraph_Compile(&graph));
+	SMOK_RENDERER_TEST_REQUIRE(graph.finalBarriers.size() == 1);
+	SMOK_RENDERER_TEST_CHECK(graph.finalBarriers[0].oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	SMOK_RENDERER_TEST_CHECK(graph.finalBarriers[0].newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+}
+
+//a graph that reads a transient before anything writes it can't compile
+SMOK_RENDERER_TEST(RenderGraph_ReadBeforeWriteFails)
+{
+	RenderGraph graph;
+	const uint32 image = RenderGraph_CreateImage(&graph, "Image", { VK_FORMAT_R8G8B8A8_UNORM, 64, 64, 1 });
+	const uint32 pass = RenderGraph_AddPass(&graph, "Read", [](VkCommandBuffer) {});
+	RenderGraph_Read(&graph, pass, image, RenderGraph_Access::FragmentRead);
+	RenderGraph_SetSideEffects(&graph, pass);
+
+	SMOK_RENDERER_TEST_CHECK(!RenderGraph_Compile(&graph));
+}
+
+//the mesh renderer's draw pass tells the graph the layouts it's render pass leaves the targets in
+SMOK_RENDERER_TEST(RenderGraph_MeshPassDeclaresFinalLayouts)
+{
+	SMWindow_Desktop_Swapchain swapchain = {};
+	swapchain.framesInFlight = 2;
+	AssetManager assetManager;
+	GPUBased::MeshRenderer::GPUMeshRenderer renderer;
+	renderer.InitCPUOnly(&swapchain, &assetManager);
+
+	RenderGraph graph;
+	const uint32 backbuffer = RenderGraph_ImportImage(&graph, "Backbuffer", { VK_FORMAT_B8G8R8A8_UNORM, 64, 64, 1 },
+		VK_NULL_HANDLE, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	const uint32 depth = RenderGraph_CreateImage(&graph, "Depth", { VK_FORMAT_D32_SFLOAT, 64, 64, 1 });
+
+	Frame frame; frame.frameSize = { 64, 64 };
+	std::vector<GPUBased::MeshRenderer::RenderBatch> renderBatch;
+	std::vector<GPUBased::MeshRenderer::ObjectBuffer_Object> objectBufferObjects;
+	const uint32 drawPass = renderer.AddRenderGraphPasses(&graph, &frame, backbuffer, depth, VK_NULL_HANDLE, &renderBatch, &objectBufferObjects);
+
+	SMOK_RENDERER_TEST_REQUIRE(RenderGraph_Compile(&graph));
+	SMOK_RENDERER_TEST_CHECK(graph.passes[drawPass].attachmentFinalLayouts.size() == 2);
+	SMOK_RENDERER_TEST_CHECK(graph.finalBarriers.empty());
+}
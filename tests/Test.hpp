@@ -0,0 +1,87 @@
+#pragma once
+
+//defines a small headless test harness for the renderers
+//each test is a function registered with SMOK_RENDERER_TEST, tests/source.cpp runs them and fails if any check does
+//tests that need a device look for one and skip themselves when there isn't one
+
+#include <SmokWindow/Desktop/DesktopWindow.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace Smok::Renderers::Test
+{
+	//defines the state of the test being run
+	struct TestContext
+	{
+		std::string name = "";
+		std::string dataPath = ""; //where the compiled shaders and other test data are, from --data
+		uint32 checkCount = 0, failedCheckCount = 0;
+		bool skipped = false;
+		std::string skipReason = "";
+	};
+
+	//defines a registered test
+	struct TestCase
+	{
+		std::string name = "";
+		std::function<void(TestContext* test)> func;
+	};
+
+	//gets every registered test
+	inline std::vector<TestCase>& Test_GetCases()
+	{
+		static std::vector<TestCase> cases;
+		return cases;
+	}
+
+	//registers a test when it's static is made
+	struct TestRegistrar
+	{
+		inline TestRegistrar(const char* name, const std::function<void(TestContext* test)>& func)
+		{
+			Test_GetCases().emplace_back(TestCase{ name, func });
+		}
+	};
+
+	//checks a condition, printing where it failed || returns the condition so a test can stop early
+	inline bool Test_Check(TestContext* test, const bool condition, const char* expression, const char* file, const int32 line)
+	{
+		test->checkCount++;
+		if (condition)
+			return true;
+
+		test->failedCheckCount++;
+		std::printf("  %s:%i: check failed: %s\n", file, line, expression);
+		return false;
+	}
+
+	//skips the rest of a test, like when there's no device to run it on
+	inline void Test_Skip(TestContext* test, const std::string& reason)
+	{
+		test->skipped = true; test->skipReason = reason;
+	}
+
+	//gets the path of a file in the test data
+	inline std::string Test_GetDataPath(const TestContext* test, const std::string& file)
+	{
+		return (test->dataPath.empty() ? file : test->dataPath + "/" + file);
+	}
+}
+
+//defines a test
+#define SMOK_RENDERER_TEST(name) \
+	static void name(Smok::Renderers::Test::TestContext* test); \
+	static Smok::Renderers::Test::TestRegistrar name##_Registrar(#name, name); \
+	static void name(Smok::Renderers::Test::TestContext* test)
+
+//checks a condition in a test, carrying on if it fails
+#define SMOK_RENDERER_TEST_CHECK(condition) Smok::Renderers::Test::Test_Check(test, (condition), #condition, __FILE__, __LINE__)
+
+//checks a condition in a test, leaving the test if it fails
+#define SMOK_RENDERER_TEST_REQUIRE(condition) do { if (!SMOK_RENDERER_TEST_CHECK(condition)) return; } while (0)
+
+//skips the rest of a test
+#define SMOK_RENDERER_TEST_SKIP(reason) do { Smok::Renderers::Test::Test_Skip(test, reason); return; } while (0)
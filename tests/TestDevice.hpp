@@ -0,0 +1,196 @@
+#pragma once
+
+//makes a headless Vulkan device for the tests that run shaders
+//CPU devices like lavapipe are picked first so results are the same on every machine, point VK_ICD_FILENAMES at lavapipe's ICD to force it
+//tests skip themselves when there's no device or the compiled shaders aren't in --data
+
+#include "Test.hpp"
+
+#include <vk_mem_alloc.h>
+
+#include <fstream>
+
+namespace Smok::Renderers::Test
+{
+	//defines a headless device
+	struct TestDevice
+	{
+		VkInstance instance = VK_NULL_HANDLE;
+		VkPhysicalDeviceProperties properties = {};
+		SMGraphics_Core_GPU GPU = {}; //only the device, physical device and graphics queue are set
+		uint32 queueFamily = 0; //a family with graphics and compute
+
+		VmaAllocator allocator = VK_NULL_HANDLE;
+		SMGraphics_Pool_CommandPool commandPool = {};
+	};
+
+	//checks if a file exists, like a compiled shader in the test data
+	inline bool Test_FileExists(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return file.good();
+	}
+
+	//destroys a headless device
+	inline void TestDevice_Destroy(TestDevice* device)
+	{
+		if (device->GPU.device != VK_NULL_HANDLE)
+		{
+			vkDeviceWaitIdle(device->GPU.device);
+			if (device->commandPool.pool != VK_NULL_HANDLE)
+				vkDestroyCommandPool(device->GPU.device, device->commandPool.pool, nullptr);
+			if (device->allocator != VK_NULL_HANDLE)
+				vmaDestroyAllocator(device->allocator);
+			vkDestroyDevice(device->GPU.device, nullptr);
+		}
+		if (device->instance != VK_NULL_HANDLE)
+			vkDestroyInstance(device->instance, nullptr);
+
+		*device = TestDevice();
+	}
+
+	//makes a headless device, returning why it couldn't in error
+	inline bool TestDevice_Create(TestDevice* device, std::string& error)
+	{
+		VkApplicationInfo appInfo = {};
+		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+		appInfo.pApplicationName = "SmokRenderers-Tests";
+		appInfo.apiVersion = VK_API_VERSION_1_2;
+
+		VkInstanceCreateInfo instanceInfo = {};
+		instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		instanceInfo.pApplicationInfo = &appInfo;
+		if (vkCreateInstance(&instanceInfo, nullptr, &device->instance) != VK_SUCCESS)
+		{
+			device->instance = VK_NULL_HANDLE;
+			error = "no Vulkan driver, install lavapipe to run the device tests";
+			return false;
+		}
+
+		//picks a CPU device first, then anything with a graphics and compute queue
+		uint32 physicalDeviceCount = 0;
+		vkEnumeratePhysicalDevices(device->instance, &physicalDeviceCount, nullptr);
+		std::vector<VkPhysicalDevice> physicalDevices(physicalDeviceCount);
+		if (physicalDeviceCount)
+			vkEnumeratePhysicalDevices(device->instance, &physicalDeviceCount, physicalDevices.data());
+
+		int32 bestScore = -1;
+		for (size_t i = 0; i < physicalDevices.size(); ++i)
+		{
+			uint32 familyCount = 0;
+			vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[i], &familyCount, nullptr);
+			std::vector<VkQueueFamilyProperties> families(familyCount);
+			vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[i], &familyCount, families.data());
+
+			for (uint32 f = 0; f < familyCount; ++f)
+			{
+				if ((families[f].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) != (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))
+					continue;
+
+				VkPhysicalDeviceProperties properties = {};
+				vkGetPhysicalDeviceProperties(physicalDevices[i], &properties);
+				const int32 score = (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU ? 1 : 0);
+				if (score > bestScore)
+				{
+					bestScore = score;
+					device->GPU.physicalDevice = physicalDevices[i]; device->properties = properties;
+					device->queueFamily = f;
+				}
+				break;
+			}
+		}
+
+		if (bestScore < 0)
+		{
+			TestDevice_Destroy(device);
+			error = "no Vulkan device with a graphics and compute queue";
+			return false;
+		}
+
+		//device
+		const float priority = 1.0f;
+		VkDeviceQueueCreateInfo queueInfo = {};
+		queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+		queueInfo.queueFamilyIndex = device->queueFamily;
+		queueInfo.queueCount = 1;
+		queueInfo.pQueuePriorities = &priority;
+
+		VkDeviceCreateInfo deviceInfo = {};
+		deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		deviceInfo.queueCreateInfoCount = 1;
+		deviceInfo.pQueueCreateInfos = &queueInfo;
+		if (vkCreateDevice(device->GPU.physicalDevice, &deviceInfo, nullptr, &device->GPU.device) != VK_SUCCESS)
+		{
+			device->GPU.device = VK_NULL_HANDLE;
+			TestDevice_Destroy(device);
+			error = "failed to create the Vulkan device";
+			return false;
+		}
+		vkGetDeviceQueue(device->GPU.device, device->queueFamily, 0, &device->GPU.graphicsQueue);
+		device->GPU.presentQueue = device->GPU.graphicsQueue;
+
+		//allocator
+		VmaAllocatorCreateInfo allocatorInfo = {};
+		allocatorInfo.physicalDevice = device->GPU.physicalDevice;
+		allocatorInfo.device = device->GPU.device;
+		allocatorInfo.instance = device->instance;
+		allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_2;
+		if (vmaCreateAllocator(&allocatorInfo, &device->allocator) != VK_SUCCESS)
+		{
+			device->allocator = VK_NULL_HANDLE;
+			TestDevice_Destroy(device);
+			error = "failed to create the allocator";
+			return false;
+		}
+
+		//command pool
+		VkCommandPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		poolInfo.queueFamilyIndex = device->queueFamily;
+		if (vkCreateCommandPool(device->GPU.device, &poolInfo, nullptr, &device->commandPool.pool) != VK_SUCCESS)
+		{
+			device->commandPool.pool = VK_NULL_HANDLE;
+			TestDevice_Destroy(device);
+			error = "failed to create the command pool";
+			return false;
+		}
+
+		return true;
+	}
+
+	//records commands into a one time command buffer, submits them and waits for them to finish
+	inline bool TestDevice_Submit(TestDevice* device, const std::function<void(VkCommandBuffer comBuffer)>& record)
+	{
+		VkCommandBufferAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = device->commandPool.pool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer comBuffer = VK_NULL_HANDLE;
+		if (vkAllocateCommandBuffers(device->GPU.device, &allocInfo, &comBuffer) != VK_SUCCESS)
+			return false;
+
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(comBuffer, &beginInfo);
+		record(comBuffer);
+		vkEndCommandBuffer(comBuffer);
+
+		VkSubmitInfo submitInfo = {};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &comBuffer;
+		const bool submitted = (vkQueueSubmit(device->GPU.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS);
+		vkQueueWaitIdle(device->GPU.graphicsQueue);
+
+		vkFreeCommandBuffers(device->GPU.device, device->commandPool.pool, 1, &comBuffer);
+		return submitted;
+	}
+}
+
+//makes a headless device for a test, skipping the test if there isn't one
+#define SMOK_RENDERER_TEST_REQUIRE_DEVICE(device) \
+	do { std::string deviceError; if (!Smok::Renderers::Test::TestDevice_Create(&(device), deviceError)) SMOK_RENDERER_TEST_SKIP(deviceError); } while (0)
@@ -0,0 +1,170 @@
+//tests encoding then decoding the block compressed formats on the CPU, which needs no device
+
+#include "Test.hpp"
+
+#include <SmokRenderers/Util/TextureCompression.hpp>
+
+using namespace Smok::Renderers;
+
+//makes a RGBA8 image of gradients with the same slope at any size, so every block is as hard to compress || up to 64x32 pixels
+//with a alpha ramp when hasAlpha, opaque otherwise
+static std::vector<uint8> BuildTestImage(const uint32 width, const uint32 height, const bool hasAlpha)
+{
+	std::vector<uint8> rgba((size_t)width * height * 4);
+	for (uint32 y = 0; y < height; ++y)
+	{
+		for (uint32 x = 0; x < width; ++x)
+		{
+			uint8* pixel = &rgba[((size_t)y * width + x) * 4];
+			pixel[0] = (uint8)(x * 4);
+			pixel[1] = (uint8)(y * 8);
+			pixel[2] = (uint8)(64 + (x + y) * 2);
+			pixel[3] = (hasAlpha ? (uint8)(255 - x * 4) : 255);
+		}
+	}
+
+	return rgba;
+}
+
+//gets the root mean square error over the first channelCount channels of two RGBA8 images
+static double CalculateRMSE(const std::vector<uint8>& a, const std::vector<uint8>& b, const uint32 channelCount)
+{
+	double sum = 0.0; size_t count = 0;
+	for (size_t p = 0; p + 3 < a.size() && p + 3 < b.size(); p += 4)
+	{
+		for (uint32 c = 0; c < channelCount; ++c, ++count)
+		{
+			const double d = (double)a[p + c] - (double)b[p + c];
+			sum += d * d;
+		}
+	}
+
+	return (count > 0 ? std::sqrt(sum / (double)count) : 0.0);
+}
+
+//gets the channels a format keeps, BC5 only keeps red and green
+static uint32 GetCheckedChannelCount(const Util::TextureCompression compression)
+{
+	switch (compression)
+	{
+	case Util::TextureCompression::BC1: return 3;
+	case Util::TextureCompression::BC5: return 2;
+	default: return 4;
+	}
+}
+
+static const Util::TextureCompression testCompressions[4] = { Util::TextureCompression::BC1, Util::TextureCompression::BC3,
+	Util::TextureCompression::BC5, Util::TextureCompression::BC7 };
+static const char* testCompressionNames[4] = { "BC1", "BC3", "BC5", "BC7" };
+
+//the largest RMSE each format may have on the gradients, BC1 and BC3 color have 565 endpoints, BC5 keeps 8 bit endpoints a channel
+static const double testMaxRMSE[4] = { 6.0, 6.0, 3.0, 5.0 };
+
+//every format decodes a gradient image close to what was encoded
+SMOK_RENDERER_TEST(TextureCompression_RoundTripsWithinErrorBound)
+{
+	const uint32 width = 64, height = 32;
+	for (uint32 f = 0; f < 4; ++f)
+	{
+		const std::vector<uint8> rgba = BuildTestImage(width, height, testCompressions[f] != Util::TextureCompression::BC1);
+
+		std::vector<uint8> encoded, decoded;
+		Util::BlockCompression_Encode(testCompressions[f], rgba.data(), width, height, encoded);
+		SMOK_RENDERER_TEST_REQUIRE(encoded.size() == Util::TextureCompression_GetLevelByteSize(testCompressions[f], width, height));
+
+		Util::BlockCompression_Decode(testCompressions[f], encoded.data(), width, height, decoded);
+		SMOK_RENDERER_TEST_REQUIRE(decoded.size() == rgba.size());
+
+		const double error = CalculateRMSE(rgba, decoded, GetCheckedChannelCount(testCompressions[f]));
+		SMOK_RENDERER_TEST_CHECK(error <= testMaxRMSE[f]);
+		if (error > testMaxRMSE[f])
+			std::printf("  %s RMSE %f is over %f\n", testCompressionNames[f], error, testMaxRMSE[f]);
+	}
+}
+
+//images that aren't a multiple of 4 keep their size, and the pixels of the partial edge blocks still round trip
+SMOK_RENDERER_TEST(TextureCompression_RoundTripsEdgeSizedImages)
+{
+	const uint32 sizes[5][2] = { { 1, 1 }, { 3, 5 }, { 7, 2 }, { 13, 9 }, { 6, 17 } };
+	for (uint32 f = 0; f < 4; ++f)
+	{
+		for (uint32 s = 0; s < 5; ++s)
+		{
+			const uint32 width = sizes[s][0], height = sizes[s][1];
+			const std::vector<uint8> rgba = BuildTestImage(width, height, testCompressions[f] != Util::TextureCompression::BC1);
+
+			std::vector<uint8> encoded, decoded;
+			Util::BlockCompression_Encode(testCompressions[f], rgba.data(), width, height, encoded);
+			const size_t blockCount = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+			SMOK_RENDERER_TEST_CHECK(encoded.size() == blockCount * Util::TextureCompression_GetBlockBytes(testCompressions[f]));
+
+			Util::BlockCompression_Decode(testCompressions[f], encoded.data(), width, height, decoded);
+			SMOK_RENDERER_TEST_REQUIRE(decoded.size() == (size_t)width * height * 4);
+
+			//the edge blocks repeat their last pixels, so they're held to the same bound as whole blocks
+			const double error = CalculateRMSE(rgba, decoded, GetCheckedChannelCount(testCompressions[f]));
+			SMOK_RENDERER_TEST_CHECK(error <= testMaxRMSE[f]);
+			if (error > testMaxRMSE[f])
+				std::printf("  %s %ux%u RMSE %f is over %f\n", testCompressionNames[f], width, height, error, testMaxRMSE[f]);
+		}
+	}
+}
+
+//a solid color comes back almost exactly, only losing the endpoint precision
+SMOK_RENDERER_TEST(TextureCompression_RoundTripsSolidColor)
+{
+	const uint32 width = 5, height = 6;
+	std::vector<uint8> rgba((size_t)width * height * 4);
+	for (size_t p = 0; p < rgba.size(); p += 4)
+	{
+		rgba[p] = 200; rgba[p + 1] = 100; rgba[p + 2] = 50; rgba[p + 3] = 255;
+	}
+
+	for (uint32 f = 0; f < 4; ++f)
+	{
+		std::vector<uint8> encoded, decoded;
+		Util::BlockCompression_Encode(testCompressions[f], rgba.data(), width, height, encoded);
+		Util::BlockCompression_Decode(testCompressions[f], encoded.data(), width, height, decoded);
+		SMOK_RENDERER_TEST_REQUIRE(decoded.size() == rgba.size());
+
+		int32 maxError = 0;
+		const uint32 channelCount = GetCheckedChannelCount(testCompressions[f]);
+		for (size_t p = 0; p < rgba.size(); p += 4)
+		{
+			for (uint32 c = 0; c < channelCount; ++c)
+				maxError = std::max(maxError, std::abs((int32)rgba[p + c] - (int32)decoded[p + c]));
+		}
+
+		SMOK_RENDERER_TEST_CHECK(maxError <= 4);
+		if (maxError > 4)
+			std::printf("  %s solid color is off by %d\n", testCompressionNames[f], maxError);
+	}
+}
+
+//BC1 keeps transparent pixels transparent with it's 3 color mode, and BC5 decodes blue as 0 and alpha as opaque
+SMOK_RENDERER_TEST(TextureCompression_KeepsPunchThroughAlphaAndBC5Channels)
+{
+	const uint32 width = 8, height = 4;
+	std::vector<uint8> rgba = BuildTestImage(width, height, false);
+	for (uint32 y = 0; y < height; ++y)
+		rgba[((size_t)y * width + (y % 4)) * 4 + 3] = 0;
+
+	std::vector<uint8> encoded, decoded;
+	Util::BlockCompression_Encode(Util::TextureCompression::BC1, rgba.data(), width, height, encoded);
+	Util::BlockCompression_Decode(Util::TextureCompression::BC1, encoded.data(), width, height, decoded);
+	SMOK_RENDERER_TEST_REQUIRE(decoded.size() == rgba.size());
+
+	bool alphaKept = true;
+	for (size_t p = 0; p < rgba.size(); p += 4)
+		alphaKept = alphaKept && (decoded[p + 3] == (rgba[p + 3] == 0 ? 0 : 255));
+	SMOK_RENDERER_TEST_CHECK(alphaKept);
+
+	Util::BlockCompression_Encode(Util::TextureCompression::BC5, rgba.data(), width, height, encoded);
+	Util::BlockCompression_Decode(Util::TextureCompression::BC5, encoded.data(), width, height, decoded);
+	SMOK_RENDERER_TEST_REQUIRE(decoded.size() == rgba.size());
+
+	bool channelsCleared = true;
+	for (size_t p = 0; p < decoded.size(); p += 4)
+		channelsCleared = channelsCleared && decoded[p + 2] == 0 && decoded[p + 3] == 255;
+	SMOK_RENDERER_TEST_CHECK(channelsCleared);
+}
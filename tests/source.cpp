@@ -0,0 +1,52 @@
+//runs the headless renderer tests
+//usage: SmokRenderers-Tests [--filter name] [--data path]
+//--data is where the compiled shaders are, the device tests skip themselves without them
+
+#include "Test.hpp"
+
+#include <cstring>
+
+using namespace Smok::Renderers::Test;
+
+int main(int argc, char** argv)
+{
+	std::string filter = "", dataPath = "shaders";
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+			filter = argv[++i];
+		else if (!strcmp(argv[i], "--data") && i + 1 < argc)
+			dataPath = argv[++i];
+	}
+
+	uint32 passed = 0, failed = 0, skipped = 0;
+	const std::vector<TestCase>& cases = Test_GetCases();
+	for (size_t i = 0; i < cases.size(); ++i)
+	{
+		if (!filter.empty() && cases[i].name.find(filter) == std::string::npos)
+			continue;
+
+		TestContext test;
+		test.name = cases[i].name; test.dataPath = dataPath;
+		cases[i].func(&test);
+
+		if (test.failedCheckCount > 0)
+		{
+			std::printf("FAIL %s (%u of %u checks failed)\n", test.name.c_str(), test.failedCheckCount, test.checkCount);
+			failed++;
+		}
+		else if (test.skipped)
+		{
+			std::printf("SKIP %s: %s\n", test.name.c_str(), test.skipReason.c_str());
+			skipped++;
+		}
+		else
+		{
+			std::printf("PASS %s\n", test.name.c_str());
+			passed++;
+		}
+	}
+
+	std::printf("%u passed, %u failed, %u skipped\n", passed, failed, skipped);
+	return (failed > 0 ? 1 : 0);
+}